@@ -0,0 +1,136 @@
+#include "federate_mode.hpp"
+#include "table_printer.hpp"
+
+#include "federated_query.hpp"
+#include "session_pool.hpp"
+#include "symbol_store_index.hpp"
+
+#include <cstdio>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+static bool gather_pdb_paths(const std::vector<std::string>& pdb_specs, const std::string& store_root,
+                             unsigned jobs, std::vector<std::string>& paths, std::string& error) {
+    if (!pdb_specs.empty()) {
+        paths = pdbsql::collect_pdb_paths(pdb_specs, error);
+        if (!error.empty()) return false;
+    }
+    if (!store_root.empty()) {
+        auto index = pdbsql::open_symbol_store_index(store_root, jobs, error);
+        if (!index) return false;
+        std::unordered_set<std::string> seen;
+        for (const auto& path : paths) seen.insert(pdbsql::pdb_path_key(path));
+        paths.reserve(paths.size() + index->size());
+        for (size_t i = 0; i < index->size(); i++) {
+            std::string path = index->path(i);
+            if (!seen.empty() && seen.count(pdbsql::pdb_path_key(path))) continue;
+            paths.push_back(std::move(path));
+        }
+    }
+    if (paths.empty()) {
+        error = "No .pdb files found";
+        return false;
+    }
+    return true;
+}
+
+int run_federate_mode(const std::vector<std::string>& pdb_specs, const std::string& store_root,
+                      const std::string& query, const std::string& merge_sql, unsigned jobs,
+                      OutputFormat format) {
+    std::vector<std::string> paths;
+    std::string error;
+    if (!gather_pdb_paths(pdb_specs, store_root, jobs, paths, error)) {
+        fprintf(stderr, "Error: %s\n", error.c_str());
+        return 1;
+    }
+
+    pdbsql::FederatedOptions options;
+    options.jobs = jobs;
+    options.merge_sql = merge_sql;
+
+    pdbsql::FederatedResult result = pdbsql::FederatedQuery::run(paths, query, options);
+
+    // Per-PDB failures are reported but don't fail the whole query
+    const size_t max_shown = 10;
+    for (size_t i = 0; i < result.failures.size() && i < max_shown; i++) {
+        fprintf(stderr, "Warning: %s\n", result.failures[i].c_str());
+    }
+    if (result.failures.size() > max_shown) {
+        fprintf(stderr, "Warning: ... and %zu more failed PDB(s)\n", result.failures.size() - max_shown);
+    }
+
+    if (!result.success) {
+        fprintf(stderr, "SQL error: %s\n", result.error.c_str());
+        return 1;
+    }
+
+    if (format == OutputFormat::Table) {
+        TablePrinter printer;
+        printer.set_columns(result.columns);
+        for (const auto& row : result.rows) {
+            std::vector<std::string> values;
+            values.reserve(row.size());
+            for (const auto& cell : row) {
+                values.push_back(pdbsql::federated_cell_text(cell));
+            }
+            printer.add_row(values);
+        }
+        printer.print();
+    } else {
+        RecordWriter writer(format);
+        writer.set_columns(result.columns);
+        std::vector<std::string> texts;
+        std::vector<char*> values;
+        for (const auto& row : result.rows) {
+            texts.clear();
+            values.clear();
+            for (const auto& cell : row) texts.push_back(pdbsql::federated_cell_text(cell));
+            for (size_t i = 0; i < row.size(); i++) {
+                bool is_null = row[i].type == pdbsql::FederatedCell::Type::Null;
+                values.push_back(is_null ? nullptr : &texts[i][0]);
+            }
+            writer.add_values(static_cast<int>(values.size()), values.data());
+        }
+        writer.flush();
+    }
+
+    fprintf(stderr, "Queried %llu of %llu PDB(s) in %.2fs (%zu failed%s)\n",
+            static_cast<unsigned long long>(result.pdbs_queried),
+            static_cast<unsigned long long>(result.pdbs_total),
+            result.seconds, result.failures.size(),
+            result.stopped_early ? ", stopped early at LIMIT" : "");
+    if (result.pdbs_skipped > 0) {
+        fprintf(stderr, "Skipped %llu PDB(s) whose name filter excludes '%s'\n",
+                static_cast<unsigned long long>(result.pdbs_skipped), result.filtered_name.c_str());
+    }
+    return result.failures.size() == result.pdbs_queried && result.pdbs_queried > 0 ? 1 : 0;
+}
+
+int run_build_filters_mode(const std::vector<std::string>& pdb_specs, const std::string& store_root,
+                           unsigned jobs) {
+    std::vector<std::string> paths;
+    std::string error;
+    if (!gather_pdb_paths(pdb_specs, store_root, jobs, paths, error)) {
+        fprintf(stderr, "Error: %s\n", error.c_str());
+        return 1;
+    }
+
+    printf("Building name filters for %zu PDB(s)...\n", paths.size());
+    pdbsql::NameFilterBuildStats stats = pdbsql::build_name_filters(paths, jobs);
+
+    const size_t max_shown = 10;
+    for (size_t i = 0; i < stats.failures.size() && i < max_shown; i++) {
+        fprintf(stderr, "Warning: %s\n", stats.failures[i].c_str());
+    }
+    if (stats.failures.size() > max_shown) {
+        fprintf(stderr, "Warning: ... and %zu more failed PDB(s)\n", stats.failures.size() - max_shown);
+    }
+
+    printf("Built %llu filter(s) (%llu names), %llu up to date, %zu failed in %.2fs\n",
+           static_cast<unsigned long long>(stats.built),
+           static_cast<unsigned long long>(stats.names),
+           static_cast<unsigned long long>(stats.up_to_date),
+           stats.failures.size(), stats.seconds);
+    return stats.failures.empty() ? 0 : 1;
+}
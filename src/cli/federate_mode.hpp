@@ -0,0 +1,17 @@
+#pragma once
+
+#include "output_format.hpp"
+
+#include <string>
+#include <vector>
+
+// Run one query against every PDB in the set (files, directories and/or an
+// indexed symbol store) and print the merged result with a `pdb` column.
+int run_federate_mode(const std::vector<std::string>& pdb_specs, const std::string& store_root,
+                      const std::string& query, const std::string& merge_sql, unsigned jobs,
+                      OutputFormat format = OutputFormat::Table);
+
+// Build (or refresh) the per-PDB name filter sidecars used to skip PDBs on
+// exact `name = '...'` federated queries.
+int run_build_filters_mode(const std::vector<std::string>& pdb_specs, const std::string& store_root,
+                           unsigned jobs);
@@ -3,17 +3,27 @@
 #ifdef PDBSQL_HAS_HTTP
 
 #include "query_json.hpp"
+#include "arrow_ipc.hpp"
+#include "metrics.hpp"
 #include "pdb_session.hpp"
 #include "pdb_tables.hpp"
+#include "server_query_dispatcher.hpp"
+#include "session_pool.hpp"
+#include "slow_query_log.hpp"
+#include "statement_cache.hpp"
+#include "trace.hpp"
 
 #include <xsql/database.hpp>
+#include <xsql/json.hpp>
 #include <xsql/thinclient/server.hpp>
 
 #include <csignal>
 #include <chrono>
+#include <cstdint>
 #include <mutex>
 #include <string>
 #include <thread>
+#include <vector>
 
 static xsql::thinclient::server* g_http_server = nullptr;
 
@@ -21,6 +31,228 @@ static void http_signal_handler(int) {
     if (g_http_server) g_http_server->stop();
 }
 
+static bool check_auth(const httplib::Request& req, httplib::Response& res, const std::string& auth_token) {
+    if (auth_token.empty()) return true;
+    std::string token;
+    if (req.has_header("X-XSQL-Token")) token = req.get_header_value("X-XSQL-Token");
+    else if (req.has_header("Authorization")) {
+        auto auth = req.get_header_value("Authorization");
+        if (auth.rfind("Bearer ", 0) == 0) token = auth.substr(7);
+    }
+    if (token != auth_token) {
+        res.status = 401;
+        res.set_content("{\"success\":false,\"error\":\"Unauthorized\"}", "application/json");
+        return false;
+    }
+    return true;
+}
+
+// Parse a JSON request body; on failure fills a 400 response.
+static bool parse_json_body(const httplib::Request& req, httplib::Response& res, xsql::json& body) {
+    try {
+        body = xsql::json::parse(req.body);
+    } catch (const std::exception& e) {
+        res.status = 400;
+        res.set_content(error_to_json(std::string("Invalid JSON: ") + e.what()), "application/json");
+        return false;
+    }
+    if (!body.is_object()) {
+        res.status = 400;
+        res.set_content(error_to_json("Request body must be a JSON object"), "application/json");
+        return false;
+    }
+    return true;
+}
+
+// Optional string field of a parsed body. Missing or null leaves `out` as is;
+// any other non-string value fills a 400 response.
+static bool body_string(const xsql::json& body, const char* key, std::string& out, httplib::Response& res) {
+    if (!body.contains(key) || body.at(key).is_null()) return true;
+    if (!body.at(key).is_string()) {
+        res.status = 400;
+        res.set_content(error_to_json(std::string("'") + key + "' must be a string"), "application/json");
+        return false;
+    }
+    out = body.at(key).get<std::string>();
+    return true;
+}
+
+static bool body_bool(const xsql::json& body, const char* key, bool& out, httplib::Response& res) {
+    if (!body.contains(key) || body.at(key).is_null()) return true;
+    if (!body.at(key).is_boolean()) {
+        res.status = 400;
+        res.set_content(error_to_json(std::string("'") + key + "' must be a boolean"), "application/json");
+        return false;
+    }
+    out = body.at(key).get<bool>();
+    return true;
+}
+
+static xsql::thinclient::server_config make_server_config(int port, const std::string& bind_addr,
+                                                          const std::string& auth_token) {
+    xsql::thinclient::server_config cfg;
+    cfg.port = port;
+    cfg.bind_address = bind_addr.empty() ? "127.0.0.1" : bind_addr;
+    if (!auth_token.empty()) cfg.auth_token = auth_token;
+    if (!bind_addr.empty() && bind_addr != "127.0.0.1" && bind_addr != "localhost") {
+        cfg.allow_insecure_no_auth = auth_token.empty();
+        fprintf(stderr, "WARNING: Binding to non-loopback address %s\n", bind_addr.c_str());
+        if (auth_token.empty()) {
+            fprintf(stderr, "WARNING: No authentication token set. Server is accessible without authentication.\n");
+            fprintf(stderr, "         Consider using --token <secret> for remote access.\n");
+        }
+    }
+    return cfg;
+}
+
+// Run the server and block until it stops (via signal or /shutdown).
+static int serve_until_stopped(xsql::thinclient::server_config& cfg, const char* endpoints) {
+    xsql::thinclient::server http_server(cfg);
+    g_http_server = &http_server;
+
+    auto old_handler = std::signal(SIGINT, http_signal_handler);
+#ifdef _WIN32
+    auto old_break_handler = std::signal(SIGBREAK, http_signal_handler);
+#else
+    auto old_term_handler = std::signal(SIGTERM, http_signal_handler);
+#endif
+
+    http_server.run_async();
+    int actual_port = http_server.port();
+
+    printf("HTTP server listening on http://%s:%d\n", cfg.bind_address.c_str(), actual_port);
+    printf("Endpoints: %s\n", endpoints);
+    printf("Example: curl http://localhost:%d/help\n", actual_port);
+    printf("Press Ctrl+C to stop.\n\n");
+    fflush(stdout);
+
+    while (http_server.is_running()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+
+    std::signal(SIGINT, old_handler);
+#ifdef _WIN32
+    std::signal(SIGBREAK, old_break_handler);
+#else
+    std::signal(SIGTERM, old_term_handler);
+#endif
+    g_http_server = nullptr;
+    printf("\nHTTP server stopped.\n");
+    return 0;
+}
+
+static void schedule_shutdown(httplib::Server& svr, httplib::Response& res) {
+    res.set_content("{\"success\":true,\"message\":\"Shutting down\"}", "application/json");
+    std::thread([&svr] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        svr.stop();
+    }).detach();
+}
+
+// Peer identity for the slow-query log
+static std::string client_of(const httplib::Request& req) {
+    return req.remote_addr + ":" + std::to_string(req.remote_port);
+}
+
+static double seconds_since(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// ?profile=true (or 1) on any query route
+static bool wants_profile(const httplib::Request& req) {
+    if (!req.has_param("profile")) return false;
+    std::string v = req.get_param_value("profile");
+    return v == "1" || v == "true";
+}
+
+// ?hex=rva writes rva columns as "0x..." strings
+static JsonResultOptions json_options(const httplib::Request& req) {
+    JsonResultOptions options;
+    options.hex_rva = req.has_param("hex") && req.get_param_value("hex") == "rva";
+    return options;
+}
+
+static const char* ARROW_STREAM_TYPE = "application/vnd.apache.arrow.stream";
+
+// Accept: application/vnd.apache.arrow.stream on /query
+static bool wants_arrow(const httplib::Request& req) {
+    return req.get_header_value("Accept").find(ARROW_STREAM_TYPE) != std::string::npos;
+}
+
+// Run one statement through the cache as an Arrow IPC stream.
+// On failure `body` holds a JSON error instead.
+static bool cached_query_to_arrow(pdbsql::StatementCache& cache, const std::string& sql,
+                                  std::string& body, size_t& rows) {
+    std::string error;
+    auto stmt = cache.acquire(sql, error);
+    if (stmt) {
+        pdbsql::ArrowIpcWriter writer(pdbsql::ArrowIpcFormat::Stream);
+        if (writer.write_statement(stmt.get(), error, &rows)) {
+            body.swap(writer.bytes());
+            return true;
+        }
+    }
+    body = error_to_json(error);
+    return false;
+}
+
+// Arrow body, or the JSON error (400) it was replaced with
+static void set_arrow_content(httplib::Response& res, std::string& body, bool ok) {
+    if (ok) {
+        res.set_content(std::move(body), ARROW_STREAM_TYPE);
+    } else {
+        res.status = 400;
+        res.set_content(std::move(body), "application/json");
+    }
+}
+
+// Trace span for one route handler. Its end marks where httplib starts
+// writing the response, which add_trace_logger() closes as "http.send".
+class RouteSpan {
+public:
+    explicit RouteSpan(const httplib::Request& req) : span_(("HTTP " + req.path).c_str(), "http") {
+        pdbsql::Tracer::name_thread("http");
+        span_.arg("method", req.method).arg("bytes_in", req.body.size());
+    }
+    ~RouteSpan() {
+        if (span_.active()) response_ready_us() = pdbsql::Tracer::now_us();
+    }
+
+    RouteSpan(const RouteSpan&) = delete;
+    RouteSpan& operator=(const RouteSpan&) = delete;
+
+    // Set per HTTP worker thread; the handler and the write share a thread.
+    static double& response_ready_us() {
+        thread_local double ready = 0.0;
+        return ready;
+    }
+
+private:
+    pdbsql::TraceSpan span_;
+};
+
+// httplib calls the logger after the response has been written.
+static void add_trace_logger(httplib::Server& svr) {
+    if (!pdbsql::Tracer::global().enabled()) return;
+    svr.set_logger([](const httplib::Request& req, const httplib::Response& res) {
+        double& ready = RouteSpan::response_ready_us();
+        if (ready <= 0.0) return;
+        std::string args = "\"path\":";
+        pdbsql::append_json_string(args, req.path);
+        args += ",\"status\":" + std::to_string(res.status) + ",\"bytes_out\":" + std::to_string(res.body.size());
+        pdbsql::Tracer::global().complete("http.send", "http", ready, pdbsql::Tracer::now_us() - ready, args);
+        ready = 0.0;
+    });
+}
+
+// Prometheus scrape endpoint. Reads atomics only, so it never waits on queries.
+static void add_metrics_route(httplib::Server& svr, const std::string& auth_token) {
+    svr.Get("/metrics", [&auth_token](const httplib::Request& req, httplib::Response& res) {
+        if (!check_auth(req, res, auth_token)) return;
+        res.set_content(pdbsql::Metrics::global().render(), "text/plain; version=0.0.4");
+    });
+}
+
 static const char* PDBSQL_HELP_TEXT = R"(PDBSQL HTTP REST API
 ====================
 
@@ -30,7 +262,12 @@ Endpoints:
   GET  /         - Welcome message
   GET  /help     - This documentation (for LLM discovery)
   POST /query    - Execute SQL (body = raw SQL, response = JSON)
+                   (Accept: application/vnd.apache.arrow.stream returns an Arrow IPC stream)
+  POST /prepare  - Register a named statement (body = {"name": "...", "sql": "..."})
+  POST /execute  - Run a prepared statement with bound parameters
+                   (body = {"sql": "...", "params": [...]} or {"statement": "name", "params": {...}})
   GET  /status   - Server health
+  GET  /metrics  - Prometheus metrics (latency by route, rows/scans per table, caches)
   POST /shutdown - Stop server
 
 Tables:
@@ -42,11 +279,17 @@ Tables:
   typedefs        - Type definitions
   thunks          - Thunk symbols
   labels          - Labels
+  symbol_search   - Ranked fuzzy name search; query = '...' is required
   compilands      - Compilation units
   source_files    - Source file paths
   line_numbers    - Line number mappings
+  inline_sites    - Inlined calls and their address ranges
   sections        - PE sections
+  section_contributions - Per-compiland byte ranges of each section
+  frame_data      - Stack frame (FPO) records; probe_rva = ? finds the covering one
   udt_members     - UDT member fields
+  udt_layout      - UDT layout: padding, holes, bitfields, cache lines
+  type_duplicates - UDTs defined more than once, by structural hash
   enum_values     - Enumeration values
   base_classes    - Class inheritance
   locals          - Local variables
@@ -57,9 +300,24 @@ Example Queries:
   SELECT name FROM udts WHERE kind = 'class';
   SELECT * FROM sections;
 
+Profiling:
+  POST /query?profile=true, or "profile": true in an /execute body, adds a "profile"
+  object: per table cursors (xFilter calls), plan used (full scan / filter #id),
+  rows emitted, generator time, rows discarded by SQLite, and EXPLAIN QUERY PLAN.
+
+Prepared Statements:
+  Use ? / ?NNN for positional params (JSON array) or :name for named params (JSON object).
+  Statements are cached (LRU) and re-used across requests, so hot queries are planned once.
+  curl -X POST http://localhost:8081/execute \
+       -d '{"sql": "SELECT * FROM functions WHERE id = ?", "params": [1234]}'
+
 Response Format:
   Success: {"success": true, "columns": [...], "rows": [[...]], "row_count": N}
+           Values are typed: integers and reals as numbers, NULL as null, text as strings.
+           ?hex=rva on /query or /execute writes rva columns as "0x..." strings.
   Error:   {"success": false, "error": "message"}
+  Arrow:   curl -H "Accept: application/vnd.apache.arrow.stream" ... returns typed columns
+           (INTEGER columns as int64) for pyarrow/pandas/DuckDB; errors stay JSON (400)
 
 Authentication (if enabled):
   Header: Authorization: Bearer <token>
@@ -85,27 +343,23 @@ int run_http_mode(const std::string& pdb_path, int port, const std::string& bind
     pdbsql::TableRegistry registry(session);
     registry.register_all(db);
 
-    xsql::thinclient::server_config cfg;
-    cfg.port = port;
-    cfg.bind_address = bind_addr.empty() ? "127.0.0.1" : bind_addr;
-    if (!auth_token.empty()) cfg.auth_token = auth_token;
-    if (!bind_addr.empty() && bind_addr != "127.0.0.1" && bind_addr != "localhost") {
-        cfg.allow_insecure_no_auth = auth_token.empty();
-        fprintf(stderr, "WARNING: Binding to non-loopback address %s\n", bind_addr.c_str());
-        if (auth_token.empty()) {
-            fprintf(stderr, "WARNING: No authentication token set. Server is accessible without authentication.\n");
-            fprintf(stderr, "         Consider using --token <secret> for remote access.\n");
-        }
-    }
+    xsql::thinclient::server_config cfg = make_server_config(port, bind_addr, auth_token);
 
     std::mutex query_mutex;
+    pdbsql::StatementCache statements(db.handle());
+    std::string function_count;  // Computed on the first /status, then cached
+
+    cfg.setup_routes = [&db, &pdb_path, &auth_token, &query_mutex, &statements, &function_count, port](httplib::Server& svr) {
+        auto& metrics = pdbsql::Metrics::global();
 
-    cfg.setup_routes = [&db, &pdb_path, &auth_token, &query_mutex, port](httplib::Server& svr) {
         svr.Get("/", [port](const httplib::Request&, httplib::Response& res) {
             std::string welcome = "PDBSQL HTTP Server\n\nEndpoints:\n"
                 "  GET  /help     - API documentation\n"
                 "  POST /query    - Execute SQL query\n"
+                "  POST /prepare  - Register a named statement\n"
+                "  POST /execute  - Execute a statement with bound parameters\n"
                 "  GET  /status   - Health check\n"
+                "  GET  /metrics  - Prometheus metrics\n"
                 "  POST /shutdown - Stop server\n\n"
                 "Example: curl -X POST http://localhost:" + std::to_string(port) + "/query -d \"SELECT name FROM functions LIMIT 5\"\n";
             res.set_content(welcome, "text/plain");
@@ -115,103 +369,391 @@ int run_http_mode(const std::string& pdb_path, int port, const std::string& bind
             res.set_content(PDBSQL_HELP_TEXT, "text/plain");
         });
 
-        svr.Post("/query", [&db, &auth_token, &query_mutex](const httplib::Request& req, httplib::Response& res) {
-            if (!auth_token.empty()) {
-                std::string token;
-                if (req.has_header("X-XSQL-Token")) token = req.get_header_value("X-XSQL-Token");
-                else if (req.has_header("Authorization")) {
-                    auto auth = req.get_header_value("Authorization");
-                    if (auth.rfind("Bearer ", 0) == 0) token = auth.substr(7);
-                }
-                if (token != auth_token) {
-                    res.status = 401;
-                    res.set_content("{\"success\":false,\"error\":\"Unauthorized\"}", "application/json");
-                    return;
-                }
-            }
+        svr.Post("/query", [&db, &auth_token, &query_mutex, &statements,
+                            latency = &metrics.route("/query")](const httplib::Request& req, httplib::Response& res) {
+            if (!check_auth(req, res, auth_token)) return;
+            pdbsql::ScopedLatency timer(*latency);
+            RouteSpan span(req);
             if (req.body.empty()) {
                 res.status = 400;
                 res.set_content("{\"success\":false,\"error\":\"Empty query\"}", "application/json");
                 return;
             }
+            const auto waiting = std::chrono::steady_clock::now();
             std::lock_guard<std::mutex> lock(query_mutex);
-            res.set_content(query_result_to_json(db, req.body), "application/json");
+            pdbsql::SlowQueryWatch slow("http", client_of(req), req.body, seconds_since(waiting));
+            slow.set_user_agent(req.get_header_value("User-Agent"));
+            size_t rows = 0;
+            if (wants_arrow(req)) {
+                std::string body;
+                bool ok = cached_query_to_arrow(statements, req.body, body, rows);
+                slow.finish(rows, ok);
+                set_arrow_content(res, body, ok);
+                return;
+            }
+            std::string json = cached_query_to_json(statements, db, req.body, wants_profile(req), &rows,
+                                                    json_options(req));
+            slow.finish(rows, json_succeeded(json));
+            res.set_content(json, "application/json");
         });
 
-        svr.Get("/status", [&db, &pdb_path, &auth_token](const httplib::Request& req, httplib::Response& res) {
-            if (!auth_token.empty()) {
-                std::string token;
-                if (req.has_header("X-XSQL-Token")) token = req.get_header_value("X-XSQL-Token");
-                else if (req.has_header("Authorization")) {
-                    auto auth = req.get_header_value("Authorization");
-                    if (auth.rfind("Bearer ", 0) == 0) token = auth.substr(7);
-                }
-                if (token != auth_token) {
-                    res.status = 401;
-                    res.set_content("{\"success\":false,\"error\":\"Unauthorized\"}", "application/json");
-                    return;
+        svr.Post("/prepare", [&auth_token, &query_mutex, &statements,
+                              latency = &metrics.route("/prepare")](const httplib::Request& req, httplib::Response& res) {
+            if (!check_auth(req, res, auth_token)) return;
+            pdbsql::ScopedLatency timer(*latency);
+            RouteSpan span(req);
+            xsql::json body;
+            if (!parse_json_body(req, res, body)) return;
+            std::string name;
+            std::string sql;
+            if (!body_string(body, "name", name, res) || !body_string(body, "sql", sql, res)) return;
+            if (name.empty() || sql.empty()) {
+                res.status = 400;
+                res.set_content(error_to_json("Both 'name' and 'sql' are required"), "application/json");
+                return;
+            }
+
+            std::lock_guard<std::mutex> lock(query_mutex);
+            std::string error;
+            int nparams = 0;
+            if (!statements.register_named(name, sql, error, &nparams)) {
+                res.set_content(error_to_json(error), "application/json");
+                return;
+            }
+            res.set_content("{\"success\":true,\"name\":\"" + json_escape(name) +
+                            "\",\"parameters\":" + std::to_string(nparams) + "}", "application/json");
+        });
+
+        svr.Post("/execute", [&auth_token, &query_mutex, &statements,
+                              latency = &metrics.route("/execute")](const httplib::Request& req, httplib::Response& res) {
+            if (!check_auth(req, res, auth_token)) return;
+            pdbsql::ScopedLatency timer(*latency);
+            RouteSpan span(req);
+            xsql::json body;
+            if (!parse_json_body(req, res, body)) return;
+
+            std::string name;
+            std::string sql;
+            if (!body_string(body, "statement", name, res) || !body_string(body, "sql", sql, res)) return;
+            if (name.empty() == sql.empty()) {
+                res.status = 400;
+                res.set_content(error_to_json("Specify exactly one of 'sql' or 'statement'"), "application/json");
+                return;
+            }
+
+            std::vector<pdbsql::StatementParam> params;
+            std::string error;
+            if (body.contains("params") && !pdbsql::params_from_json(body["params"], params, error)) {
+                res.status = 400;
+                res.set_content(error_to_json(error), "application/json");
+                return;
+            }
+
+            bool profile = false;
+            if (!body_bool(body, "profile", profile, res)) return;
+            profile = profile || wants_profile(req);
+            const auto waiting = std::chrono::steady_clock::now();
+            std::lock_guard<std::mutex> lock(query_mutex);
+            pdbsql::SlowQueryWatch slow("http", client_of(req), sql, seconds_since(waiting));
+            slow.set_user_agent(req.get_header_value("User-Agent"));
+            slow.set_statement(name);
+            size_t rows = 0;
+            std::string json = name.empty()
+                ? prepared_query_to_json(statements, sql, params, false, profile, &rows, json_options(req))
+                : prepared_query_to_json(statements, name, params, true, profile, &rows, json_options(req));
+            slow.finish(rows, json_succeeded(json));
+            res.set_content(json, "application/json");
+        });
+
+        svr.Get("/status", [&db, &pdb_path, &auth_token, &query_mutex, &function_count,
+                             latency = &metrics.route("/status")](const httplib::Request& req, httplib::Response& res) {
+            if (!check_auth(req, res, auth_token)) return;
+            pdbsql::ScopedLatency timer(*latency);
+            RouteSpan span(req);
+            std::string count;
+            {
+                // Health probes are frequent; only the first one scans the table
+                std::lock_guard<std::mutex> lock(query_mutex);
+                if (function_count.empty()) {
+                    auto result = db.query("SELECT COUNT(*) FROM functions");
+                    if (result.ok() && !result.empty()) function_count = result[0][0];
                 }
+                count = function_count.empty() ? "null" : function_count;
             }
-            auto result = db.query("SELECT COUNT(*) FROM functions");
-            std::string count = result.ok() && !result.empty() ? result[0][0] : "?";
             res.set_content("{\"success\":true,\"status\":\"ok\",\"tool\":\"pdbsql\",\"pdb\":\"" + json_escape(pdb_path) + "\",\"functions\":" + count + "}", "application/json");
         });
 
+        add_metrics_route(svr, auth_token);
+        add_trace_logger(svr);
+
         svr.Post("/shutdown", [&svr, &auth_token](const httplib::Request& req, httplib::Response& res) {
-            if (!auth_token.empty()) {
-                std::string token;
-                if (req.has_header("X-XSQL-Token")) token = req.get_header_value("X-XSQL-Token");
-                else if (req.has_header("Authorization")) {
-                    auto auth = req.get_header_value("Authorization");
-                    if (auth.rfind("Bearer ", 0) == 0) token = auth.substr(7);
+            if (!check_auth(req, res, auth_token)) return;
+            schedule_shutdown(svr, res);
+        });
+    };
+
+    return serve_until_stopped(cfg, "/help, /query, /prepare, /execute, /status, /metrics, /shutdown");
+}
+
+//=============================================================================
+// Pooled mode - many PDBs behind one server
+//=============================================================================
+
+static const char* PDBSQL_POOL_HELP_TEXT = R"(PDBSQL HTTP REST API (pooled)
+=============================
+
+Serves many PDBs from one process. PDBs are opened on first use and the
+least recently used ones are closed when the memory budget is exceeded.
+
+Selecting a PDB (path, module name, or GUID+age signature):
+  POST /query?pdb=ntdll            - Query parameter
+  X-PDB: ntdll                     - Request header
+  USE ntdll; SELECT ...            - Leading directive in the SQL
+  Without a selection, queries run against the pool catalog (table: pdbs).
+  With --index-store, every PDB in the store is listed and opens on first use;
+  SELECT * FROM pdbs WHERE signature = '<GUID+age>' is a binary search.
+
+Endpoints:
+  GET  /         - Welcome message
+  GET  /help     - This documentation (for LLM discovery)
+  POST /query    - Execute SQL (body = raw SQL, response = JSON)
+                   (Accept: application/vnd.apache.arrow.stream returns an Arrow IPC stream)
+  POST /prepare  - Register a named statement (body = {"pdb": "...", "name": "...", "sql": "..."})
+  POST /execute  - Run a statement with bound parameters
+                   (body = {"pdb": "...", "sql": "...", "params": [...]})
+  GET  /pdbs     - List pooled PDBs (path, module, signature, is_open, opens, queries)
+  GET  /status   - Pool statistics
+  GET  /metrics  - Prometheus metrics (latency by route, rows/scans per table, caches, queue)
+  POST /shutdown - Stop server
+
+  Add ?profile=true (or "profile": true on /execute) for a per-table profile.
+
+Response Format:
+  Success: {"success": true, "columns": [...], "rows": [[...]], "row_count": N}
+           Values are typed: integers and reals as numbers, NULL as null, text as strings.
+           ?hex=rva on /query or /execute writes rva columns as "0x..." strings.
+  Error:   {"success": false, "error": "message"}
+  Arrow:   curl -H "Accept: application/vnd.apache.arrow.stream" ... returns typed columns
+           (INTEGER columns as int64) for pyarrow/pandas/DuckDB; errors stay JSON (400)
+
+Example:
+  curl http://localhost:8081/pdbs
+  curl -X POST "http://localhost:8081/query?pdb=ntdll" -d "SELECT name FROM functions LIMIT 5"
+  curl -X POST http://localhost:8081/query -d "USE kernel32; SELECT COUNT(*) FROM publics"
+)";
+
+// PDB selector from ?pdb= or the X-PDB header (empty = use routing directive)
+static std::string requested_pdb(const httplib::Request& req) {
+    if (req.has_param("pdb")) return req.get_param_value("pdb");
+    if (req.has_header("X-PDB")) return req.get_header_value("X-PDB");
+    return "";
+}
+
+int run_http_pool_mode(const std::vector<std::string>& pdb_specs, const std::string& store_root, unsigned jobs,
+                       uint64_t pool_bytes, int port, const std::string& bind_addr, const std::string& auth_token) {
+    pdbsql::SessionPool pool(pool_bytes);
+    std::string error;
+    if (!pdbsql::populate_session_pool(pool, pdb_specs, store_root, jobs, error)) {
+        fprintf(stderr, "Error: %s\n", error.c_str());
+        return 1;
+    }
+
+    printf("PDBSQL HTTP Server - Pooled %zu PDB(s), %zu indexed, budget %llu MB\n",
+           pool.size(), pool.indexed_count(), static_cast<unsigned long long>(pool_bytes >> 20));
+
+    xsql::thinclient::server_config cfg = make_server_config(port, bind_addr, auth_token);
+
+    // All pool and DIA access is serialized on the dispatcher worker
+    pdbsql::ServerQueryDispatcher dispatcher(pool.router());
+
+    cfg.setup_routes = [&pool, &dispatcher, &auth_token, port](httplib::Server& svr) {
+        auto& metrics = pdbsql::Metrics::global();
+
+        svr.Get("/", [port](const httplib::Request&, httplib::Response& res) {
+            std::string welcome = "PDBSQL HTTP Server (pooled)\n\nEndpoints:\n"
+                "  GET  /help     - API documentation\n"
+                "  POST /query    - Execute SQL query (?pdb=<name> or USE <name>;)\n"
+                "  POST /prepare  - Register a named statement\n"
+                "  POST /execute  - Execute a statement with bound parameters\n"
+                "  GET  /pdbs     - List pooled PDBs\n"
+                "  GET  /status   - Pool statistics\n"
+                "  GET  /metrics  - Prometheus metrics\n"
+                "  POST /shutdown - Stop server\n\n"
+                "Example: curl -X POST \"http://localhost:" + std::to_string(port) + "/query?pdb=ntdll\" -d \"SELECT name FROM functions LIMIT 5\"\n";
+            res.set_content(welcome, "text/plain");
+        });
+
+        svr.Get("/help", [](const httplib::Request&, httplib::Response& res) {
+            res.set_content(PDBSQL_POOL_HELP_TEXT, "text/plain");
+        });
+
+        svr.Post("/query", [&pool, &dispatcher, &auth_token,
+                         latency = &metrics.route("/query")](const httplib::Request& req, httplib::Response& res) {
+            if (!check_auth(req, res, auth_token)) return;
+            pdbsql::ScopedLatency timer(*latency);
+            RouteSpan span(req);
+            if (req.body.empty()) {
+                res.status = 400;
+                res.set_content("{\"success\":false,\"error\":\"Empty query\"}", "application/json");
+                return;
+            }
+            std::string pdb = requested_pdb(req);
+            const bool profile = wants_profile(req);
+            const bool arrow = wants_arrow(req);
+            bool arrow_ok = false;
+            std::string body = dispatcher.call([&]() -> std::string {
+                pdbsql::SlowQueryWatch slow("http", client_of(req), req.body,
+                                            pdbsql::ServerQueryDispatcher::queue_wait());
+                slow.set_user_agent(req.get_header_value("User-Agent"));
+                pdbsql::QueryTarget target;
+                std::string error;
+                bool routed = pdb.empty() ? pool.route(req.body, target, error)
+                                          : pool.route_to(pdb, req.body, target, error);
+                if (!routed) {
+                    slow.finish(0, false, error);
+                    return error_to_json(error);
                 }
-                if (token != auth_token) {
-                    res.status = 401;
-                    res.set_content("{\"success\":false,\"error\":\"Unauthorized\"}", "application/json");
-                    return;
+                size_t rows = 0;
+                if (arrow) {
+                    std::string out;
+                    arrow_ok = cached_query_to_arrow(*target.statements, target.sql, out, rows);
+                    slow.finish(rows, arrow_ok);
+                    return out;
                 }
+                std::string json = cached_query_to_json(*target.statements, *target.db, target.sql, profile, &rows,
+                                                        json_options(req));
+                slow.finish(rows, json_succeeded(json));
+                return json;
+            });
+            if (arrow) set_arrow_content(res, body, arrow_ok);
+            else res.set_content(std::move(body), "application/json");
+        });
+
+        svr.Post("/prepare", [&pool, &dispatcher, &auth_token,
+                         latency = &metrics.route("/prepare")](const httplib::Request& req, httplib::Response& res) {
+            if (!check_auth(req, res, auth_token)) return;
+            pdbsql::ScopedLatency timer(*latency);
+            RouteSpan span(req);
+            xsql::json body;
+            if (!parse_json_body(req, res, body)) return;
+            std::string pdb = requested_pdb(req);
+            std::string name;
+            std::string sql;
+            if (!body_string(body, "pdb", pdb, res) || !body_string(body, "name", name, res) ||
+                !body_string(body, "sql", sql, res)) {
+                return;
             }
-            res.set_content("{\"success\":true,\"message\":\"Shutting down\"}", "application/json");
-            std::thread([&svr] {
-                std::this_thread::sleep_for(std::chrono::milliseconds(100));
-                svr.stop();
-            }).detach();
+            if (name.empty() || sql.empty()) {
+                res.status = 400;
+                res.set_content(error_to_json("Both 'name' and 'sql' are required"), "application/json");
+                return;
+            }
+
+            res.set_content(dispatcher.call([&]() -> std::string {
+                std::string error;
+                int nparams = 0;
+                if (!pool.register_named(pdb, name, sql, error, &nparams)) return error_to_json(error);
+                return "{\"success\":true,\"name\":\"" + json_escape(name) +
+                       "\",\"parameters\":" + std::to_string(nparams) + "}";
+            }), "application/json");
         });
-    };
 
-    xsql::thinclient::server http_server(cfg);
-    g_http_server = &http_server;
+        svr.Post("/execute", [&pool, &dispatcher, &auth_token,
+                         latency = &metrics.route("/execute")](const httplib::Request& req, httplib::Response& res) {
+            if (!check_auth(req, res, auth_token)) return;
+            pdbsql::ScopedLatency timer(*latency);
+            RouteSpan span(req);
+            xsql::json body;
+            if (!parse_json_body(req, res, body)) return;
 
-    auto old_handler = std::signal(SIGINT, http_signal_handler);
-#ifdef _WIN32
-    auto old_break_handler = std::signal(SIGBREAK, http_signal_handler);
-#else
-    auto old_term_handler = std::signal(SIGTERM, http_signal_handler);
-#endif
+            std::string pdb = requested_pdb(req);
+            std::string name;
+            std::string sql;
+            if (!body_string(body, "pdb", pdb, res) || !body_string(body, "statement", name, res) ||
+                !body_string(body, "sql", sql, res)) {
+                return;
+            }
+            if (name.empty() == sql.empty()) {
+                res.status = 400;
+                res.set_content(error_to_json("Specify exactly one of 'sql' or 'statement'"), "application/json");
+                return;
+            }
 
-    http_server.run_async();
-    int actual_port = http_server.port();
+            std::vector<pdbsql::StatementParam> params;
+            std::string error;
+            if (body.contains("params") && !pdbsql::params_from_json(body["params"], params, error)) {
+                res.status = 400;
+                res.set_content(error_to_json(error), "application/json");
+                return;
+            }
 
-    printf("HTTP server listening on http://%s:%d\n", cfg.bind_address.c_str(), actual_port);
-    printf("Endpoints: /help, /query, /status, /shutdown\n");
-    printf("Example: curl http://localhost:%d/help\n", actual_port);
-    printf("Press Ctrl+C to stop.\n\n");
-    fflush(stdout);
+            bool profile = false;
+            if (!body_bool(body, "profile", profile, res)) return;
+            profile = profile || wants_profile(req);
+            res.set_content(dispatcher.call([&]() -> std::string {
+                pdbsql::SlowQueryWatch slow("http", client_of(req), sql,
+                                            pdbsql::ServerQueryDispatcher::queue_wait());
+                slow.set_user_agent(req.get_header_value("User-Agent"));
+                slow.set_statement(name);
+                pdbsql::QueryTarget target;
+                std::string route_error;
+                if (!pool.route_to(pdb, sql, target, route_error)) {
+                    slow.finish(0, false, route_error);
+                    return error_to_json(route_error);
+                }
+                size_t rows = 0;
+                std::string json = name.empty()
+                    ? prepared_query_to_json(*target.statements, target.sql, params, false, profile, &rows,
+                                             json_options(req))
+                    : prepared_query_to_json(*target.statements, name, params, true, profile, &rows,
+                                             json_options(req));
+                slow.finish(rows, json_succeeded(json));
+                return json;
+            }), "application/json");
+        });
 
-    // Block until server stops (via signal or /shutdown)
-    while (http_server.is_running()) {
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
-    }
+        svr.Get("/pdbs", [&pool, &dispatcher, &auth_token,
+                         latency = &metrics.route("/pdbs")](const httplib::Request& req, httplib::Response& res) {
+            if (!check_auth(req, res, auth_token)) return;
+            pdbsql::ScopedLatency timer(*latency);
+            RouteSpan span(req);
+            res.set_content(dispatcher.call([&pool] {
+                return query_result_to_json(pool.catalog_db(), "SELECT * FROM pdbs");
+            }), "application/json");
+        });
 
-    std::signal(SIGINT, old_handler);
-#ifdef _WIN32
-    std::signal(SIGBREAK, old_break_handler);
-#else
-    std::signal(SIGTERM, old_term_handler);
-#endif
-    g_http_server = nullptr;
-    printf("\nHTTP server stopped.\n");
-    return 0;
+        svr.Get("/status", [&pool, &dispatcher, &auth_token,
+                         latency = &metrics.route("/status")](const httplib::Request& req, httplib::Response& res) {
+            if (!check_auth(req, res, auth_token)) return;
+            pdbsql::ScopedLatency timer(*latency);
+            RouteSpan span(req);
+            res.set_content(dispatcher.call([&pool] {
+                return std::string("{\"success\":true,\"status\":\"ok\",\"tool\":\"pdbsql\",\"mode\":\"pool\"") +
+                       ",\"pdbs\":" + std::to_string(pool.size()) +
+                       ",\"indexed\":" + std::to_string(pool.indexed_count()) +
+                       ",\"open\":" + std::to_string(pool.open_count()) +
+                       ",\"memory_used\":" + std::to_string(pool.memory_used()) +
+                       ",\"memory_cap\":" + std::to_string(pool.memory_cap()) +
+                       ",\"hits\":" + std::to_string(pool.hits()) +
+                       ",\"misses\":" + std::to_string(pool.misses()) +
+                       ",\"evictions\":" + std::to_string(pool.evictions()) + "}";
+            }), "application/json");
+        });
+
+        add_metrics_route(svr, auth_token);
+        add_trace_logger(svr);
+
+        svr.Post("/shutdown", [&svr, &auth_token](const httplib::Request& req, httplib::Response& res) {
+            if (!check_auth(req, res, auth_token)) return;
+            schedule_shutdown(svr, res);
+        });
+    };
+
+    int rc = serve_until_stopped(cfg, "/help, /query, /prepare, /execute, /pdbs, /status, /metrics, /shutdown");
+
+    // Release DIA objects on the thread that created them
+    dispatcher.call([&pool] { pool.close_all(); });
+    return rc;
 }
 
 #endif // PDBSQL_HAS_HTTP
@@ -2,9 +2,15 @@
 
 #ifdef PDBSQL_HAS_HTTP
 
+#include <cstdint>
 #include <string>
+#include <vector>
 
 int run_http_mode(const std::string& pdb_path, int port,
                   const std::string& bind_addr, const std::string& auth_token);
 
+// Serve many PDBs (files, directories, or an indexed symbol store) from an LRU session pool.
+int run_http_pool_mode(const std::vector<std::string>& pdb_specs, const std::string& store_root, unsigned jobs,
+                       uint64_t pool_bytes, int port, const std::string& bind_addr, const std::string& auth_token);
+
 #endif
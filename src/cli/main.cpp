@@ -7,13 +7,24 @@
  *   pdbsql <pdb_file> -q "<query>"         Execute SQL query (local)
  *   pdbsql <pdb_file> -i                   Interactive mode (local)
  *   pdbsql <pdb_file> --server [port]      Start server mode (default: 13337)
+ *   pdbsql --pdbs <dir> --server [port]    Serve many PDBs from one process
+ *   pdbsql --index-store <dir>             Index a symbol store by GUID+age
+ *   pdbsql --pdbs <dir> --federate -q "<query>"  Query many PDBs in parallel
+ *   pdbsql --pdbs <dir> --build-filters    Build name filter sidecars
+ *   pdbsql <pdb_file> --materialize <db>   Copy every table into a SQLite file
+ *   pdbsql <pdb_file> --export-arrow <dir> Export every table as Arrow IPC
+ *   pdbsql <old.pdb> --diff <new.pdb>      Compare two builds (pdb_diff table)
+ *   pdbsql <pdb_file> --size-report [dim]  Size attribution as folded stacks
  *   pdbsql --remote host:port -q "<query>" Execute SQL query (remote)
  *   pdbsql --remote host:port -i           Interactive mode (remote)
  */
 
 #include "table_printer.hpp"
+#include "arrow_ipc.hpp"
+#include "output_format.hpp"
 #include "query_json.hpp"
 #include "remote_mode.hpp"
+#include "federate_mode.hpp"
 #ifdef PDBSQL_HAS_HTTP
 #include "http_mode.hpp"
 #endif
@@ -22,8 +33,17 @@
 #endif
 
 #include "pdb_session.hpp"
+#include "materialize.hpp"
+#include "pdb_diff.hpp"
 #include "pdb_tables.hpp"
+#include "query_profile.hpp"
 #include "server_query_dispatcher.hpp"
+#include "session_pool.hpp"
+#include "size_report.hpp"
+#include "slow_query_log.hpp"
+#include "symbol_store_index.hpp"
+#include "statement_cache.hpp"
+#include "trace.hpp"
 
 #include <xsql/database.hpp>
 #include <xsql/socket/server.hpp>
@@ -42,6 +62,8 @@
 #include <thread>
 #include <chrono>
 #include <memory>
+#include <cstdint>
+#include <filesystem>
 
 #ifdef PDBSQL_HAS_AI_AGENT
 #include "../common/ai_agent.hpp"
@@ -83,19 +105,78 @@ static int table_callback(void*, int argc, char** argv, char** colNames) {
     return 0;
 }
 
-static bool execute_query(xsql::Database& db, const char* sql) {
+// Rows sampled to size columns before query output starts streaming (--width-rows)
+static size_t g_width_rows = StreamingTablePrinter::DEFAULT_SAMPLE_ROWS;
+
+static int stream_callback(void* printer, int argc, char** argv, char** colNames) {
+    static_cast<StreamingTablePrinter*>(printer)->add_row(argc, argv, colNames);
+    return 0;
+}
+
+// Query output format (--format); table unless asked otherwise
+static OutputFormat g_format = OutputFormat::Table;
+
+// Run sql into the --format writer (or the streaming table). Returns the SQLite rc.
+static int exec_formatted(xsql::Database& db, const char* sql, size_t& rows) {
+    if (g_format == OutputFormat::Table) {
+        // Rows print while the query runs; memory stays bounded by the width sample
+        StreamingTablePrinter printer(g_width_rows);
+        int rc = db.exec(sql, stream_callback, &printer);
+        printer.finish();
+        rows = printer.row_count();
+        return rc;
+    }
+    RecordWriter writer(g_format);
+    int rc = exec_records(db.handle(), sql, writer);
+    writer.flush();
+    rows = writer.row_count();
+    if (g_format == OutputFormat::Null) fprintf(stderr, "%zu row(s)\n", rows);
+    return rc;
+}
+
+static void print_profile(const pdbsql::QueryProfile& profile) {
     TablePrinter printer;
-    g_printer = &printer;
+    printer.set_columns(pdbsql::QueryProfile::columns());
+    for (const auto& row : profile.rows()) {
+        printer.add_row(row);
+    }
+    printf("\nProfile (%.3f ms):\n", profile.seconds * 1000.0);
+    printer.print();
+}
 
-    int rc = db.exec(sql, table_callback, nullptr);
-    g_printer = nullptr;
+// Run a query and print it; `profile` (or a leading PROFILE) adds a per-table report.
+static bool execute_query(xsql::Database& db, const char* sql, bool profile = false) {
+    std::string unprefixed;
+    if (pdbsql::split_profile_directive(sql, unprefixed)) {
+        sql = unprefixed.c_str();
+        profile = true;
+    }
+
+    pdbsql::QueryProfile query_profile;
+    size_t rows = 0;
+    int rc;
+    {
+        pdbsql::TraceSpan span("sql.exec+print", "sql");
+        span.arg("sql", sql);
+        if (profile) {
+            pdbsql::QueryProfile::Scope scope(query_profile);
+            rc = exec_formatted(db, sql, rows);
+        } else {
+            rc = exec_formatted(db, sql, rows);
+        }
+        span.arg("rows", rows);
+    }
 
     if (rc != SQLITE_OK) {
         fprintf(stderr, "SQL error: %s\n", db.last_error().c_str());
         return false;
     }
 
-    printer.print();
+    if (profile) {
+        query_profile.rows_returned = rows;
+        query_profile.explain(db.handle(), sql);
+        print_profile(query_profile);
+    }
     return true;
 }
 
@@ -104,13 +185,21 @@ static std::string execute_query_to_string(xsql::Database& db, const std::string
     TablePrinter printer;
     g_printer = &printer;
 
-    int rc = db.exec(sql.c_str(), table_callback, nullptr);
+    int rc;
+    {
+        pdbsql::TraceSpan span("sql.exec", "sql");
+        span.arg("sql", sql);
+        rc = db.exec(sql.c_str(), table_callback, nullptr);
+        span.arg("rows", printer.rows.size());
+    }
     g_printer = nullptr;
 
     if (rc != SQLITE_OK) {
         return "Error: " + db.last_error();
     }
 
+    pdbsql::TraceSpan span("serialize.text", "serialize");
+
     if (printer.columns.empty()) {
         return "OK (no results)";
     }
@@ -157,10 +246,35 @@ static void print_usage(const char* prog) {
     printf("  %s <pdb_file> -q \"<query>\"          Execute SQL query (local)\n", prog);
     printf("  %s <pdb_file> -i                    Interactive mode (local)\n", prog);
     printf("  %s <pdb_file> --server [port]       Start server (default: 13337)\n", prog);
+    printf("  %s --pdbs <dir> --server [port]     Serve many PDBs (route with USE <pdb>;)\n", prog);
+    printf("  %s --index-store <dir>              Build the GUID+age catalog of a symbol store\n", prog);
+    printf("  %s --pdbs <dir> --federate -q \"<query>\"  Query every PDB in parallel\n", prog);
+    printf("  %s --pdbs <dir> --build-filters     Write name filter sidecars (<pdb>.pdbsql-names)\n", prog);
+    printf("  %s <pdb_file> --materialize <db>  Copy every table into an indexed SQLite database\n", prog);
+    printf("  %s <pdb_file> --export-arrow <dir>  Export every table as Arrow IPC (<dir>/<table>.arrow)\n", prog);
+    printf("  %s <old.pdb> --diff <new.pdb>       Summarize what changed between two builds\n", prog);
+    printf("  %s <pdb_file> --size-report [dim]   Size attribution as folded stacks (flame graphs)\n", prog);
     printf("\nOptions:\n");
     printf("  -s, --source <path>    PDB file path (alternative to positional)\n");
     printf("  -q <query>             SQL query to execute\n");
     printf("  -i, --interactive      Interactive SQL mode\n");
+    printf("  --pdbs <file|dir>      Add PDBs to the server pool (repeatable, dirs are recursive)\n");
+    printf("  --pool-mb <n>          Memory budget for open pooled PDBs (default: 2048)\n");
+    printf("  --index-store <dir>    Index a symbol store (alone), or serve it with --server/--http\n");
+    printf("  --jobs <n>             Worker threads for indexing/federation/materialize (default: all cores)\n");
+    printf("  --federate             Run -q against every PDB from --pdbs/--index-store (adds a pdb column)\n");
+    printf("  --merge \"<query>\"      Re-aggregate federated rows (table: results)\n");
+    printf("  --build-filters        Build name filters so --federate skips PDBs on name = '...'\n");
+    printf("  --format <fmt>         Output: table (default), csv, tsv, ndjson/jsonl, null (count only)\n");
+    printf("  --materialize <db>     Write all tables to a native SQLite file (indexed, with PDB GUID/age)\n");
+    printf("  --export-arrow <path>  Write the -q result as an Arrow IPC file (no -q: every table into dir <path>)\n");
+    printf("  --arrow-stream         With --export-arrow, write the Arrow IPC stream format instead\n");
+    printf("  --diff <new.pdb>       Add the pdb_diff table (this PDB vs <new.pdb>); no -q/-i: print a summary\n");
+    printf("  --size-report [dim]    Print bytes by directory (default), compiland, library or namespace\n");
+    printf("  --width-rows <n>       Rows sampled for column widths before output streams (default: 256, 0 = exact)\n");
+    printf("  --trace <file>         Write a Chrome trace (chrome://tracing, ui.perfetto.dev) of the run\n");
+    printf("  --slow-log <file>      Append slow --server/--http/--mcp queries as JSON lines\n");
+    printf("  --slow-ms <n>          Slow-query threshold in milliseconds (default: 500)\n");
     printf("  %s --remote host:port -q \"<query>\"  Execute SQL query (remote)\n", prog);
     printf("  %s --remote host:port -i            Interactive mode (remote)\n", prog);
     printf("  %s --token <token>                  Auth token for server/remote mode\n", prog);
@@ -177,9 +291,14 @@ static void print_usage(const char* prog) {
     printf("  %s <pdb_file> -v                    Show agent debug logs\n", prog);
 #endif
     printf("\nTables:\n");
-    printf("  functions, publics, data, udts, enums, typedefs, thunks, labels\n");
-    printf("  compilands, source_files, line_numbers, sections\n");
-    printf("  udt_members, enum_values, base_classes, locals, parameters\n");
+    printf("  functions, publics, data, udts, enums, typedefs, thunks, labels, symbol_search\n");
+    printf("  compilands, source_files, line_numbers, inline_sites, sections, section_contributions, frame_data\n");
+    printf("  udt_members, udt_layout, type_duplicates, enum_values, base_classes, locals, parameters\n");
+    printf("  inlinees_at(rva) - inline call chain at an address, innermost first\n");
+    printf("  contrib_at(rva)  - compiland_id of the section contribution covering an address\n");
+    printf("  undecorate(name[, flags]) - MSVC name undecorator (UNDNAME_* flags, 0x1000 = name only)\n");
+    printf("  size_by (dimension, path, parent, depth, bytes, code/data/self bytes, items, folded)\n");
+    printf("  pdb_diff (with --diff: kind, change, name, old/new rva and size, deltas, detail)\n");
 #ifdef PDBSQL_HAS_AI_AGENT
     printf("\nAgent settings stored in: ~/.pdbsql/agent_settings.json (or %%APPDATA%%\\pdbsql on Windows)\n");
 #endif
@@ -187,6 +306,11 @@ static void print_usage(const char* prog) {
     printf("  %s test.pdb \"SELECT name, rva FROM functions LIMIT 10\"\n", prog);
     printf("  %s test.pdb \"SELECT * FROM udts WHERE name LIKE '%%Counter%%'\"\n", prog);
     printf("  %s test.pdb --server 13337\n", prog);
+    printf("  %s --pdbs C:\\symbols --server 13337\n", prog);
+    printf("  %s --index-store D:\\symstore --http 8081\n", prog);
+    printf("  %s --pdbs C:\\symbols --federate -q \"SELECT name FROM functions WHERE name = 'main'\"\n", prog);
+    printf("  %s --pdbs C:\\symbols --federate -q \"SELECT COUNT(*) AS n FROM udts\" --merge \"SELECT SUM(n) FROM results\"\n", prog);
+    printf("  %s old.pdb --diff new.pdb -q \"SELECT name, size_delta FROM pdb_diff WHERE kind = 'functions' ORDER BY size_delta DESC LIMIT 20\"\n", prog);
     printf("  %s --remote localhost:13337 -q \"SELECT * FROM functions\"\n", prog);
 #ifdef PDBSQL_HAS_AI_AGENT
     printf("  %s test.pdb --prompt \"Find the largest functions\"\n", prog);
@@ -207,6 +331,7 @@ static void interactive_mode(xsql::Database& db) {
 #endif
     std::string line;
     std::string stmt;
+    bool profile = false;  // .profile on
 
 #ifdef PDBSQL_HAS_AI_AGENT
     std::unique_ptr<pdbsql::AIAgent> agent;
@@ -282,6 +407,12 @@ static void interactive_mode(xsql::Database& db) {
             callbacks.get_info = [&db]() -> std::string {
                 return "PDBSQL Database\n";
             };
+            callbacks.set_profile = [&profile](const std::string& arg) -> std::string {
+                if (arg == "on") profile = true;
+                else if (arg == "off") profile = false;
+                else if (!arg.empty()) return "Usage: .profile [on|off]";
+                return std::string("Profiling is ") + (profile ? "on" : "off");
+            };
             callbacks.clear_session = [&agent]() -> std::string {
                 if (agent) {
                     agent->reset_session();
@@ -307,6 +438,11 @@ static void interactive_mode(xsql::Database& db) {
                 pdbsql::QueryCallback sql_cb = [&db](const std::string& sql) -> std::string {
                     return query_result_to_json(db, sql);
                 };
+                auto statements = std::make_shared<pdbsql::StatementCache>(db.handle());
+                g_mcp_server->set_execute_callback(
+                    [statements](const std::string& sql, const std::vector<pdbsql::StatementParam>& params) {
+                        return prepared_query_to_json(*statements, sql, params);
+                    });
                 g_mcp_agent = std::make_unique<pdbsql::AIAgent>(sql_cb);
                 g_mcp_agent->start();
                 pdbsql::AskCallback ask_cb = [](const std::string& question) -> std::string {
@@ -318,7 +454,7 @@ static void interactive_mode(xsql::Database& db) {
                     g_mcp_agent.reset();
                     return "Error: Failed to start MCP server\n";
                 }
-                printf("%s", pdbsql::format_mcp_info(port, true).c_str());
+                printf("%s", pdbsql::format_mcp_info(port, true, true).c_str());
                 printf("Press Ctrl+C to stop MCP server and return to REPL...\n\n");
                 fflush(stdout);
                 g_quit_requested.store(false);
@@ -415,8 +551,13 @@ static void interactive_mode(xsql::Database& db) {
                 execute_query(db, "SELECT sql FROM sqlite_master WHERE type='table'");
                 continue;
             }
+            if (line == ".profile" || line == ".profile on" || line == ".profile off") {
+                if (line != ".profile") profile = line == ".profile on";
+                printf("Profiling is %s\n", profile ? "on" : "off");
+                continue;
+            }
             if (line == ".help") {
-                printf("Commands: .tables, .schema, .quit, .help\n");
+                printf("Commands: .tables, .schema, .profile [on|off], .quit, .help\n");
                 printf("SQL queries end with semicolon (;)\n");
                 continue;
             }
@@ -444,7 +585,7 @@ static void interactive_mode(xsql::Database& db) {
         size_t last = line.length() - 1;
         while (last > 0 && (line[last] == ' ' || line[last] == '\t')) last--;
         if (line[last] == ';') {
-            execute_query(db, stmt.c_str());
+            execute_query(db, stmt.c_str(), profile);
             stmt.clear();
         }
     }
@@ -497,6 +638,167 @@ static int run_server_mode(const std::string& pdb_path, int port, const std::str
     return 0;
 }
 
+static int run_pool_server_mode(const std::vector<std::string>& pdb_specs, const std::string& store_root,
+                                unsigned jobs, uint64_t pool_bytes, int port, const std::string& auth_token) {
+    pdbsql::SessionPool pool(pool_bytes);
+    std::string error;
+    if (!pdbsql::populate_session_pool(pool, pdb_specs, store_root, jobs, error)) {
+        fprintf(stderr, "Error: %s\n", error.c_str());
+        return 1;
+    }
+
+    printf("PDBSQL Server - Pooled %zu PDB(s), %zu indexed, budget %llu MB\n",
+           pool.size(), pool.indexed_count(), static_cast<unsigned long long>(pool_bytes >> 20));
+
+    xsql::socket::Server server;
+    if (!auth_token.empty()) {
+        xsql::socket::ServerConfig cfg;
+        cfg.auth_token = auth_token;
+        server.set_config(cfg);
+    }
+    // PDBs are opened lazily on the dispatcher worker (COM-initialized)
+    pdbsql::ServerQueryDispatcher dispatcher(pool.router());
+    server.set_query_handler([&dispatcher](const std::string& sql) -> xsql::socket::QueryResult {
+        return dispatcher.run(sql);
+    });
+
+    printf("Starting server on port %d...\n", port);
+    printf("Connect with: pdbsql --remote localhost:%d -q \"USE <pdb>; SELECT * FROM functions\"\n", port);
+    printf("List PDBs with: pdbsql --remote localhost:%d -q \"SELECT * FROM pdbs\"\n", port);
+    printf("Press Ctrl+C to stop.\n\n");
+
+    server.run(port);
+
+    // Release DIA objects on the thread that created them
+    dispatcher.call([&pool] { pool.close_all(); });
+    return 0;
+}
+
+static int run_index_store_mode(const std::string& store_root, unsigned jobs) {
+    std::string index_path = pdbsql::SymbolStoreIndex::default_index_path(store_root);
+    printf("Indexing symbol store: %s\n", store_root.c_str());
+
+    pdbsql::SymbolStoreIndex::BuildStats stats;
+    std::string error;
+    if (!pdbsql::SymbolStoreIndex::build(store_root, index_path, jobs, stats, error)) {
+        fprintf(stderr, "Error: %s\n", error.c_str());
+        return 1;
+    }
+
+    printf("Indexed %llu of %llu PDB(s) in %.2fs (%llu unreadable)\n",
+           static_cast<unsigned long long>(stats.indexed), static_cast<unsigned long long>(stats.files),
+           stats.seconds, static_cast<unsigned long long>(stats.failed));
+    printf("Catalog: %s\n", index_path.c_str());
+    return 0;
+}
+
+static int run_materialize_mode(const std::string& pdb_path, const std::string& db_path, unsigned jobs) {
+    printf("Materializing %s into %s\n", pdb_path.c_str(), db_path.c_str());
+
+    pdbsql::MaterializeStats stats;
+    std::string error;
+    if (!pdbsql::materialize_pdb(pdb_path, db_path, jobs, stats, error)) {
+        fprintf(stderr, "Error: %s\n", error.c_str());
+        return 1;
+    }
+
+    uint64_t total = 0;
+    for (const auto& t : stats.tables) {
+        printf("  %-16s %10llu row(s)\n", t.name.c_str(), static_cast<unsigned long long>(t.rows));
+        total += t.rows;
+    }
+    printf("Wrote %llu row(s) in %zu table(s), %zu index(es) in %.2fs\n",
+           static_cast<unsigned long long>(total), stats.tables.size(), stats.indexes.size(), stats.seconds);
+    return 0;
+}
+
+// --size-report: folded stacks on stdout (pipe into flamegraph.pl), summary on stderr
+static int run_size_report_mode(const std::string& pdb_path, const std::string& dimension) {
+    pdbsql::SizeDimension dim;
+    if (!pdbsql::parse_size_dimension(dimension, dim)) {
+        fprintf(stderr, "Invalid --size-report dimension: %s (directory, compiland, library, namespace)\n",
+                dimension.c_str());
+        return 1;
+    }
+
+    pdbsql::PdbSession session;
+    if (!session.open(pdb_path)) {
+        fprintf(stderr, "Error: %s\n", session.last_error().c_str());
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    pdbsql::SectionContribCache contribs(session);
+    pdbsql::SizeReport report(session, contribs);
+    size_t lines = report.write_folded(stdout, dim);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    fprintf(stderr, "%zu stack(s), %llu byte(s) by %s in %.2fs\n", lines,
+            static_cast<unsigned long long>(report.total_bytes()), dimension.c_str(), seconds);
+    return 0;
+}
+
+// --export-arrow: the -q result to one file, or every table to <dir>/<table>.arrow
+static int run_arrow_export(xsql::Database& db, const pdbsql::TableRegistry& registry, const std::string& query,
+                            const std::string& path, pdbsql::ArrowIpcFormat format) {
+    // Written to <file>.tmp and renamed on success, so a failed query or
+    // write never leaves a truncated IPC file behind
+    auto export_one = [&db, format](const std::string& sql, const std::string& file, size_t& rows) -> bool {
+        namespace fs = std::filesystem;
+        const std::string tmp = file + ".tmp";
+        FILE* out = fopen(tmp.c_str(), "wb");
+        if (!out) {
+            fprintf(stderr, "Error: cannot create %s\n", tmp.c_str());
+            return false;
+        }
+        std::string error;
+        bool ok = pdbsql::query_to_arrow(db.handle(), sql, format, out, nullptr, error, &rows);
+        if (fclose(out) != 0 && ok) {
+            ok = false;
+            error = "write failed";
+        }
+
+        std::error_code ec;
+        if (ok) {
+            fs::rename(fs::u8path(tmp), fs::u8path(file), ec);
+            if (ec) {
+                fs::remove(fs::u8path(file), ec);
+                fs::rename(fs::u8path(tmp), fs::u8path(file), ec);
+            }
+            if (ec) {
+                ok = false;
+                error = "cannot replace file";
+            }
+        }
+        if (!ok) {
+            fs::remove(fs::u8path(tmp), ec);
+            fprintf(stderr, "Error: %s: %s\n", file.c_str(), error.c_str());
+        }
+        return ok;
+    };
+
+    size_t rows = 0;
+    if (!query.empty()) {
+        if (!export_one(query, path, rows)) return 1;
+        printf("Wrote %zu row(s) to %s\n", rows, path.c_str());
+        return 0;
+    }
+
+    std::error_code ec;
+    std::filesystem::create_directories(std::filesystem::u8path(path), ec);
+    if (ec) {
+        fprintf(stderr, "Error: cannot create directory %s: %s\n", path.c_str(), ec.message().c_str());
+        return 1;
+    }
+    const char* ext = format == pdbsql::ArrowIpcFormat::Stream ? ".arrows" : ".arrow";
+    for (const auto& table : registry.table_names()) {
+        std::string file = (std::filesystem::u8path(path) / (table + ext)).u8string();
+        if (!export_one("SELECT * FROM " + table, file, rows)) return 1;
+        printf("  %-16s %10zu row(s)\n", table.c_str(), rows);
+    }
+    printf("Wrote %zu table(s) to %s\n", registry.table_names().size(), path.c_str());
+    return 0;
+}
+
 static void dump_symbol_counts(pdbsql::PdbSession& session) {
     printf("Symbol Counts:\n");
     printf("  Functions:      %ld\n", session.count_symbols(SymTagFunction));
@@ -523,6 +825,21 @@ int main(int argc, char* argv[]) {
     bool http_mode = false;
     int server_port = 13337;
     int http_port = 8080;
+    std::vector<std::string> pool_specs;
+    uint64_t pool_mb = 2048;
+    std::string index_store;
+    unsigned jobs = 0;
+    bool federate = false;
+    std::string merge_sql;
+    bool build_filters = false;
+    std::string trace_path;
+    std::string arrow_path;
+    std::string materialize_path;
+    std::string diff_path;
+    std::string size_report_dim;  // Empty unless --size-report
+    pdbsql::ArrowIpcFormat arrow_format = pdbsql::ArrowIpcFormat::File;
+    std::string slow_log_path;
+    double slow_ms = 500.0;
 #ifdef PDBSQL_HAS_AI_AGENT
     std::string nl_prompt;
     bool agent_mode = false;
@@ -593,6 +910,70 @@ int main(int argc, char* argv[]) {
                     return 1;
                 }
             }
+        } else if (strcmp(argv[i], "--pdbs") == 0 && i + 1 < argc) {
+            pool_specs.push_back(argv[++i]);
+        } else if (strcmp(argv[i], "--pool-mb") == 0 && i + 1 < argc) {
+            char* end = nullptr;
+            unsigned long long mb = strtoull(argv[++i], &end, 10);
+            if (!end || *end != '\0' || mb == 0) {
+                fprintf(stderr, "Invalid --pool-mb: %s\n", argv[i]);
+                return 1;
+            }
+            pool_mb = mb;
+        } else if (strcmp(argv[i], "--index-store") == 0 && i + 1 < argc) {
+            index_store = argv[++i];
+        } else if (strcmp(argv[i], "--federate") == 0) {
+            federate = true;
+        } else if (strcmp(argv[i], "--merge") == 0 && i + 1 < argc) {
+            merge_sql = argv[++i];
+        } else if (strcmp(argv[i], "--build-filters") == 0) {
+            build_filters = true;
+        } else if (strcmp(argv[i], "--jobs") == 0 && i + 1 < argc) {
+            char* end = nullptr;
+            unsigned long n = strtoul(argv[++i], &end, 10);
+            if (!end || *end != '\0' || n == 0 || n > 1024) {
+                fprintf(stderr, "Invalid --jobs: %s\n", argv[i]);
+                return 1;
+            }
+            jobs = static_cast<unsigned>(n);
+        } else if (strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+            if (!parse_output_format(argv[++i], g_format)) {
+                fprintf(stderr, "Invalid --format: %s (table, csv, tsv, ndjson, jsonl, null)\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--width-rows") == 0 && i + 1 < argc) {
+            char* end = nullptr;
+            unsigned long n = strtoul(argv[++i], &end, 10);
+            if (!end || *end != '\0') {
+                fprintf(stderr, "Invalid --width-rows: %s\n", argv[i]);
+                return 1;
+            }
+            g_width_rows = n;
+        } else if (strcmp(argv[i], "--materialize") == 0 && i + 1 < argc) {
+            materialize_path = argv[++i];
+        } else if (strcmp(argv[i], "--diff") == 0 && i + 1 < argc) {
+            diff_path = argv[++i];
+        } else if (strcmp(argv[i], "--size-report") == 0) {
+            size_report_dim = "directory";
+            pdbsql::SizeDimension dim;
+            if (i + 1 < argc && pdbsql::parse_size_dimension(argv[i + 1], dim)) {
+                size_report_dim = argv[++i];
+            }
+        } else if (strcmp(argv[i], "--export-arrow") == 0 && i + 1 < argc) {
+            arrow_path = argv[++i];
+        } else if (strcmp(argv[i], "--arrow-stream") == 0) {
+            arrow_format = pdbsql::ArrowIpcFormat::Stream;
+        } else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            trace_path = argv[++i];
+        } else if (strcmp(argv[i], "--slow-log") == 0 && i + 1 < argc) {
+            slow_log_path = argv[++i];
+        } else if (strcmp(argv[i], "--slow-ms") == 0 && i + 1 < argc) {
+            char* end = nullptr;
+            slow_ms = strtod(argv[++i], &end);
+            if (!end || *end != '\0' || slow_ms < 0) {
+                fprintf(stderr, "Invalid --slow-ms: %s\n", argv[i]);
+                return 1;
+            }
         } else if (strcmp(argv[i], "--bind") == 0 && i + 1 < argc) {
             bind_addr = argv[++i];
         } else if ((strcmp(argv[i], "-s") == 0 || strcmp(argv[i], "--source") == 0) && i + 1 < argc) {
@@ -608,11 +989,31 @@ int main(int argc, char* argv[]) {
         }
     }
 
+    // Stays open until main returns; servers flush it every second meanwhile
+    pdbsql::TraceFile trace;
+    if (!trace_path.empty()) {
+        std::string error;
+        if (!trace.open(trace_path, error)) {
+            fprintf(stderr, "Error: %s\n", error.c_str());
+            return 1;
+        }
+        pdbsql::Tracer::name_thread("main");
+    }
+
+    pdbsql::SlowQueryLogFile slow_log;
+    if (!slow_log_path.empty()) {
+        std::string error;
+        if (!slow_log.open(slow_log_path, slow_ms, error)) {
+            fprintf(stderr, "Error: %s\n", error.c_str());
+            return 1;
+        }
+    }
+
     //=========================================================================
     // Remote mode
     //=========================================================================
     if (!remote_spec.empty()) {
-        if (!pdb_path.empty()) {
+        if (!pdb_path.empty() || !pool_specs.empty() || !index_store.empty()) {
             fprintf(stderr, "Error: Cannot use both PDB path and --remote\n");
             return 1;
         }
@@ -635,7 +1036,53 @@ int main(int argc, char* argv[]) {
             host = remote_spec;
         }
 
-        return run_remote_mode(host, port, query, auth_token, interactive);
+        return run_remote_mode(host, port, query, auth_token, interactive, g_format);
+    }
+
+    //=========================================================================
+    // Symbol store indexing and pooled server modes - many PDBs, routed per query
+    //=========================================================================
+    if (build_filters) {
+        if (!pdb_path.empty()) pool_specs.push_back(pdb_path);
+        if (pool_specs.empty() && index_store.empty()) {
+            fprintf(stderr, "Error: --build-filters requires --pdbs or --index-store\n");
+            return 1;
+        }
+        return run_build_filters_mode(pool_specs, index_store, jobs);
+    }
+
+    if (federate) {
+        if (query.empty() && !pdb_path.empty() && (!pool_specs.empty() || !index_store.empty())) {
+            query = pdb_path;  // pdbsql --pdbs <dir> --federate "<query>"
+        } else if (!pdb_path.empty()) {
+            pool_specs.push_back(pdb_path);
+        }
+        if (query.empty() || (pool_specs.empty() && index_store.empty())) {
+            fprintf(stderr, "Error: --federate requires -q \"<query>\" and --pdbs or --index-store\n");
+            return 1;
+        }
+        return run_federate_mode(pool_specs, index_store, query, merge_sql, jobs, g_format);
+    }
+
+    if (!index_store.empty() && !server_mode && !http_mode) {
+        return run_index_store_mode(index_store, jobs);
+    }
+
+    if (!pool_specs.empty() || !index_store.empty()) {
+        if (!pdb_path.empty()) {
+            pool_specs.push_back(pdb_path);
+        }
+        const uint64_t pool_bytes = pool_mb << 20;
+        if (server_mode) {
+            return run_pool_server_mode(pool_specs, index_store, jobs, pool_bytes, server_port, auth_token);
+        }
+#ifdef PDBSQL_HAS_HTTP
+        if (http_mode) {
+            return run_http_pool_mode(pool_specs, index_store, jobs, pool_bytes, http_port, bind_addr, auth_token);
+        }
+#endif
+        fprintf(stderr, "Error: --pdbs requires --server or --http\n");
+        return 1;
     }
 
     //=========================================================================
@@ -647,6 +1094,14 @@ int main(int argc, char* argv[]) {
         return 1;
     }
 
+    if (!materialize_path.empty()) {
+        return run_materialize_mode(pdb_path, materialize_path, jobs);
+    }
+
+    if (!size_report_dim.empty()) {
+        return run_size_report_mode(pdb_path, size_report_dim);
+    }
+
     if (server_mode) {
         return run_server_mode(pdb_path, server_port, auth_token);
     }
@@ -678,11 +1133,24 @@ int main(int argc, char* argv[]) {
         return 1;
     }
 
-    printf("pdbsql - Loaded: %s\n\n", pdb_path.c_str());
+    printf("pdbsql - Loaded: %s\n", pdb_path.c_str());
+    if (!diff_path.empty()) printf("Diff against: %s\n", diff_path.c_str());
+    printf("\n");
 
-    xsql::Database db;
+    // Declared before db: the registry, pdb_diff and size_by tables must outlive it
     pdbsql::TableRegistry registry(session);
+    std::unique_ptr<pdbsql::PdbDiff> diff;
+    if (!diff_path.empty()) diff = std::make_unique<pdbsql::PdbDiff>(pdb_path, diff_path, jobs);
+    pdbsql::SizeReport size_report_table(session, registry.section_contrib_cache());
+
+    xsql::Database db;
     registry.register_all(db);
+    if (diff) diff->register_table(db);
+    size_report_table.register_table(db);
+
+    if (!arrow_path.empty()) {
+        return run_arrow_export(db, registry, query, arrow_path, arrow_format);
+    }
 
     if (!query.empty()) {
         execute_query(db, query.c_str());
@@ -722,6 +1190,10 @@ int main(int argc, char* argv[]) {
 #else
         interactive_mode(db);
 #endif
+    } else if (diff) {
+        bool ok = execute_query(db, "SELECT kind, change, COUNT(*) AS symbols, SUM(size_delta) AS size_delta "
+                                    "FROM pdb_diff GROUP BY kind, change ORDER BY kind, change");
+        if (!ok || !diff->last_error().empty()) return 1;
     } else {
         dump_symbol_counts(session);
     }
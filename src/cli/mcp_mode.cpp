@@ -6,6 +6,8 @@
 #include "table_printer.hpp"
 #include "pdb_session.hpp"
 #include "pdb_tables.hpp"
+#include "slow_query_log.hpp"
+#include "statement_cache.hpp"
 #include "../common/ai_agent.hpp"
 #include "../common/mcp_server.hpp"
 
@@ -18,7 +20,7 @@
 #include <string>
 
 // Forward declaration for query_to_string used by AI agent
-static std::string execute_query_to_string(xsql::Database& db, const std::string& sql);
+static std::string execute_query_to_string(xsql::Database& db, const std::string& sql, size_t* row_count = nullptr);
 
 static std::atomic<bool> g_mcp_quit{false};
 
@@ -35,12 +37,13 @@ static int mcp_table_callback(void*, int argc, char** argv, char** colNames) {
     return 0;
 }
 
-static std::string execute_query_to_string(xsql::Database& db, const std::string& sql) {
+static std::string execute_query_to_string(xsql::Database& db, const std::string& sql, size_t* row_count) {
     TablePrinter printer;
     g_mcp_printer = &printer;
 
     int rc = db.exec(sql.c_str(), mcp_table_callback, nullptr);
     g_mcp_printer = nullptr;
+    if (row_count) *row_count = printer.rows.size();
 
     if (rc != SQLITE_OK) {
         return "Error: " + db.last_error();
@@ -95,14 +98,32 @@ int run_mcp_mode(const std::string& pdb_path, int port,
     pdbsql::TableRegistry registry(session);
     registry.register_all(db);
 
-    // SQL executor (returns JSON for MCP)
-    pdbsql::QueryCallback sql_cb = [&db](const std::string& sql) -> std::string {
-        return query_result_to_json(db, sql);
+    // SQL executors (return JSON for MCP). Callbacks run on this thread (queue mode),
+    // so the statement cache needs no locking.
+    pdbsql::StatementCache statements(db.handle());
+    pdbsql::QueryCallback sql_cb = [&db, &statements](const std::string& sql) -> std::string {
+        pdbsql::SlowQueryWatch slow("mcp", std::string(), sql);
+        size_t rows = 0;
+        std::string json = cached_query_to_json(statements, db, sql, false, &rows);
+        slow.finish(rows, json_succeeded(json));
+        return json;
+    };
+    pdbsql::ExecuteCallback execute_cb = [&statements](const std::string& sql,
+                                                       const std::vector<pdbsql::StatementParam>& params) -> std::string {
+        pdbsql::SlowQueryWatch slow("mcp", std::string(), sql);
+        size_t rows = 0;
+        std::string json = prepared_query_to_json(statements, sql, params, false, false, &rows);
+        slow.finish(rows, json_succeeded(json));
+        return json;
     };
 
     // Create AI agent for natural language queries
     auto executor = [&db](const std::string& sql) -> std::string {
-        return execute_query_to_string(db, sql);
+        pdbsql::SlowQueryWatch slow("agent", std::string(), sql);
+        size_t rows = 0;
+        std::string text = execute_query_to_string(db, sql, &rows);
+        slow.finish(rows, text.rfind("Error: ", 0) != 0);
+        return text;
     };
     pdbsql::AgentSettings settings = pdbsql::LoadAgentSettings();
     if (!provider_override.empty()) {
@@ -119,13 +140,14 @@ int run_mcp_mode(const std::string& pdb_path, int port,
 
     // Start MCP server
     pdbsql::PdbsqlMCPServer mcp_server;
+    mcp_server.set_execute_callback(execute_cb);
     int actual_port = mcp_server.start(port, sql_cb, ask_cb, "127.0.0.1", true);
     if (actual_port <= 0) {
         fprintf(stderr, "Error: Failed to start MCP server on port %d\n", port);
         return 1;
     }
 
-    printf("%s", pdbsql::format_mcp_info(actual_port, true).c_str());
+    printf("%s", pdbsql::format_mcp_info(actual_port, true, static_cast<bool>(execute_cb)).c_str());
     printf("Press Ctrl+C to stop.\n\n");
     fflush(stdout);
 
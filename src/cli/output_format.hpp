@@ -0,0 +1,219 @@
+#pragma once
+// output_format.hpp - Machine-readable query output (--format)
+//
+//   table   ASCII box table (StreamingTablePrinter, the default)
+//   csv     RFC 4180: header row, fields quoted only when needed, NULL = empty
+//   tsv     Header row; tab, newline, CR and backslash escaped as \t \n \r \\, NULL = \N
+//   ndjson  One JSON object per row ({"col":"text",...}, NULL = null); alias jsonl
+//   null    Count rows and discard them (engine speed without output cost)
+//
+// RecordWriter appends straight from sqlite3_column_text() pointers into one
+// large buffer that is written with fwrite; no per-row allocations.
+
+#include "json_text.hpp"
+
+#include <sqlite3.h>
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+enum class OutputFormat { Table, Csv, Tsv, Ndjson, Null };
+
+inline bool parse_output_format(const std::string& name, OutputFormat& format) {
+    if (name == "table") format = OutputFormat::Table;
+    else if (name == "csv") format = OutputFormat::Csv;
+    else if (name == "tsv") format = OutputFormat::Tsv;
+    else if (name == "ndjson" || name == "jsonl") format = OutputFormat::Ndjson;
+    else if (name == "null") format = OutputFormat::Null;
+    else return false;
+    return true;
+}
+
+class RecordWriter {
+public:
+    static constexpr size_t BUFFER_BYTES = 1 << 20;
+
+    explicit RecordWriter(OutputFormat format, FILE* out = stdout)
+        : format_(format), out_(out)
+    {
+        if (format_ != OutputFormat::Null) buf_.reserve(BUFFER_BYTES + 64 * 1024);
+    }
+
+    ~RecordWriter() { flush(); }
+
+    RecordWriter(const RecordWriter&) = delete;
+    RecordWriter& operator=(const RecordWriter&) = delete;
+
+    // One row after set_columns(); a null pointer is SQL NULL.
+    void add_values(int argc, char** argv) {
+        rows_++;
+        switch (format_) {
+            case OutputFormat::Csv:
+                for (int i = 0; i < argc; i++) {
+                    if (i > 0) buf_ += ',';
+                    if (argv[i]) csv_field(argv[i], strlen(argv[i]));
+                }
+                buf_ += "\r\n";
+                break;
+            case OutputFormat::Tsv:
+                for (int i = 0; i < argc; i++) {
+                    if (i > 0) buf_ += '\t';
+                    if (argv[i]) tsv_field(argv[i], strlen(argv[i]));
+                    else buf_ += "\\N";
+                }
+                buf_ += '\n';
+                break;
+            case OutputFormat::Ndjson:
+                for (int i = 0; i < argc; i++) {
+                    if (i < static_cast<int>(keys_.size())) buf_ += keys_[i];
+                    else buf_ += i == 0 ? "{\"\":" : ",\"\":";
+                    if (argv[i]) {
+                        buf_ += '"';
+                        pdbsql::append_json_escaped(buf_, argv[i], strlen(argv[i]));
+                        buf_ += '"';
+                    } else {
+                        buf_ += "null";
+                    }
+                }
+                buf_ += argc > 0 ? "}\n" : "{}\n";
+                break;
+            case OutputFormat::Table:
+            case OutputFormat::Null:
+                return;
+        }
+        if (buf_.size() >= BUFFER_BYTES) write_out();
+    }
+
+    // Header; call once before the rows (exec_records, remote and federated queries)
+    void set_columns(const std::vector<std::string>& columns) {
+        started_ = true;
+        switch (format_) {
+            case OutputFormat::Csv:
+                for (size_t i = 0; i < columns.size(); i++) {
+                    if (i > 0) buf_ += ',';
+                    csv_field(columns[i].data(), columns[i].size());
+                }
+                buf_ += "\r\n";
+                break;
+            case OutputFormat::Tsv:
+                for (size_t i = 0; i < columns.size(); i++) {
+                    if (i > 0) buf_ += '\t';
+                    tsv_field(columns[i].data(), columns[i].size());
+                }
+                buf_ += '\n';
+                break;
+            case OutputFormat::Ndjson:
+                // Pre-render `{"name":` / `,"name":` once per column
+                keys_.clear();
+                for (size_t i = 0; i < columns.size(); i++) {
+                    std::string key = i == 0 ? "{" : ",";
+                    pdbsql::append_json_string(key, columns[i]);
+                    key += ':';
+                    keys_.push_back(std::move(key));
+                }
+                break;
+            case OutputFormat::Table:
+            case OutputFormat::Null:
+                break;
+        }
+    }
+
+    void add_row(const std::vector<std::string>& values) {
+        argv_.clear();
+        for (const auto& v : values) argv_.push_back(const_cast<char*>(v.c_str()));
+        add_values(static_cast<int>(argv_.size()), argv_.data());
+    }
+
+    size_t row_count() const { return rows_; }
+    bool has_columns() const { return started_; }
+
+    void flush() {
+        write_out();
+        fflush(out_);
+    }
+
+private:
+    OutputFormat format_;
+    FILE* out_;
+    std::string buf_;
+    std::vector<std::string> keys_;  // NDJSON object keys, pre-escaped
+    std::vector<char*> argv_;        // Scratch for add_row(vector)
+    size_t rows_ = 0;
+    bool started_ = false;
+
+    void write_out() {
+        if (!buf_.empty()) {
+            fwrite(buf_.data(), 1, buf_.size(), out_);
+            buf_.clear();
+        }
+    }
+
+    void csv_field(const char* text, size_t len) {
+        if (!strpbrk(text, ",\"\r\n")) {  // text is NUL-terminated
+            buf_.append(text, len);
+            return;
+        }
+        buf_ += '"';
+        for (size_t i = 0; i < len; i++) {
+            if (text[i] == '"') buf_ += '"';
+            buf_ += text[i];
+        }
+        buf_ += '"';
+    }
+
+    void tsv_field(const char* text, size_t len) {
+        size_t start = 0;
+        for (size_t i = 0; i < len; i++) {
+            const char* esc = nullptr;
+            switch (text[i]) {
+                case '\t': esc = "\\t"; break;
+                case '\n': esc = "\\n"; break;
+                case '\r': esc = "\\r"; break;
+                case '\\': esc = "\\\\"; break;
+                default: continue;
+            }
+            buf_.append(text + start, i - start);
+            buf_ += esc;
+            start = i + 1;
+        }
+        buf_.append(text + start, len - start);
+    }
+};
+
+// Run every statement in sql into writer, as sqlite3_exec would. The header
+// comes from the first statement that has result columns, so a query that
+// returns no rows still writes it. Returns the SQLite rc (message in
+// sqlite3_errmsg).
+inline int exec_records(sqlite3* db, const char* sql, RecordWriter& writer) {
+    std::vector<std::string> names;
+    std::vector<char*> values;
+    const char* tail = sql;
+    while (tail && *tail) {
+        sqlite3_stmt* stmt = nullptr;
+        int rc = sqlite3_prepare_v2(db, tail, -1, &stmt, &tail);
+        if (rc != SQLITE_OK) return rc;
+        if (!stmt) continue;  // Trailing whitespace or comment
+
+        const int columns = sqlite3_column_count(stmt);
+        if (columns > 0 && !writer.has_columns()) {
+            names.clear();
+            for (int i = 0; i < columns; i++) {
+                const char* name = sqlite3_column_name(stmt, i);
+                names.push_back(name ? name : "");
+            }
+            writer.set_columns(names);
+        }
+        values.resize(static_cast<size_t>(columns));
+        while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+            for (int i = 0; i < columns; i++) {
+                values[i] = const_cast<char*>(reinterpret_cast<const char*>(sqlite3_column_text(stmt, i)));
+            }
+            writer.add_values(columns, values.data());
+        }
+        sqlite3_finalize(stmt);
+        if (rc != SQLITE_DONE) return rc;
+    }
+    return SQLITE_OK;
+}
@@ -1,63 +1,320 @@
 #pragma once
 
 #include <xsql/database.hpp>
-#include <string>
-#include <sstream>
+#include "json_text.hpp"
+#include "query_profile.hpp"
+#include "statement_cache.hpp"
+#include "trace.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
 #include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <vector>
 
 inline std::string json_escape(const std::string& s) {
     std::string out;
     out.reserve(s.size() + 10);
-    for (char ch : s) {
-        switch (ch) {
-            case '"': out += "\\\""; break;
-            case '\\': out += "\\\\"; break;
-            case '\n': out += "\\n"; break;
-            case '\r': out += "\\r"; break;
-            case '\t': out += "\\t"; break;
-            default:
-                if (static_cast<unsigned char>(ch) < 0x20) {
-                    char buf[8];
-                    snprintf(buf, sizeof(buf), "\\u%04x", static_cast<unsigned char>(ch));
-                    out += buf;
-                } else {
-                    out += ch;
+    pdbsql::append_json_escaped(out, s);
+    return out;
+}
+
+inline std::string error_to_json(const std::string& error) {
+    return "{\"success\":false,\"error\":\"" + json_escape(error) + "\"}";
+}
+
+// Result values are typed from sqlite3_column_type: INTEGER and REAL are JSON
+// numbers, NULL is null, TEXT a string and BLOB a hex string. With hex_rva,
+// integer columns named rva or *_rva are written as "0x..." strings.
+struct JsonResultOptions {
+    bool hex_rva = false;
+};
+
+// Appends one statement's column list and rows to `out`, straight from
+// sqlite3_column_* (no intermediate strings or streams).
+class JsonRowWriter {
+public:
+    JsonRowWriter(sqlite3_stmt* stmt, std::string& out, const JsonResultOptions& options = {})
+        : stmt_(stmt), out_(out), ncols_(sqlite3_column_count(stmt))
+    {
+        if (!options.hex_rva) return;
+        hex_.resize(ncols_);
+        for (int c = 0; c < ncols_; c++) {
+            const char* name = sqlite3_column_name(stmt, c);
+            size_t len = name ? strlen(name) : 0;
+            hex_[c] = len >= 3 && strcmp(name + len - 3, "rva") == 0 && (len == 3 || name[len - 4] == '_');
+        }
+    }
+
+    int column_count() const { return ncols_; }
+
+    // ["name",...]
+    void columns() {
+        out_ += '[';
+        for (int c = 0; c < ncols_; c++) {
+            if (c > 0) out_ += ',';
+            const char* name = sqlite3_column_name(stmt_, c);
+            out_ += '"';
+            if (name) pdbsql::append_json_escaped(out_, name, strlen(name));
+            out_ += '"';
+        }
+        out_ += ']';
+    }
+
+    // [v,...] for the row the statement is on
+    void row() {
+        char buf[32];
+        out_ += '[';
+        for (int c = 0; c < ncols_; c++) {
+            if (c > 0) out_ += ',';
+            switch (sqlite3_column_type(stmt_, c)) {
+                case SQLITE_INTEGER: {
+                    const sqlite3_int64 v = sqlite3_column_int64(stmt_, c);
+                    if (!hex_.empty() && hex_[c]) {
+                        snprintf(buf, sizeof(buf), "\"0x%llx\"", static_cast<unsigned long long>(v));
+                        out_ += buf;
+                    } else {
+                        out_.append(buf, std::to_chars(buf, buf + sizeof(buf), v).ptr - buf);
+                    }
+                    break;
+                }
+                case SQLITE_FLOAT: {
+                    const double v = sqlite3_column_double(stmt_, c);
+                    if (std::isfinite(v)) out_.append(buf, std::to_chars(buf, buf + sizeof(buf), v).ptr - buf);
+                    else out_ += "null";  // JSON has no NaN/Inf
+                    break;
                 }
+                case SQLITE_NULL:
+                    out_ += "null";
+                    break;
+                case SQLITE_BLOB: {
+                    static const char digits[] = "0123456789abcdef";
+                    const unsigned char* p = static_cast<const unsigned char*>(sqlite3_column_blob(stmt_, c));
+                    const int n = sqlite3_column_bytes(stmt_, c);
+                    out_ += '"';
+                    for (int i = 0; i < n; i++) {
+                        out_ += digits[p[i] >> 4];
+                        out_ += digits[p[i] & 0xF];
+                    }
+                    out_ += '"';
+                    break;
+                }
+                default: {
+                    const unsigned char* text = sqlite3_column_text(stmt_, c);
+                    out_ += '"';
+                    if (text) {
+                        pdbsql::append_json_escaped(out_, reinterpret_cast<const char*>(text),
+                                                    static_cast<size_t>(sqlite3_column_bytes(stmt_, c)));
+                    }
+                    out_ += '"';
+                    break;
+                }
+            }
         }
+        out_ += ']';
     }
-    return out;
+
+private:
+    sqlite3_stmt* stmt_;
+    std::string& out_;
+    int ncols_;
+    std::vector<bool> hex_;
+};
+
+// Capacity to reserve for the next response on this thread. It follows the
+// recent response size (and halves back after a large one), so the buffer is
+// allocated once instead of regrowing while rows are appended.
+inline size_t& json_capacity_hint() {
+    thread_local size_t hint = 4096;
+    return hint;
 }
 
-inline std::string query_result_to_json(xsql::Database& db, const std::string& sql) {
-    auto result = db.query(sql);
-    std::ostringstream json;
-    json << "{";
-    json << "\"success\":" << (result.ok() ? "true" : "false");
-
-    if (result.ok()) {
-        json << ",\"columns\":[";
-        for (size_t i = 0; i < result.columns.size(); i++) {
-            if (i > 0) json << ",";
-            json << "\"" << json_escape(result.columns[i]) << "\"";
+inline void reserve_json(std::string& json) {
+    json.reserve(json_capacity_hint());
+}
+
+inline void remember_json_size(size_t size) {
+    size_t& hint = json_capacity_hint();
+    hint = (std::max)((std::max)(size + size / 8, hint / 2), static_cast<size_t>(4096));
+}
+
+// Run a SQL script (one or more statements). Rows of every statement are
+// returned under the columns of the first statement that has any, as
+// sqlite3_exec would report them.
+inline std::string query_result_to_json(xsql::Database& db, const std::string& sql,
+                                        size_t* row_count = nullptr,
+                                        const JsonResultOptions& options = {}) {
+    pdbsql::TraceSpan span("sql.step+serialize.json", "sql");
+    span.arg("sql", sql);
+
+    std::string columns;
+    std::string rows;
+    reserve_json(rows);
+    size_t count = 0;
+    const char* next = sql.c_str();
+    while (next && *next) {
+        sqlite3_stmt* stmt = nullptr;
+        if (sqlite3_prepare_v2(db.handle(), next, -1, &stmt, &next) != SQLITE_OK) {
+            return error_to_json(sqlite3_errmsg(db.handle()));
         }
-        json << "]";
-
-        json << ",\"rows\":[";
-        for (size_t i = 0; i < result.rows.size(); i++) {
-            if (i > 0) json << ",";
-            json << "[";
-            for (size_t c = 0; c < result.rows[i].size(); c++) {
-                if (c > 0) json << ",";
-                json << "\"" << json_escape(result.rows[i][c]) << "\"";
-            }
-            json << "]";
+        if (!stmt) continue;  // Whitespace or comment
+        JsonRowWriter writer(stmt, rows, options);
+        if (columns.empty() && writer.column_count() > 0) {
+            JsonRowWriter(stmt, columns, options).columns();
+        }
+        int rc;
+        while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+            if (count > 0) rows += ',';
+            writer.row();
+            count++;
         }
-        json << "]";
-        json << ",\"row_count\":" << result.rows.size();
-    } else {
-        json << ",\"error\":\"" << json_escape(result.error) << "\"";
+        sqlite3_finalize(stmt);
+        if (rc != SQLITE_DONE) return error_to_json(sqlite3_errmsg(db.handle()));
+    }
+
+    std::string json;
+    json.reserve(rows.size() + columns.size() + 64);
+    json += "{\"success\":true,\"columns\":";
+    json += columns.empty() ? "[]" : columns;
+    json += ",\"rows\":[";
+    json += rows;
+    json += "],\"row_count\":" + std::to_string(count) + "}";
+    remember_json_size(json.size());
+    span.arg("rows", count);
+    if (row_count) *row_count = count;
+    return json;
+}
+
+// Step a prepared statement to completion and serialize it like query_result_to_json.
+// Rows are serialized as they are stepped, so the trace span covers both.
+inline std::string statement_to_json(sqlite3_stmt* stmt, size_t* row_count_out = nullptr,
+                                     const JsonResultOptions& options = {}) {
+    pdbsql::TraceSpan span("sql.step+serialize.json", "sql");
+    if (span.active()) span.arg("sql", sqlite3_sql(stmt));
+
+    std::string json;
+    reserve_json(json);
+    json += "{\"success\":true,\"columns\":";
+    JsonRowWriter writer(stmt, json, options);
+    writer.columns();
+    json += ",\"rows\":[";
+
+    size_t row_count = 0;
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        if (row_count > 0) json += ',';
+        writer.row();
+        row_count++;
     }
+    if (rc != SQLITE_DONE) return error_to_json(sqlite3_errmsg(sqlite3_db_handle(stmt)));
 
-    json << "}";
+    json += "],\"row_count\":" + std::to_string(row_count) + "}";
+    remember_json_size(json.size());
+    span.arg("rows", row_count);
+    if (row_count_out) *row_count_out = row_count;
+    return json;
+}
+
+inline std::string profile_to_json(const pdbsql::QueryProfile& profile) {
+    std::ostringstream json;
+    char ms[32];
+    snprintf(ms, sizeof(ms), "%.3f", profile.seconds * 1000.0);
+    json << "{\"ms\":" << ms
+         << ",\"rows_returned\":" << profile.rows_returned
+         << ",\"rows_emitted\":" << profile.rows_emitted()
+         << ",\"rows_discarded\":" << profile.rows_discarded()
+         << ",\"tables\":[";
+    bool first = true;
+    for (const pdbsql::TableProfile* t : profile.tables()) {
+        if (!first) json << ",";
+        first = false;
+        snprintf(ms, sizeof(ms), "%.3f", static_cast<double>(t->generator_ns) / 1e6);
+        json << "{\"table\":\"" << json_escape(t->table) << "\""
+             << ",\"cursors\":" << t->cursors
+             << ",\"plans\":{";
+        bool first_plan = true;
+        for (const auto& [label, count] : t->plans) {
+            if (!first_plan) json << ",";
+            first_plan = false;
+            json << "\"" << json_escape(label) << "\":" << count;
+        }
+        json << "},\"rows\":" << t->rows
+             << ",\"next_calls\":" << t->next_calls
+             << ",\"generator_ms\":" << ms << "}";
+    }
+    json << "],\"plan\":[";
+    for (size_t i = 0; i < profile.plan.size(); i++) {
+        if (i > 0) json << ",";
+        json << "\"" << json_escape(profile.plan[i]) << "\"";
+    }
+    json << "]}";
     return json.str();
 }
+
+// Run `run(row_count)` (returning a result object) under a profile and add
+// a "profile" member with per-table stats and the query plan.
+template<typename F>
+inline std::string profiled_to_json(sqlite3* db, const std::string& sql, F&& run) {
+    pdbsql::QueryProfile profile;
+    size_t rows = 0;
+    std::string json;
+    {
+        pdbsql::QueryProfile::Scope scope(profile);
+        json = run(rows);
+    }
+    profile.rows_returned = rows;
+    profile.explain(db, sql);
+    if (!json.empty() && json.back() == '}') {
+        json.pop_back();
+        json += ",\"profile\":" + profile_to_json(profile) + "}";
+    }
+    return json;
+}
+
+// Bind params and run a cached statement (by SQL text, or by registered name).
+inline std::string prepared_query_to_json(pdbsql::StatementCache& cache,
+                                          const std::string& sql,
+                                          const std::vector<pdbsql::StatementParam>& params,
+                                          bool by_name = false,
+                                          bool profile = false,
+                                          size_t* row_count = nullptr,
+                                          const JsonResultOptions& options = {}) {
+    std::string error;
+    auto stmt = by_name ? cache.acquire_named(sql, error) : cache.acquire(sql, error);
+    if (!stmt) return error_to_json(error);
+    if (!pdbsql::bind_statement_params(stmt.get(), params, error)) return error_to_json(error);
+    if (!profile) return statement_to_json(stmt.get(), row_count, options);
+    return profiled_to_json(sqlite3_db_handle(stmt.get()), sqlite3_sql(stmt.get()), [&](size_t& rows) {
+        std::string json = statement_to_json(stmt.get(), &rows, options);
+        if (row_count) *row_count = rows;
+        return json;
+    });
+}
+
+// Plain SQL through the statement cache; multi-statement scripts run uncached.
+inline std::string cached_query_to_json(pdbsql::StatementCache& cache,
+                                        xsql::Database& db,
+                                        const std::string& sql,
+                                        bool profile = false,
+                                        size_t* row_count = nullptr,
+                                        const JsonResultOptions& options = {}) {
+    std::string error;
+    auto stmt = cache.acquire(sql, error);
+    if (!profile) {
+        return stmt ? statement_to_json(stmt.get(), row_count, options)
+                    : query_result_to_json(db, sql, row_count, options);
+    }
+    return profiled_to_json(db.handle(), sql, [&](size_t& rows) {
+        std::string json = stmt ? statement_to_json(stmt.get(), &rows, options)
+                                : query_result_to_json(db, sql, &rows, options);
+        if (row_count) *row_count = rows;
+        return json;
+    });
+}
+
+// True if a *_to_json result reports success.
+inline bool json_succeeded(const std::string& json) {
+    return json.compare(0, 15, "{\"success\":true") == 0;
+}
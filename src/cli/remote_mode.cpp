@@ -3,10 +3,21 @@
 
 #include <xsql/socket/client.hpp>
 
+#include <cstdio>
 #include <iostream>
 #include <string>
 
-void print_remote_result(const xsql::socket::RemoteResult& qr) {
+void print_remote_result(const xsql::socket::RemoteResult& qr, OutputFormat format) {
+    if (format != OutputFormat::Table) {
+        RecordWriter writer(format);
+        writer.set_columns(qr.columns);
+        for (const auto& row : qr.rows) {
+            writer.add_row(row.values);
+        }
+        writer.flush();
+        if (format == OutputFormat::Null) fprintf(stderr, "%zu row(s)\n", writer.row_count());
+        return;
+    }
     if (qr.rows.empty() && qr.columns.empty()) {
         std::cout << "OK\n";
         return;
@@ -34,7 +45,7 @@ bool parse_port(const std::string& s, int& port) {
 
 int run_remote_mode(const std::string& host, int port,
                     const std::string& query, const std::string& auth_token,
-                    bool interactive) {
+                    bool interactive, OutputFormat format) {
     std::cerr << "Connecting to " << host << ":" << port << "..." << std::endl;
     xsql::socket::Client client;
     if (!auth_token.empty()) {
@@ -52,7 +63,7 @@ int run_remote_mode(const std::string& host, int port,
         // Single query
         auto qr = client.query(query);
         if (qr.success) {
-            print_remote_result(qr);
+            print_remote_result(qr, format);
         } else {
             std::cerr << "Error: " << qr.error << "\n";
             result = 1;
@@ -103,7 +114,7 @@ SQL queries end with semicolon (;)
             if (line[last] == ';') {
                 auto qr = client.query(stmt);
                 if (qr.success) {
-                    print_remote_result(qr);
+                    print_remote_result(qr, format);
                 } else {
                     std::cerr << "Error: " << qr.error << "\n";
                 }
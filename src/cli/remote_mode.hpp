@@ -1,12 +1,14 @@
 #pragma once
 
+#include "output_format.hpp"
+
 #include <xsql/socket/client.hpp>
 #include <string>
 
-void print_remote_result(const xsql::socket::RemoteResult& qr);
+void print_remote_result(const xsql::socket::RemoteResult& qr, OutputFormat format = OutputFormat::Table);
 
 bool parse_port(const std::string& s, int& port);
 
 int run_remote_mode(const std::string& host, int port,
                     const std::string& query, const std::string& auth_token,
-                    bool interactive);
+                    bool interactive, OutputFormat format = OutputFormat::Table);
@@ -4,7 +4,11 @@
 #include <vector>
 #include <iostream>
 #include <algorithm>
+#include <cstdio>
+#include <cstring>
 
+// Buffers the whole result to size columns exactly. Used for small results
+// and for callers that need the rows (agent output, profile reports).
 struct TablePrinter {
     std::vector<std::string> columns;
     std::vector<std::vector<std::string>> rows;
@@ -77,3 +81,142 @@ struct TablePrinter {
         std::cout << rows.size() << " row(s)\n";
     }
 };
+
+// Prints rows as they arrive, in bounded memory. Column widths come from the
+// first `sample_rows` rows (0 = buffer everything: exact widths, same output
+// as TablePrinter). Results that fit in the sample print exactly as well.
+// A wider value later widens its column and re-emits the header.
+class StreamingTablePrinter {
+public:
+    static constexpr size_t DEFAULT_SAMPLE_ROWS = 256;
+
+    explicit StreamingTablePrinter(size_t sample_rows = DEFAULT_SAMPLE_ROWS, FILE* out = stdout)
+        : sample_rows_(sample_rows), out_(out) {}
+
+    ~StreamingTablePrinter() { flush(); }
+
+    StreamingTablePrinter(const StreamingTablePrinter&) = delete;
+    StreamingTablePrinter& operator=(const StreamingTablePrinter&) = delete;
+
+    void add_row(int argc, char** argv, char** colNames) {
+        if (columns_.empty()) {
+            columns_.reserve(argc);
+            widths_.resize(argc, 0);
+            for (int i = 0; i < argc; i++) {
+                columns_.push_back(colNames[i] ? colNames[i] : "");
+                widths_[i] = columns_[i].length();
+            }
+        }
+        rows_++;
+
+        if (!streaming_) {
+            std::vector<std::string> row;
+            row.reserve(argc);
+            for (int i = 0; i < argc; i++) {
+                row.push_back(argv[i] ? argv[i] : "NULL");
+                widths_[i] = (std::max)(widths_[i], row.back().length());
+            }
+            pending_.push_back(std::move(row));
+            if (sample_rows_ > 0 && pending_.size() >= sample_rows_) start_streaming();
+            return;
+        }
+
+        // Streaming: no per-row allocations; widen (with headroom) on overflow
+        bool widened = false;
+        for (int i = 0; i < argc && i < static_cast<int>(widths_.size()); i++) {
+            size_t len = argv[i] ? strlen(argv[i]) : 4;
+            if (len > widths_[i]) {
+                widths_[i] = (std::max)(len, widths_[i] + (std::max<size_t>)(widths_[i] / 4, 4));
+                widened = true;
+            }
+        }
+        if (widened) write_header();
+        write_row(argc, argv);
+    }
+
+    // Print whatever is still buffered, the closing separator and the row count.
+    void finish() {
+        if (finished_ || columns_.empty()) return;
+        finished_ = true;
+        if (!streaming_) start_streaming();
+        write_separator();
+        buf_ += std::to_string(rows_) + " row(s)\n";
+        flush();
+    }
+
+    size_t row_count() const { return rows_; }
+
+    void flush() {
+        if (!buf_.empty()) {
+            fwrite(buf_.data(), 1, buf_.size(), out_);
+            buf_.clear();
+        }
+        fflush(out_);
+    }
+
+private:
+    static constexpr size_t FLUSH_BYTES = 64 * 1024;
+
+    size_t sample_rows_;
+    FILE* out_;
+    std::vector<std::string> columns_;
+    std::vector<size_t> widths_;
+    std::vector<std::vector<std::string>> pending_;  // Sampled rows, printed once widths are fixed
+    size_t rows_ = 0;
+    bool streaming_ = false;
+    bool finished_ = false;
+    std::string buf_;
+
+    void start_streaming() {
+        streaming_ = true;
+        write_header();
+        for (const auto& row : pending_) {
+            buf_ += "| ";
+            for (size_t i = 0; i < row.size(); i++) cell(row[i].data(), row[i].size(), widths_[i]);
+            buf_ += '\n';
+            maybe_flush();
+        }
+        std::vector<std::vector<std::string>>().swap(pending_);
+    }
+
+    void write_separator() {
+        buf_ += '+';
+        for (size_t w : widths_) {
+            buf_.append(w + 2, '-');
+            buf_ += '+';
+        }
+        buf_ += '\n';
+    }
+
+    void write_header() {
+        write_separator();
+        buf_ += "| ";
+        for (size_t i = 0; i < columns_.size(); i++) cell(columns_[i].data(), columns_[i].size(), widths_[i]);
+        buf_ += '\n';
+        write_separator();
+    }
+
+    void write_row(int argc, char** argv) {
+        buf_ += "| ";
+        for (int i = 0; i < argc; i++) {
+            const char* v = argv[i] ? argv[i] : "NULL";
+            cell(v, strlen(v), i < static_cast<int>(widths_.size()) ? widths_[i] : 0);
+        }
+        buf_ += '\n';
+        maybe_flush();
+    }
+
+    // Left-aligned value padded to width, then " | "
+    void cell(const char* text, size_t len, size_t width) {
+        buf_.append(text, len);
+        if (len < width) buf_.append(width - len, ' ');
+        buf_ += " | ";
+    }
+
+    void maybe_flush() {
+        if (buf_.size() >= FLUSH_BYTES) {
+            fwrite(buf_.data(), 1, buf_.size(), out_);
+            buf_.clear();
+        }
+    }
+};
@@ -4,6 +4,7 @@
 
 // Embedded documentation from prompts/pdbsql_agent.md
 #include "pdbsql_agent_prompt.hpp"
+#include "trace.hpp"
 
 #include <algorithm>
 #include <cctype>
@@ -173,9 +174,14 @@ void AIAgent::setup_tools() {
     pdbsql_tool.name = "pdbsql";
     pdbsql_tool.description =
         "Execute a SQL query against a PDB (Program Database) file. "
-        "Available tables: functions, publics, data, udts, enums, typedefs, thunks, labels, "
-        "compilands, source_files, line_numbers, sections, udt_members, enum_values, "
+        "Available tables: functions, publics, data, udts, enums, typedefs, thunks, labels, symbol_search, "
+        "compilands, source_files, line_numbers, inline_sites, sections, section_contributions, frame_data, udt_members, udt_layout, type_duplicates, enum_values, "
         "base_classes, locals, parameters. "
+        "inlinees_at(rva) returns the inline call chain at an address, "
+        "contrib_at(rva) the compiland_id that contributed it, "
+        "undecorate(name[, flags]) demangles an MSVC decorated name. "
+        "To find a symbol whose exact name is unknown, use one ranked query instead of LIKE guesses: "
+        "SELECT kind, id, name FROM symbol_search WHERE query = 'file size' LIMIT 10. "
         "Example: SELECT name, rva, length FROM functions WHERE name LIKE '%main%' ORDER BY length DESC LIMIT 10";
 
     pdbsql_tool.parameters_schema = R"({
@@ -201,7 +207,10 @@ void AIAgent::setup_tools() {
             }
 
             // This runs on the main thread (query_hosted guarantees this)
+            TraceSpan span("agent.tool", "agent");
+            span.arg("sql", sql);
             std::string result = executor_(sql);
+            span.arg("bytes", result.size());
 
             if (verbose_) {
                 std::cerr << "[TOOL] Result: " << result.size() << " bytes" << std::endl;
@@ -226,6 +235,7 @@ void AIAgent::setup_tools() {
 // ============================================================================
 
 std::string AIAgent::query(const std::string& prompt) {
+    TraceSpan span("agent.query", "agent");
     // SQL passthrough - execute directly
     if (looks_like_sql(prompt)) {
         return executor_(prompt);
@@ -251,6 +261,7 @@ std::string AIAgent::query(const std::string& prompt) {
 }
 
 std::string AIAgent::query_streaming(const std::string& prompt, ContentCallback on_content) {
+    TraceSpan span("agent.query", "agent");
     // SQL passthrough
     if (looks_like_sql(prompt)) {
         std::string result = executor_(prompt);
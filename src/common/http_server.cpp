@@ -25,11 +25,17 @@ Tables:
   typedefs        - Type definitions
   thunks          - Thunk symbols
   labels          - Labels
+  symbol_search   - Ranked fuzzy name search; query = '...' is required
   compilands      - Compilation units
   source_files    - Source file paths
   line_numbers    - Line number mappings
+  inline_sites    - Inlined calls and their address ranges
   sections        - PE sections
+  section_contributions - Per-compiland byte ranges of each section
+  frame_data      - Stack frame (FPO) records; probe_rva = ? finds the covering one
   udt_members     - UDT member fields
+  udt_layout      - UDT layout: padding, holes, bitfields, cache lines
+  type_duplicates - UDTs defined more than once, by structural hash
   enum_values     - Enumeration values
   base_classes    - Class inheritance
   locals          - Local variables
@@ -26,7 +26,8 @@ PdbsqlMCPServer::~PdbsqlMCPServer() {
     stop();
 }
 
-MCPQueueResult PdbsqlMCPServer::queue_and_wait(MCPPendingCommand::Type type, const std::string& input) {
+MCPQueueResult PdbsqlMCPServer::queue_and_wait(MCPPendingCommand::Type type, const std::string& input,
+                                               std::vector<StatementParam> params) {
     if (!running_.load()) {
         return {false, "Error: MCP server is not running"};
     }
@@ -34,6 +35,7 @@ MCPQueueResult PdbsqlMCPServer::queue_and_wait(MCPPendingCommand::Type type, con
     MCPPendingCommand cmd;
     cmd.type = type;
     cmd.input = input;
+    cmd.params = std::move(params);
     cmd.completed = false;
 
     std::mutex done_mutex;
@@ -145,6 +147,68 @@ int PdbsqlMCPServer::start(int port, QueryCallback query_cb, AskCallback ask_cb,
     sql_query_tool.set_description("Execute a SQL query against the PDB debug symbols database and return results");
     impl_->tool_manager.register_tool(sql_query_tool);
 
+    // Register pdbsql_execute tool - SQL with bound parameters (if execute_cb provided)
+    if (execute_cb_) {
+        Json execute_input_schema = {
+            {"type", "object"},
+            {"properties", {
+                {"query", {
+                    {"type", "string"},
+                    {"description", "Single SQL statement with ? or :name placeholders (e.g. 'SELECT * FROM functions WHERE id = ?')"}
+                }},
+                {"params", {
+                    {"type", Json::array({"array", "object"})},
+                    {"description", "Values to bind: an array for positional placeholders or an object for named ones"}
+                }}
+            }},
+            {"required", Json::array({"query"})}
+        };
+
+        fastmcpp::tools::Tool execute_tool{
+            "pdbsql_execute",
+            execute_input_schema,
+            query_output_schema,
+            [this](const Json& args) -> Json {
+                std::string query = args.value("query", "");
+                std::vector<StatementParam> params;
+                std::string error;
+                if (query.empty()) {
+                    error = "Error: missing query";
+                } else if (args.contains("params") && !params_from_json(args["params"], params, error)) {
+                    error = "Error: " + error;
+                }
+                if (!error.empty()) {
+                    return Json{
+                        {"content", Json::array({
+                            Json{{"type", "text"}, {"text", error}}
+                        })},
+                        {"isError", true}
+                    };
+                }
+
+                std::string result;
+                bool success = true;
+
+                if (use_queue_.load()) {
+                    auto qr = queue_and_wait(MCPPendingCommand::Type::Execute, query, std::move(params));
+                    result = qr.payload;
+                    success = qr.success;
+                } else {
+                    result = execute_cb_(query, params);
+                }
+
+                return Json{
+                    {"content", Json::array({
+                        Json{{"type", "text"}, {"text", result}}
+                    })},
+                    {"isError", !success}
+                };
+            }
+        };
+        execute_tool.set_description("Execute a parameterized SQL statement (prepared and cached) against the PDB debug symbols database");
+        impl_->tool_manager.register_tool(execute_tool);
+    }
+
     // Register pdbsql_agent tool - natural language query (if ask_cb provided)
     if (ask_cb_) {
         Json ask_input_schema = {
@@ -208,6 +272,9 @@ int PdbsqlMCPServer::start(int port, QueryCallback query_cb, AskCallback ask_cb,
     std::unordered_map<std::string, std::string> descriptions = {
         {"pdbsql_query", "Execute a SQL query against the PDB debug symbols database and return results"}
     };
+    if (execute_cb_) {
+        descriptions["pdbsql_execute"] = "Execute a parameterized SQL statement (prepared and cached) against the PDB debug symbols database";
+    }
     if (ask_cb_) {
         descriptions["pdbsql_agent"] = "Ask a natural language question about the PDB debug symbols - AI translates to SQL and returns results";
     }
@@ -267,6 +334,8 @@ void PdbsqlMCPServer::run_until_stopped() {
             try {
                 if (cmd->type == MCPPendingCommand::Type::Query && query_cb_) {
                     cmd->result = query_cb_(cmd->input);
+                } else if (cmd->type == MCPPendingCommand::Type::Execute && execute_cb_) {
+                    cmd->result = execute_cb_(cmd->input, cmd->params);
                 } else if (cmd->type == MCPPendingCommand::Type::Ask && ask_cb_) {
                     cmd->result = ask_cb_(cmd->input);
                 } else {
@@ -330,15 +399,18 @@ std::string PdbsqlMCPServer::url() const {
     return ss.str();
 }
 
-std::string format_mcp_info(int port, bool has_agent) {
+std::string format_mcp_info(int port, bool has_agent, bool has_execute) {
     std::ostringstream ss;
     ss << "MCP server started on port " << port << "\n";
     ss << "SSE endpoint: http://127.0.0.1:" << port << "/sse\n\n";
 
     ss << "Available tools:\n";
-    ss << "  pdbsql_query  - Execute SQL query directly\n";
+    ss << "  pdbsql_query   - Execute SQL query directly\n";
+    if (has_execute) {
+        ss << "  pdbsql_execute - Execute SQL with bound parameters\n";
+    }
     if (has_agent) {
-        ss << "  pdbsql_agent  - Ask natural language question (AI-powered)\n";
+        ss << "  pdbsql_agent   - Ask natural language question (AI-powered)\n";
     }
     ss << "\n";
 
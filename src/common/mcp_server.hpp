@@ -18,20 +18,27 @@
 #include <condition_variable>
 #include <queue>
 #include <memory>
+#include <vector>
+
+#include "statement_cache.hpp"  // StatementParam
 
 namespace pdbsql {
 
 // Callbacks for handling requests
 // QueryCallback: Direct SQL execution
 // AskCallback: Natural language query (requires AI agent)
+// ExecuteCallback: SQL with bound parameters (prepared statement)
 using QueryCallback = std::function<std::string(const std::string& sql)>;
 using AskCallback = std::function<std::string(const std::string& question)>;
+using ExecuteCallback = std::function<std::string(const std::string& sql,
+                                                  const std::vector<StatementParam>& params)>;
 
 // Internal command structure for cross-thread execution
 struct MCPPendingCommand {
-    enum class Type { Query, Ask };
+    enum class Type { Query, Ask, Execute };
     Type type;
     std::string input;
+    std::vector<StatementParam> params;  // Execute only
     std::string result;
     bool completed = false;
     std::mutex* done_mutex = nullptr;
@@ -66,6 +73,12 @@ public:
     int start(int port, QueryCallback query_cb, AskCallback ask_cb = nullptr,
               const std::string& bind_addr = "127.0.0.1", bool use_queue = false);
 
+    /**
+     * Enable the pdbsql_execute tool (SQL + bound parameters)
+     * Must be called before start()
+     */
+    void set_execute_callback(ExecuteCallback execute_cb) { execute_cb_ = std::move(execute_cb); }
+
     /**
      * Block until server stops, processing commands on the calling thread
      * Only needed when use_queue=true (CLI mode)
@@ -102,7 +115,8 @@ public:
      * Queue a command for execution on the main thread
      * Called by MCP tool handlers when use_queue=true
      */
-    MCPQueueResult queue_and_wait(MCPPendingCommand::Type type, const std::string& input);
+    MCPQueueResult queue_and_wait(MCPPendingCommand::Type type, const std::string& input,
+                                  std::vector<StatementParam> params = {});
 
 private:
     std::function<bool()> interrupt_check_;
@@ -119,6 +133,7 @@ private:
     // Callbacks stored for execution
     QueryCallback query_cb_;
     AskCallback ask_cb_;
+    ExecuteCallback execute_cb_;
 
     // Forward declaration - impl hides fastmcpp
     class Impl;
@@ -130,7 +145,7 @@ private:
 /**
  * Format MCP server info for display
  */
-std::string format_mcp_info(int port, bool has_agent);
+std::string format_mcp_info(int port, bool has_agent, bool has_execute);
 
 /**
  * Format MCP server status
@@ -1,5 +1,5 @@
 // Auto-generated from pdbsql_agent.md
-// Generated: 2026-01-28T09:14:19.220407
+// Generated: 2026-10-16T14:08:35.253815
 // DO NOT EDIT - regenerate with: python scripts/embed_prompt.py
 
 #pragma once
@@ -61,6 +61,7 @@ Functions are code symbols with:
 PDB files map source code to addresses:
 - `source_files` - Original source file paths
 - `line_numbers` - Line number to RVA mapping
+- `inline_sites` - Code inlined into each function, with its address ranges
 
 ---
 
@@ -109,6 +110,19 @@ Public symbols (exports, etc.).
 SELECT name FROM publics ORDER BY name;
 ```
 
+The scalar function `undecorate(name[, flags])` undecorates an MSVC mangled
+name (`?...` C++ names and `_name@N` / `@name@N` C names) without DIA.
+`flags` takes the UNDNAME_* values: 0x1000 = qualified name only,
+0x2 = no `__cdecl`/`__ptr64`, 0x4 = no return type, 0x80 = no `public:`.
+Names that are not decorated come back unchanged.
+
+```sql
+-- Group overloads by their plain qualified name
+SELECT undecorate(name, 0x1000) as qname, COUNT(*) as overloads
+FROM publics WHERE name LIKE '?%'
+GROUP BY qname HAVING overloads > 1 ORDER BY overloads DESC;
+```
+
 #### data
 Global and static data symbols.
 
@@ -192,6 +206,37 @@ Code labels (not functions).
 | `section` | INT | PE section number |
 | `offset` | INT | Section offset |
 
+#### symbol_search
+Ranked fuzzy search over the names and undecorated names of functions,
+publics, udts, data and enums. Requires `WHERE query = '...'`; rows come back
+best first (at most 100), so `LIMIT n` keeps the top n. Matches whole names,
+prefixes, substrings, words split at camelCase / `_` / `::` boundaries, and
+initials (`gfs` finds `GetFileSize`). The index is built on the first query.
+
+| Column | Type | Description |
+|--------|------|-------------|
+| `query` | TEXT | The search text (required filter) |
+| `rank` | INT | 1 = best match |
+| `score` | INT | Match score (higher is better) |
+| `kind` | TEXT | `function`, `public`, `udt`, `data` or `enum` |
+| `id` | INT | Symbol ID (join the table named by `kind`) |
+| `name` | TEXT | Symbol name |
+| `undecorated` | TEXT | Undecorated name |
+
+**Use this first when you do not know a symbol's exact name** - one query
+replaces a series of `LIKE` guesses.
+
+```sql
+-- Best matches for a half-remembered name
+SELECT rank, kind, id, name FROM symbol_search WHERE query = 'file size' LIMIT 10;
+
+-- Only functions, with their address
+SELECT s.name, printf('0x%X', f.rva) as rva, f.length
+FROM symbol_search s JOIN functions f ON f.id = s.id
+WHERE s.query = 'CreateWnd' AND s.kind = 'function'
+LIMIT 5;
+```
+
 ### Type Detail Tables
 
 #### udt_members
@@ -218,6 +263,64 @@ ORDER BY offset;
 SELECT parent_name, name FROM udt_members WHERE type_name LIKE '%*%';
 ```
 
+#### udt_layout
+Memory layout of each struct/class/union (pahole-style), computed once per session.
+Includes instance members, bitfields, non-virtual base classes and the vfptr.
+
+| Column | Type | Description |
+|--------|------|-------------|
+| `udt_id` | INT | UDT ID |
+| `udt_name` | TEXT | UDT name |
+| `udt_size` | INT | UDT size in bytes |
+| `ordinal` | INT | Field index in offset order |
+| `kind` | TEXT | `member`, `base` or `vfptr` |
+| `name` | TEXT | Field name |
+| `type` | TEXT | Field type |
+| `offset` | INT | Byte offset |
+| `size` | INT | Size (storage unit size for bitfields) |
+| `bit_position` | INT | First bit within the storage unit |
+| `bit_length` | INT | Bit width (0 if not a bitfield) |
+| `padding_after` | INT | Unused bytes before the next field (or the end) |
+| `cache_line` | INT | `offset / 64` |
+| `crosses_cache_line` | INT | 1 if the field spans two cache lines |
+| `holes` | INT | Interior padding bytes of the UDT (same on every row) |
+| `tail_padding` | INT | Padding after the last field (same on every row) |
+
+```sql
+-- Structs wasting the most space to padding
+SELECT DISTINCT udt_name, udt_size, holes, tail_padding
+FROM udt_layout WHERE holes > 0
+ORDER BY holes DESC LIMIT 20;
+
+-- Layout of one struct (filter by udt_name or udt_id for speed)
+SELECT offset, size, bit_position, bit_length, name, type, padding_after, cache_line
+FROM udt_layout WHERE udt_name = 'MyStruct';
+```
+
+#### type_duplicates
+UDT names with more than one definition in the PDB, one row per distinct structure.
+The structural hash covers kind, size and every field's name, offset, bits and type
+(recursively through by-value members). Computed once per session, in parallel.
+
+| Column | Type | Description |
+|--------|------|-------------|
+| `name` | TEXT | UDT name |
+| `hash` | TEXT | Structural hash (hex) |
+| `udt_id` | INT | ID of the first definition with this hash |
+| `size` | INT | Size in bytes |
+| `members` | INT | Fields and bases hashed |
+| `copies` | INT | Definitions with this name and hash |
+| `variants` | INT | Distinct hashes for this name |
+| `odr_violation` | INT | 1 if definitions of the name disagree (`variants > 1`) |
+
+```sql
+-- Types whose definitions disagree across compilands (ODR violations)
+SELECT name, hash, size, copies FROM type_duplicates WHERE odr_violation = 1;
+
+-- Identical copies (bloat)
+SELECT name, copies, size FROM type_duplicates WHERE variants = 1 ORDER BY copies DESC LIMIT 20;
+```
+
 #### enum_values
 Enumeration constant values.
 
@@ -328,31 +431,146 @@ SELECT COUNT(DISTINCT line) as line_count, COUNT(DISTINCT rva) as addr_count
 FROM line_numbers;
 ```
 
+#### inline_sites
+Calls the compiler inlined, one row per address range of each inline site
+(decoded from the S_INLINESITE binary annotations). `functions` only lists
+out-of-line code; use this table to see what a hot function is made of.
+
+| Column | Type | Description |
+|--------|------|-------------|
+| `site_id` | INT | Inline site symbol ID |
+| `parent_id` | INT | Enclosing inline site, or `func_id` at depth 1 |
+| `func_id` | INT | Out-of-line function the code was inlined into |
+| `func_name` | TEXT | Name of that function |
+| `inlinee` | TEXT | Inlined function name |
+| `depth` | INT | Nesting level (1 = inlined directly into `func_id`) |
+| `call_file_id` | INT | Source file of the call site |
+| `call_line` | INT | Line of the call site in the parent |
+| `rva` | INT | Start of the range |
+| `length` | INT | Range length in bytes |
+| `file_id` | INT | Inlinee source file at the range start |
+| `line` | INT | Inlinee source line at the range start |
+
+**Filter by `func_id`** to walk a single function (pushdown).
+
+The scalar function `inlinees_at(rva)` returns the inline call chain at an
+address, innermost first and ending with the out-of-line function
+(`inner <- outer <- Function`), or NULL if no function covers it.
+
+```sql
+-- What was inlined into a function, and how many bytes each inlinee takes
+SELECT inlinee, depth, call_line, COUNT(*) as ranges, SUM(length) as bytes
+FROM inline_sites
+WHERE func_id = (SELECT id FROM functions WHERE name = 'ProcessRequest')
+GROUP BY site_id
+ORDER BY bytes DESC;
+
+-- Most inlined functions across the binary
+SELECT inlinee, COUNT(DISTINCT site_id) as sites, SUM(length) as bytes
+FROM inline_sites
+GROUP BY inlinee
+ORDER BY bytes DESC
+LIMIT 20;
+
+-- Symbolize an address including inline frames
+SELECT inlinees_at(0x1234);
+```
+
 ### PE Section Tables
 
 #### sections
 PE sections from section contributions.
-
-| Column | Type | Description |
+)PROMPT"
+    R"PROMPT(| Column | Type | Description |
 |--------|------|-------------|
-| `section_number` | INT | Section number |
-| `name` | TEXT | Section name |
+| `number` | INT | Section number |
 | `rva` | INT | Section RVA |
 | `length` | INT | Section size |
-| `characteristics` | INT | Section flags |
-| `read` | INT | 1 if readable |
-| `write` | INT | 1 if writable |
-| `execute` | INT | 1 if executable |
+| `characteristics` | INT | IMAGE_SCN_* flags of its contributions (alignment bits dropped) |
+| `readable` | INT | 1 if readable |
+| `writable` | INT | 1 if writable |
+| `executable` | INT | 1 if executable |
 | `code` | INT | 1 if code section |
 
 ```sql
 -- Code sections
-SELECT name, printf('0x%X', rva) as addr, length
-FROM sections WHERE execute = 1;
+SELECT number, printf('0x%X', rva) as addr, length
+FROM sections WHERE executable = 1;
 
 -- Data sections
-SELECT name, printf('0x%X', rva) as addr, length
-FROM sections WHERE write = 1 AND execute = 0;
+SELECT number, printf('0x%X', rva) as addr, length
+FROM sections WHERE writable = 1 AND executable = 0;
+```
+
+#### section_contributions
+Which compiland contributed which bytes of each section. Read once per
+session and indexed by address.
+
+| Column | Type | Description |
+|--------|------|-------------|
+| `section` | INT | Section number |
+| `offset` | INT | Offset within the section |
+| `rva` | INT | Start address |
+| `length` | INT | Bytes contributed |
+| `compiland_id` | INT | Contributing compiland (join `compilands.id`) |
+| `characteristics` | INT | IMAGE_SCN_* flags of the contributing COFF section |
+| `readable` | INT | 1 if readable |
+| `writable` | INT | 1 if writable |
+| `executable` | INT | 1 if executable |
+| `code` | INT | 1 if code |
+
+The scalar function `contrib_at(rva)` returns the `compiland_id` of the
+contribution covering an address (NULL if none).
+
+```sql
+-- Bytes per compiland per section (binary size attribution)
+SELECT c.name as compiland, sc.section, SUM(sc.length) as bytes
+FROM section_contributions sc
+JOIN compilands c ON c.id = sc.compiland_id
+GROUP BY sc.compiland_id, sc.section
+ORDER BY bytes DESC
+LIMIT 20;
+
+-- Which object file an address came from
+SELECT name FROM compilands WHERE id = contrib_at(0x1234);
+```
+
+#### frame_data
+Stack frame records from the DIA FrameData table (FPO and x86 FrameData),
+as used for stack unwinding. Read once per session and kept sorted by address.
+
+| Column | Type | Description |
+|--------|------|-------------|
+| `rva` | INT | First address the record covers (same as `rva_start`) |
+| `rva_start` | INT | First address the record covers |
+| `code_size` | INT | Bytes of code covered |
+| `locals_size` | INT | Bytes of locals |
+| `params_size` | INT | Bytes of parameters |
+| `max_stack` | INT | Maximum stack usage |
+| `prolog_size` | INT | Prolog bytes |
+| `saved_regs_size` | INT | Bytes of saved registers |
+| `type` | TEXT | fpo, trap, tss, standard, framedata |
+| `function_start` | INT | 1 if the record starts a function |
+| `uses_bp` | INT | 1 if the frame allocates EBP |
+| `seh` | INT | 1 if it has SEH |
+| `cpp_eh` | INT | 1 if it has C++ EH |
+| `program` | TEXT | Unwind program string |
+| `probe_rva` | INT | Lookup address for `probe_rva = X` (else equals `rva_start`) |
+
+**`WHERE probe_rva = X`** is a point lookup: it returns the innermost record
+covering X (not only records starting at X), with `probe_rva` = X, so a list
+of addresses can be unwound in one query. `rva = X` matches only records
+starting at X.
+
+```sql
+-- Frame record for one address
+SELECT rva_start, code_size, locals_size, params_size, program
+FROM frame_data WHERE probe_rva = 0x1234;
+
+-- Bulk lookup for a set of return addresses
+SELECT a.pc, fd.rva_start, fd.program
+FROM (SELECT 0x1234 AS pc UNION ALL SELECT 0x5678) a
+JOIN frame_data fd ON fd.probe_rva = a.pc;
 ```
 
 ### Function-Scoped Tables
@@ -412,6 +630,9 @@ WHERE function_name = 'MyFunction';
 ### Find Functions by Name Pattern
 
 ```sql
+-- Ranked search when the exact name is unknown
+SELECT kind, id, name FROM symbol_search WHERE query = 'init' LIMIT 20;
+
 -- Case-insensitive search
 SELECT name, rva, length FROM functions WHERE name LIKE '%Init%';
 
@@ -510,12 +731,12 @@ SELECT DISTINCT parent_name, level FROM derived ORDER BY level, parent_name;
 ```sql
 -- Symbol distribution by section
 SELECT
-  s.name as section,
+  s.number as section,
   COUNT(f.id) as function_count,
   SUM(f.length) as total_size
 FROM sections s
-LEFT JOIN functions f ON s.section_number = f.section
-GROUP BY s.section_number
+LEFT JOIN functions f ON s.number = f.section
+GROUP BY s.number
 ORDER BY total_size DESC;
 ```
 
@@ -556,6 +777,18 @@ SELECT * FROM udts WHERE name LIKE '%Struct%';
 SELECT * FROM udts WHERE name LIKE 'My%';
 ```
 
+### Profile Slow Queries
+
+Prefix a query with `PROFILE` (or use `.profile on`) to get, per table, the cursors opened,
+the plan used (`full scan` vs `filter #N (col =)`), rows emitted, rows SQLite discarded and
+generator time, followed by `EXPLAIN QUERY PLAN`. Many cursors on one table means a nested
+loop re-scanning it; `full scan` where you expected a filter means the predicate was not pushed down.
+
+```sql
+PROFILE SELECT u.name, m.name FROM udts u JOIN udt_members m ON m.udt_id = u.id WHERE u.name = 'MyStruct';
+```
+Over HTTP use `POST /query?profile=true` (or `"profile": true` on `/execute`).
+
 ---
 
 ## Hex Address Formatting
@@ -622,8 +855,8 @@ GROUP BY language;
 ```sql
 -- Function count
 SELECT COUNT(*) FROM functions;
-)PROMPT"
-    R"PROMPT(-- Type count
+
+-- Type count
 SELECT COUNT(*) FROM udts;
 
 -- Source files
@@ -681,14 +914,21 @@ GROUP BY type;
 | Goal | Table/Join |
 |------|------------|
 | List all functions | `functions` |
+| Find a symbol by approximate name | `symbol_search WHERE query = '...'` |
 | Find types | `udts`, `enums`, `typedefs` |
 | Type members | `udt_members` |
+| Padding / struct layout | `udt_layout` |
+| ODR violations / duplicate types | `type_duplicates` |
 | Enum values | `enum_values` |
 | Inheritance | `base_classes` |
 | Source files | `source_files` |
 | Line mapping | `line_numbers` |
+| Inlined code / inline frames | `inline_sites`, `inlinees_at(rva)` |
 | Compilands | `compilands` |
 | PE sections | `sections` |
+| Size per compiland / owner of an address | `section_contributions`, `contrib_at(rva)` |
+| Demangle a decorated name | `undecorate(name[, flags])` |
+| Stack unwind info per address | `frame_data WHERE probe_rva = X` |
 | Local variables | `locals WHERE function_id = X` |
 | Parameters | `parameters WHERE function_id = X` |
 
@@ -702,7 +942,7 @@ GROUP BY type;
 
 ```sql
 -- 1. Find the type
-SELECT * FROM udts WHERE name LIKE '%MyClass%';
+SELECT id, name FROM symbol_search WHERE query = 'MyClass' AND kind = 'udt' LIMIT 5;
 
 -- 2. Get its members
 SELECT name, offset, length, type_name
@@ -781,7 +1021,10 @@ pdbsql database.pdb --http 8081 --token mysecret
 | `/` | GET | No | Welcome message |
 | `/help` | GET | No | API documentation (for LLM discovery) |
 | `/query` | POST | Yes* | Execute SQL (body = raw SQL) |
+| `/prepare` | POST | Yes* | Register a named statement (`{"name": ..., "sql": ...}`) |
+| `/execute` | POST | Yes* | Run a statement with bound params (`{"sql": ..., "params": [...]}`) |
 | `/status` | GET | Yes* | Health check |
+| `/metrics` | GET | Yes* | Prometheus metrics: latency per route, rows/scans per table (full vs pushdown), cache hit ratios, queue depth |
 | `/shutdown` | POST | Yes* | Stop server |
 
 *Auth required only if `--token` was specified.
@@ -799,21 +1042,63 @@ curl -X POST http://localhost:8081/query \
      -H "Authorization: Bearer mysecret" \
      -d "SELECT * FROM udts"
 
+# Parameterized query (prepared once, cached across requests)
+curl -X POST http://localhost:8081/execute \
+     -d '{"sql": "SELECT name, rva FROM functions WHERE id = ?", "params": [1234]}'
+
 # Check status
 curl http://localhost:8081/status
 ```
 
 **Response Format (JSON):**
 ```json
-{"success": true, "columns": ["name", "rva"], "rows": [["main", "4096"]], "row_count": 1}
+{"success": true, "columns": ["name", "rva"], "rows": [["main", 4096]], "row_count": 1}
 ```
 
+Values keep their SQL type: integers and reals are JSON numbers, NULL is `null`.
+Add `?hex=rva` to `/query` or `/execute` to get rva columns as `"0x1000"` strings.
+
 ```json
 {"success": false, "error": "no such table: bad_table"}
 ```
 
 ---
 
+### Pooled Server (Many PDBs)
+
+Serve a whole symbol directory from one process. PDBs open on first use and the
+least recently used ones are closed once `--pool-mb` (default 2048) is exceeded.
+
+```bash
+pdbsql --pdbs C:\symbols --http 8081)PROMPT"
+    R"PROMPT(pdbsql --pdbs ntdll.pdb --pdbs kernel32.pdb --server 13337 --pool-mb 4096
+```
+
+Select the PDB per query by module name, path, or GUID+age signature:
+```bash
+curl -X POST "http://localhost:8081/query?pdb=ntdll" -d "SELECT COUNT(*) FROM functions"
+curl -X POST http://localhost:8081/query -d "USE kernel32; SELECT name FROM publics LIMIT 5"
+curl http://localhost:8081/pdbs
+```
+
+Without a selection (and more than one PDB), queries run against the catalog table
+`pdbs` (`path`, `module`, `signature`, `file_size`, `is_open`, `opens`, `queries`).
+`/execute` and `/prepare` take a `"pdb"` field; `/status` reports pool hits, misses and evictions.
+
+**Symbol stores:** `pdbsql --index-store <dir>` reads each PDB's MSF header (GUID, age) in
+parallel and writes a sorted catalog (`<dir>/pdbsql.idx`). Serving with
+`pdbsql --index-store <dir> --http` lists every indexed PDB in `pdbs`; an exact
+`signature = '...'` lookup is a binary search, and `USE <GUID+age>;` opens the PDB on demand.
+
+**Federated queries:** `pdbsql --pdbs <dir> --federate -q "<query>"` runs the query against
+every PDB in parallel (`--jobs N`) and prefixes each row with a `pdb` column. `LIMIT` without
+`ORDER BY` stops early; `ORDER BY ... LIMIT n` is re-ranked globally; `--merge "<query>"`
+re-aggregates the rows from a `results` table (e.g. `SELECT SUM(n) FROM results`).
+After `pdbsql --pdbs <dir> --build-filters`, queries over `functions`/`publics`/`udts` with
+an exact `name = '...'` condition (ANDed, no `OR`) skip PDBs whose name filter rules the name out.
+
+---
+
 ### Raw TCP Server (Legacy)
 
 Binary protocol with length-prefixed JSON. Use only when HTTP is not available.
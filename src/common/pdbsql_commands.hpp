@@ -32,6 +32,7 @@ struct CommandCallbacks {
     std::function<std::string(const std::string&)> get_schema;  // Return schema for table
     std::function<std::string()> get_info;        // Return database info
     std::function<std::string()> clear_session;   // Clear/reset session (agent, UI, etc.)
+    std::function<std::string(const std::string&)> set_profile;  // .profile [on|off]
 
     // MCP server callbacks (optional - agent mode only)
     std::function<std::string()> mcp_status;
@@ -81,6 +82,16 @@ inline CommandResult handle_command(
         return CommandResult::HANDLED;
     }
 
+    if (input == ".profile" || input.rfind(".profile ", 0) == 0) {
+        std::string arg = input.size() > 9 ? input.substr(9) : "";
+        if (callbacks.set_profile) {
+            output = callbacks.set_profile(arg);
+        } else {
+            output = "Profiling not available";
+        }
+        return CommandResult::HANDLED;
+    }
+
     if (input == ".clear") {
         if (callbacks.clear_session) {
             output = callbacks.clear_session();
@@ -96,6 +107,7 @@ inline CommandResult handle_command(
                  "  .schema <table> Show table schema\n"
                  "  .info           Show database info\n"
                  "  .clear          Clear/reset session\n"
+                 "  .profile on|off Per-table profile after each query (or prefix with PROFILE)\n"
                  "  .quit / .exit   Exit\n"
                  "  .help           Show this help\n"
 
@@ -173,9 +185,10 @@ inline CommandResult handle_command(
                      "  .mcp stop       Stop MCP server\n"
                      "  .mcp help       Show this help\n"
                      "\n"
-                     "The MCP server exposes two tools:\n"
-                     "  pdbsql_query  - Execute SQL query directly\n"
-                     "  pdbsql_agent  - Ask natural language question (AI-powered)\n"
+                     "The MCP server exposes three tools:\n"
+                     "  pdbsql_query   - Execute SQL query directly\n"
+                     "  pdbsql_execute - Execute SQL with bound parameters (prepared, cached)\n"
+                     "  pdbsql_agent   - Ask natural language question (AI-powered)\n"
                      "\n"
                      "Connect with Claude Desktop by adding to config:\n"
                      "  {\"mcpServers\": {\"pdbsql\": {\"url\": \"http://127.0.0.1:<port>/sse\"}}}\n";
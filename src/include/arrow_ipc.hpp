@@ -0,0 +1,554 @@
+#pragma once
+// arrow_ipc.hpp - Apache Arrow IPC export of query results (--export-arrow, HTTP Accept)
+//
+// Writes a statement's rows as an Arrow IPC stream (application/vnd.apache.arrow.stream)
+// or Arrow IPC file (Feather v2), readable by pyarrow, pandas, polars and DuckDB.
+//
+// Column types come from the declared vtable column type (sqlite3_column_decltype):
+//   INTEGER -> int64, REAL -> float64, TEXT -> utf8, BLOB -> binary
+// Expressions without a declared type take the type of their value in the first row.
+// All columns are nullable. Record batches hold up to BATCH_ROWS rows and are filled
+// column-wise straight from sqlite3_column_*; no text round trip for numbers.
+//
+// The IPC metadata (Schema, RecordBatch, Footer) is FlatBuffers; the few tables
+// needed are encoded by hand below rather than pulling in the Arrow libraries.
+// Little-endian hosts only (x86, x64, ARM64), as Arrow itself assumes.
+
+#include <xsql/database.hpp>
+
+#include "trace.hpp"
+
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace pdbsql {
+
+enum class ArrowIpcFormat { Stream, File };
+
+namespace arrow_detail {
+
+// ----------------------------------------------------------------------------
+// Minimal FlatBuffers encoder
+// ----------------------------------------------------------------------------
+// Objects are laid out front to back: a table is written before the strings,
+// vectors and tables it references, so every uoffset points forward as the
+// format requires. vtables are not shared (the messages are tiny).
+
+struct FbObject;
+using FbPtr = std::unique_ptr<FbObject>;
+
+struct FbObject {
+    enum class Kind { Table, String, TableVector, StructVector };
+
+    struct Slot {
+        uint8_t size = 0;  // Scalar width; 0 = reference or absent
+        uint64_t bits = 0;
+        FbPtr ref;
+    };
+
+    Kind kind = Kind::Table;
+    std::vector<Slot> slots;   // Table
+    std::string bytes;         // String text, or packed structs
+    uint32_t count = 0;        // StructVector element count
+    std::vector<FbPtr> items;  // TableVector
+
+    template<typename T>
+    FbObject& scalar(size_t slot, T value) {
+        static_assert(sizeof(T) <= 8, "scalar too wide");
+        Slot& s = at(slot);
+        s.size = static_cast<uint8_t>(sizeof(T));
+        s.bits = 0;
+        memcpy(&s.bits, &value, sizeof(T));
+        return *this;
+    }
+
+    FbObject& ref(size_t slot, FbPtr object) {
+        at(slot).ref = std::move(object);
+        return *this;
+    }
+
+private:
+    Slot& at(size_t slot) {
+        if (slots.size() <= slot) slots.resize(slot + 1);
+        return slots[slot];
+    }
+};
+
+inline FbPtr fb_table() {
+    return std::make_unique<FbObject>();
+}
+
+inline FbPtr fb_string(const std::string& text) {
+    auto s = std::make_unique<FbObject>();
+    s->kind = FbObject::Kind::String;
+    s->bytes = text;
+    return s;
+}
+
+inline FbPtr fb_tables(std::vector<FbPtr> items) {
+    auto v = std::make_unique<FbObject>();
+    v->kind = FbObject::Kind::TableVector;
+    v->items = std::move(items);
+    return v;
+}
+
+// Vector of 8-byte aligned structs, already packed
+inline FbPtr fb_structs(std::string packed, uint32_t count) {
+    auto v = std::make_unique<FbObject>();
+    v->kind = FbObject::Kind::StructVector;
+    v->bytes = std::move(packed);
+    v->count = count;
+    return v;
+}
+
+class FbWriter {
+public:
+    // Serialize with `root` as the root table; padded to 8 bytes.
+    std::string finish(const FbObject& root) {
+        buf_.assign(4, '\0');
+        patch(0, static_cast<uint32_t>(write(root)));
+        pad(8);
+        return std::move(buf_);
+    }
+
+private:
+    std::string buf_;
+
+    void pad(size_t align) {
+        while (buf_.size() % align) buf_ += '\0';
+    }
+
+    template<typename T>
+    void put(T value) {
+        buf_.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    void patch(size_t at, uint32_t value) {
+        memcpy(&buf_[at], &value, sizeof(value));
+    }
+
+    // Point the uoffset at `at` to an object written now.
+    void write_ref(size_t at, const FbObject& object) {
+        size_t pos = write(object);
+        patch(at, static_cast<uint32_t>(pos - at));
+    }
+
+    size_t write(const FbObject& o) {
+        switch (o.kind) {
+            case FbObject::Kind::String: {
+                pad(4);
+                size_t pos = buf_.size();
+                put(static_cast<uint32_t>(o.bytes.size()));
+                buf_ += o.bytes;
+                buf_ += '\0';
+                return pos;
+            }
+            case FbObject::Kind::StructVector: {
+                while (buf_.size() % 8 != 4) buf_ += '\0';  // Elements land on 8
+                size_t pos = buf_.size();
+                put(o.count);
+                buf_ += o.bytes;
+                return pos;
+            }
+            case FbObject::Kind::TableVector: {
+                pad(4);
+                size_t pos = buf_.size();
+                put(static_cast<uint32_t>(o.items.size()));
+                buf_.append(o.items.size() * 4, '\0');
+                for (size_t i = 0; i < o.items.size(); i++) write_ref(pos + 4 + i * 4, *o.items[i]);
+                return pos;
+            }
+            case FbObject::Kind::Table:
+                break;
+        }
+
+        // Field layout relative to the table start (after the soffset)
+        std::vector<uint16_t> field_pos(o.slots.size(), 0);
+        size_t inline_size = 4;
+        size_t align = 4;
+        for (size_t i = 0; i < o.slots.size(); i++) {
+            const auto& s = o.slots[i];
+            size_t width = s.ref ? 4 : s.size;
+            if (width == 0) continue;
+            inline_size = (inline_size + width - 1) / width * width;
+            field_pos[i] = static_cast<uint16_t>(inline_size);
+            inline_size += width;
+            if (width > align) align = width;
+        }
+
+        pad(2);
+        size_t vtable = buf_.size();
+        put(static_cast<uint16_t>(4 + 2 * o.slots.size()));
+        put(static_cast<uint16_t>(inline_size));
+        for (uint16_t p : field_pos) put(p);
+
+        pad(align);
+        size_t table = buf_.size();
+        put(static_cast<int32_t>(table - vtable));
+        buf_.resize(table + inline_size, '\0');
+        for (size_t i = 0; i < o.slots.size(); i++) {
+            const auto& s = o.slots[i];
+            if (!s.ref && s.size) memcpy(&buf_[table + field_pos[i]], &s.bits, s.size);
+        }
+        for (size_t i = 0; i < o.slots.size(); i++) {
+            if (o.slots[i].ref) write_ref(table + field_pos[i], *o.slots[i].ref);
+        }
+        return table;
+    }
+};
+
+// ----------------------------------------------------------------------------
+// Arrow schema constants (format/Schema.fbs, format/Message.fbs)
+// ----------------------------------------------------------------------------
+
+constexpr int16_t METADATA_V5 = 4;
+constexpr uint8_t HEADER_SCHEMA = 1;
+constexpr uint8_t HEADER_RECORD_BATCH = 3;
+constexpr uint8_t TYPE_INT = 2;
+constexpr uint8_t TYPE_FLOATING_POINT = 3;
+constexpr uint8_t TYPE_BINARY = 4;
+constexpr uint8_t TYPE_UTF8 = 5;
+constexpr int16_t PRECISION_DOUBLE = 2;
+
+template<typename T>
+inline void pack(std::string& out, T value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+} // namespace arrow_detail
+
+// ============================================================================
+// ArrowIpcWriter
+// ============================================================================
+
+// Encodes one statement's result set. Output goes to a FILE (flushed as it
+// grows) or, with a null FILE, accumulates in bytes() for an HTTP body.
+class ArrowIpcWriter {
+public:
+    static constexpr size_t BATCH_ROWS = 64 * 1024;
+    static constexpr size_t BATCH_BYTES = 64 * 1024 * 1024;  // Keeps utf8 offsets in int32
+    static constexpr size_t FLUSH_BYTES = 1 << 20;
+
+    ArrowIpcWriter(ArrowIpcFormat format, FILE* out = nullptr)
+        : format_(format), out_(out) {}
+
+    ArrowIpcWriter(const ArrowIpcWriter&) = delete;
+    ArrowIpcWriter& operator=(const ArrowIpcWriter&) = delete;
+
+    // Step stmt to completion and write the whole stream/file. On a step
+    // error the output is incomplete and should be discarded.
+    bool write_statement(sqlite3_stmt* stmt, std::string& error, size_t* row_count = nullptr) {
+        TraceSpan span("sql.step+serialize.arrow", "sql");
+        if (span.active()) span.arg("sql", sqlite3_sql(stmt));
+
+        if (format_ == ArrowIpcFormat::File) emit("ARROW1\0\0", 8);
+
+        const int ncols = sqlite3_column_count(stmt);
+        columns_.assign(ncols, Column());
+        for (int c = 0; c < ncols; c++) {
+            const char* name = sqlite3_column_name(stmt, c);
+            columns_[c].name = name ? name : "";
+            columns_[c].type = declared_type(sqlite3_column_decltype(stmt, c));
+        }
+
+        size_t rows = 0;
+        bool schema_written = false;
+        int rc;
+        while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+            if (!schema_written) {
+                for (int c = 0; c < ncols; c++) {
+                    if (columns_[c].type == Type::Unknown) columns_[c].type = value_type(sqlite3_column_type(stmt, c));
+                }
+                write_schema();
+                schema_written = true;
+            }
+            for (int c = 0; c < ncols; c++) columns_[c].append(stmt, c, batch_rows_);
+            batch_rows_++;
+            rows++;
+            if (batch_rows_ >= BATCH_ROWS || batch_bytes() >= BATCH_BYTES) write_batch();
+        }
+        if (row_count) *row_count = rows;
+        if (rc != SQLITE_DONE) {
+            error = sqlite3_errmsg(sqlite3_db_handle(stmt));
+            flush();
+            return false;
+        }
+
+        if (!schema_written) {
+            for (auto& col : columns_) {
+                if (col.type == Type::Unknown) col.type = Type::Utf8;
+            }
+            write_schema();
+        }
+        if (batch_rows_ > 0) write_batch();
+
+        pack32(0xFFFFFFFFu);  // End-of-stream marker
+        pack32(0);
+        if (format_ == ArrowIpcFormat::File) write_footer();
+        flush();
+        span.arg("rows", rows).arg("bytes", written_);
+        return true;
+    }
+
+    // Accumulated output when constructed without a FILE
+    std::string& bytes() { return buf_; }
+
+private:
+    enum class Type { Unknown, Int64, Float64, Utf8, Binary };
+
+    struct Column {
+        std::string name;
+        Type type = Type::Unknown;
+        std::string validity;          // LSB-first bitmap, 1 = present
+        std::string values;            // int64/float64 values, or string bytes
+        std::vector<int32_t> offsets;  // utf8/binary
+        int64_t nulls = 0;
+
+        void append(sqlite3_stmt* stmt, int c, size_t row) {
+            if (row % 8 == 0) validity += '\0';
+            const bool is_null = sqlite3_column_type(stmt, c) == SQLITE_NULL;
+            if (is_null) nulls++;
+            else validity.back() = static_cast<char>(validity.back() | (1 << (row % 8)));
+
+            switch (type) {
+                case Type::Int64: {
+                    int64_t v = is_null ? 0 : sqlite3_column_int64(stmt, c);
+                    values.append(reinterpret_cast<const char*>(&v), sizeof(v));
+                    break;
+                }
+                case Type::Float64: {
+                    double v = is_null ? 0.0 : sqlite3_column_double(stmt, c);
+                    values.append(reinterpret_cast<const char*>(&v), sizeof(v));
+                    break;
+                }
+                case Type::Utf8:
+                case Type::Binary: {
+                    if (offsets.empty()) offsets.push_back(0);
+                    if (!is_null) {
+                        const void* p = type == Type::Utf8 ? static_cast<const void*>(sqlite3_column_text(stmt, c))
+                                                           : sqlite3_column_blob(stmt, c);
+                        int n = sqlite3_column_bytes(stmt, c);
+                        if (p && n > 0) values.append(static_cast<const char*>(p), n);
+                    }
+                    offsets.push_back(static_cast<int32_t>(values.size()));
+                    break;
+                }
+                case Type::Unknown:
+                    break;
+            }
+        }
+
+        void clear() {
+            validity.clear();
+            values.clear();
+            offsets.clear();
+            nulls = 0;
+        }
+    };
+
+    ArrowIpcFormat format_;
+    FILE* out_;
+    std::string buf_;
+    size_t written_ = 0;  // Bytes emitted so far (file offsets for the footer)
+    std::vector<Column> columns_;
+    size_t batch_rows_ = 0;
+    std::string blocks_;  // Footer Block structs, one per record batch
+    uint32_t block_count_ = 0;
+
+    static Type declared_type(const char* decl) {
+        if (!decl) return Type::Unknown;
+        std::string t;
+        for (const char* p = decl; *p; p++) t += static_cast<char>(std::toupper(static_cast<unsigned char>(*p)));
+        // SQLite type affinity rules
+        if (t.find("INT") != std::string::npos) return Type::Int64;
+        if (t.find("CHAR") != std::string::npos || t.find("CLOB") != std::string::npos ||
+            t.find("TEXT") != std::string::npos) return Type::Utf8;
+        if (t.find("BLOB") != std::string::npos) return Type::Binary;
+        if (t.find("REAL") != std::string::npos || t.find("FLOA") != std::string::npos ||
+            t.find("DOUB") != std::string::npos) return Type::Float64;
+        return Type::Unknown;
+    }
+
+    static Type value_type(int sqlite_type) {
+        switch (sqlite_type) {
+            case SQLITE_INTEGER: return Type::Int64;
+            case SQLITE_FLOAT: return Type::Float64;
+            case SQLITE_BLOB: return Type::Binary;
+            default: return Type::Utf8;
+        }
+    }
+
+    size_t batch_bytes() const {
+        size_t total = 0;
+        for (const auto& col : columns_) total += col.values.size();
+        return total;
+    }
+
+    void emit(const void* data, size_t len) {
+        buf_.append(static_cast<const char*>(data), len);
+        written_ += len;
+        if (out_ && buf_.size() >= FLUSH_BYTES) flush();
+    }
+
+    void pack32(uint32_t v) { emit(&v, sizeof(v)); }
+
+    void emit_padding(size_t len) {
+        static const char zeros[8] = {};
+        emit(zeros, (8 - len % 8) % 8);
+    }
+
+    void flush() {
+        if (out_ && !buf_.empty()) {
+            fwrite(buf_.data(), 1, buf_.size(), out_);
+            buf_.clear();
+        }
+    }
+
+    // Encapsulated message: continuation, metadata size, metadata, body.
+    // Returns the metadata length including the 8-byte prefix.
+    size_t emit_message(const std::string& metadata) {
+        pack32(0xFFFFFFFFu);
+        pack32(static_cast<uint32_t>(metadata.size()));
+        emit(metadata.data(), metadata.size());
+        return 8 + metadata.size();
+    }
+
+    static arrow_detail::FbPtr message(uint8_t header_type, arrow_detail::FbPtr header, int64_t body_length) {
+        using namespace arrow_detail;
+        auto msg = fb_table();
+        msg->scalar(0, METADATA_V5)
+            .scalar(1, header_type)
+            .ref(2, std::move(header))
+            .scalar(3, body_length);
+        return msg;
+    }
+
+    arrow_detail::FbPtr schema() const {
+        using namespace arrow_detail;
+        std::vector<FbPtr> fields;
+        for (const auto& col : columns_) {
+            auto type = fb_table();
+            uint8_t type_id = TYPE_UTF8;
+            switch (col.type) {
+                case Type::Int64:
+                    type_id = TYPE_INT;
+                    type->scalar(0, static_cast<int32_t>(64)).scalar(1, static_cast<uint8_t>(1));
+                    break;
+                case Type::Float64:
+                    type_id = TYPE_FLOATING_POINT;
+                    type->scalar(0, PRECISION_DOUBLE);
+                    break;
+                case Type::Binary:
+                    type_id = TYPE_BINARY;
+                    break;
+                default:
+                    break;
+            }
+            auto field = fb_table();
+            field->ref(0, fb_string(col.name))
+                .scalar(1, static_cast<uint8_t>(1))  // nullable
+                .scalar(2, type_id)
+                .ref(3, std::move(type))
+                .ref(5, fb_tables({}));  // children (readers expect the vector)
+            fields.push_back(std::move(field));
+        }
+        auto s = fb_table();
+        s->scalar(0, static_cast<int16_t>(0))  // little endian
+            .ref(1, fb_tables(std::move(fields)));
+        return s;
+    }
+
+    void write_schema() {
+        arrow_detail::FbWriter fb;
+        emit_message(fb.finish(*message(arrow_detail::HEADER_SCHEMA, schema(), 0)));
+    }
+
+    void write_batch() {
+        using namespace arrow_detail;
+        TraceSpan span("arrow.batch", "serialize");
+        span.arg("rows", batch_rows_);
+
+        // Body buffers, each padded to 8: validity, then values or offsets + data
+        struct Buf { const void* data; size_t len; };
+        std::vector<Buf> body;
+        std::string nodes, buffers;
+        int64_t offset = 0;
+        auto add = [&](const void* data, size_t len) {
+            body.push_back({data, len});
+            pack(buffers, offset);
+            pack(buffers, static_cast<int64_t>(len));
+            offset += static_cast<int64_t>((len + 7) / 8 * 8);
+        };
+        for (const auto& col : columns_) {
+            pack(nodes, static_cast<int64_t>(batch_rows_));
+            pack(nodes, col.nulls);
+            add(col.validity.data(), col.nulls ? col.validity.size() : 0);
+            if (col.type == Type::Utf8 || col.type == Type::Binary) {
+                add(col.offsets.data(), col.offsets.size() * sizeof(int32_t));
+            }
+            add(col.values.data(), col.values.size());
+        }
+
+        auto batch = fb_table();
+        batch->scalar(0, static_cast<int64_t>(batch_rows_))
+            .ref(1, fb_structs(std::move(nodes), static_cast<uint32_t>(columns_.size())))
+            .ref(2, fb_structs(std::move(buffers), static_cast<uint32_t>(body.size())));
+        FbWriter fb;
+        const size_t block_offset = written_;
+        const size_t metadata_len = emit_message(fb.finish(*message(HEADER_RECORD_BATCH, std::move(batch), offset)));
+        for (const Buf& b : body) {
+            emit(b.data, b.len);
+            emit_padding(b.len);
+        }
+
+        pack(blocks_, static_cast<int64_t>(block_offset));
+        pack(blocks_, static_cast<int32_t>(metadata_len));
+        pack(blocks_, static_cast<int32_t>(0));
+        pack(blocks_, offset);
+        block_count_++;
+
+        for (auto& col : columns_) col.clear();
+        batch_rows_ = 0;
+    }
+
+    void write_footer() {
+        using namespace arrow_detail;
+        auto footer = fb_table();
+        footer->scalar(0, METADATA_V5)
+            .ref(1, schema())
+            .ref(2, fb_structs(std::string(), 0))
+            .ref(3, fb_structs(std::move(blocks_), block_count_));
+        FbWriter fb;
+        std::string bytes = fb.finish(*footer);
+        emit(bytes.data(), bytes.size());
+        pack32(static_cast<uint32_t>(bytes.size()));
+        emit("ARROW1", 6);
+    }
+};
+
+// Run a single SQL statement into `out` (FILE) or `body` (when out is null).
+inline bool query_to_arrow(sqlite3* db, const std::string& sql, ArrowIpcFormat format,
+                           FILE* out, std::string* body, std::string& error, size_t* row_count = nullptr) {
+    sqlite3_stmt* stmt = nullptr;
+    const char* tail = nullptr;
+    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, &tail) != SQLITE_OK) {
+        error = sqlite3_errmsg(db);
+        return false;
+    }
+    if (!stmt) {
+        error = "Empty statement";
+        return false;
+    }
+    ArrowIpcWriter writer(format, out);
+    bool ok = writer.write_statement(stmt, error, row_count);
+    sqlite3_finalize(stmt);
+    if (ok && body) body->swap(writer.bytes());
+    return ok;
+}
+
+} // namespace pdbsql
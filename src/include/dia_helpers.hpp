@@ -3,9 +3,12 @@
 
 #include <atlbase.h>
 #include <dia2.h>
+#include <cstdio>
 #include <string>
 #include <stdexcept>
 
+#include "utf16.hpp"
+
 namespace pdbsql {
 
 // ============================================================================
@@ -32,14 +35,20 @@ public:
 // BSTR utilities
 // ============================================================================
 
-// Convert BSTR to std::string (UTF-8)
+// Convert BSTR to std::string (UTF-8). One pass, sized from the BSTR length
+// prefix rather than a WideCharToMultiByte sizing call. Embedded NULs are kept
+// (the whole SysStringLen() is converted); the old WideCharToMultiByte(-1)
+// call stopped at the first one.
 inline std::string bstr_to_string(BSTR bstr) {
     if (!bstr) return "";
-    int len = WideCharToMultiByte(CP_UTF8, 0, bstr, -1, nullptr, 0, nullptr, nullptr);
-    if (len <= 0) return "";
-    std::string result(len - 1, '\0');
-    WideCharToMultiByte(CP_UTF8, 0, bstr, -1, result.data(), len, nullptr, nullptr);
-    return result;
+    static_assert(sizeof(WCHAR) == sizeof(char16_t), "BSTR must be UTF-16");
+    return utf16_to_utf8(reinterpret_cast<const char16_t*>(bstr), SysStringLen(bstr));
+}
+
+// Append a BSTR to out as UTF-8 (no temporary string)
+inline void append_bstr(std::string& out, BSTR bstr) {
+    if (!bstr) return;
+    append_utf16_as_utf8(out, reinterpret_cast<const char16_t*>(bstr), SysStringLen(bstr));
 }
 
 // Convert std::string to wide string
@@ -63,12 +72,28 @@ public:
     BSTR get() const { return bstr_; }
     BSTR bstr() const { return bstr_; }  // Alias for compatibility
     std::string str() const { return bstr_to_string(bstr_); }
+    void append_to(std::string& out) const { append_bstr(out, bstr_); }
     bool empty() const { return !bstr_ || SysStringLen(bstr_) == 0; }
 
     SafeBSTR(const SafeBSTR&) = delete;
     SafeBSTR& operator=(const SafeBSTR&) = delete;
 };
 
+// ============================================================================
+// PDB identity
+// ============================================================================
+
+// Symbol-server style signature: GUID (no dashes) followed by age, upper-case hex
+inline std::string format_pdb_signature(const GUID& guid, DWORD age) {
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%08X%04X%04X%02X%02X%02X%02X%02X%02X%02X%02X%X",
+             static_cast<unsigned>(guid.Data1), guid.Data2, guid.Data3,
+             guid.Data4[0], guid.Data4[1], guid.Data4[2], guid.Data4[3],
+             guid.Data4[4], guid.Data4[5], guid.Data4[6], guid.Data4[7],
+             static_cast<unsigned>(age));
+    return buf;
+}
+
 // ============================================================================
 // SymTag enum to string
 // ============================================================================
@@ -0,0 +1,681 @@
+#pragma once
+// federated_query.hpp - Run one query against many PDBs in parallel
+//
+// Each worker thread opens its own PdbSession/Database per PDB (DIA sessions
+// are never shared across threads) and runs the query there; per-PDB results
+// are merged into one result set with a leading `pdb` column.
+//
+//   - LIMIT: a top-level LIMIT without ORDER BY stops all workers once
+//     enough rows are collected.
+//   - ORDER BY ... LIMIT: each PDB returns its own top rows and the merged
+//     set is re-ranked with the same ORDER BY/LIMIT.
+//   - Aggregation: the query runs per PDB (partial aggregates) and an
+//     optional merge query re-aggregates over the `results` table, e.g.
+//       query: SELECT COUNT(*) AS n FROM functions
+//       merge: SELECT SUM(n) AS functions FROM results
+
+#include "name_filter.hpp"
+#include "pdb_session.hpp"
+#include "pdb_tables.hpp"
+#include "statement_cache.hpp"
+#include "trace.hpp"
+
+#include <xsql/database.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace pdbsql {
+
+// Result values reuse the parameter type: rows bind straight into `results`.
+using FederatedCell = StatementParam;
+using FederatedRow = std::vector<FederatedCell>;
+
+inline std::string federated_cell_text(const FederatedCell& cell) {
+    switch (cell.type) {
+        case FederatedCell::Type::Null:
+            return "NULL";
+        case FederatedCell::Type::Integer:
+            return std::to_string(cell.int_value);
+        case FederatedCell::Type::Real: {
+            char buf[32];
+            snprintf(buf, sizeof(buf), "%.15g", cell.real_value);
+            return buf;
+        }
+        case FederatedCell::Type::Text:
+            return cell.text_value;
+    }
+    return "";
+}
+
+// ============================================================================
+// Query shape (top-level ORDER BY / LIMIT)
+// ============================================================================
+
+struct SqlToken {
+    std::string upper;  // Upper-cased word, single punctuation char, "'" for literals, "(" / ")"
+    size_t begin, end;  // Span in the original SQL
+};
+
+// Tokens at the top level of a statement. Comments are dropped, string and
+// quoted identifiers become one token, and a parenthesized group (subquery,
+// call arguments) collapses to its "(" and ")".
+inline std::vector<SqlToken> sql_top_level_tokens(const std::string& sql) {
+    std::vector<SqlToken> tokens;
+    int depth = 0;
+    size_t i = 0;
+    const size_t n = sql.size();
+    while (i < n) {
+        char c = sql[i];
+        if (std::isspace(static_cast<unsigned char>(c))) {
+            i++;
+        } else if (c == '-' && i + 1 < n && sql[i + 1] == '-') {
+            while (i < n && sql[i] != '\n') i++;
+        } else if (c == '/' && i + 1 < n && sql[i + 1] == '*') {
+            size_t end = sql.find("*/", i + 2);
+            i = end == std::string::npos ? n : end + 2;
+        } else if (c == '\'' || c == '"' || c == '`' || c == '[') {
+            char close = c == '[' ? ']' : c;
+            size_t start = i++;
+            while (i < n) {
+                if (sql[i] == close) {
+                    if (close != ']' && i + 1 < n && sql[i + 1] == close) { i += 2; continue; }
+                    break;
+                }
+                i++;
+            }
+            i = i < n ? i + 1 : n;
+            if (depth == 0) tokens.push_back({c == '\'' ? "'" : "\"", start, i});
+        } else if (c == '(') {
+            if (depth++ == 0) tokens.push_back({"(", i, i + 1});
+            i++;
+        } else if (c == ')') {
+            if (--depth == 0) tokens.push_back({")", i, i + 1});
+            i++;
+        } else if (std::isalnum(static_cast<unsigned char>(c)) || c == '_') {
+            size_t start = i;
+            while (i < n && (std::isalnum(static_cast<unsigned char>(sql[i])) || sql[i] == '_' || sql[i] == '.')) i++;
+            if (depth == 0) {
+                std::string word = sql.substr(start, i - start);
+                for (char& ch : word) ch = static_cast<char>(std::toupper(static_cast<unsigned char>(ch)));
+                tokens.push_back({word, start, i});
+            }
+        } else {
+            if (depth == 0) tokens.push_back({std::string(1, c), i, i + 1});
+            i++;
+        }
+    }
+    while (!tokens.empty() && tokens.back().upper == ";") tokens.pop_back();
+    return tokens;
+}
+
+struct QueryShape {
+    int64_t limit = -1;      // Trailing top-level "LIMIT n", -1 if none
+    std::string order_by;    // Top-level ORDER BY terms (without the keywords)
+};
+
+// Find a trailing top-level "ORDER BY ... LIMIT n".
+// OFFSET or "LIMIT a, b" disable the limit.
+inline QueryShape analyze_query_shape(const std::string& sql) {
+    const std::vector<SqlToken> tokens = sql_top_level_tokens(sql);
+
+    QueryShape shape;
+    size_t count = tokens.size();
+    size_t limit_pos = count;
+    if (count >= 2 && tokens[count - 2].upper == "LIMIT" &&
+        std::isdigit(static_cast<unsigned char>(tokens[count - 1].upper[0]))) {
+        const std::string& digits = tokens[count - 1].upper;
+        bool all_digits = digits.size() <= 18;
+        for (char ch : digits) all_digits = all_digits && std::isdigit(static_cast<unsigned char>(ch));
+        if (all_digits) {
+            shape.limit = std::stoll(digits);
+            limit_pos = count - 2;
+        }
+    }
+
+    for (size_t t = 0; t + 1 < limit_pos; t++) {
+        if (tokens[t].upper == "ORDER" && tokens[t + 1].upper == "BY" && t + 2 < limit_pos) {
+            size_t begin = tokens[t + 2].begin;
+            size_t end = tokens[limit_pos - 1].end;
+            shape.order_by = sql.substr(begin, end - begin);
+        }
+    }
+    return shape;
+}
+
+// Tables whose names are covered by the name filter sidecars
+inline bool is_name_filtered_table(const std::string& upper) {
+    return upper == "FUNCTIONS" || upper == "PUBLICS" || upper == "UDTS";
+}
+
+// True for a select list that calls an aggregate (at any nesting depth) in a
+// query without GROUP BY: such a query returns one row even when nothing
+// matches, e.g. SELECT COUNT(*) ... -> 0.
+inline bool aggregates_without_group_by(const std::string& sql, const std::vector<SqlToken>& tokens) {
+    size_t select = tokens.size();
+    size_t from = tokens.size();
+    for (size_t t = 0; t < tokens.size(); t++) {
+        const std::string& u = tokens[t].upper;
+        if (u == "GROUP" && t + 1 < tokens.size() && tokens[t + 1].upper == "BY") return false;
+        if (u == "SELECT" && select == tokens.size()) select = t;
+        if (u == "FROM" && select != tokens.size() && from == tokens.size()) from = t;
+    }
+    if (select == tokens.size()) return false;
+    const size_t begin = tokens[select].end;
+    const size_t end = from == tokens.size() ? sql.size() : tokens[from].begin;
+
+    static const char* const aggregates[] = {"COUNT", "SUM", "TOTAL", "AVG", "MIN", "MAX", "GROUP_CONCAT",
+                                             "STRING_AGG"};
+    size_t i = begin;
+    while (i < end) {
+        if (!std::isalpha(static_cast<unsigned char>(sql[i])) && sql[i] != '_') {
+            i++;
+            continue;
+        }
+        size_t start = i;
+        while (i < end && (std::isalnum(static_cast<unsigned char>(sql[i])) || sql[i] == '_')) i++;
+        std::string word = sql.substr(start, i - start);
+        for (char& ch : word) ch = static_cast<char>(std::toupper(static_cast<unsigned char>(ch)));
+        size_t k = i;
+        while (k < end && std::isspace(static_cast<unsigned char>(sql[k]))) k++;
+        if (k < end && sql[k] == '(') {
+            for (const char* agg : aggregates) {
+                if (word == agg) return true;
+            }
+        }
+    }
+    return false;
+}
+
+// Detect a query that can only match rows with one exact symbol name:
+// every top-level FROM/JOIN source is a name-filtered table and the WHERE
+// clause has a top-level conjunct `name = '<literal>'` (no OR). Aggregates
+// without GROUP BY are excluded, since they return a row for every PDB.
+inline bool exact_name_predicate(const std::string& sql, std::string& name) {
+    const std::vector<SqlToken> tokens = sql_top_level_tokens(sql);
+    if (aggregates_without_group_by(sql, tokens)) return false;
+
+    size_t where = tokens.size();
+    bool has_source = false;
+    bool in_from = false;
+    for (size_t t = 0; t < tokens.size(); t++) {
+        const std::string& u = tokens[t].upper;
+        if (u == "FROM" || u == "JOIN" || (u == "," && in_from)) {
+            if (t + 1 >= tokens.size() || !is_name_filtered_table(tokens[t + 1].upper)) return false;
+            has_source = true;
+            in_from = true;
+        } else if (u == "WHERE" || u == "GROUP" || u == "ORDER" || u == "LIMIT" || u == "HAVING") {
+            in_from = false;
+            if (u == "WHERE" && where == tokens.size()) where = t;
+        } else if (u == "OR" || u == "COLLATE" || u == "UNION" || u == "EXCEPT" || u == "INTERSECT") {
+            return false;
+        }
+    }
+    if (!has_source || where == tokens.size()) return false;
+
+    auto is_name_column = [](const std::string& u) {
+        size_t dot = u.rfind('.');
+        return (dot == std::string::npos ? u : u.substr(dot + 1)) == "NAME";
+    };
+    auto literal = [&sql](const SqlToken& tok) {
+        std::string out;
+        for (size_t i = tok.begin + 1; i + 1 < tok.end; i++) {
+            out += sql[i];
+            if (sql[i] == '\'' && sql[i + 1] == '\'') i++;
+        }
+        return out;
+    };
+
+    for (size_t t = where + 1; t < tokens.size(); t++) {
+        const std::string& u = tokens[t].upper;
+        if (u == "GROUP" || u == "ORDER" || u == "LIMIT" || u == "HAVING" || u == "WINDOW") break;
+
+        size_t eq = t + 1;
+        size_t rhs = eq + 1;
+        if (rhs < tokens.size() && tokens[eq].upper == "=" && tokens[rhs].upper == "=") rhs++;  // ==
+        if (eq >= tokens.size() || tokens[eq].upper != "=" || rhs >= tokens.size()) continue;
+
+        // Must be a whole conjunct: WHERE|AND <a> = <b> AND|<clause end>
+        const std::string& before = tokens[t - 1].upper;
+        if (before != "WHERE" && before != "AND") continue;
+        if (rhs + 1 < tokens.size()) {
+            const std::string& after = tokens[rhs + 1].upper;
+            if (after != "AND" && after != "GROUP" && after != "ORDER" && after != "LIMIT" &&
+                after != "HAVING" && after != "WINDOW") continue;
+        }
+
+        if (is_name_column(u) && tokens[rhs].upper == "'") {
+            name = literal(tokens[rhs]);
+            return true;
+        }
+        if (u == "'" && is_name_column(tokens[rhs].upper)) {
+            name = literal(tokens[t]);
+            return true;
+        }
+    }
+    return false;
+}
+
+// ============================================================================
+// Federated execution
+// ============================================================================
+
+// Run fn(i) for i in [0, count) on `jobs` threads (0 = all cores) until done or stop is set.
+inline void run_parallel(size_t count, unsigned jobs, std::atomic<bool>& stop,
+                         const std::function<void(size_t)>& fn) {
+    if (jobs == 0) jobs = (std::max)(1u, std::thread::hardware_concurrency());
+    jobs = static_cast<unsigned>((std::min<size_t>)(jobs, (std::max<size_t>)(count, 1)));
+
+    std::atomic<size_t> next{0};
+    auto worker = [&]() {
+        for (size_t i; !stop.load() && (i = next.fetch_add(1)) < count;) {
+            fn(i);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned t = 1; t < jobs; t++) {
+        threads.emplace_back([&worker] {
+            Tracer::name_thread("federate");
+            worker();
+        });
+    }
+    worker();
+    for (auto& t : threads) t.join();
+}
+
+// Open a PDB with its own session and tables and call fn(db). Safe to use
+// from any thread: nothing is shared with other sessions.
+inline bool with_pdb_database(const std::string& path, const std::function<void(xsql::Database&)>& fn,
+                              std::string& error) {
+    TraceSpan span("federate.pdb", "federate");
+    span.arg("path", path);
+    PdbSession session;
+    if (!session.open(path)) {
+        error = session.last_error();
+        return false;
+    }
+    auto registry = std::make_unique<TableRegistry>(session);
+    xsql::Database db;
+    registry->register_all(db);
+    fn(db);
+    return true;
+}
+
+// ============================================================================
+// Name filter sidecars
+// ============================================================================
+
+struct NameFilterBuildStats {
+    uint64_t pdbs = 0;
+    uint64_t built = 0;
+    uint64_t up_to_date = 0;
+    uint64_t names = 0;
+    std::vector<std::string> failures;
+    double seconds = 0.0;
+};
+
+// Build (or refresh stale) name filter sidecars for each PDB, in parallel.
+inline NameFilterBuildStats build_name_filters(const std::vector<std::string>& paths, unsigned jobs,
+                                               bool force = false) {
+    auto start = std::chrono::steady_clock::now();
+    NameFilterBuildStats stats;
+    stats.pdbs = paths.size();
+
+    std::atomic<uint64_t> built{0}, up_to_date{0}, names{0};
+    std::mutex failures_mutex;
+    std::atomic<bool> stop{false};
+
+    run_parallel(paths.size(), jobs, stop, [&](size_t i) {
+        const std::string& path = paths[i];
+        const std::string sidecar = NameBloomFilter::sidecar_path(path);
+        std::string error;
+
+        PdbFileStamp stamp;
+        if (!PdbFileStamp::of(path, stamp)) {
+            error = "Cannot stat file";
+        } else if (NameBloomFilter existing; !force && existing.load(sidecar, stamp)) {
+            up_to_date.fetch_add(1);
+            return;
+        } else {
+            std::vector<std::string> all;
+            bool opened = with_pdb_database(path, [&](xsql::Database& db) {
+                const char* sql = "SELECT name FROM publics UNION SELECT name FROM functions "
+                                  "UNION SELECT name FROM udts";
+                sqlite3_stmt* stmt = nullptr;
+                if (sqlite3_prepare_v2(db.handle(), sql, -1, &stmt, nullptr) != SQLITE_OK) {
+                    error = sqlite3_errmsg(db.handle());
+                    return;
+                }
+                while (sqlite3_step(stmt) == SQLITE_ROW) {
+                    const unsigned char* text = sqlite3_column_text(stmt, 0);
+                    if (text) all.emplace_back(reinterpret_cast<const char*>(text));
+                }
+                sqlite3_finalize(stmt);
+            }, error);
+
+            if (opened && error.empty()) {
+                NameBloomFilter filter(all.size());
+                for (const auto& name : all) filter.add(name);
+                if (filter.save(sidecar, stamp, error)) {
+                    built.fetch_add(1);
+                    names.fetch_add(all.size());
+                    return;
+                }
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(failures_mutex);
+        stats.failures.push_back(path + ": " + error);
+    });
+
+    stats.built = built.load();
+    stats.up_to_date = up_to_date.load();
+    stats.names = names.load();
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return stats;
+}
+
+// True unless the PDB's sidecar proves `name` is absent (missing/stale sidecars never skip).
+inline bool name_filter_may_contain(const std::string& pdb_path, const std::string& name) {
+    PdbFileStamp stamp;
+    if (!PdbFileStamp::of(pdb_path, stamp)) return true;
+    NameBloomFilter filter;
+    if (!filter.load(NameBloomFilter::sidecar_path(pdb_path), stamp)) return true;
+    return filter.may_contain(name);
+}
+
+// ============================================================================
+// Federated query
+// ============================================================================
+
+struct FederatedOptions {
+    unsigned jobs = 0;        // 0 = hardware concurrency
+    std::string merge_sql;    // Optional query over the `results` table
+    // Optional pre-filter: return false to skip a PDB without opening it
+    std::function<bool(const std::string& path)> should_query;
+    // Skip PDBs whose name filter sidecar rules out an exact `name = '...'`
+    bool use_name_filters = true;
+};
+
+struct FederatedResult {
+    bool success = false;
+    std::string error;
+    std::vector<std::string> columns;  // "pdb" first
+    std::vector<FederatedRow> rows;
+    std::vector<std::string> failures; // "path: message"
+    uint64_t pdbs_total = 0;
+    uint64_t pdbs_queried = 0;
+    uint64_t pdbs_skipped = 0;     // Ruled out without opening (name filters, should_query)
+    std::string filtered_name;     // Exact name used for sidecar pruning, if any
+    bool stopped_early = false;
+    double seconds = 0.0;
+};
+
+class FederatedQuery {
+public:
+    static FederatedResult run(const std::vector<std::string>& paths, const std::string& sql,
+                               const FederatedOptions& options) {
+        auto start = std::chrono::steady_clock::now();
+        FederatedResult result;
+        result.pdbs_total = paths.size();
+
+        const QueryShape shape = analyze_query_shape(sql);
+        const bool early_stop = shape.limit >= 0 && shape.order_by.empty() && options.merge_sql.empty();
+
+        std::string exact_name;
+        const bool prune = options.use_name_filters && exact_name_predicate(sql, exact_name);
+        if (prune) result.filtered_name = exact_name;
+
+        struct PerPdb {
+            std::vector<FederatedRow> rows;
+            std::vector<std::string> columns;
+            std::string error;
+            bool queried = false;
+            bool skipped = false;
+        };
+        std::vector<PerPdb> per_pdb(paths.size());
+
+        std::atomic<int64_t> collected{0};
+        std::atomic<bool> stop{false};
+
+        run_parallel(paths.size(), options.jobs, stop, [&](size_t i) {
+            PerPdb& out = per_pdb[i];
+            if ((options.should_query && !options.should_query(paths[i])) ||
+                (prune && !name_filter_may_contain(paths[i], exact_name))) {
+                out.skipped = true;
+                return;
+            }
+            out.queried = true;
+            query_one(paths[i], sql, out.columns, out.rows, out.error,
+                      early_stop ? shape.limit : -1, collected, stop);
+        });
+
+        // Merge in input order so output is stable across runs
+        for (size_t i = 0; i < paths.size(); i++) {
+            PerPdb& p = per_pdb[i];
+            if (p.skipped) result.pdbs_skipped++;
+            if (!p.queried) continue;
+            result.pdbs_queried++;
+            if (!p.error.empty()) {
+                result.failures.push_back(paths[i] + ": " + p.error);
+                continue;
+            }
+            if (result.columns.empty() && !p.columns.empty()) {
+                result.columns.push_back("pdb");
+                result.columns.insert(result.columns.end(), p.columns.begin(), p.columns.end());
+            }
+            for (auto& row : p.rows) {
+                FederatedRow merged;
+                merged.reserve(row.size() + 1);
+                merged.push_back(FederatedCell::text(paths[i]));
+                for (auto& cell : row) merged.push_back(std::move(cell));
+                result.rows.push_back(std::move(merged));
+            }
+        }
+        result.stopped_early = stop.load();
+        if (early_stop && result.rows.size() > static_cast<size_t>(shape.limit)) {
+            result.rows.resize(static_cast<size_t>(shape.limit));
+        }
+
+        result.success = true;
+        if (!options.merge_sql.empty()) {
+            merge(result, options.merge_sql);
+        } else if (shape.limit >= 0 && !shape.order_by.empty() && !result.columns.empty()) {
+            // Re-rank per-PDB top rows; keep them as-is if the terms don't resolve
+            FederatedResult ranked = result;
+            merge(ranked, "SELECT * FROM results ORDER BY " + unqualify(shape.order_by) +
+                          " LIMIT " + std::to_string(shape.limit));
+            if (ranked.success) result = std::move(ranked);
+        }
+
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return result;
+    }
+
+private:
+    // Run sql against one PDB. Rows are appended until done or the global limit is reached.
+    static void query_one(const std::string& path, const std::string& sql,
+                          std::vector<std::string>& columns, std::vector<FederatedRow>& rows,
+                          std::string& error, int64_t limit,
+                          std::atomic<int64_t>& collected, std::atomic<bool>& stop) {
+        with_pdb_database(path, [&](xsql::Database& db) {
+            sqlite3_stmt* stmt = nullptr;
+            if (sqlite3_prepare_v2(db.handle(), sql.c_str(), static_cast<int>(sql.size()), &stmt, nullptr) != SQLITE_OK) {
+                error = sqlite3_errmsg(db.handle());
+                if (stmt) sqlite3_finalize(stmt);
+                return;
+            }
+            if (!stmt) {
+                error = "Empty query";
+                return;
+            }
+
+            const int ncols = sqlite3_column_count(stmt);
+            for (int c = 0; c < ncols; c++) {
+                const char* name = sqlite3_column_name(stmt, c);
+                columns.push_back(name ? name : "");
+            }
+
+            int rc = SQLITE_DONE;
+            while (!stop.load(std::memory_order_relaxed) && (rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+                rows.push_back(read_row(stmt, ncols));
+                if (limit >= 0 && collected.fetch_add(1) + 1 >= limit) {
+                    stop.store(true);
+                    break;
+                }
+            }
+            if (!stop.load() && rc != SQLITE_DONE) {
+                error = sqlite3_errmsg(db.handle());
+            }
+            sqlite3_finalize(stmt);
+        }, error);
+    }
+
+    static FederatedRow read_row(sqlite3_stmt* stmt, int ncols) {
+        FederatedRow row;
+        row.reserve(static_cast<size_t>(ncols));
+        for (int c = 0; c < ncols; c++) {
+            switch (sqlite3_column_type(stmt, c)) {
+                case SQLITE_INTEGER:
+                    row.push_back(FederatedCell::integer(sqlite3_column_int64(stmt, c)));
+                    break;
+                case SQLITE_FLOAT:
+                    row.push_back(FederatedCell::real(sqlite3_column_double(stmt, c)));
+                    break;
+                case SQLITE_NULL:
+                    row.push_back(FederatedCell::null_value());
+                    break;
+                default: {
+                    const unsigned char* text = sqlite3_column_text(stmt, c);
+                    int len = sqlite3_column_bytes(stmt, c);
+                    row.push_back(FederatedCell::text(
+                        text ? std::string(reinterpret_cast<const char*>(text), static_cast<size_t>(len)) : ""));
+                    break;
+                }
+            }
+        }
+        return row;
+    }
+
+    // "f.length DESC, u.name" -> "length DESC, name" (merged columns are unqualified)
+    static std::string unqualify(const std::string& terms) {
+        std::string out;
+        size_t word_start = 0;
+        for (size_t i = 0; i < terms.size(); i++) {
+            char c = terms[i];
+            if (c == '.') {
+                out.resize(out.size() - (i - word_start));
+                word_start = i + 1;
+                continue;
+            }
+            if (!(std::isalnum(static_cast<unsigned char>(c)) || c == '_')) word_start = i + 1;
+            out += c;
+        }
+        return out;
+    }
+
+    static std::string quote_identifier(const std::string& name) {
+        std::string out = "\"";
+        for (char c : name) {
+            if (c == '"') out += '"';
+            out += c;
+        }
+        return out + "\"";
+    }
+
+    // Load rows into an in-memory `results` table and replace them with merge_sql's output.
+    static void merge(FederatedResult& result, const std::string& merge_sql) {
+        xsql::Database db;
+        sqlite3* h = db.handle();
+
+        std::vector<std::string> names;
+        std::string create = "CREATE TABLE results(";
+        std::string insert = "INSERT INTO results VALUES(";
+        for (size_t c = 0; c < result.columns.size(); c++) {
+            std::string name = result.columns[c].empty() ? "column" + std::to_string(c + 1) : result.columns[c];
+            std::string unique = name;
+            for (int k = 2; std::find(names.begin(), names.end(), unique) != names.end(); k++) {
+                unique = name + "_" + std::to_string(k);
+            }
+            names.push_back(unique);
+            create += (c ? ", " : "") + quote_identifier(unique);
+            insert += c ? ", ?" : "?";
+        }
+        if (names.empty()) {
+            create += "pdb";
+            insert += "?";
+        }
+        create += ")";
+        insert += ")";
+
+        std::string error;
+        if (db.exec(create.c_str(), nullptr, nullptr) != SQLITE_OK ||
+            db.exec("BEGIN", nullptr, nullptr) != SQLITE_OK) {
+            result.success = false;
+            result.error = db.last_error();
+            return;
+        }
+
+        sqlite3_stmt* ins = nullptr;
+        if (sqlite3_prepare_v2(h, insert.c_str(), -1, &ins, nullptr) != SQLITE_OK) {
+            result.success = false;
+            result.error = sqlite3_errmsg(h);
+            return;
+        }
+        for (const auto& row : result.rows) {
+            if (!bind_statement_params(ins, row, error) || sqlite3_step(ins) != SQLITE_DONE) {
+                result.success = false;
+                result.error = error.empty() ? sqlite3_errmsg(h) : error;
+                sqlite3_finalize(ins);
+                return;
+            }
+            sqlite3_reset(ins);
+            sqlite3_clear_bindings(ins);
+        }
+        sqlite3_finalize(ins);
+        db.exec("COMMIT", nullptr, nullptr);
+
+        sqlite3_stmt* stmt = nullptr;
+        if (sqlite3_prepare_v2(h, merge_sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK || !stmt) {
+            result.success = false;
+            result.error = std::string("Merge query: ") + sqlite3_errmsg(h);
+            if (stmt) sqlite3_finalize(stmt);
+            return;
+        }
+
+        const int ncols = sqlite3_column_count(stmt);
+        std::vector<std::string> columns;
+        for (int c = 0; c < ncols; c++) {
+            const char* name = sqlite3_column_name(stmt, c);
+            columns.push_back(name ? name : "");
+        }
+        std::vector<FederatedRow> rows;
+        int rc;
+        while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+            rows.push_back(read_row(stmt, ncols));
+        }
+        if (rc != SQLITE_DONE) {
+            result.success = false;
+            result.error = std::string("Merge query: ") + sqlite3_errmsg(h);
+            sqlite3_finalize(stmt);
+            return;
+        }
+        sqlite3_finalize(stmt);
+
+        result.columns = std::move(columns);
+        result.rows = std::move(rows);
+    }
+};
+
+} // namespace pdbsql
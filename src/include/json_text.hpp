@@ -0,0 +1,151 @@
+#pragma once
+// json_text.hpp - JSON string escaping shared by the JSON writers
+//
+// append_json_escaped() scans 16 bytes at a time (32 with AVX2) for '"', '\\',
+// control bytes and non-ASCII bytes, and copies clean runs in bulk. Non-ASCII
+// bytes are validated as UTF-8 in the same pass; invalid sequences become
+// \ufffd so the output is always valid JSON. Targets without SSE2 (ARM64)
+// take the scalar loop.
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define PDBSQL_JSON_AVX2 1
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PDBSQL_JSON_SSE2 1
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace pdbsql {
+
+namespace json_detail {
+
+inline unsigned count_trailing_zeros(uint32_t bits) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, bits);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctz(bits));
+#endif
+}
+
+// Bytes up to the first one that needs attention ('"', '\\', < 0x20 or >= 0x80).
+inline size_t clean_prefix(const unsigned char* p, size_t len) {
+    size_t i = 0;
+#if defined(PDBSQL_JSON_AVX2)
+    const __m256i quote32 = _mm256_set1_epi8('"');
+    const __m256i backslash32 = _mm256_set1_epi8('\\');
+    const __m256i space32 = _mm256_set1_epi8(0x20);
+    for (; i + 32 <= len; i += 32) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+        // Signed compare: bytes >= 0x80 are negative, so < 0x20 catches them too
+        __m256i hit = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(v, quote32), _mm256_cmpeq_epi8(v, backslash32)),
+                                      _mm256_cmpgt_epi8(space32, v));
+        uint32_t bits = static_cast<uint32_t>(_mm256_movemask_epi8(hit));
+        if (bits) return i + count_trailing_zeros(bits);
+    }
+#endif
+#if defined(PDBSQL_JSON_SSE2)
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i space = _mm_set1_epi8(0x20);
+    for (; i + 16 <= len; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+        __m128i hit = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, backslash)),
+                                   _mm_cmplt_epi8(v, space));
+        uint32_t bits = static_cast<uint32_t>(_mm_movemask_epi8(hit));
+        if (bits) return i + count_trailing_zeros(bits);
+    }
+#endif
+    for (; i < len; i++) {
+        unsigned char c = p[i];
+        if (c < 0x20 || c >= 0x80 || c == '"' || c == '\\') return i;
+    }
+    return len;
+}
+
+// Length of the well-formed UTF-8 sequence starting at p[0] (a byte >= 0x80),
+// or 0 if it is invalid, overlong, a surrogate or truncated.
+inline size_t utf8_sequence_length(const unsigned char* p, size_t avail) {
+    const unsigned char c = p[0];
+    auto cont = [p](size_t k) { return (p[k] & 0xC0) == 0x80; };
+    if (c >= 0xC2 && c <= 0xDF) {
+        return avail >= 2 && cont(1) ? 2 : 0;
+    }
+    if (c >= 0xE0 && c <= 0xEF) {
+        if (avail < 3 || !cont(1) || !cont(2)) return 0;
+        if (c == 0xE0 && p[1] < 0xA0) return 0;  // Overlong
+        if (c == 0xED && p[1] > 0x9F) return 0;  // Surrogate
+        return 3;
+    }
+    if (c >= 0xF0 && c <= 0xF4) {
+        if (avail < 4 || !cont(1) || !cont(2) || !cont(3)) return 0;
+        if (c == 0xF0 && p[1] < 0x90) return 0;  // Overlong
+        if (c == 0xF4 && p[1] > 0x8F) return 0;  // Above U+10FFFF
+        return 4;
+    }
+    return 0;
+}
+
+} // namespace json_detail
+
+// Append text[0, len) to out with JSON string escaping (no surrounding quotes).
+inline void append_json_escaped(std::string& out, const char* text, size_t len) {
+    static const char hex[] = "0123456789abcdef";
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(text);
+    size_t run = 0;  // Start of the pending clean run
+    size_t i = 0;
+    while (true) {
+        i += json_detail::clean_prefix(p + i, len - i);
+        if (i >= len) break;
+
+        const unsigned char c = p[i];
+        if (c >= 0x80) {
+            size_t n = json_detail::utf8_sequence_length(p + i, len - i);
+            if (n) {
+                i += n;  // Valid: stays in the run
+                continue;
+            }
+            out.append(text + run, i - run);
+            out += "\\ufffd";
+            run = ++i;
+            continue;
+        }
+
+        out.append(text + run, i - run);
+        switch (c) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default: {
+                const char esc[6] = {'\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xF]};
+                out.append(esc, sizeof(esc));
+            }
+        }
+        run = ++i;
+    }
+    out.append(text + run, len - run);
+}
+
+inline void append_json_escaped(std::string& out, const std::string& s) {
+    append_json_escaped(out, s.data(), s.size());
+}
+
+// Append s as a quoted JSON string.
+inline void append_json_string(std::string& out, const std::string& s) {
+    out += '"';
+    append_json_escaped(out, s);
+    out += '"';
+}
+
+} // namespace pdbsql
@@ -0,0 +1,476 @@
+#pragma once
+// materialize.hpp - Copy a PDB's tables into a native SQLite database (--materialize)
+//
+// Every TableRegistry table becomes a real table with the same columns and
+// declared types, so repeated analysis pays the DIA extraction cost once:
+//
+//   pdbsql foo.pdb --materialize foo.db
+//   sqlite3 foo.db "SELECT name, length FROM functions ORDER BY length DESC LIMIT 10"
+//
+// Extraction runs on `jobs` worker threads, each with its own PDB session
+// (DIA sessions are never shared across threads). Workers copy rows into
+// compact batches and hand them to the calling thread, the only writer,
+// which inserts them through one prepared statement per table inside a
+// single transaction. Indexes on id, name, rva and the *_id join keys are
+// built after the data is in, then ANALYZE. The PDB identity goes into
+// `pdbsql_metadata` (key, value).
+//
+// The database is written to <path>.tmp and renamed over <path> on success.
+
+#include "federated_query.hpp"
+#include "pdb_session.hpp"
+#include "pdb_tables.hpp"
+#include "trace.hpp"
+
+#include <xsql/database.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace pdbsql {
+
+struct MaterializeStats {
+    struct Table {
+        std::string name;
+        uint64_t rows = 0;
+    };
+    std::vector<Table> tables;
+    std::vector<std::string> indexes;
+    double seconds = 0.0;
+};
+
+class Materializer {
+public:
+    static constexpr size_t BATCH_ROWS = 4096;
+    static constexpr size_t MAX_QUEUED_BATCHES = 64;  // Bounds memory when the writer lags
+
+    Materializer(std::string pdb_path, std::string db_path, unsigned jobs)
+        : pdb_path_(std::move(pdb_path)), db_path_(std::move(db_path)), jobs_(jobs) {}
+
+    bool run(MaterializeStats& stats, std::string& error) {
+        TraceSpan span("materialize", "materialize");
+        span.arg("pdb", pdb_path_).arg("db", db_path_);
+        auto start = std::chrono::steady_clock::now();
+
+        if (!describe(error)) return false;
+
+        namespace fs = std::filesystem;
+        const fs::path final_path = fs::u8path(db_path_);
+        const fs::path tmp_path = fs::u8path(db_path_ + ".tmp");
+        std::error_code ec;
+        fs::remove(tmp_path, ec);
+
+        sqlite3* out = nullptr;
+        if (sqlite3_open(tmp_path.u8string().c_str(), &out) != SQLITE_OK) {
+            error = "Cannot create " + tmp_path.u8string() + ": " + sqlite3_errmsg(out);
+            sqlite3_close(out);
+            return false;
+        }
+
+        bool ok = write(out, stats, error);
+        if (sqlite3_close(out) != SQLITE_OK && ok) {
+            error = "Cannot close " + tmp_path.u8string();
+            ok = false;
+        }
+        if (!ok) {
+            fs::remove(tmp_path, ec);
+            return false;
+        }
+
+        fs::rename(tmp_path, final_path, ec);
+        if (ec) {
+            // Windows will not rename over an existing file
+            fs::remove(final_path, ec);
+            fs::rename(tmp_path, final_path, ec);
+        }
+        if (ec) {
+            error = "Cannot replace " + db_path_ + ": " + ec.message();
+            return false;
+        }
+
+        stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return true;
+    }
+
+private:
+    struct Column {
+        std::string name;
+        std::string type;  // Declared type (INTEGER, TEXT, ...)
+    };
+
+    struct Table {
+        std::string name;
+        std::vector<Column> columns;
+    };
+
+    // Rows of one table, cells stored flat; text lives in `text`.
+    struct Batch {
+        struct Cell {
+            int type = SQLITE_NULL;
+            int64_t i = 0;
+            double d = 0.0;
+            size_t offset = 0, length = 0;
+        };
+        size_t table = 0;
+        size_t rows = 0;
+        std::vector<Cell> cells;
+        std::string text;
+    };
+
+    std::string pdb_path_;
+    std::string db_path_;
+    unsigned jobs_;
+
+    std::vector<Table> tables_;
+    std::string signature_;
+    std::string guid_;
+    unsigned long age_ = 0;
+
+    // Worker -> writer queue
+    std::mutex mutex_;
+    std::condition_variable ready_;  // Batches queued or a worker finished
+    std::condition_variable space_;  // Writer took batches
+    std::deque<std::unique_ptr<Batch>> queue_;
+    unsigned running_ = 0;
+    std::atomic<bool> stop_{false};
+    std::string worker_error_;
+
+    static std::string quote(const std::string& ident) {
+        std::string out = "\"";
+        for (char c : ident) {
+            if (c == '"') out += '"';
+            out += c;
+        }
+        return out + "\"";
+    }
+
+    static bool exec(sqlite3* db, const std::string& sql, std::string& error) {
+        char* msg = nullptr;
+        if (sqlite3_exec(db, sql.c_str(), nullptr, nullptr, &msg) == SQLITE_OK) return true;
+        error = msg ? msg : sqlite3_errmsg(db);
+        sqlite3_free(msg);
+        return false;
+    }
+
+    // Table list, column types and PDB identity from a session on this thread.
+    bool describe(std::string& error) {
+        PdbSession session;
+        if (!session.open(pdb_path_)) {
+            error = session.last_error();
+            return false;
+        }
+        GUID guid = {};
+        DWORD age = 0;
+        if (session.identity(guid, age)) {
+            char buf[64];
+            snprintf(buf, sizeof(buf), "%08X-%04X-%04X-%02X%02X-%02X%02X%02X%02X%02X%02X",
+                     static_cast<unsigned>(guid.Data1), guid.Data2, guid.Data3,
+                     guid.Data4[0], guid.Data4[1], guid.Data4[2], guid.Data4[3],
+                     guid.Data4[4], guid.Data4[5], guid.Data4[6], guid.Data4[7]);
+            guid_ = buf;
+            age_ = age;
+            signature_ = format_pdb_signature(guid, age);
+        }
+
+        TableRegistry registry(session);
+        xsql::Database db;
+        registry.register_all(db);
+        for (const auto& name : registry.table_names()) {
+            sqlite3_stmt* stmt = nullptr;
+            std::string sql = "SELECT * FROM " + quote(name);
+            if (sqlite3_prepare_v2(db.handle(), sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+                error = name + ": " + sqlite3_errmsg(db.handle());
+                return false;
+            }
+            Table table;
+            table.name = name;
+            for (int c = 0; c < sqlite3_column_count(stmt); c++) {
+                const char* col = sqlite3_column_name(stmt, c);
+                const char* type = sqlite3_column_decltype(stmt, c);
+                table.columns.push_back({col ? col : "", type ? type : ""});
+            }
+            sqlite3_finalize(stmt);
+            tables_.push_back(std::move(table));
+        }
+        return true;
+    }
+
+    bool write(sqlite3* out, MaterializeStats& stats, std::string& error) {
+        // Nothing to recover on a crash: the .tmp file is simply discarded
+        if (!exec(out, "PRAGMA journal_mode=OFF; PRAGMA synchronous=OFF; PRAGMA locking_mode=EXCLUSIVE;"
+                       "PRAGMA cache_size=-262144; BEGIN", error)) {
+            return false;
+        }
+
+        std::vector<sqlite3_stmt*> inserts(tables_.size(), nullptr);
+        auto finalize_all = [&inserts] {
+            for (sqlite3_stmt* s : inserts) sqlite3_finalize(s);
+        };
+        for (size_t t = 0; t < tables_.size(); t++) {
+            const Table& table = tables_[t];
+            std::string create = "CREATE TABLE " + quote(table.name) + "(";
+            std::string insert = "INSERT INTO " + quote(table.name) + " VALUES(";
+            for (size_t c = 0; c < table.columns.size(); c++) {
+                if (c > 0) {
+                    create += ", ";
+                    insert += ',';
+                }
+                create += quote(table.columns[c].name);
+                if (!table.columns[c].type.empty()) create += " " + table.columns[c].type;
+                insert += '?';
+            }
+            create += ")";
+            insert += ")";
+            if (!exec(out, create, error) ||
+                sqlite3_prepare_v2(out, insert.c_str(), -1, &inserts[t], nullptr) != SQLITE_OK) {
+                if (error.empty()) error = sqlite3_errmsg(out);
+                finalize_all();
+                return false;
+            }
+            stats.tables.push_back({table.name, 0});
+        }
+
+        bool ok = copy_rows(out, inserts, stats, error);
+        finalize_all();
+        if (!ok) return false;
+
+        if (!create_indexes(out, stats, error)) return false;
+
+        if (!write_metadata(out, error)) return false;
+
+        TraceSpan span("materialize.commit", "materialize");
+        return exec(out, "COMMIT; ANALYZE", error);
+    }
+
+    bool write_metadata(sqlite3* out, std::string& error) {
+        sqlite3_stmt* insert = nullptr;
+        if (!exec(out, "CREATE TABLE pdbsql_metadata(key TEXT PRIMARY KEY, value TEXT)", error) ||
+            sqlite3_prepare_v2(out, "INSERT INTO pdbsql_metadata VALUES(?, ?)", -1, &insert, nullptr) != SQLITE_OK) {
+            if (error.empty()) error = sqlite3_errmsg(out);
+            return false;
+        }
+        bool ok = true;
+        auto add = [&](const char* key, const std::string& value) {
+            sqlite3_bind_text(insert, 1, key, -1, SQLITE_STATIC);
+            sqlite3_bind_text(insert, 2, value.c_str(), static_cast<int>(value.size()), SQLITE_TRANSIENT);
+            if (ok && sqlite3_step(insert) != SQLITE_DONE) {
+                error = sqlite3_errmsg(out);
+                ok = false;
+            }
+            sqlite3_reset(insert);
+        };
+
+        char created[32];
+        std::time_t now = std::time(nullptr);
+        std::tm tm{};
+#ifdef _WIN32
+        gmtime_s(&tm, &now);
+#else
+        gmtime_r(&now, &tm);
+#endif
+        strftime(created, sizeof(created), "%Y-%m-%dT%H:%M:%SZ", &tm);
+        add("pdb_path", pdb_path_);
+        add("guid", guid_);
+        add("age", std::to_string(age_));
+        add("signature", signature_);
+        add("created", created);
+        add("format_version", "1");
+        sqlite3_finalize(insert);
+        return ok;
+    }
+
+    // Start the extraction workers and insert their batches as they arrive.
+    bool copy_rows(sqlite3* out, const std::vector<sqlite3_stmt*>& inserts, MaterializeStats& stats,
+                   std::string& error) {
+        unsigned jobs = jobs_ ? jobs_ : (std::max)(1u, std::thread::hardware_concurrency());
+        jobs = static_cast<unsigned>((std::min<size_t>)(jobs, tables_.size()));
+
+        std::atomic<size_t> next{0};
+        running_ = jobs;
+        std::vector<std::thread> workers;
+        for (unsigned w = 0; w < jobs; w++) {
+            workers.emplace_back([this, &next] { extract(next); });
+        }
+
+        std::string write_error;
+        while (true) {
+            std::unique_ptr<Batch> batch;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                ready_.wait(lock, [this] { return !queue_.empty() || running_ == 0; });
+                if (queue_.empty()) break;
+                batch = std::move(queue_.front());
+                queue_.pop_front();
+            }
+            space_.notify_all();
+            if (!write_error.empty()) continue;  // Drain so workers can finish
+            if (!insert_batch(out, inserts[batch->table], *batch, write_error)) {
+                stop_.store(true);
+                continue;
+            }
+            stats.tables[batch->table].rows += batch->rows;
+        }
+        for (auto& t : workers) t.join();
+
+        if (!write_error.empty()) {
+            error = write_error;
+            return false;
+        }
+        if (!worker_error_.empty()) {
+            error = worker_error_;
+            return false;
+        }
+        return true;
+    }
+
+    // Worker thread: one PDB session, tables taken from `next` until none remain.
+    void extract(std::atomic<size_t>& next) {
+        Tracer::name_thread("materialize");
+        std::string error;
+        bool opened = with_pdb_database(pdb_path_, [&](xsql::Database& db) {
+            for (size_t t; !stop_.load() && (t = next.fetch_add(1)) < tables_.size();) {
+                if (!extract_table(db, t, error)) {
+                    stop_.store(true);
+                    break;
+                }
+            }
+        }, error);
+        if (!opened) stop_.store(true);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!error.empty() && worker_error_.empty()) worker_error_ = error;
+        running_--;
+        ready_.notify_one();
+    }
+
+    bool extract_table(xsql::Database& db, size_t t, std::string& error) {
+        const Table& table = tables_[t];
+        TraceSpan span("materialize.extract", "materialize");
+        span.arg("table", table.name);
+
+        sqlite3_stmt* stmt = nullptr;
+        std::string sql = "SELECT * FROM " + quote(table.name);
+        if (sqlite3_prepare_v2(db.handle(), sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+            error = table.name + ": " + sqlite3_errmsg(db.handle());
+            return false;
+        }
+
+        const int ncols = sqlite3_column_count(stmt);
+        auto batch = std::make_unique<Batch>();
+        batch->table = t;
+        int rc = SQLITE_DONE;
+        while (!stop_.load(std::memory_order_relaxed) && (rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+            for (int c = 0; c < ncols; c++) {
+                Batch::Cell cell;
+                cell.type = sqlite3_column_type(stmt, c);
+                switch (cell.type) {
+                    case SQLITE_INTEGER: cell.i = sqlite3_column_int64(stmt, c); break;
+                    case SQLITE_FLOAT: cell.d = sqlite3_column_double(stmt, c); break;
+                    case SQLITE_NULL: break;
+                    default: {
+                        const void* p = cell.type == SQLITE_BLOB ? sqlite3_column_blob(stmt, c)
+                                                                 : static_cast<const void*>(sqlite3_column_text(stmt, c));
+                        cell.length = static_cast<size_t>(sqlite3_column_bytes(stmt, c));
+                        cell.offset = batch->text.size();
+                        if (p) batch->text.append(static_cast<const char*>(p), cell.length);
+                        break;
+                    }
+                }
+                batch->cells.push_back(cell);
+            }
+            if (++batch->rows >= BATCH_ROWS) {
+                push(std::move(batch));
+                batch = std::make_unique<Batch>();
+                batch->table = t;
+            }
+        }
+        if (!stop_.load() && rc != SQLITE_DONE) {
+            error = table.name + ": " + sqlite3_errmsg(db.handle());
+            sqlite3_finalize(stmt);
+            return false;
+        }
+        sqlite3_finalize(stmt);
+        if (batch->rows > 0) push(std::move(batch));
+        return true;
+    }
+
+    void push(std::unique_ptr<Batch> batch) {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            space_.wait(lock, [this] { return queue_.size() < MAX_QUEUED_BATCHES || stop_.load(); });
+            if (stop_.load()) return;
+            queue_.push_back(std::move(batch));
+        }
+        ready_.notify_one();
+    }
+
+    static bool insert_batch(sqlite3* out, sqlite3_stmt* insert, const Batch& batch, std::string& error) {
+        const int ncols = sqlite3_bind_parameter_count(insert);
+        size_t i = 0;
+        for (size_t r = 0; r < batch.rows; r++) {
+            for (int c = 1; c <= ncols; c++, i++) {
+                const Batch::Cell& cell = batch.cells[i];
+                switch (cell.type) {
+                    case SQLITE_INTEGER: sqlite3_bind_int64(insert, c, cell.i); break;
+                    case SQLITE_FLOAT: sqlite3_bind_double(insert, c, cell.d); break;
+                    case SQLITE_NULL: sqlite3_bind_null(insert, c); break;
+                    case SQLITE_BLOB:
+                        sqlite3_bind_blob(insert, c, batch.text.data() + cell.offset,
+                                          static_cast<int>(cell.length), SQLITE_STATIC);
+                        break;
+                    default:
+                        sqlite3_bind_text(insert, c, batch.text.data() + cell.offset,
+                                          static_cast<int>(cell.length), SQLITE_STATIC);
+                        break;
+                }
+            }
+            if (sqlite3_step(insert) != SQLITE_DONE) {
+                error = sqlite3_errmsg(out);
+                sqlite3_reset(insert);
+                return false;
+            }
+            sqlite3_reset(insert);
+        }
+        return true;
+    }
+
+    // id, name, rva and *_id join keys on every table that has them
+    bool create_indexes(sqlite3* out, MaterializeStats& stats, std::string& error) {
+        TraceSpan span("materialize.index", "materialize");
+        for (const Table& table : tables_) {
+            for (const Column& col : table.columns) {
+                const std::string& c = col.name;
+                bool key = c == "id" || c == "name" || c == "rva" ||
+                           (c.size() > 3 && c.compare(c.size() - 3, 3, "_id") == 0);
+                if (!key) continue;
+                std::string index = table.name + "_" + c;
+                if (!exec(out, "CREATE INDEX " + quote(index) + " ON " + quote(table.name) + "(" + quote(c) + ")",
+                          error)) {
+                    return false;
+                }
+                stats.indexes.push_back(index);
+            }
+        }
+        return true;
+    }
+};
+
+inline bool materialize_pdb(const std::string& pdb_path, const std::string& db_path, unsigned jobs,
+                            MaterializeStats& stats, std::string& error) {
+    Materializer materializer(pdb_path, db_path, jobs);
+    return materializer.run(stats, error);
+}
+
+} // namespace pdbsql
@@ -0,0 +1,263 @@
+#pragma once
+// metrics.hpp - Process-wide counters and histograms (Prometheus text format)
+//
+// Hot paths only touch relaxed atomics: a vtable cursor bumps its table's
+// counters, a request observes one histogram. The registry mutex is taken
+// only to create a named series (once per table/route) and to render.
+//
+// Exposed by the HTTP servers as GET /metrics.
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace pdbsql {
+
+class MetricCounter {
+public:
+    void inc(uint64_t n = 1) { value_.fetch_add(n, std::memory_order_relaxed); }
+    uint64_t value() const { return value_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<uint64_t> value_{0};
+};
+
+class MetricGauge {
+public:
+    void set(int64_t v) { value_.store(v, std::memory_order_relaxed); }
+    void add(int64_t n) { value_.fetch_add(n, std::memory_order_relaxed); }
+    int64_t value() const { return value_.load(std::memory_order_relaxed); }
+
+private:
+    std::atomic<int64_t> value_{0};
+};
+
+// Latency histogram with fixed buckets from 100us to 30s.
+class LatencyHistogram {
+public:
+    static constexpr std::array<double, 14> BOUNDS = {
+        0.0001, 0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0, 5.0, 30.0
+    };
+
+    void observe(double seconds) {
+        size_t i = 0;
+        while (i < BOUNDS.size() && seconds > BOUNDS[i]) i++;
+        buckets_[i].fetch_add(1, std::memory_order_relaxed);
+        sum_ns_.fetch_add(static_cast<uint64_t>(seconds > 0 ? seconds * 1e9 : 0), std::memory_order_relaxed);
+    }
+
+    double sum_seconds() const { return static_cast<double>(sum_ns_.load(std::memory_order_relaxed)) / 1e9; }
+    uint64_t bucket(size_t i) const { return buckets_[i].load(std::memory_order_relaxed); }
+
+private:
+    std::array<std::atomic<uint64_t>, BOUNDS.size() + 1> buckets_{};  // Last = +Inf
+    std::atomic<uint64_t> sum_ns_{0};
+};
+
+// Observes the elapsed time into a histogram when it goes out of scope.
+class ScopedLatency {
+public:
+    explicit ScopedLatency(LatencyHistogram& histogram)
+        : histogram_(histogram), start_(std::chrono::steady_clock::now()) {}
+    ~ScopedLatency() {
+        histogram_.observe(std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count());
+    }
+
+    ScopedLatency(const ScopedLatency&) = delete;
+    ScopedLatency& operator=(const ScopedLatency&) = delete;
+
+private:
+    LatencyHistogram& histogram_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+// Per-vtable scan counters. Aggregated by table name across all open PDBs.
+struct TableScanMetrics {
+    std::string name;
+    MetricCounter full_scans;      // Cursors over the whole table
+    MetricCounter pushdown_scans;  // Cursors served by an xFilter pushdown
+    MetricCounter next_calls;      // Generator next() calls (rows + one per exhausted cursor)
+    MetricCounter rows;            // Rows produced
+};
+
+class Metrics {
+public:
+    static Metrics& global() {
+        static Metrics instance;
+        return instance;
+    }
+
+    // Named series; references stay valid for the life of the process.
+    TableScanMetrics& table(const std::string& name) { return get_or_create(tables_, name); }
+    LatencyHistogram& route(const std::string& name) { return get_or_create(routes_, name); }
+
+    // Server dispatcher
+    MetricGauge dispatcher_queue_depth;
+    MetricCounter dispatcher_jobs;
+    LatencyHistogram dispatcher_wait;  // Time from enqueue to start on the worker
+
+    // Prepared statement caches (all databases)
+    MetricCounter statement_cache_hits;
+    MetricCounter statement_cache_misses;
+
+    // Session pool
+    MetricCounter pool_hits;
+    MetricCounter pool_misses;
+    MetricCounter pool_evictions;
+    MetricGauge pool_open_pdbs;
+    MetricGauge pool_memory_bytes;
+
+    // Slow-query log (slow_query_log.hpp)
+    MetricCounter slow_queries;
+    MetricCounter slow_queries_dropped;  // Writer queue full
+
+    // Prometheus text exposition format (version 0.0.4)
+    std::string render() const {
+        std::string out;
+        out.reserve(8192);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        header(out, "pdbsql_table_scans_total", "Virtual table cursors opened, by plan", "counter");
+        for (const auto& [name, m] : tables_) {
+            sample(out, "pdbsql_table_scans_total", "table=\"" + name + "\",plan=\"full\"", m->full_scans.value());
+            sample(out, "pdbsql_table_scans_total", "table=\"" + name + "\",plan=\"pushdown\"", m->pushdown_scans.value());
+        }
+        header(out, "pdbsql_table_rows_total", "Rows produced by virtual tables", "counter");
+        for (const auto& [name, m] : tables_) {
+            sample(out, "pdbsql_table_rows_total", "table=\"" + name + "\"", m->rows.value());
+        }
+        header(out, "pdbsql_table_next_calls_total", "Generator next() calls", "counter");
+        for (const auto& [name, m] : tables_) {
+            sample(out, "pdbsql_table_next_calls_total", "table=\"" + name + "\"", m->next_calls.value());
+        }
+
+        header(out, "pdbsql_request_duration_seconds", "Request latency by route", "histogram");
+        for (const auto& [name, h] : routes_) {
+            histogram(out, "pdbsql_request_duration_seconds", "route=\"" + name + "\"", *h);
+        }
+
+        header(out, "pdbsql_dispatcher_queue_depth", "Jobs waiting for the query worker", "gauge");
+        sample(out, "pdbsql_dispatcher_queue_depth", "", dispatcher_queue_depth.value());
+        header(out, "pdbsql_dispatcher_jobs_total", "Jobs run on the query worker", "counter");
+        sample(out, "pdbsql_dispatcher_jobs_total", "", dispatcher_jobs.value());
+        header(out, "pdbsql_dispatcher_wait_seconds", "Time jobs spent queued", "histogram");
+        histogram(out, "pdbsql_dispatcher_wait_seconds", "", dispatcher_wait);
+
+        header(out, "pdbsql_statement_cache_lookups_total", "Prepared statement cache lookups", "counter");
+        sample(out, "pdbsql_statement_cache_lookups_total", "result=\"hit\"", statement_cache_hits.value());
+        sample(out, "pdbsql_statement_cache_lookups_total", "result=\"miss\"", statement_cache_misses.value());
+        header(out, "pdbsql_statement_cache_hit_ratio", "Prepared statement cache hit ratio", "gauge");
+        ratio(out, "pdbsql_statement_cache_hit_ratio", statement_cache_hits.value(), statement_cache_misses.value());
+
+        header(out, "pdbsql_pool_lookups_total", "Session pool lookups (miss = PDB opened)", "counter");
+        sample(out, "pdbsql_pool_lookups_total", "result=\"hit\"", pool_hits.value());
+        sample(out, "pdbsql_pool_lookups_total", "result=\"miss\"", pool_misses.value());
+        header(out, "pdbsql_pool_hit_ratio", "Session pool hit ratio", "gauge");
+        ratio(out, "pdbsql_pool_hit_ratio", pool_hits.value(), pool_misses.value());
+        header(out, "pdbsql_pool_evictions_total", "PDBs closed to stay under the memory budget", "counter");
+        sample(out, "pdbsql_pool_evictions_total", "", pool_evictions.value());
+        header(out, "pdbsql_pool_open_pdbs", "PDBs currently open in the pool", "gauge");
+        sample(out, "pdbsql_pool_open_pdbs", "", pool_open_pdbs.value());
+        header(out, "pdbsql_pool_memory_bytes", "Estimated memory held by open pooled PDBs", "gauge");
+        sample(out, "pdbsql_pool_memory_bytes", "", pool_memory_bytes.value());
+
+        header(out, "pdbsql_slow_queries_total", "Queries over the --slow-ms threshold, by outcome", "counter");
+        sample(out, "pdbsql_slow_queries_total", "result=\"logged\"", slow_queries.value());
+        sample(out, "pdbsql_slow_queries_total", "result=\"dropped\"", slow_queries_dropped.value());
+
+        header(out, "pdbsql_uptime_seconds", "Seconds since process start", "gauge");
+        char buf[64];
+        snprintf(buf, sizeof(buf), "pdbsql_uptime_seconds %.3f\n",
+                 std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count());
+        out += buf;
+        return out;
+    }
+
+private:
+    Metrics() : start_(std::chrono::steady_clock::now()) {}
+
+    mutable std::mutex mutex_;
+    std::map<std::string, std::unique_ptr<TableScanMetrics>> tables_;
+    std::map<std::string, std::unique_ptr<LatencyHistogram>> routes_;
+    std::chrono::steady_clock::time_point start_;
+
+    template<typename T>
+    T& get_or_create(std::map<std::string, std::unique_ptr<T>>& map, const std::string& name) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto& slot = map[name];
+        if (!slot) {
+            slot = std::make_unique<T>();
+            name_series(*slot, name);
+        }
+        return *slot;
+    }
+
+    static void name_series(TableScanMetrics& m, const std::string& name) { m.name = name; }
+    static void name_series(LatencyHistogram&, const std::string&) {}
+
+    static void header(std::string& out, const char* name, const char* help, const char* type) {
+        out += "# HELP ";
+        out += name;
+        out += ' ';
+        out += help;
+        out += "\n# TYPE ";
+        out += name;
+        out += ' ';
+        out += type;
+        out += '\n';
+    }
+
+    template<typename V>
+    static void sample(std::string& out, const char* name, const std::string& labels, V value) {
+        out += name;
+        if (!labels.empty()) {
+            out += '{';
+            out += labels;
+            out += '}';
+        }
+        out += ' ';
+        out += std::to_string(value);
+        out += '\n';
+    }
+
+    static void ratio(std::string& out, const char* name, uint64_t hits, uint64_t misses) {
+        char buf[128];
+        double total = static_cast<double>(hits + misses);
+        snprintf(buf, sizeof(buf), "%s %.6f\n", name, total > 0 ? static_cast<double>(hits) / total : 0.0);
+        out += buf;
+    }
+
+    static void histogram(std::string& out, const char* name, const std::string& labels,
+                          const LatencyHistogram& h) {
+        const std::string prefix = labels.empty() ? "" : labels + ",";
+        const std::string bucket = std::string(name) + "_bucket";
+        uint64_t cumulative = 0;
+        char le[32];
+        for (size_t i = 0; i < LatencyHistogram::BOUNDS.size(); i++) {
+            cumulative += h.bucket(i);
+            snprintf(le, sizeof(le), "%g", LatencyHistogram::BOUNDS[i]);
+            sample(out, bucket.c_str(), prefix + "le=\"" + le + "\"", cumulative);
+        }
+        cumulative += h.bucket(LatencyHistogram::BOUNDS.size());
+        sample(out, bucket.c_str(), prefix + "le=\"+Inf\"", cumulative);
+
+        char buf[64];
+        snprintf(buf, sizeof(buf), "%.6f", h.sum_seconds());
+        out += name;
+        out += "_sum";
+        if (!labels.empty()) out += "{" + labels + "}";
+        out += ' ';
+        out += buf;
+        out += '\n';
+        sample(out, (std::string(name) + "_count").c_str(), labels, cumulative);  // Consistent with +Inf
+    }
+};
+
+} // namespace pdbsql
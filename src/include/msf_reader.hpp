@@ -0,0 +1,218 @@
+#pragma once
+// msf_reader.hpp - Minimal portable PDB (MSF 7.00) header reader
+//
+// Identifies a PDB (GUID, age, signature) without DIA by reading only the
+// superblock, the stream directory and the first block of the PDB info
+// stream (1) and DBI stream (3). Used for symbol-store indexing, where
+// opening every PDB through DIA would be far too slow.
+
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <vector>
+
+namespace pdbsql {
+
+// Identity of a PDB as recorded in its headers
+struct PdbHeaderInfo {
+    uint8_t guid[16] = {};   // On-disk GUID layout (Data1..Data3 little-endian)
+    uint32_t age = 0;        // DBI age when present (what debuggers match), else info stream age
+    uint32_t signature = 0;  // Legacy time-stamp signature
+    uint32_t version = 0;    // PDB info stream version (e.g. 20000404)
+    uint64_t file_size = 0;
+};
+
+namespace msf {
+
+inline uint32_t read_u32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+inline uint16_t read_u16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+constexpr char MAGIC[] = "Microsoft C/C++ MSF 7.00\r\n\x1a" "DS\0\0";
+constexpr size_t MAGIC_SIZE = 32;
+constexpr size_t SUPERBLOCK_SIZE = 56;
+constexpr uint32_t NIL_STREAM_SIZE = 0xFFFFFFFFu;
+constexpr uint32_t PDB_INFO_STREAM = 1;
+constexpr uint32_t DBI_STREAM = 3;
+
+} // namespace msf
+
+// Symbol-server style signature: GUID (no dashes) followed by age, upper-case hex.
+// Same format as format_pdb_signature() for DIA GUIDs.
+inline std::string format_guid_age(const uint8_t guid[16], uint32_t age) {
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%08X%04X%04X%02X%02X%02X%02X%02X%02X%02X%02X%X",
+             static_cast<unsigned>(msf::read_u32(guid)),
+             static_cast<unsigned>(msf::read_u16(guid + 4)),
+             static_cast<unsigned>(msf::read_u16(guid + 6)),
+             guid[8], guid[9], guid[10], guid[11], guid[12], guid[13], guid[14], guid[15],
+             static_cast<unsigned>(age));
+    return buf;
+}
+
+// Parse a GUID+age signature (32 hex digits + 1..8 hex digits of age).
+inline bool parse_guid_age(const std::string& text, uint8_t guid[16], uint32_t& age) {
+    if (text.size() < 33 || text.size() > 40) return false;
+
+    auto hex = [](char c) -> int {
+        if (c >= '0' && c <= '9') return c - '0';
+        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+        return -1;
+    };
+    auto parse = [&](size_t pos, size_t len, uint64_t& out) -> bool {
+        out = 0;
+        for (size_t i = pos; i < pos + len; i++) {
+            int v = hex(text[i]);
+            if (v < 0) return false;
+            out = (out << 4) | static_cast<uint64_t>(v);
+        }
+        return true;
+    };
+
+    uint64_t data1, data2, data3, age_value;
+    if (!parse(0, 8, data1) || !parse(8, 4, data2) || !parse(12, 4, data3)) return false;
+    if (!parse(32, text.size() - 32, age_value)) return false;
+
+    for (int i = 0; i < 4; i++) guid[i] = static_cast<uint8_t>(data1 >> (8 * i));
+    for (int i = 0; i < 2; i++) guid[4 + i] = static_cast<uint8_t>(data2 >> (8 * i));
+    for (int i = 0; i < 2; i++) guid[6 + i] = static_cast<uint8_t>(data3 >> (8 * i));
+    for (int i = 0; i < 8; i++) {
+        uint64_t b;
+        if (!parse(16 + 2 * static_cast<size_t>(i), 2, b)) return false;
+        guid[8 + i] = static_cast<uint8_t>(b);
+    }
+    age = static_cast<uint32_t>(age_value);
+    return true;
+}
+
+// Read the identity of a PDB from its MSF headers.
+inline bool read_pdb_header(const std::string& path, PdbHeaderInfo& info, std::string& error) {
+    namespace fs = std::filesystem;
+    info = PdbHeaderInfo{};
+
+    std::error_code ec;
+    fs::path file_path = fs::u8path(path);
+    uint64_t file_size = fs::file_size(file_path, ec);
+    if (ec) {
+        error = "Cannot stat: " + path;
+        return false;
+    }
+    info.file_size = file_size;
+
+    std::ifstream in(file_path, std::ios::binary);
+    if (!in) {
+        error = "Cannot open: " + path;
+        return false;
+    }
+
+    auto read_at = [&in, file_size](uint64_t offset, void* buf, size_t size) -> bool {
+        if (offset > file_size || size > file_size - offset) return false;
+        in.seekg(static_cast<std::streamoff>(offset));
+        in.read(static_cast<char*>(buf), static_cast<std::streamsize>(size));
+        return static_cast<size_t>(in.gcount()) == size;
+    };
+
+    uint8_t sb[msf::SUPERBLOCK_SIZE];
+    if (!read_at(0, sb, sizeof(sb)) || std::memcmp(sb, msf::MAGIC, msf::MAGIC_SIZE) != 0) {
+        error = "Not an MSF 7.00 PDB: " + path;
+        return false;
+    }
+
+    const uint32_t block_size = msf::read_u32(sb + 32);
+    const uint32_t num_blocks = msf::read_u32(sb + 40);
+    const uint32_t dir_bytes = msf::read_u32(sb + 44);
+    const uint32_t block_map_addr = msf::read_u32(sb + 52);
+
+    if (block_size != 512 && block_size != 1024 && block_size != 2048 && block_size != 4096 &&
+        block_size != 8192 && block_size != 16384 && block_size != 32768) {
+        error = "Invalid MSF block size: " + path;
+        return false;
+    }
+    if (block_map_addr >= num_blocks || dir_bytes == 0) {
+        error = "Corrupt MSF superblock: " + path;
+        return false;
+    }
+
+    // Block map: the list of blocks holding the stream directory
+    const uint32_t dir_block_count = (dir_bytes + block_size - 1) / block_size;
+    if (static_cast<uint64_t>(dir_block_count) * 4 > block_size) {
+        error = "Stream directory too large: " + path;
+        return false;
+    }
+    std::vector<uint8_t> block_map(static_cast<size_t>(dir_block_count) * 4);
+    if (!read_at(static_cast<uint64_t>(block_map_addr) * block_size, block_map.data(), block_map.size())) {
+        error = "Truncated MSF block map: " + path;
+        return false;
+    }
+
+    std::vector<uint8_t> dir(static_cast<size_t>(dir_block_count) * block_size);
+    for (uint32_t i = 0; i < dir_block_count; i++) {
+        uint32_t block = msf::read_u32(block_map.data() + 4 * i);
+        if (block >= num_blocks ||
+            !read_at(static_cast<uint64_t>(block) * block_size, dir.data() + static_cast<size_t>(i) * block_size, block_size)) {
+            error = "Truncated MSF stream directory: " + path;
+            return false;
+        }
+    }
+    dir.resize(dir_bytes);
+
+    // Directory: num_streams, stream sizes[], then the block list of each stream
+    const uint32_t num_streams = msf::read_u32(dir.data());
+    if (num_streams <= msf::PDB_INFO_STREAM || 4 + static_cast<uint64_t>(num_streams) * 4 > dir.size()) {
+        error = "Corrupt MSF stream directory: " + path;
+        return false;
+    }
+
+    auto stream_size = [&](uint32_t stream) -> uint32_t {
+        return msf::read_u32(dir.data() + 4 + 4 * static_cast<size_t>(stream));
+    };
+    auto stream_blocks = [&](uint32_t stream) -> uint32_t {
+        uint32_t size = stream_size(stream);
+        return size == msf::NIL_STREAM_SIZE ? 0 : (size + block_size - 1) / block_size;
+    };
+
+    // Read the first `size` bytes of a stream (they fit in its first block)
+    auto read_stream_head = [&](uint32_t stream, uint8_t* buf, size_t size) -> bool {
+        if (stream >= num_streams) return false;
+        uint32_t ssize = stream_size(stream);
+        if (ssize == msf::NIL_STREAM_SIZE || ssize < size) return false;
+        uint64_t pos = 4 + static_cast<uint64_t>(num_streams) * 4;
+        for (uint32_t s = 0; s < stream; s++) pos += static_cast<uint64_t>(stream_blocks(s)) * 4;
+        if (pos + 4 > dir.size()) return false;
+        uint32_t block = msf::read_u32(dir.data() + pos);
+        if (block >= num_blocks) return false;
+        return read_at(static_cast<uint64_t>(block) * block_size, buf, size);
+    };
+
+    // PDB info stream: version, signature, age, GUID
+    uint8_t pdbi[28];
+    if (!read_stream_head(msf::PDB_INFO_STREAM, pdbi, sizeof(pdbi))) {
+        error = "Missing PDB info stream: " + path;
+        return false;
+    }
+    info.version = msf::read_u32(pdbi);
+    info.signature = msf::read_u32(pdbi + 4);
+    info.age = msf::read_u32(pdbi + 8);
+    std::memcpy(info.guid, pdbi + 12, 16);
+
+    // DBI stream header: version signature, version header, age
+    uint8_t dbi[12];
+    if (read_stream_head(msf::DBI_STREAM, dbi, sizeof(dbi)) && msf::read_u32(dbi) == 0xFFFFFFFFu) {
+        info.age = msf::read_u32(dbi + 8);
+    }
+
+    return true;
+}
+
+} // namespace pdbsql
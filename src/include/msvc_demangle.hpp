@@ -0,0 +1,1053 @@
+#pragma once
+// msvc_demangle.hpp - Portable MSVC name undecorator
+//
+// Turns MSVC C++ decorated names ("?name@scope@@YAHH@Z") and the x86 C forms
+// (_name@N, @name@N, name@@N) back into declarations, in the style of
+// UnDecorateSymbolName / DIA's undecorated names. No Windows API, so it also
+// runs where DIA is not available. Flags use the UNDNAME_* values.
+//
+// Names that are not decorated, or use encodings not handled here, are
+// returned unchanged (undecorate() reports false), as undname does.
+// UndecorateCache memoizes results (LRU) for repeated lookups from SQL.
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace pdbsql {
+
+// Same values as UNDNAME_* in dbghelp.h
+enum UndecorateFlags : unsigned {
+    UNDECORATE_COMPLETE = 0x0000,
+    UNDECORATE_NO_MS_KEYWORDS = 0x0002,         // __cdecl, __ptr64, ...
+    UNDECORATE_NO_FUNCTION_RETURNS = 0x0004,
+    UNDECORATE_NO_ACCESS_SPECIFIERS = 0x0080,   // public:, private:, ...
+    UNDECORATE_NO_MEMBER_TYPE = 0x0200,         // static, virtual
+    UNDECORATE_NAME_ONLY = 0x1000,              // Qualified name only
+};
+
+namespace demangle_detail {
+
+enum Quals : unsigned { Q_NONE = 0, Q_CONST = 1, Q_VOLATILE = 2 };
+
+struct TypeNode {
+    enum Kind { Simple, Pointer, Function, Array } kind = Simple;
+    std::string text;           // Simple: type name; Function: calling convention
+    std::string member_of;      // Pointer: class of a pointer to member
+    unsigned quals = Q_NONE;    // Of this value (for pointers: of the pointer)
+    const char* ptr = "*";      // Pointer: "*", "&" or "&&"
+    bool ptr64 = false;
+    int child = -1;             // Pointee, return type or element type
+    std::vector<int> params;    // Function
+    bool variadic = false;
+    unsigned this_quals = Q_NONE;   // Function: const/volatile member function
+    const char* ref_qual = "";      // Function: "&" or "&&"
+    bool this_ptr64 = false;
+    std::string dims;           // Array: "[2][3]"
+};
+
+inline const char* calling_convention(char c) {
+    switch (c) {
+        case 'A': case 'B': return "__cdecl";
+        case 'C': case 'D': return "__pascal";
+        case 'E': case 'F': return "__thiscall";
+        case 'G': case 'H': return "__stdcall";
+        case 'I': case 'J': return "__fastcall";
+        case 'M': case 'N': return "__clrcall";
+        case 'O': case 'P': return "__eabi";
+        case 'Q': return "__vectorcall";
+        case 'S': return "__swift_1";
+        case 'W': return "__regcall";
+        default: return nullptr;
+    }
+}
+
+inline const char* primitive_type(char c) {
+    switch (c) {
+        case 'C': return "signed char";
+        case 'D': return "char";
+        case 'E': return "unsigned char";
+        case 'F': return "short";
+        case 'G': return "unsigned short";
+        case 'H': return "int";
+        case 'I': return "unsigned int";
+        case 'J': return "long";
+        case 'K': return "unsigned long";
+        case 'M': return "float";
+        case 'N': return "double";
+        case 'O': return "long double";
+        case 'X': return "void";
+        default: return nullptr;
+    }
+}
+
+inline const char* extended_type(char c) {
+    switch (c) {
+        case 'D': return "__int8";
+        case 'E': return "unsigned __int8";
+        case 'F': return "__int16";
+        case 'G': return "unsigned __int16";
+        case 'H': return "__int32";
+        case 'I': return "unsigned __int32";
+        case 'J': return "__int64";
+        case 'K': return "unsigned __int64";
+        case 'L': return "__int128";
+        case 'M': return "unsigned __int128";
+        case 'N': return "bool";
+        case 'Q': return "char8_t";
+        case 'S': return "char16_t";
+        case 'U': return "char32_t";
+        case 'W': return "wchar_t";
+        default: return nullptr;
+    }
+}
+
+// ?0 .. ?_V (and ?__L, ?__M). Nullptr for the ones with their own syntax.
+inline const char* operator_name(char c, bool underscore) {
+    if (!underscore) {
+        switch (c) {
+            case '2': return "operator new";
+            case '3': return "operator delete";
+            case '4': return "operator=";
+            case '5': return "operator>>";
+            case '6': return "operator<<";
+            case '7': return "operator!";
+            case '8': return "operator==";
+            case '9': return "operator!=";
+            case 'A': return "operator[]";
+            case 'C': return "operator->";
+            case 'D': return "operator*";
+            case 'E': return "operator++";
+            case 'F': return "operator--";
+            case 'G': return "operator-";
+            case 'H': return "operator+";
+            case 'I': return "operator&";
+            case 'J': return "operator->*";
+            case 'K': return "operator/";
+            case 'L': return "operator%";
+            case 'M': return "operator<";
+            case 'N': return "operator<=";
+            case 'O': return "operator>";
+            case 'P': return "operator>=";
+            case 'Q': return "operator,";
+            case 'R': return "operator()";
+            case 'S': return "operator~";
+            case 'T': return "operator^";
+            case 'U': return "operator|";
+            case 'V': return "operator&&";
+            case 'W': return "operator||";
+            case 'X': return "operator*=";
+            case 'Y': return "operator+=";
+            case 'Z': return "operator-=";
+            default: return nullptr;
+        }
+    }
+    switch (c) {
+        case '0': return "operator/=";
+        case '1': return "operator%=";
+        case '2': return "operator>>=";
+        case '3': return "operator<<=";
+        case '4': return "operator&=";
+        case '5': return "operator|=";
+        case '6': return "operator^=";
+        case '7': return "`vftable'";
+        case '8': return "`vbtable'";
+        case '9': return "`vcall'";
+        case 'A': return "`typeof'";
+        case 'B': return "`local static guard'";
+        case 'D': return "`vbase destructor'";
+        case 'E': return "`vector deleting destructor'";
+        case 'F': return "`default constructor closure'";
+        case 'G': return "`scalar deleting destructor'";
+        case 'H': return "`vector constructor iterator'";
+        case 'I': return "`vector destructor iterator'";
+        case 'J': return "`vector vbase constructor iterator'";
+        case 'K': return "`virtual displacement map'";
+        case 'L': return "`eh vector constructor iterator'";
+        case 'M': return "`eh vector destructor iterator'";
+        case 'N': return "`eh vector vbase constructor iterator'";
+        case 'O': return "`copy constructor closure'";
+        case 'S': return "`local vftable'";
+        case 'T': return "`local vftable constructor closure'";
+        case 'U': return "operator new[]";
+        case 'V': return "operator delete[]";
+        case 'X': return "`placement delete closure'";
+        case 'Y': return "`placement delete[] closure'";
+        default: return nullptr;
+    }
+}
+
+// Recursive-descent parser over one decorated name. Nodes live in a vector
+// owned by the parser; the back-reference tables are fixed arrays of ten
+// entries as in the encoding itself.
+class Demangler {
+    std::string_view in_;
+    size_t pos_ = 0;
+    unsigned flags_ = 0;
+    bool error_ = false;
+
+    // Nesting limit for types and type names (nested symbols inherit the
+    // depth); deeper input fails instead of exhausting the stack
+    static constexpr int MAX_DEPTH = 256;
+    int depth_ = 0;
+
+    struct DepthGuard {
+        Demangler& d;
+        explicit DepthGuard(Demangler& owner) : d(owner) {
+            if (++d.depth_ > MAX_DEPTH) d.fail();
+        }
+        ~DepthGuard() { d.depth_--; }
+        DepthGuard(const DepthGuard&) = delete;
+        DepthGuard& operator=(const DepthGuard&) = delete;
+    };
+
+    std::vector<TypeNode> nodes_;
+    struct Backrefs {
+        std::string names[10];
+        size_t name_count = 0;
+        int params[10] = {};
+        size_t param_count = 0;
+    };
+    Backrefs refs_;
+
+    // Names whose printed form comes from the enclosing scope or the type
+    enum class Special { None, Ctor, Dtor, Conversion };
+
+    bool keywords() const { return !(flags_ & UNDECORATE_NO_MS_KEYWORDS); }
+
+    bool eof() const { return pos_ >= in_.size(); }
+    char peek(size_t ahead = 0) const { return pos_ + ahead < in_.size() ? in_[pos_ + ahead] : '\0'; }
+    bool consume(char c) {
+        if (peek() != c) return false;
+        pos_++;
+        return true;
+    }
+    bool consume(std::string_view s) {
+        if (in_.substr(pos_, s.size()) != s) return false;
+        pos_ += s.size();
+        return true;
+    }
+    char next() {
+        if (eof()) {
+            error_ = true;
+            return '\0';
+        }
+        return in_[pos_++];
+    }
+    void fail() { error_ = true; }
+
+    int add_node(TypeNode node) {
+        nodes_.push_back(std::move(node));
+        return static_cast<int>(nodes_.size() - 1);
+    }
+
+    int simple(std::string text, unsigned quals = Q_NONE) {
+        TypeNode n;
+        n.kind = TypeNode::Simple;
+        n.text = std::move(text);
+        n.quals = quals;
+        return add_node(std::move(n));
+    }
+
+    // <number> ::= [?] <digit>         (1..10)
+    //            | [?] <hex A-P>* @
+    int64_t number() {
+        const bool negative = consume('?');
+        const char c = peek();
+        if (c >= '0' && c <= '9') {
+            pos_++;
+            return negative ? -(c - '0' + 1) : (c - '0' + 1);
+        }
+        uint64_t value = 0;
+        while (!eof() && peek() != '@') {
+            const char h = next();
+            if (h < 'A' || h > 'P') {
+                fail();
+                return 0;
+            }
+            value = value * 16 + static_cast<uint64_t>(h - 'A');
+        }
+        if (!consume('@')) fail();
+        return negative ? -static_cast<int64_t>(value) : static_cast<int64_t>(value);
+    }
+
+    // <simple name> ::= <identifier> @
+    std::string_view identifier() {
+        const size_t at = in_.find('@', pos_);
+        if (at == std::string_view::npos || at == pos_) {
+            fail();
+            return {};
+        }
+        std::string_view id = in_.substr(pos_, at - pos_);
+        pos_ = at + 1;
+        return id;
+    }
+
+    void memorize(const std::string& name) {
+        for (size_t i = 0; i < refs_.name_count; i++) {
+            if (refs_.names[i] == name) return;
+        }
+        if (refs_.name_count < 10) refs_.names[refs_.name_count++] = name;
+    }
+
+    std::string name_backref() {
+        const size_t i = static_cast<size_t>(next() - '0');
+        if (i >= refs_.name_count) {
+            fail();
+            return {};
+        }
+        return refs_.names[i];
+    }
+
+    // ?$ <name> <template args> @   (own back-reference scope)
+    std::string template_name(Special* special) {
+        Backrefs outer = std::move(refs_);
+        refs_ = Backrefs{};
+
+        std::string name;
+        if (peek() == '?') {
+            pos_++;
+            name = operator_piece(special);
+        } else {
+            name = std::string(identifier());
+            memorize(name);
+        }
+        name += '<';
+        name += template_args();
+        if (!name.empty() && name.back() == '>') name += ' ';
+        name += '>';
+
+        refs_ = std::move(outer);
+        return name;
+    }
+
+    std::string template_args() {
+        std::string out;
+        bool first = true;
+        while (!error_ && !consume('@')) {
+            if (eof()) {
+                fail();
+                break;
+            }
+            std::string arg;
+            if (consume("$$V") || consume("$$Z") || consume("$$$V") || consume("$S")) {
+                continue;  // Empty pack / pack separator
+            } else if (consume("$0")) {
+                arg = std::to_string(number());
+            } else if (consume("$1") || consume("$E")) {
+                if (peek() == '?') {
+                    Demangler inner(in_.substr(pos_), UNDECORATE_NAME_ONLY);
+                    inner.depth_ = depth_;
+                    std::string sym;
+                    const size_t used = inner.parse(sym);
+                    if (!used) {
+                        fail();
+                        break;
+                    }
+                    pos_ += used;
+                    arg = "&" + sym;
+                } else if (consume('0')) {
+                    arg = "nullptr";
+                } else {
+                    fail();
+                    break;
+                }
+            } else if (consume("$$T")) {
+                arg = "std::nullptr_t";
+            } else {
+                const int t = type(Mode::Drop);
+                if (error_) break;
+                arg = print(t, std::string());
+            }
+            if (!first) out += ',';
+            out += arg;
+            first = false;
+        }
+        return out;
+    }
+
+    // After '?' in a name position: operators, structors and specials
+    std::string operator_piece(Special* special) {
+        const char c = next();
+        if (c == '0' || c == '1') {
+            if (special) *special = c == '0' ? Special::Ctor : Special::Dtor;
+            return std::string();
+        }
+        if (c == 'B') {
+            if (special) *special = Special::Conversion;
+            return "operator";
+        }
+        if (c == '_') {
+            const char d = next();
+            if (d == '_') {
+                const char e = next();
+                if (e == 'L') return "operator co_await";
+                if (e == 'M') return "operator<=>";
+                if (e == 'E' || e == 'F') {
+                    const char* what = e == 'E' ? "`dynamic initializer for '" : "`dynamic atexit destructor for '";
+                    std::string target;
+                    if (peek() == '?') {
+                        Demangler inner(in_.substr(pos_), flags_);
+                        inner.depth_ = depth_;
+                        const size_t used = inner.parse(target);
+                        if (!used) {
+                            fail();
+                            return {};
+                        }
+                        pos_ += used;
+                        consume('@');
+                    } else {
+                        target = std::string(identifier());
+                    }
+                    return what + target + "''";
+                }
+                fail();
+                return {};
+            }
+            if (const char* op = operator_name(d, true)) return op;
+            fail();
+            return {};
+        }
+        if (const char* op = operator_name(c, false)) return op;
+        fail();
+        return {};
+    }
+
+    // First component of a symbol name (not memorized unless simple)
+    std::string unqualified_symbol_name(Special* special) {
+        const char c = peek();
+        if (c >= '0' && c <= '9') return name_backref();
+        if (consume("?$")) return template_name(special);
+        if (consume('?')) return operator_piece(special);
+        std::string name(identifier());
+        memorize(name);
+        return name;
+    }
+
+    // Scope components after the first, up to the terminating '@'
+    std::string scope_piece() {
+        const char c = peek();
+        if (c >= '0' && c <= '9') return name_backref();
+        if (consume("?$")) {
+            std::string name = template_name(nullptr);
+            memorize(name);
+            return name;
+        }
+        if (consume("?A")) {
+            // Anonymous namespace: ?A0x<hash>@
+            identifier();
+            memorize("`anonymous namespace'");
+            return "`anonymous namespace'";
+        }
+        if (peek() == '?' && (peek(1) == '?' || (peek(1) >= '0' && peek(1) <= '9') || (peek(1) >= 'A' && peek(1) <= 'P'))) {
+            // Local scope: ?<number>?<nested symbol>  ->  `nested'::`n'
+            pos_++;
+            const int64_t n = number();
+            if (!consume('?')) {
+                fail();
+                return {};
+            }
+            Demangler inner(in_.substr(pos_), flags_ & ~UNDECORATE_NAME_ONLY);
+            inner.depth_ = depth_;
+            std::string nested;
+            const size_t used = inner.parse(nested);
+            if (!used) {
+                fail();
+                return {};
+            }
+            pos_ += used;
+            return "`" + nested + "'::`" + std::to_string(n) + "'";
+        }
+        std::string name(identifier());
+        memorize(name);
+        return name;
+    }
+
+    // Components are mangled innermost first; returns them outermost first
+    std::vector<std::string> qualified_name(std::string first) {
+        std::vector<std::string> parts;
+        parts.push_back(std::move(first));
+        while (!error_ && !consume('@')) {
+            if (eof()) {
+                fail();
+                break;
+            }
+            parts.push_back(scope_piece());
+        }
+        return {parts.rbegin(), parts.rend()};
+    }
+
+    static std::string join(const std::vector<std::string>& parts) {
+        std::string out;
+        for (size_t i = 0; i < parts.size(); i++) {
+            if (i) out += "::";
+            out += parts[i];
+        }
+        return out;
+    }
+
+    // Class/struct/union/enum name in a type position
+    std::string type_name() {
+        DepthGuard guard(*this);
+        if (error_) return {};
+        std::string first;
+        const char c = peek();
+        if (c >= '0' && c <= '9') {
+            first = name_backref();
+        } else if (consume("?$")) {
+            first = template_name(nullptr);
+            memorize(first);
+        } else {
+            first = std::string(identifier());
+            memorize(first);
+        }
+        return join(qualified_name(std::move(first)));
+    }
+
+    unsigned qualifier_char(bool* member = nullptr) {
+        const char c = next();
+        if (member) *member = c >= 'Q' && c <= 'T';
+        switch (c) {
+            case 'A': case 'Q': return Q_NONE;
+            case 'B': case 'R': return Q_CONST;
+            case 'C': case 'S': return Q_VOLATILE;
+            case 'D': case 'T': return Q_CONST | Q_VOLATILE;
+            default: fail(); return Q_NONE;
+        }
+    }
+
+    // __ptr64 / __restrict / __unaligned after a pointer code
+    bool pointer_ext() {
+        bool ptr64 = false;
+        while (true) {
+            if (consume('E')) ptr64 = true;
+            else if (!consume('I') && !consume('F')) break;
+        }
+        return ptr64;
+    }
+
+    enum class Mode { Drop, Mangle, Result };
+
+    int function_type(bool with_this) {
+        DepthGuard guard(*this);
+        if (error_) return -1;
+        TypeNode fn;
+        fn.kind = TypeNode::Function;
+        if (with_this) {
+            fn.this_ptr64 = pointer_ext();
+            if (consume('G')) fn.ref_qual = "&";
+            else if (consume('H')) fn.ref_qual = "&&";
+            fn.this_quals = qualifier_char();
+        }
+        const char* cc = calling_convention(next());
+        if (!cc) {
+            fail();
+            return -1;
+        }
+        fn.text = cc;
+        if (consume('@')) {
+            fn.child = -1;  // Structor: no return type
+        } else {
+            fn.child = type(Mode::Result);
+        }
+        params(fn);
+        // Throw specification
+        if (!consume('Z') && !consume("_E")) fail();
+        return add_node(std::move(fn));
+    }
+
+    void params(TypeNode& fn) {
+        if (consume('X')) return;  // (void)
+        while (!error_) {
+            if (consume('@')) return;
+            if (consume('Z')) {
+                fn.variadic = true;
+                return;
+            }
+            if (eof()) {
+                fail();
+                return;
+            }
+            const char c = peek();
+            if (c >= '0' && c <= '9') {
+                pos_++;
+                const size_t i = static_cast<size_t>(c - '0');
+                if (i >= refs_.param_count) {
+                    fail();
+                    return;
+                }
+                fn.params.push_back(refs_.params[i]);
+                continue;
+            }
+            const size_t start = pos_;
+            const int t = type(Mode::Drop);
+            if (error_) return;
+            fn.params.push_back(t);
+            if (pos_ - start > 1 && refs_.param_count < 10) refs_.params[refs_.param_count++] = t;
+        }
+    }
+
+    int pointer(const char* kind, unsigned quals) {
+        DepthGuard guard(*this);
+        if (error_) return -1;
+        TypeNode p;
+        p.kind = TypeNode::Pointer;
+        p.ptr = kind;
+        p.quals = quals;
+        if (consume('6')) {
+            p.child = function_type(false);
+            return add_node(std::move(p));
+        }
+        if (consume('8')) {
+            p.member_of = type_name();
+            p.child = function_type(true);
+            return add_node(std::move(p));
+        }
+        p.ptr64 = pointer_ext();
+        bool member = false;
+        const unsigned pointee_quals = qualifier_char(&member);
+        if (member) p.member_of = type_name();
+        p.child = type(Mode::Drop);
+        if (p.child >= 0) nodes_[static_cast<size_t>(p.child)].quals |= pointee_quals;
+        return add_node(std::move(p));
+    }
+
+    int type(Mode mode) {
+        DepthGuard guard(*this);
+        unsigned quals = Q_NONE;
+        if (mode == Mode::Mangle || (mode == Mode::Result && consume('?'))) {
+            quals = qualifier_char();
+        }
+        if (error_) return -1;
+
+        if (consume("$$C")) {
+            const unsigned q = qualifier_char();
+            const int t = type(Mode::Drop);
+            if (t >= 0) nodes_[static_cast<size_t>(t)].quals |= q | quals;
+            return t;
+        }
+        if (consume("$$Q")) return pointer("&&", quals);
+        if (consume("$$R")) return pointer("&&", quals | Q_VOLATILE);
+        if (consume("$$T")) return simple("std::nullptr_t", quals);
+        if (consume("$$A6")) return function_type(false);
+        if (consume("$$A8@@")) return function_type(true);
+
+        const char c = next();
+        if (error_) return -1;
+        if (const char* prim = primitive_type(c)) return simple(prim, quals);
+        switch (c) {
+            case '_': {
+                const char* ext = extended_type(next());
+                if (!ext) {
+                    fail();
+                    return -1;
+                }
+                return simple(ext, quals);
+            }
+            case 'T': return simple("union " + type_name(), quals);
+            case 'U': return simple("struct " + type_name(), quals);
+            case 'V': return simple("class " + type_name(), quals);
+            case 'W': {
+                next();  // Underlying type, '4' for int
+                return simple("enum " + type_name(), quals);
+            }
+            case 'A': return pointer("&", quals);
+            case 'B': return pointer("&", quals | Q_VOLATILE);
+            case 'P': return pointer("*", quals);
+            case 'Q': return pointer("*", quals | Q_CONST);
+            case 'R': return pointer("*", quals | Q_VOLATILE);
+            case 'S': return pointer("*", quals | Q_CONST | Q_VOLATILE);
+            case 'Y': {
+                TypeNode a;
+                a.kind = TypeNode::Array;
+                const int64_t rank = number();
+                for (int64_t i = 0; i < rank && !error_; i++) {
+                    a.dims += '[';
+                    a.dims += std::to_string(number());
+                    a.dims += ']';
+                }
+                unsigned elem_quals = Q_NONE;
+                if (consume("$$C")) elem_quals = qualifier_char();
+                a.child = type(Mode::Drop);
+                if (a.child >= 0) nodes_[static_cast<size_t>(a.child)].quals |= elem_quals;
+                a.quals = quals;
+                return add_node(std::move(a));
+            }
+            default:
+                fail();
+                return -1;
+        }
+    }
+
+    static void append_quals(std::string& out, unsigned quals) {
+        if (quals & Q_CONST) out += " const";
+        if (quals & Q_VOLATILE) out += " volatile";
+    }
+
+    std::string params_text(const TypeNode& fn) {
+        std::string out = "(";
+        if (fn.params.empty() && !fn.variadic) {
+            out += "void";
+        } else {
+            for (size_t i = 0; i < fn.params.size(); i++) {
+                if (i) out += ',';
+                out += print(fn.params[i], std::string());
+            }
+            if (fn.variadic) out += fn.params.empty() ? "..." : ",...";
+        }
+        out += ')';
+        return out;
+    }
+
+    std::string function_suffix(const TypeNode& fn) {
+        std::string out;
+        append_quals(out, fn.this_quals);
+        if (fn.this_ptr64 && keywords()) out += " __ptr64";
+        if (*fn.ref_qual) {
+            out += ' ';
+            out += fn.ref_qual;
+        }
+        return out;
+    }
+
+    // Type t around declarator decl ("" for an abstract type)
+    std::string print(int t, std::string decl) {
+        if (t < 0) return decl;
+        const TypeNode& n = nodes_[static_cast<size_t>(t)];
+        switch (n.kind) {
+            case TypeNode::Simple: {
+                std::string out = n.text;
+                append_quals(out, n.quals);
+                if (!decl.empty()) {
+                    out += ' ';
+                    out += decl;
+                }
+                return out;
+            }
+            case TypeNode::Pointer: {
+                std::string p;
+                if (!n.member_of.empty()) p = n.member_of + "::";
+                p += n.ptr;
+                if (n.ptr64 && keywords()) p += " __ptr64";
+                append_quals(p, n.quals);
+                if (!decl.empty()) {
+                    p += ' ';
+                    p += decl;
+                }
+                const TypeNode::Kind pointee = n.child >= 0 ? nodes_[static_cast<size_t>(n.child)].kind
+                                                            : TypeNode::Simple;
+                if (pointee == TypeNode::Function) {
+                    const TypeNode& fn = nodes_[static_cast<size_t>(n.child)];
+                    std::string inner = "(";
+                    if (keywords()) {
+                        inner += fn.text;
+                        if (!n.member_of.empty()) inner += ' ';  // "(__cdecl C::*)", but "(__cdecl*)"
+                    }
+                    inner += p;
+                    inner += ')';
+                    return print_function(n.child, inner);
+                }
+                if (pointee == TypeNode::Array) return print(n.child, "(" + p + ")");
+                return print(n.child, p);
+            }
+            case TypeNode::Function:
+                return print_function(t, keywords() ? n.text + decl : decl);
+            case TypeNode::Array:
+                return print(n.child, decl + n.dims);
+        }
+        return decl;
+    }
+
+    std::string print_function(int t, const std::string& decl) {
+        const TypeNode& fn = nodes_[static_cast<size_t>(t)];
+        std::string d = decl + params_text(fn) + function_suffix(fn);
+        if (fn.child < 0) return d;
+        return print(fn.child, d);
+    }
+
+    std::string access_prefix(char c) {
+        if (flags_ & UNDECORATE_NO_ACCESS_SPECIFIERS) return {};
+        switch (c) {
+            case 'A': case 'B': case 'C': case 'D': case 'E': case 'F': case 'G': case 'H': return "private: ";
+            case 'I': case 'J': case 'K': case 'L': case 'M': case 'N': case 'O': case 'P': return "protected: ";
+            case 'Q': case 'R': case 'S': case 'T': case 'U': case 'V': case 'W': case 'X': return "public: ";
+            default: return {};
+        }
+    }
+
+    // Everything after the qualified name of a '?' symbol
+    std::string encoding(const std::vector<std::string>& parts, Special special) {
+        std::vector<std::string> names = parts;
+        if (special == Special::Ctor || special == Special::Dtor) {
+            if (names.size() < 2) {
+                fail();
+                return {};
+            }
+            names.back() = (special == Special::Dtor ? "~" : "") + names[names.size() - 2];
+        }
+        std::string name = join(names);
+
+        const char c = next();
+        if (error_) return {};
+
+        // Variables
+        if (c >= '0' && c <= '4') {
+            std::string prefix;
+            if (c <= '2') {
+                prefix = access_prefix(c == '0' ? 'A' : c == '1' ? 'I' : 'Q');
+                if (!(flags_ & UNDECORATE_NO_MEMBER_TYPE)) prefix += "static ";
+            }
+            const int t = type(Mode::Drop);
+            if (error_) return {};
+            // No references into nodes_ across type_name(): it can add nodes
+            if (nodes_[static_cast<size_t>(t)].kind == TypeNode::Pointer) {
+                if (pointer_ext() && keywords()) nodes_[static_cast<size_t>(t)].ptr64 = true;
+                bool member = false;
+                const unsigned q = qualifier_char(&member);
+                if (member) type_name();
+                const int child = nodes_[static_cast<size_t>(t)].child;
+                if (child >= 0) nodes_[static_cast<size_t>(child)].quals |= q;
+            } else {
+                pointer_ext();
+                nodes_[static_cast<size_t>(t)].quals |= qualifier_char();
+            }
+            if (flags_ & UNDECORATE_NAME_ONLY) return name;
+            return prefix + print(t, name);
+        }
+
+        // vftable / vbtable / RTTI locators
+        if (c == '6' || c == '7') {
+            const unsigned q = qualifier_char();
+            std::string out;
+            if (!(flags_ & UNDECORATE_NAME_ONLY)) append_quals(out, q);
+            if (!out.empty()) out = out.substr(1) + " ";
+            out += name;
+            if (!consume('@')) {
+                out += "{for `";
+                bool first = true;
+                while (!error_ && !consume('@')) {
+                    if (!first) out += "'s `";
+                    out += type_name();
+                    first = false;
+                }
+                out += "'}";
+            }
+            return out;
+        }
+        if (c == '8') return name;
+
+        // Functions
+        bool with_this = true;
+        bool is_static = false;
+        bool is_virtual = false;
+        bool thunk = false;
+        switch (c) {
+            case 'C': case 'D': case 'K': case 'L': case 'S': case 'T':
+                is_static = true;
+                with_this = false;
+                break;
+            case 'E': case 'F': case 'M': case 'N': case 'U': case 'V':
+                is_virtual = true;
+                break;
+            case 'G': case 'H': case 'O': case 'P': case 'W': case 'X':
+                is_virtual = true;
+                thunk = true;
+                break;
+            case 'Y': case 'Z':
+                with_this = false;
+                break;
+            case 'A': case 'B': case 'I': case 'J': case 'Q': case 'R':
+                break;
+            default:
+                fail();
+                return {};
+        }
+        int64_t adjust = 0;
+        if (thunk) adjust = number();
+
+        const int fn = function_type(with_this);
+        if (error_) return {};
+        if (flags_ & UNDECORATE_NAME_ONLY) {
+            if (special == Special::Conversion) {
+                return name + " " + print(nodes_[static_cast<size_t>(fn)].child, std::string());
+            }
+            return name;
+        }
+
+        std::string out;
+        if (thunk) out += "[thunk]:";
+        out += access_prefix(c);
+        if (!(flags_ & UNDECORATE_NO_MEMBER_TYPE)) {
+            if (is_static) out += "static ";
+            if (is_virtual) out += "virtual ";
+        }
+
+        TypeNode& f = nodes_[static_cast<size_t>(fn)];
+        if (special == Special::Conversion) {
+            name += ' ';
+            name += print(f.child, std::string());
+            f.child = -1;
+        }
+        if (thunk) name += "`adjustor{" + std::to_string(adjust) + "}' ";
+        std::string decl;
+        if (keywords()) {
+            decl += f.text;
+            decl += ' ';
+        }
+        decl += name;
+        if (flags_ & UNDECORATE_NO_FUNCTION_RETURNS) f.child = -1;
+        return out + print_function(fn, decl);
+    }
+
+    // "??_R0" type descriptors and friends
+    bool rtti(std::string& out) {
+        if (consume("?_R0")) {
+            const int t = type(Mode::Result);
+            if (error_ || !consume("@8")) return false;
+            out = print(t, std::string()) + " `RTTI Type Descriptor'";
+            return true;
+        }
+        if (consume("?_R1")) {
+            int64_t v[4];
+            for (int64_t& x : v) x = number();
+            std::string cls = type_name();
+            if (error_ || !consume('8')) return false;
+            out = cls + "::`RTTI Base Class Descriptor at (" + std::to_string(v[0]) + "," + std::to_string(v[1]) +
+                  "," + std::to_string(v[2]) + "," + std::to_string(v[3]) + ")'";
+            return true;
+        }
+        const char* what = nullptr;
+        if (consume("?_R2")) what = "::`RTTI Base Class Array'";
+        else if (consume("?_R3")) what = "::`RTTI Class Hierarchy Descriptor'";
+        else if (consume("?_R4")) what = "::`RTTI Complete Object Locator'";
+        if (!what) return false;
+        std::string cls = type_name();
+        if (error_) return false;
+        if (consume("6B")) {
+            consume('@');
+            out = "const " + cls + what;
+        } else {
+            consume('8');
+            out = cls + what;
+        }
+        return true;
+    }
+
+public:
+    Demangler(std::string_view in, unsigned flags) : in_(in), flags_(flags) {}
+
+    // Parse a '?' symbol at the start of the input. Returns the number of
+    // characters consumed, or 0 on failure.
+    size_t parse(std::string& out) {
+        if (!consume('?')) return 0;
+        if (peek() == '?' && peek(1) == '@') {
+            out = std::string(in_);  // MD5-hashed name
+            return in_.size();
+        }
+        if (consume("?_C@_")) {
+            out = "`string'";
+            return in_.size();
+        }
+        if (peek() == '?' && peek(1) == '_' && peek(2) == 'R' && peek(3) >= '0' && peek(3) <= '4') {
+            return rtti(out) && !error_ ? pos_ : 0;
+        }
+
+        Special special = Special::None;
+        std::string first = unqualified_symbol_name(&special);
+        if (error_) return 0;
+        std::vector<std::string> parts = qualified_name(std::move(first));
+        if (error_) return 0;
+        out = encoding(parts, special);
+        return error_ ? 0 : pos_;
+    }
+};
+
+// _name@N (stdcall), @name@N (fastcall), name@@N (vectorcall)
+inline bool undecorate_c_name(std::string_view in, std::string& out) {
+    auto all_digits = [](std::string_view s) {
+        if (s.empty()) return false;
+        for (char c : s) {
+            if (c < '0' || c > '9') return false;
+        }
+        return true;
+    };
+    size_t at = in.rfind('@');
+    if (at == std::string_view::npos || at == 0 || !all_digits(in.substr(at + 1))) return false;
+    if (at >= 2 && in[at - 1] == '@' && in[0] != '_' && in[0] != '@') {
+        out = std::string(in.substr(0, at - 1));  // vectorcall
+        return !out.empty();
+    }
+    if (in[0] != '_' && in[0] != '@') return false;
+    out = std::string(in.substr(1, at - 1));
+    return !out.empty() && out.find('@') == std::string::npos;
+}
+
+} // namespace demangle_detail
+
+// Undecorate `mangled` into out. Returns false (and copies the input) when
+// the name is not decorated or not understood.
+inline bool undecorate(std::string_view mangled, unsigned flags, std::string& out) {
+    if (!mangled.empty() && mangled[0] == '?') {
+        demangle_detail::Demangler d(mangled, flags);
+        std::string result;
+        if (d.parse(result) == mangled.size()) {
+            out = std::move(result);
+            return true;
+        }
+    } else if (demangle_detail::undecorate_c_name(mangled, out)) {
+        return true;
+    }
+    out.assign(mangled.data(), mangled.size());
+    return false;
+}
+
+inline std::string undecorate(std::string_view mangled, unsigned flags = UNDECORATE_COMPLETE) {
+    std::string out;
+    undecorate(mangled, flags, out);
+    return out;
+}
+
+// LRU cache of undecorate() results keyed by (flags, name). Not thread-safe:
+// one per database connection, like the other per-session caches.
+class UndecorateCache {
+    struct Entry {
+        std::string key;
+        std::string value;
+    };
+    size_t capacity_;
+    std::list<Entry> lru_;  // Most recent first
+    std::unordered_map<std::string_view, std::list<Entry>::iterator> index_;
+    std::string key_;       // Scratch for lookups
+
+public:
+    explicit UndecorateCache(size_t capacity = 65536) : capacity_(capacity ? capacity : 1) {}
+
+    const std::string& get(std::string_view mangled, unsigned flags) {
+        key_.clear();
+        key_.append(reinterpret_cast<const char*>(&flags), sizeof(flags));
+        key_.append(mangled.data(), mangled.size());
+
+        auto it = index_.find(key_);
+        if (it != index_.end()) {
+            lru_.splice(lru_.begin(), lru_, it->second);
+            return it->second->value;
+        }
+
+        if (lru_.size() >= capacity_) {
+            index_.erase(lru_.back().key);
+            lru_.pop_back();
+        }
+        lru_.push_front(Entry{key_, undecorate(mangled, flags)});
+        index_.emplace(lru_.front().key, lru_.begin());
+        return lru_.front().value;
+    }
+
+    size_t size() const { return lru_.size(); }
+};
+
+} // namespace pdbsql
@@ -0,0 +1,183 @@
+#pragma once
+// name_filter.hpp - Per-PDB Bloom filter sidecars over symbol names
+//
+// A sidecar (<pdb>.pdbsql-names) holds a Bloom filter of the public,
+// function and UDT names in one PDB, ~10 bits per name (~1% false
+// positives). Federated queries with an exact `name = '...'` predicate
+// consult it to skip PDBs that cannot contain the name without opening
+// them. A sidecar is ignored when the PDB's size or timestamp changed.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+namespace pdbsql {
+
+// Identifies the PDB contents a sidecar was built from
+struct PdbFileStamp {
+    uint64_t size = 0;
+    int64_t mtime = 0;
+
+    static bool of(const std::string& path, PdbFileStamp& stamp) {
+        namespace fs = std::filesystem;
+        std::error_code ec;
+        fs::path p = fs::u8path(path);
+        stamp.size = fs::file_size(p, ec);
+        if (ec) return false;
+        auto t = fs::last_write_time(p, ec);
+        if (ec) return false;
+        stamp.mtime = static_cast<int64_t>(t.time_since_epoch().count());
+        return true;
+    }
+
+    bool operator==(const PdbFileStamp& o) const { return size == o.size && mtime == o.mtime; }
+};
+
+class NameBloomFilter {
+public:
+    static constexpr const char* SIDECAR_SUFFIX = ".pdbsql-names";
+
+    static std::string sidecar_path(const std::string& pdb_path) {
+        return pdb_path + SIDECAR_SUFFIX;
+    }
+
+    NameBloomFilter() = default;
+
+    // Size for `expected` names at `bits_per_name` bits each.
+    explicit NameBloomFilter(size_t expected, double bits_per_name = 10.0) {
+        uint64_t bits = static_cast<uint64_t>(std::ceil(static_cast<double>(expected ? expected : 1) * bits_per_name));
+        bits = (bits + 63) & ~uint64_t(63);
+        words_.assign(static_cast<size_t>(bits / 64), 0);
+        hashes_ = static_cast<uint32_t>((std::max)(1.0, std::round(bits_per_name * 0.6931)));
+    }
+
+    void add(std::string_view name) {
+        uint64_t h1, h2;
+        hash(name, h1, h2);
+        const uint64_t nbits = bit_count();
+        for (uint32_t i = 0; i < hashes_; i++) {
+            uint64_t bit = (h1 + i * h2) % nbits;
+            words_[static_cast<size_t>(bit >> 6)] |= uint64_t(1) << (bit & 63);
+        }
+    }
+
+    // False = definitely absent. True = possibly present.
+    bool may_contain(std::string_view name) const {
+        if (words_.empty()) return true;
+        uint64_t h1, h2;
+        hash(name, h1, h2);
+        const uint64_t nbits = bit_count();
+        for (uint32_t i = 0; i < hashes_; i++) {
+            uint64_t bit = (h1 + i * h2) % nbits;
+            if (!(words_[static_cast<size_t>(bit >> 6)] & (uint64_t(1) << (bit & 63)))) return false;
+        }
+        return true;
+    }
+
+    uint64_t bit_count() const { return static_cast<uint64_t>(words_.size()) * 64; }
+    uint32_t hash_count() const { return hashes_; }
+
+    // Written to <path>.tmp and renamed, so readers never see a partial file
+    bool save(const std::string& path, const PdbFileStamp& stamp, std::string& error) const {
+        namespace fs = std::filesystem;
+        const fs::path final_path = fs::u8path(path);
+        fs::path tmp_path = final_path;
+        tmp_path += ".tmp";
+        {
+            std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+            if (!out) {
+                error = "Cannot write " + path;
+                return false;
+            }
+            Header h{};
+            std::memcpy(h.magic, MAGIC, sizeof(h.magic));
+            h.version = VERSION;
+            h.hashes = hashes_;
+            h.words = words_.size();
+            h.pdb_size = stamp.size;
+            h.pdb_mtime = stamp.mtime;
+            out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+            out.write(reinterpret_cast<const char*>(words_.data()),
+                      static_cast<std::streamsize>(words_.size() * sizeof(uint64_t)));
+            if (!out) {
+                error = "Failed writing " + path;
+                return false;
+            }
+        }
+
+        std::error_code ec;
+        fs::rename(tmp_path, final_path, ec);
+        if (ec) {
+            fs::remove(final_path, ec);
+            fs::rename(tmp_path, final_path, ec);
+        }
+        if (ec) {
+            fs::remove(tmp_path, ec);
+            error = "Cannot replace " + path;
+            return false;
+        }
+        return true;
+    }
+
+    // Load a sidecar; fails if it is missing, corrupt or built from a different file.
+    bool load(const std::string& path, const PdbFileStamp& stamp) {
+        std::ifstream in(std::filesystem::u8path(path), std::ios::binary);
+        if (!in) return false;
+        Header h{};
+        in.read(reinterpret_cast<char*>(&h), sizeof(h));
+        if (in.gcount() != static_cast<std::streamsize>(sizeof(h)) ||
+            std::memcmp(h.magic, MAGIC, sizeof(h.magic)) != 0 || h.version != VERSION ||
+            h.pdb_size != stamp.size || h.pdb_mtime != stamp.mtime ||
+            h.hashes == 0 || h.hashes > 32 || h.words == 0 || h.words > (uint64_t(1) << 28)) {
+            return false;
+        }
+        std::vector<uint64_t> words(static_cast<size_t>(h.words));
+        in.read(reinterpret_cast<char*>(words.data()), static_cast<std::streamsize>(words.size() * sizeof(uint64_t)));
+        if (!in) return false;
+        words_ = std::move(words);
+        hashes_ = h.hashes;
+        return true;
+    }
+
+private:
+    static constexpr char MAGIC[8] = {'P', 'D', 'B', 'S', 'Q', 'L', 'B', 'F'};
+    static constexpr uint32_t VERSION = 1;
+
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t hashes;
+        uint64_t words;
+        uint64_t pdb_size;
+        int64_t pdb_mtime;
+    };
+    static_assert(sizeof(Header) == 40, "sidecar header layout");
+
+    std::vector<uint64_t> words_;
+    uint32_t hashes_ = 0;
+
+    // FNV-1a, then two splitmix64 finalizers for double hashing
+    static void hash(std::string_view s, uint64_t& h1, uint64_t& h2) {
+        uint64_t h = 1469598103934665603ull;
+        for (unsigned char c : s) {
+            h ^= c;
+            h *= 1099511628211ull;
+        }
+        auto mix = [](uint64_t z) {
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+            return z ^ (z >> 31);
+        };
+        h1 = mix(h);
+        h2 = mix(h + 0x9e3779b97f4a7c15ull) | 1;
+    }
+};
+
+} // namespace pdbsql
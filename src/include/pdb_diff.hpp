@@ -0,0 +1,419 @@
+#pragma once
+// pdb_diff.hpp - Compare two PDBs (two builds of a module) symbol by symbol
+//
+// Each side of each kind is read on its own worker thread with its own
+// session (see with_pdb_database), then the two sides are hash-joined on the
+// symbol key and reduced to added / removed / changed rows:
+//
+//   functions, publics  key: name              changed: rva or length differ
+//   udts                key: name (unnamed UDTs by layout signature)
+//                                              changed: size or layout differ
+//   udt_members         key: udt_name::name    changed: offset, type or length
+//
+// Repeated keys (overloads, file statics) are paired in enumeration order.
+// For udt_members the rva columns carry the member offset.
+// The `pdb_diff` table exposes the rows; `WHERE kind = '...'` computes only
+// that kind, a full scan computes all of them in one parallel pass.
+
+#include "federated_query.hpp"
+#include "metrics.hpp"
+#include "pdb_tables.hpp"
+#include "trace.hpp"
+
+#include <xsql/database.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace pdbsql {
+
+enum class DiffKind { Functions, Publics, Udts, UdtMembers };
+
+constexpr size_t DIFF_KIND_COUNT = 4;
+
+inline const char* diff_kind_name(DiffKind kind) {
+    switch (kind) {
+        case DiffKind::Functions: return "functions";
+        case DiffKind::Publics: return "publics";
+        case DiffKind::Udts: return "udts";
+        case DiffKind::UdtMembers: return "udt_members";
+    }
+    return "";
+}
+
+inline bool parse_diff_kind(const std::string& name, DiffKind& kind) {
+    for (size_t k = 0; k < DIFF_KIND_COUNT; k++) {
+        if (name == diff_kind_name(static_cast<DiffKind>(k))) {
+            kind = static_cast<DiffKind>(k);
+            return true;
+        }
+    }
+    return false;
+}
+
+struct DiffRow {
+    std::string kind;
+    std::string change;   // added, removed, changed
+    std::string name;     // Join key as shown (udt_members: "Udt::member")
+    int64_t old_rva = 0;
+    int64_t new_rva = 0;
+    int64_t old_size = 0;
+    int64_t new_size = 0;
+    std::string detail;   // What changed, e.g. "offset 8 -> 16"
+    std::string error;    // Set only on the row standing in for a failed diff
+};
+
+namespace diff_detail {
+
+// One symbol as read from either side
+struct Entry {
+    std::string key;
+    std::string type;     // udt_members: member type; udts: layout signature
+    int64_t rva = 0;
+    int64_t size = 0;
+    int64_t offset = 0;
+};
+
+inline const char* extract_sql(DiffKind kind) {
+    switch (kind) {
+        case DiffKind::Functions: return "SELECT name, rva, length FROM functions";
+        case DiffKind::Publics: return "SELECT name, rva, length FROM publics";
+        case DiffKind::Udts: return "SELECT name, 0, length FROM udts";
+        case DiffKind::UdtMembers: return "SELECT udt_name || '::' || name, offset, length, type FROM udt_members";
+    }
+    return "";
+}
+
+inline bool extract(xsql::Database& db, DiffKind kind, std::vector<Entry>& out, std::string& error) {
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v2(db.handle(), extract_sql(kind), -1, &stmt, nullptr) != SQLITE_OK) {
+        error = sqlite3_errmsg(db.handle());
+        return false;
+    }
+    const bool member = kind == DiffKind::UdtMembers;
+    int rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+        Entry e;
+        const unsigned char* name = sqlite3_column_text(stmt, 0);
+        if (name) e.key = reinterpret_cast<const char*>(name);
+        if (member) {
+            e.offset = sqlite3_column_int64(stmt, 1);
+            const unsigned char* type = sqlite3_column_text(stmt, 3);
+            if (type) e.type = reinterpret_cast<const char*>(type);
+        } else {
+            e.rva = sqlite3_column_int64(stmt, 1);
+        }
+        e.size = sqlite3_column_int64(stmt, 2);
+        out.push_back(std::move(e));
+    }
+    if (rc != SQLITE_DONE) error = sqlite3_errmsg(db.handle());
+    sqlite3_finalize(stmt);
+    return rc == SQLITE_DONE;
+}
+
+inline uint64_t fnv1a(std::string_view s, uint64_t h = 1469598103934665603ULL) {
+    for (unsigned char c : s) {
+        h ^= c;
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+// Give each UDT its layout signature (hash of member name/type/offset) and
+// key unnamed UDTs by it, since their names are not stable across builds.
+inline void sign_udts(std::vector<Entry>& udts, const std::vector<Entry>& members) {
+    std::unordered_map<std::string_view, uint64_t> layout;
+    for (const auto& m : members) {
+        const size_t sep = m.key.rfind("::");
+        if (sep == std::string::npos) continue;
+        std::string_view udt(m.key.data(), sep);
+        uint64_t& h = layout.try_emplace(udt, 1469598103934665603ULL).first->second;
+        h = fnv1a(std::string_view(m.key).substr(sep + 2), h);
+        h = fnv1a(m.type, h);
+        h = fnv1a(std::to_string(m.offset), h);
+    }
+    char buf[32];
+    for (auto& u : udts) {
+        auto it = layout.find(u.key);
+        snprintf(buf, sizeof(buf), "%016llx", static_cast<unsigned long long>(it == layout.end() ? 0 : it->second));
+        u.type = buf;
+        if (!u.key.empty() && u.key[0] == '<') u.key = "<unnamed:" + u.type + ">";
+    }
+}
+
+inline std::string describe(DiffKind kind, const Entry& a, const Entry& b) {
+    std::string detail;
+    auto add = [&detail](const std::string& part) {
+        if (!detail.empty()) detail += ", ";
+        detail += part;
+    };
+    if (a.size != b.size) add("size " + std::to_string(a.size) + " -> " + std::to_string(b.size));
+    if (a.rva != b.rva) add("moved");
+    if (kind == DiffKind::UdtMembers) {
+        if (a.offset != b.offset) add("offset " + std::to_string(a.offset) + " -> " + std::to_string(b.offset));
+        if (a.type != b.type) add("type " + a.type + " -> " + b.type);
+    } else if (kind == DiffKind::Udts && a.type != b.type) {
+        add("layout");
+    }
+    return detail;
+}
+
+// Hash join on key; the n-th repeat of a key pairs with the n-th on the other side.
+inline std::vector<DiffRow> join(DiffKind kind, const std::vector<Entry>& before, const std::vector<Entry>& after) {
+    std::unordered_map<std::string_view, std::vector<size_t>> index;
+    index.reserve(before.size());
+    for (size_t i = 0; i < before.size(); i++) index[before[i].key].push_back(i);
+
+    std::unordered_map<std::string_view, size_t> used;
+    std::vector<bool> matched(before.size(), false);
+    std::vector<DiffRow> rows;
+    const bool member = kind == DiffKind::UdtMembers;
+
+    auto row = [kind, member](const char* change, const Entry* a, const Entry* b) {
+        DiffRow r;
+        r.kind = diff_kind_name(kind);
+        r.change = change;
+        r.name = (a ? a : b)->key;
+        if (a) { r.old_rva = member ? a->offset : a->rva; r.old_size = a->size; }
+        if (b) { r.new_rva = member ? b->offset : b->rva; r.new_size = b->size; }
+        return r;
+    };
+
+    for (const auto& b : after) {
+        auto it = index.find(b.key);
+        size_t n = it == index.end() ? 0 : used[b.key]++;
+        if (it == index.end() || n >= it->second.size()) {
+            rows.push_back(row("added", nullptr, &b));
+            continue;
+        }
+        const size_t i = it->second[n];
+        matched[i] = true;
+        std::string detail = describe(kind, before[i], b);
+        if (detail.empty()) continue;
+        DiffRow r = row("changed", &before[i], &b);
+        r.detail = std::move(detail);
+        rows.push_back(std::move(r));
+    }
+    for (size_t i = 0; i < before.size(); i++) {
+        if (!matched[i]) rows.push_back(row("removed", &before[i], nullptr));
+    }
+
+    std::stable_sort(rows.begin(), rows.end(), [](const DiffRow& x, const DiffRow& y) { return x.name < y.name; });
+    return rows;
+}
+
+} // namespace diff_detail
+
+// Diff rows per kind; kinds not asked for stay empty.
+using PdbDiffResult = std::array<std::vector<DiffRow>, DIFF_KIND_COUNT>;
+
+// Compare `kinds` of old_path against new_path using up to `jobs` threads (0 = all cores).
+inline bool compute_pdb_diff(const std::string& old_path, const std::string& new_path,
+                             const std::vector<DiffKind>& kinds, unsigned jobs,
+                             PdbDiffResult& result, std::string& error) {
+    TraceSpan span("pdb_diff", "diff");
+    using diff_detail::Entry;
+
+    // udts need both sides' members for their layout signatures
+    std::array<bool, DIFF_KIND_COUNT> read{};
+    for (DiffKind k : kinds) {
+        read[static_cast<size_t>(k)] = true;
+        if (k == DiffKind::Udts) read[static_cast<size_t>(DiffKind::UdtMembers)] = true;
+    }
+
+    struct Task {
+        DiffKind kind;
+        int side;
+    };
+    std::vector<Task> tasks;
+    for (size_t k = 0; k < DIFF_KIND_COUNT; k++) {
+        if (!read[k]) continue;
+        tasks.push_back({static_cast<DiffKind>(k), 0});
+        tasks.push_back({static_cast<DiffKind>(k), 1});
+    }
+
+    std::array<std::array<std::vector<Entry>, 2>, DIFF_KIND_COUNT> entries;
+    std::vector<std::string> errors(tasks.size());
+    std::atomic<bool> stop{false};
+    run_parallel(tasks.size(), jobs, stop, [&](size_t t) {
+        const Task& task = tasks[t];
+        const std::string& path = task.side == 0 ? old_path : new_path;
+        auto& out = entries[static_cast<size_t>(task.kind)][task.side];
+        std::string& err = errors[t];
+        bool opened = with_pdb_database(path, [&](xsql::Database& db) {
+            diff_detail::extract(db, task.kind, out, err);
+        }, err);
+        if (!opened || !err.empty()) {
+            err = path + ": " + err;
+            stop.store(true);
+        }
+    });
+    for (const auto& err : errors) {
+        if (!err.empty()) {
+            error = err;
+            return false;
+        }
+    }
+
+    const auto members = static_cast<size_t>(DiffKind::UdtMembers);
+    const auto udts = static_cast<size_t>(DiffKind::Udts);
+    if (read[udts]) {
+        diff_detail::sign_udts(entries[udts][0], entries[members][0]);
+        diff_detail::sign_udts(entries[udts][1], entries[members][1]);
+    }
+
+    run_parallel(kinds.size(), jobs, stop, [&](size_t i) {
+        const size_t k = static_cast<size_t>(kinds[i]);
+        result[k] = diff_detail::join(kinds[i], entries[k][0], entries[k][1]);
+    });
+    return true;
+}
+
+// ============================================================================
+// pdb_diff table
+// ============================================================================
+
+// Lazily computed diff of two PDBs exposed as the `pdb_diff` table.
+class PdbDiff {
+    std::string old_path_;
+    std::string new_path_;
+    unsigned jobs_;
+
+    std::mutex mutex_;
+    std::array<std::shared_ptr<const std::vector<DiffRow>>, DIFF_KIND_COUNT> rows_;
+    std::shared_ptr<const std::vector<DiffRow>> all_;
+    std::string error_;
+
+    GeneratorTableDef<DiffRow> def_;
+
+    // Compute the kinds not cached yet. A failure is not cached, so the next
+    // query tries again.
+    bool ensure(const std::vector<DiffKind>& kinds, std::string& error) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<DiffKind> missing;
+        for (DiffKind k : kinds) {
+            if (!rows_[static_cast<size_t>(k)]) missing.push_back(k);
+        }
+        if (missing.empty()) return true;
+
+        PdbDiffResult result;
+        if (!compute_pdb_diff(old_path_, new_path_, missing, jobs_, result, error)) {
+            error_ = error;
+            return false;
+        }
+        error_.clear();
+        for (DiffKind k : missing) {
+            const size_t i = static_cast<size_t>(k);
+            rows_[i] = std::make_shared<const std::vector<DiffRow>>(std::move(result[i]));
+        }
+        return true;
+    }
+
+    // Generators can't fail a query, so a failed diff scans as one row whose
+    // columns raise the error (see fail_error_rows). A query reading no
+    // column, like a bare COUNT(*), still sees that row.
+    static std::shared_ptr<const std::vector<DiffRow>> error_rows(const std::string& error) {
+        DiffRow row;
+        row.error = "pdb_diff: " + error;
+        return std::make_shared<const std::vector<DiffRow>>(1, std::move(row));
+    }
+
+    // Make every column of an error row fail the statement with its message
+    static void fail_error_rows(GeneratorTableDef<DiffRow>& def) {
+        for (auto& column : def.columns) {
+            column.get = [get = std::move(column.get)](sqlite3_context* ctx, const DiffRow& r) {
+                if (!r.error.empty()) {
+                    sqlite3_result_error(ctx, r.error.c_str(), -1);
+                    return;
+                }
+                get(ctx, r);
+            };
+        }
+    }
+
+    std::shared_ptr<const std::vector<DiffRow>> all_rows() {
+        std::vector<DiffKind> kinds;
+        for (size_t k = 0; k < DIFF_KIND_COUNT; k++) kinds.push_back(static_cast<DiffKind>(k));
+        std::string error;
+        if (!ensure(kinds, error)) return error_rows(error);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!all_) {
+            auto all = std::make_shared<std::vector<DiffRow>>();
+            for (const auto& rows : rows_) all->insert(all->end(), rows->begin(), rows->end());
+            all_ = std::move(all);
+        }
+        return all_;
+    }
+
+    std::shared_ptr<const std::vector<DiffRow>> kind_rows(const char* name) {
+        DiffKind kind;
+        if (!name || !parse_diff_kind(name, kind)) return std::make_shared<const std::vector<DiffRow>>();
+        std::string error;
+        if (!ensure({kind}, error)) return error_rows(error);
+        std::lock_guard<std::mutex> lock(mutex_);
+        return rows_[static_cast<size_t>(kind)];
+    }
+
+    GeneratorTableDef<DiffRow> define_table() {
+        return generator_table<DiffRow>("pdb_diff")
+            .estimate_rows([]() { return static_cast<size_t>(10000); })
+            .generator([this, scans = &Metrics::global().table("pdb_diff")]() {
+                return counted(*scans, std::make_unique<VectorGenerator<DiffRow>>(all_rows()));
+            })
+            .column_text("kind", [](const DiffRow& r) { return r.kind; })
+            .column_text("change", [](const DiffRow& r) { return r.change; })
+            .column_text("name", [](const DiffRow& r) { return r.name; })
+            .column_int64("old_rva", [](const DiffRow& r) { return r.old_rva; })
+            .column_int64("new_rva", [](const DiffRow& r) { return r.new_rva; })
+            .column_int64("rva_delta", [](const DiffRow& r) { return r.new_rva - r.old_rva; })
+            .column_int64("old_size", [](const DiffRow& r) { return r.old_size; })
+            .column_int64("new_size", [](const DiffRow& r) { return r.new_size; })
+            .column_int64("size_delta", [](const DiffRow& r) { return r.new_size - r.old_size; })
+            .column_text("detail", [](const DiffRow& r) { return r.detail; })
+            .build();
+    }
+
+public:
+    PdbDiff(std::string old_path, std::string new_path, unsigned jobs = 0)
+        : old_path_(std::move(old_path))
+        , new_path_(std::move(new_path))
+        , jobs_(jobs)
+        , def_(define_table())
+    {
+        fail_error_rows(def_);
+        auto* def = &def_;
+        add_filter_eq_text(def_, "kind",
+                           [def, this](const char* kind) -> std::unique_ptr<xsql::RowIterator> {
+                               return std::make_unique<GeneratorRowIterator<DiffRow>>(
+                                   def, std::make_unique<VectorGenerator<DiffRow>>(kind_rows(kind)));
+                           },
+                           1.0, 1000.0);
+    }
+
+    PdbDiff(const PdbDiff&) = delete;
+    PdbDiff& operator=(const PdbDiff&) = delete;
+
+    // Must outlive db
+    void register_table(xsql::Database& db) {
+        db.register_generator_table("pdb_pdb_diff", &def_);
+        db.create_table("pdb_diff", "pdb_pdb_diff");
+    }
+
+    // Last compute error (empty once a later computation succeeds)
+    std::string last_error() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return error_;
+    }
+};
+
+} // namespace pdbsql
@@ -2,6 +2,7 @@
 // pdb_session.hpp - PDB file session management
 
 #include "dia_helpers.hpp"
+#include "trace.hpp"
 #include <memory>
 
 namespace pdbsql {
@@ -40,6 +41,8 @@ public:
 
     // Open a PDB file
     bool open(const std::string& pdb_path) {
+        TraceSpan span("pdb.open", "pdb");
+        span.arg("path", pdb_path);
         close();
 
         // Create DiaDataSource
@@ -51,7 +54,10 @@ public:
 
         // Load PDB
         std::wstring wpath = string_to_wstring(pdb_path);
-        hr = source_->loadDataFromPdb(wpath.c_str());
+        {
+            TraceSpan load("dia.loadDataFromPdb", "dia");
+            hr = source_->loadDataFromPdb(wpath.c_str());
+        }
         if (FAILED(hr)) {
             last_error_ = "Failed to load PDB: " + pdb_path;
             return false;
@@ -90,10 +96,29 @@ public:
     IDiaSession* session() const { return session_; }
     IDiaSymbol* global() const { return global_; }
 
+    // PDB identity (GUID + age) as recorded in the PDB
+    bool identity(GUID& guid, DWORD& age) const {
+        if (!global_) return false;
+        if (FAILED(global_->get_guid(&guid))) return false;
+        age = 0;
+        global_->get_age(&age);
+        return true;
+    }
+
+    // GUID+age signature used by symbol stores (e.g. "1B2C...A1")
+    std::string signature() const {
+        GUID guid = {};
+        DWORD age = 0;
+        if (!identity(guid, age)) return "";
+        return format_pdb_signature(guid, age);
+    }
+
     // Enumerate children of a symbol
     CComPtr<IDiaEnumSymbols> enum_children(IDiaSymbol* parent, enum SymTagEnum symtag) {
         CComPtr<IDiaEnumSymbols> result;
         if (parent) {
+            TraceSpan span("dia.findChildren", "dia");
+            span.arg("symtag", static_cast<int>(symtag));
             parent->findChildren(symtag, nullptr, nsNone, &result);
         }
         return result;
@@ -108,6 +133,8 @@ public:
     CComPtr<IDiaEnumSymbols> find_symbols(const std::string& name, enum SymTagEnum symtag = SymTagNull) {
         CComPtr<IDiaEnumSymbols> result;
         if (global_) {
+            TraceSpan span("dia.findChildren", "dia");
+            span.arg("symtag", static_cast<int>(symtag)).arg("name", name);
             std::wstring wname = string_to_wstring(name);
             global_->findChildren(symtag, wname.c_str(), nsCaseSensitive, &result);
         }
@@ -119,6 +146,7 @@ public:
         auto symbols = enum_symbols(symtag);
         if (!symbols) return 0;
         LONG count = 0;
+        TraceSpan span("dia.get_Count", "dia");
         symbols->get_Count(&count);
         return count;
     }
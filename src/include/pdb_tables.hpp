@@ -16,10 +16,15 @@
  *   compilands    - Object files / compilation units
  *   source_files  - Source file paths
  *   line_numbers  - Source line to RVA mapping
+ *   inline_sites  - Inlined calls: parent function, inlinee, call line, address ranges
  *   sections      - PE sections from section contributions
+ *   section_contributions - Per-compiland byte ranges of each section
+ *   frame_data    - FPO / FrameData unwind records (probe_rva lookup finds the covering record)
  *   thunks        - Thunk symbols (import stubs, etc.)
  *   labels        - Code labels
  *   udt_members   - UDT member fields (struct/class members)
+ *   udt_layout    - UDT memory layout: padding, holes, bitfields, cache lines
+ *   type_duplicates - UDT names defined more than once, grouped by structural hash
  *   enum_values   - Enum value constants
  *   base_classes  - Base class relationships
  *   locals        - Local variables (per function)
@@ -28,10 +33,19 @@
 
 #include <xsql/xsql.hpp>
 #include <xsql/database.hpp>
+#include "metrics.hpp"
+#include "msvc_demangle.hpp"
 #include "pdb_session.hpp"
+#include "query_profile.hpp"
+#include "symbol_search.hpp"
+#include "trace.hpp"
 #include <algorithm>
+#include <chrono>
+#include <cstdio>
 #include <vector>
 #include <memory>
+#include <thread>
+#include <type_traits>
 #include <unordered_map>
 
 namespace pdbsql {
@@ -167,6 +181,9 @@ inline CachedSymbol extract_symbol(IDiaSymbol* symbol) {
     if (SUCCEEDED(symbol->get_undecoratedName(undec.ptr()))) {
         cs.undecorated = undec.str();
     }
+    if (cs.undecorated.empty() && !cs.name.empty() && cs.name[0] == '?') {
+        cs.undecorated = undecorate(cs.name);  // DIA leaves some forms decorated
+    }
 
     symbol->get_relativeVirtualAddress(&cs.rva);
     symbol->get_length(&cs.length);
@@ -423,102 +440,28 @@ public:
     sqlite3_int64 rowid() const override { return rowid_; }
 };
 
-class SectionGenerator : public xsql::Generator<CachedSection> {
-    PdbSession& session_;
-    std::vector<CachedSection> sections_;
-    size_t idx_ = 0;
-    sqlite3_int64 rowid_ = -1;
-    bool started_ = false;
-
-    void build() {
-        sections_.clear();
-
-        IDiaSession* dia_session = session_.session();
-        if (!dia_session) return;
-
-        CComPtr<IDiaEnumTables> tables;
-        if (FAILED(dia_session->getEnumTables(&tables)) || !tables) return;
-
-        // Find section contributions table
-        CComPtr<IDiaEnumSectionContribs> contribs;
-        CComPtr<IDiaTable> table;
-        ULONG tfetched = 0;
-        while (SUCCEEDED(tables->Next(1, &table, &tfetched)) && tfetched == 1) {
-            SafeBSTR name;
-            if (SUCCEEDED(table->get_name(name.ptr()))) {
-                if (wcscmp(name.get(), L"SectionContribs") == 0) {
-                    table->QueryInterface(IID_IDiaEnumSectionContribs, (void**)&contribs);
-                    break;
-                }
-            }
-            table.Release();
-        }
-        if (!contribs) return;
-
-        std::unordered_map<DWORD, CachedSection> sections;
-
-        CComPtr<IDiaSectionContrib> contrib;
-        ULONG cfetched = 0;
-        while (SUCCEEDED(contribs->Next(1, &contrib, &cfetched)) && cfetched == 1) {
-            DWORD sec_num = 0;
-            contrib->get_addressSection(&sec_num);
-
-            DWORD rva = 0, len = 0;
-            contrib->get_relativeVirtualAddress(&rva);
-            contrib->get_length(&len);
-
-            auto [it, inserted] = sections.emplace(sec_num, CachedSection{});
-            CachedSection& cs = it->second;
-
-            if (inserted) {
-                cs.section_number = sec_num;
-                cs.rva = rva;
-                cs.length = len;
-
-                BOOL val = FALSE;
-                if (SUCCEEDED(contrib->get_read(&val))) cs.read = (val != FALSE);
-                if (SUCCEEDED(contrib->get_write(&val))) cs.write = (val != FALSE);
-                if (SUCCEEDED(contrib->get_execute(&val))) cs.execute = (val != FALSE);
-                if (SUCCEEDED(contrib->get_code(&val))) cs.code = (val != FALSE);
-            } else {
-                DWORD end = rva + len;
-                DWORD cur_end = cs.rva + cs.length;
-                if (end > cur_end) {
-                    cs.length = end - cs.rva;
-                }
-            }
-
-            contrib.Release();
-        }
-
-        sections_.reserve(sections.size());
-        for (const auto& [num, sec] : sections) {
-            sections_.push_back(sec);
-        }
-
-        std::sort(sections_.begin(), sections_.end(), [](const CachedSection& a, const CachedSection& b) {
-            return a.section_number < b.section_number;
-        });
-    }
-
-public:
-    explicit SectionGenerator(PdbSession& session) : session_(session) {}
-
-    bool next() override {
-        if (!started_) {
-            started_ = true;
-            build();
+// Open one of the DIA tables (SectionContribs, FrameData, ...) by name
+template<typename EnumTable>
+inline CComPtr<EnumTable> find_dia_table(PdbSession& session, const wchar_t* table_name, REFIID iid) {
+    CComPtr<EnumTable> result;
+    IDiaSession* dia_session = session.session();
+    if (!dia_session) return result;
+
+    CComPtr<IDiaEnumTables> tables;
+    if (FAILED(dia_session->getEnumTables(&tables)) || !tables) return result;
+
+    CComPtr<IDiaTable> table;
+    ULONG fetched = 0;
+    while (SUCCEEDED(tables->Next(1, &table, &fetched)) && fetched == 1) {
+        SafeBSTR name;
+        if (SUCCEEDED(table->get_name(name.ptr())) && wcscmp(name.get(), table_name) == 0) {
+            table->QueryInterface(iid, (void**)&result);
+            break;
         }
-
-        if (idx_ >= sections_.size()) return false;
-        ++rowid_;
-        ++idx_;
-        return true;
+        table.Release();
     }
-
-    const CachedSection& current() const override { return sections_[idx_ - 1]; }
-    sqlite3_int64 rowid() const override { return rowid_; }
-};
+    return result;
+}
 
 class MemberGenerator : public xsql::Generator<CachedMember> {
     PdbSession& session_;
@@ -911,6 +854,41 @@ public:
     sqlite3_int64 rowid() const override { return rowid_; }
 };
 
+// Generator over a pre-built row vector (session caches, snapshots).
+// Optionally restricted to [begin, end) for pushdowns over sorted caches.
+template<typename RowData>
+class VectorGenerator : public xsql::Generator<RowData> {
+    std::shared_ptr<const std::vector<RowData>> rows_;
+    size_t idx_ = 0;
+    size_t end_ = 0;
+    sqlite3_int64 rowid_ = -1;
+    bool started_ = false;
+
+public:
+    explicit VectorGenerator(std::shared_ptr<const std::vector<RowData>> rows)
+        : rows_(std::move(rows))
+        , end_(rows_ ? rows_->size() : 0)
+    {}
+
+    VectorGenerator(std::shared_ptr<const std::vector<RowData>> rows, size_t begin, size_t end)
+        : rows_(std::move(rows))
+        , idx_(begin)
+        , end_(rows_ ? (std::min)(end, rows_->size()) : 0)
+        , rowid_(static_cast<sqlite3_int64>(begin) - 1)
+    {}
+
+    bool next() override {
+        if (started_) ++idx_;
+        started_ = true;
+        if (idx_ >= end_) return false;
+        rowid_ = static_cast<sqlite3_int64>(idx_);
+        return true;
+    }
+
+    const RowData& current() const override { return (*rows_)[idx_]; }
+    sqlite3_int64 rowid() const override { return rowid_; }
+};
+
 template<typename RowData>
 class GeneratorRowIterator final : public xsql::RowIterator {
     const GeneratorTableDef<RowData>* def_ = nullptr;
@@ -955,6 +933,131 @@ public:
     }
 };
 
+// Reports one cursor to the thread's active QueryProfile, if any (see
+// query_profile.hpp), and to the tracer as generator batches (trace.hpp).
+class ProfileTap {
+    TableProfile* table_ = nullptr;
+    uint64_t profile_id_ = 0;
+    bool timed_ = false;
+    TraceBatch trace_;
+
+public:
+    ProfileTap(const std::string& table, const char* plan, uint64_t setup_ns = 0) {
+        trace_.open(table, plan);
+        QueryProfile* profile = QueryProfile::active();
+        if (!profile) return;
+        table_ = &profile->table(table);
+        profile_id_ = profile->id();
+        timed_ = profile->timed;
+        table_->cursors++;
+        table_->plans[plan]++;
+        table_->generator_ns += setup_ns;
+    }
+
+    // Non-null only while the profile this cursor was opened under is active
+    TableProfile* get() const {
+        if (!table_) return nullptr;
+        QueryProfile* profile = QueryProfile::active();
+        return profile && profile->id() == profile_id_ ? table_ : nullptr;
+    }
+
+    // Advance `inner`, feeding the table's metrics, the profile and the trace.
+    template<typename Cursor>
+    bool next(Cursor& inner, TableScanMetrics& metrics) {
+        metrics.next_calls.inc();
+        TableProfile* profile = get();
+        if (!trace_.active() && (!profile || !timed_)) {
+            bool ok = inner.next();
+            if (ok) metrics.rows.inc();
+            if (profile) {
+                profile->next_calls++;
+                if (ok) profile->rows++;
+            }
+            return ok;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        bool ok = inner.next();
+        auto end = std::chrono::steady_clock::now();
+        if (ok) metrics.rows.inc();
+        if (trace_.active()) {
+            trace_.record(std::chrono::duration<double, std::micro>(start.time_since_epoch()).count(),
+                          std::chrono::duration<double, std::micro>(end - start).count(), ok);
+        }
+        if (profile) {
+            profile->generator_ns += static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+            profile->next_calls++;
+            if (ok) profile->rows++;
+        }
+        return ok;
+    }
+};
+
+// Generator wrapper that feeds the table's scan metrics and profile.
+template<typename RowData>
+class CountedGenerator final : public xsql::Generator<RowData> {
+    std::unique_ptr<xsql::Generator<RowData>> inner_;
+    TableScanMetrics& metrics_;
+    ProfileTap tap_;
+
+public:
+    CountedGenerator(std::unique_ptr<xsql::Generator<RowData>> inner, TableScanMetrics& metrics)
+        : inner_(std::move(inner))
+        , metrics_(metrics)
+        , tap_(metrics.name, "full scan")
+    {
+        metrics_.full_scans.inc();
+    }
+
+    bool next() override { return tap_.next(*inner_, metrics_); }
+    const RowData& current() const override { return inner_->current(); }
+    sqlite3_int64 rowid() const override { return inner_->rowid(); }
+};
+
+// Full-scan generator factory helper: counted(metrics, std::make_unique<G>(...))
+template<typename G>
+inline auto counted(TableScanMetrics& metrics, std::unique_ptr<G> gen) {
+    using RowData = std::decay_t<decltype(gen->current())>;
+    return std::unique_ptr<xsql::Generator<RowData>>(
+        std::make_unique<CountedGenerator<RowData>>(std::move(gen), metrics));
+}
+
+// Row iterator wrapper for pushdown cursors. `plan` names the filter used.
+class CountedRowIterator final : public xsql::RowIterator {
+    std::unique_ptr<xsql::RowIterator> inner_;
+    TableScanMetrics& metrics_;
+    ProfileTap tap_;
+
+public:
+    CountedRowIterator(std::unique_ptr<xsql::RowIterator> inner, TableScanMetrics& metrics,
+                       const char* plan, uint64_t setup_ns)
+        : inner_(std::move(inner))
+        , metrics_(metrics)
+        , tap_(metrics.name, plan, setup_ns)
+    {
+        metrics_.pushdown_scans.inc();
+    }
+
+    bool next() override { return tap_.next(*inner_, metrics_); }
+    bool eof() const override { return inner_->eof(); }
+    void column(sqlite3_context* ctx, int col) override { inner_->column(ctx, col); }
+    int64_t rowid() const override { return inner_->rowid(); }
+};
+
+// Run a pushdown factory and wrap its cursor, timing the lookup itself.
+template<typename Factory, typename Arg>
+inline std::unique_ptr<xsql::RowIterator> counted_filter(const Factory& factory, Arg arg,
+                                                         TableScanMetrics& metrics, const std::string& plan) {
+    TraceSpan span("xFilter", "vtable");
+    span.arg("table", metrics.name).arg("plan", plan);
+    auto start = std::chrono::steady_clock::now();
+    auto inner = factory(arg);
+    uint64_t setup_ns = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+    return std::make_unique<CountedRowIterator>(std::move(inner), metrics, plan.c_str(), setup_ns);
+}
+
 template<typename RowData>
 inline void add_filter_eq(GeneratorTableDef<RowData>& def,
                           const char* column_name,
@@ -964,10 +1067,12 @@ inline void add_filter_eq(GeneratorTableDef<RowData>& def,
     int col_idx = def.find_column(column_name ? column_name : "");
     if (col_idx < 0) return;
     int filter_id = static_cast<int>(def.filters.size()) + 1;
+    std::string plan = "filter #" + std::to_string(filter_id) + " (" + column_name + " =)";
     def.filters.emplace_back(
         col_idx, filter_id, cost, est_rows,
-        [factory = std::move(factory)](sqlite3_value* val) -> std::unique_ptr<xsql::RowIterator> {
-            return factory(sqlite3_value_int64(val));
+        [factory = std::move(factory), scans = &Metrics::global().table(def.name), plan](sqlite3_value* val)
+            -> std::unique_ptr<xsql::RowIterator> {
+            return counted_filter(factory, sqlite3_value_int64(val), *scans, plan);
         });
 }
 
@@ -980,11 +1085,13 @@ inline void add_filter_eq_text(GeneratorTableDef<RowData>& def,
     int col_idx = def.find_column(column_name ? column_name : "");
     if (col_idx < 0) return;
     int filter_id = static_cast<int>(def.filters.size()) + 1;
+    std::string plan = "filter #" + std::to_string(filter_id) + " (" + column_name + " =)";
     def.filters.emplace_back(
         col_idx, filter_id, cost, est_rows,
-        [factory = std::move(factory)](sqlite3_value* val) -> std::unique_ptr<xsql::RowIterator> {
+        [factory = std::move(factory), scans = &Metrics::global().table(def.name), plan](sqlite3_value* val)
+            -> std::unique_ptr<xsql::RowIterator> {
             const char* text = reinterpret_cast<const char*>(sqlite3_value_text(val));
-            return factory(text ? text : "");
+            return counted_filter(factory, text ? text : "", *scans, plan);
         });
 }
 
@@ -1782,6 +1889,1157 @@ public:
     sqlite3_int64 rowid() const override { return rowid_; }
 };
 
+// ============================================================================
+// UDT layout (pahole-style)
+// ============================================================================
+
+constexpr ULONGLONG CACHE_LINE_BYTES = 64;
+
+// One field of a UDT's memory layout. udt_* and the totals repeat per row.
+struct CachedLayoutMember {
+    DWORD udt_id = 0;
+    std::string udt_name;
+    ULONGLONG udt_size = 0;
+    DWORD ordinal = 0;
+    std::string kind;           // member, base, vfptr
+    std::string name;
+    std::string type_name;
+    DWORD offset = 0;
+    ULONGLONG size = 0;         // Storage unit size for bitfields
+    DWORD bit_position = 0;
+    DWORD bit_length = 0;       // 0 unless a bitfield
+    ULONGLONG padding_after = 0;
+    ULONGLONG holes = 0;        // Interior padding bytes of the UDT
+    ULONGLONG tail_padding = 0;
+
+    ULONGLONG cache_line() const { return offset / CACHE_LINE_BYTES; }
+    bool crosses_cache_line() const {
+        return size > 0 && (offset + size - 1) / CACHE_LINE_BYTES != cache_line();
+    }
+};
+
+// Order fields[first, end) by offset and fill ordinal, padding_after and the
+// per-UDT totals. Overlapping fields (unions, bitfields sharing a storage
+// unit) only pad past the furthest byte covered so far.
+inline void compute_layout_padding(std::vector<CachedLayoutMember>& fields, size_t first, ULONGLONG udt_size) {
+    auto begin = fields.begin() + static_cast<std::ptrdiff_t>(first);
+    std::stable_sort(begin, fields.end(), [](const CachedLayoutMember& a, const CachedLayoutMember& b) {
+        return a.offset != b.offset ? a.offset < b.offset : a.bit_position < b.bit_position;
+    });
+
+    const size_t n = fields.size() - first;
+    ULONGLONG covered = 0;
+    ULONGLONG holes = 0;
+    for (size_t i = 0; i < n; i++) {
+        CachedLayoutMember& f = fields[first + i];
+        covered = (std::max)(covered, static_cast<ULONGLONG>(f.offset) + f.size);
+        const ULONGLONG next = i + 1 < n ? fields[first + i + 1].offset : udt_size;
+        f.ordinal = static_cast<DWORD>(i);
+        f.padding_after = next > covered ? next - covered : 0;
+        if (i + 1 < n) holes += f.padding_after;
+    }
+    const ULONGLONG tail = n ? fields.back().padding_after : 0;
+    for (size_t i = first; i < fields.size(); i++) {
+        fields[i].holes = holes;
+        fields[i].tail_padding = tail;
+    }
+}
+
+// Append the layout of one UDT: instance data members (incl. bitfields),
+// non-virtual base classes and the vfptr, with padding computed.
+inline void append_udt_layout(IDiaSymbol* udt, std::vector<CachedLayoutMember>& out) {
+    if (!udt) return;
+    CComPtr<IDiaEnumSymbols> children;
+    if (FAILED(udt->findChildren(SymTagNull, nullptr, nsNone, &children)) || !children) return;
+
+    CachedLayoutMember proto;
+    udt->get_symIndexId(&proto.udt_id);
+    proto.udt_name = safe_symbol_name(udt);
+    udt->get_length(&proto.udt_size);
+
+    const size_t first = out.size();
+    CComPtr<IDiaSymbol> child;
+    ULONG fetched = 0;
+    while (SUCCEEDED(children->Next(1, &child, &fetched)) && fetched == 1) {
+        CComPtr<IDiaSymbol> field(child);
+        child.Release();
+
+        DWORD tag = 0;
+        field->get_symTag(&tag);
+        CachedLayoutMember m = proto;
+        if (tag == SymTagData) {
+            DWORD loc = 0;
+            field->get_locationType(&loc);
+            if (loc != LocIsThisRel && loc != LocIsBitField) continue;  // Statics, constants
+            m.kind = "member";
+            m.name = safe_symbol_name(field);
+            if (loc == LocIsBitField) {
+                ULONGLONG bits = 0;
+                field->get_length(&bits);
+                m.bit_length = static_cast<DWORD>(bits);
+                field->get_bitPosition(&m.bit_position);
+            }
+        } else if (tag == SymTagBaseClass) {
+            BOOL virt = FALSE;
+            field->get_virtualBaseClass(&virt);
+            if (virt) continue;  // Located through the vbtable, not at a fixed offset
+            m.kind = "base";
+            m.name = safe_symbol_name(field);
+        } else if (tag == SymTagVTable) {
+            m.kind = "vfptr";
+            m.name = "__vfptr";
+        } else {
+            continue;
+        }
+
+        LONG offset = 0;
+        field->get_offset(&offset);
+        m.offset = static_cast<DWORD>(offset);
+        CComPtr<IDiaSymbol> type;
+        if (SUCCEEDED(field->get_type(&type)) && type) {
+            m.type_name = safe_symbol_name(type);
+            type->get_length(&m.size);
+        }
+        out.push_back(std::move(m));
+    }
+    compute_layout_padding(out, first, proto.udt_size);
+}
+
+// udt_layout rows cached for the session: every UDT on the first full scan
+// (later udt_id lookups are ranges into it), single UDTs on demand before that.
+class UdtLayoutCache {
+    PdbSession& session_;
+    std::shared_ptr<const std::vector<CachedLayoutMember>> all_;
+    std::unordered_map<DWORD, std::pair<size_t, size_t>> ranges_;
+    std::unordered_map<DWORD, std::shared_ptr<const std::vector<CachedLayoutMember>>> single_;
+
+    using Rows = std::shared_ptr<const std::vector<CachedLayoutMember>>;
+
+public:
+    explicit UdtLayoutCache(PdbSession& session) : session_(session) {}
+
+    Rows all() {
+        if (all_) return all_;
+        TraceSpan span("udt_layout.build", "cache");
+        auto rows = std::make_shared<std::vector<CachedLayoutMember>>();
+        auto udts = session_.enum_symbols(SymTagUDT);
+        CComPtr<IDiaSymbol> udt;
+        ULONG fetched = 0;
+        while (udts && SUCCEEDED(udts->Next(1, &udt, &fetched)) && fetched == 1) {
+            DWORD id = 0;
+            udt->get_symIndexId(&id);
+            const size_t begin = rows->size();
+            append_udt_layout(udt, *rows);
+            ranges_.emplace(id, std::make_pair(begin, rows->size()));
+            udt.Release();
+        }
+        span.arg("rows", rows->size());
+        all_ = std::move(rows);
+        single_.clear();
+        return all_;
+    }
+
+    std::unique_ptr<xsql::Generator<CachedLayoutMember>> by_id(DWORD id) {
+        if (all_) {
+            auto it = ranges_.find(id);
+            if (it == ranges_.end()) return std::make_unique<VectorGenerator<CachedLayoutMember>>(nullptr);
+            return std::make_unique<VectorGenerator<CachedLayoutMember>>(all_, it->second.first, it->second.second);
+        }
+        return std::make_unique<VectorGenerator<CachedLayoutMember>>(single(id));
+    }
+
+    std::unique_ptr<xsql::Generator<CachedLayoutMember>> by_name(const std::string& name) {
+        auto rows = std::make_shared<std::vector<CachedLayoutMember>>();
+        auto udts = session_.find_symbols(name, SymTagUDT);
+        CComPtr<IDiaSymbol> udt;
+        ULONG fetched = 0;
+        while (udts && SUCCEEDED(udts->Next(1, &udt, &fetched)) && fetched == 1) {
+            DWORD id = 0;
+            udt->get_symIndexId(&id);
+            udt.Release();
+            if (all_) {
+                auto it = ranges_.find(id);
+                if (it == ranges_.end()) continue;
+                rows->insert(rows->end(), all_->begin() + static_cast<std::ptrdiff_t>(it->second.first),
+                             all_->begin() + static_cast<std::ptrdiff_t>(it->second.second));
+            } else {
+                Rows one = single(id);
+                rows->insert(rows->end(), one->begin(), one->end());
+            }
+        }
+        return std::make_unique<VectorGenerator<CachedLayoutMember>>(std::move(rows));
+    }
+
+private:
+    Rows single(DWORD id) {
+        auto it = single_.find(id);
+        if (it != single_.end()) return it->second;
+        auto rows = std::make_shared<std::vector<CachedLayoutMember>>();
+        CComPtr<IDiaSymbol> udt;
+        IDiaSession* dia_session = session_.session();
+        DWORD tag = 0;
+        if (dia_session && SUCCEEDED(dia_session->symbolById(id, &udt)) && udt &&
+            SUCCEEDED(udt->get_symTag(&tag)) && tag == SymTagUDT) {
+            append_udt_layout(udt, *rows);
+        }
+        Rows shared = std::move(rows);
+        single_.emplace(id, shared);
+        return shared;
+    }
+};
+
+// ============================================================================
+// Structural type hashing (type_duplicates)
+// ============================================================================
+
+inline uint64_t hash_mix(uint64_t h, const void* data, size_t len) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < len; i++) {
+        h ^= p[i];
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+inline uint64_t hash_mix(uint64_t h, const std::string& s) {
+    h = hash_mix(h, s.data(), s.size());
+    return hash_mix(h, "", 1);  // Terminator: "ab","c" != "a","bc"
+}
+
+inline uint64_t hash_mix(uint64_t h, uint64_t v) {
+    return hash_mix(h, &v, sizeof(v));
+}
+
+// Structural hash of types within one session: UDTs hash their kind, size
+// and fields (name, offset, bits, field type), recursively through by-value
+// members, arrays and typedefs. Pointers hash the pointee's name, so cycles
+// through pointers stop there. Hashes are memoized per symIndexId, except
+// ones cut short by MAX_DEPTH: those depend on the depth they were reached at.
+class StructuralHasher {
+    static constexpr uint64_t SEED = 1469598103934665603ULL;
+    static constexpr int MAX_DEPTH = 32;
+    std::unordered_map<DWORD, uint64_t> memo_;
+    bool truncated_ = false;  // The type_hash() in progress hit MAX_DEPTH somewhere below
+
+public:
+    struct UdtHash {
+        uint64_t hash = 0;
+        DWORD members = 0;
+    };
+
+    UdtHash udt(IDiaSymbol* symbol, int depth = 0) {
+        UdtHash out;
+        uint64_t h = SEED;
+        DWORD kind = 0;
+        ULONGLONG length = 0;
+        symbol->get_udtKind(&kind);
+        symbol->get_length(&length);
+        h = hash_mix(h, static_cast<uint64_t>(kind));
+        h = hash_mix(h, static_cast<uint64_t>(length));
+
+        CComPtr<IDiaEnumSymbols> children;
+        if (SUCCEEDED(symbol->findChildren(SymTagNull, nullptr, nsNone, &children)) && children) {
+            CComPtr<IDiaSymbol> child;
+            ULONG fetched = 0;
+            while (SUCCEEDED(children->Next(1, &child, &fetched)) && fetched == 1) {
+                CComPtr<IDiaSymbol> field(child);
+                child.Release();
+                DWORD tag = 0;
+                field->get_symTag(&tag);
+                DWORD loc = 0;
+                if (tag == SymTagData) {
+                    field->get_locationType(&loc);
+                    if (loc != LocIsThisRel && loc != LocIsBitField) continue;
+                } else if (tag != SymTagBaseClass) {
+                    continue;  // Methods, nested types and statics don't affect layout
+                }
+                LONG offset = 0;
+                DWORD bit_position = 0;
+                ULONGLONG bits = 0;
+                field->get_offset(&offset);
+                if (loc == LocIsBitField) {
+                    field->get_bitPosition(&bit_position);
+                    field->get_length(&bits);
+                }
+                h = hash_mix(h, static_cast<uint64_t>(tag));
+                h = hash_mix(h, safe_symbol_name(field));
+                h = hash_mix(h, static_cast<uint64_t>(static_cast<uint32_t>(offset)));
+                h = hash_mix(h, (static_cast<uint64_t>(bit_position) << 32) | bits);
+                CComPtr<IDiaSymbol> type;
+                if (tag == SymTagData && SUCCEEDED(field->get_type(&type)) && type) {
+                    h = hash_mix(h, type_hash(type, depth + 1));
+                }
+                out.members++;
+            }
+        }
+        out.hash = h;
+        return out;
+    }
+
+    uint64_t type_hash(IDiaSymbol* type, int depth) {
+        DWORD id = 0;
+        type->get_symIndexId(&id);
+        auto it = memo_.find(id);
+        if (it != memo_.end()) return it->second;
+        const bool outer_truncated = truncated_;
+        truncated_ = false;
+
+        DWORD tag = 0;
+        ULONGLONG length = 0;
+        type->get_symTag(&tag);
+        type->get_length(&length);
+        uint64_t h = hash_mix(hash_mix(SEED, static_cast<uint64_t>(tag)), static_cast<uint64_t>(length));
+
+        CComPtr<IDiaSymbol> inner;
+        switch (tag) {
+            case SymTagUDT:
+                h = hash_mix(h, safe_symbol_name(type));
+                if (depth < MAX_DEPTH) {
+                    h = hash_mix(h, udt(type, depth).hash);
+                } else {
+                    truncated_ = true;
+                }
+                break;
+            case SymTagBaseType: {
+                DWORD base = 0;
+                type->get_baseType(&base);
+                h = hash_mix(h, static_cast<uint64_t>(base));
+                break;
+            }
+            case SymTagPointerType: {
+                BOOL ref = FALSE;
+                type->get_reference(&ref);
+                h = hash_mix(h, static_cast<uint64_t>(ref));
+                if (SUCCEEDED(type->get_type(&inner)) && inner) {
+                    DWORD inner_tag = 0;
+                    inner->get_symTag(&inner_tag);
+                    // Named pointees by name (breaks cycles), others structurally
+                    if (inner_tag == SymTagUDT || inner_tag == SymTagEnum) {
+                        h = hash_mix(h, safe_symbol_name(inner));
+                    } else if (depth < MAX_DEPTH) {
+                        h = hash_mix(h, type_hash(inner, depth + 1));
+                    } else {
+                        truncated_ = true;
+                    }
+                }
+                break;
+            }
+            case SymTagArrayType:
+            case SymTagTypedef:
+                if (SUCCEEDED(type->get_type(&inner)) && inner) {
+                    if (depth < MAX_DEPTH) {
+                        h = hash_mix(h, type_hash(inner, depth + 1));
+                    } else {
+                        truncated_ = true;
+                    }
+                }
+                break;
+            default:
+                h = hash_mix(h, safe_symbol_name(type));
+                break;
+        }
+        if (!truncated_) memo_.emplace(id, h);
+        truncated_ = truncated_ || outer_truncated;
+        return h;
+    }
+};
+
+// One (name, structural hash) group among UDT names defined more than once
+struct CachedTypeDuplicate {
+    std::string name;
+    uint64_t hash = 0;
+    DWORD first_id = 0;
+    ULONGLONG size = 0;
+    DWORD members = 0;
+    DWORD copies = 0;     // Definitions with this name and hash
+    DWORD variants = 0;   // Distinct hashes for this name (> 1: layouts disagree)
+};
+
+// type_duplicates rows, built once per session. UDTs are hashed in parallel:
+// each worker opens its own session on the same PDB (DIA objects are never
+// shared across threads) and hashes a range of the UDT enumeration; rows use
+// this session's ids, matched by enumeration index and name.
+class TypeDuplicateCache {
+    PdbSession& session_;
+    std::shared_ptr<const std::vector<CachedTypeDuplicate>> rows_;
+
+    struct Record {
+        DWORD id = 0;
+        std::string name;
+        ULONGLONG size = 0;
+        StructuralHasher::UdtHash hash;
+        bool hashed = false;
+    };
+
+    // Hash records[begin, end) from enumeration position `begin` of `symbols`
+    static void hash_range(IDiaEnumSymbols* symbols, std::vector<Record>& records, size_t begin, size_t end) {
+        if (!symbols || (begin > 0 && FAILED(symbols->Skip(static_cast<ULONG>(begin))))) return;
+        StructuralHasher hasher;
+        for (size_t i = begin; i < end; i++) {
+            CComPtr<IDiaSymbol> udt;
+            ULONG fetched = 0;
+            if (FAILED(symbols->Next(1, &udt, &fetched)) || fetched != 1) return;
+            Record& r = records[i];
+            if (safe_symbol_name(udt) != r.name) return;  // Enumeration differs; the caller redoes the rest
+            r.hash = hasher.udt(udt);
+            r.hashed = true;
+        }
+    }
+
+    std::vector<Record> hash_all() {
+        std::vector<Record> records;
+        auto udts = session_.enum_symbols(SymTagUDT);
+        CComPtr<IDiaSymbol> udt;
+        ULONG fetched = 0;
+        while (udts && SUCCEEDED(udts->Next(1, &udt, &fetched)) && fetched == 1) {
+            Record r;
+            udt->get_symIndexId(&r.id);
+            r.name = safe_symbol_name(udt);
+            udt->get_length(&r.size);
+            records.push_back(std::move(r));
+            udt.Release();
+        }
+
+        const size_t per_worker = 4096;
+        unsigned jobs = (std::max)(1u, std::thread::hardware_concurrency());
+        jobs = static_cast<unsigned>((std::min<size_t>)(jobs, records.size() / per_worker + 1));
+        if (jobs > 1 && !session_.path().empty()) {
+            const size_t chunk = (records.size() + jobs - 1) / jobs;
+            std::vector<std::thread> threads;
+            const std::string path = session_.path();
+            for (unsigned w = 1; w < jobs; w++) {
+                threads.emplace_back([&records, path, w, chunk] {
+                    Tracer::name_thread("type_hash");
+                    TraceSpan span("type_hash.range", "cache");
+                    PdbSession worker;
+                    if (!worker.open(path)) return;
+                    hash_range(worker.enum_symbols(SymTagUDT), records, w * chunk,
+                               (std::min)(records.size(), (w + 1) * chunk));
+                });
+            }
+            hash_range(session_.enum_symbols(SymTagUDT), records, 0, (std::min)(records.size(), chunk));
+            for (auto& t : threads) t.join();
+        }
+
+        // Anything a worker could not do (single-threaded, open failure) is hashed here
+        StructuralHasher hasher;
+        for (Record& r : records) {
+            if (r.hashed) continue;
+            CComPtr<IDiaSymbol> symbol;
+            IDiaSession* dia_session = session_.session();
+            if (dia_session && SUCCEEDED(dia_session->symbolById(r.id, &symbol)) && symbol) {
+                r.hash = hasher.udt(symbol);
+                r.hashed = true;
+            }
+        }
+        return records;
+    }
+
+    void build() {
+        TraceSpan span("type_duplicates.build", "cache");
+        std::vector<Record> records = hash_all();
+
+        std::unordered_map<std::string, std::vector<size_t>> by_name;
+        for (size_t i = 0; i < records.size(); i++) {
+            if (records[i].hashed && !records[i].name.empty()) by_name[records[i].name].push_back(i);
+        }
+
+        auto rows = std::make_shared<std::vector<CachedTypeDuplicate>>();
+        for (const auto& [name, indices] : by_name) {
+            if (indices.size() < 2) continue;
+            const size_t first_row = rows->size();
+            for (size_t i : indices) {
+                const Record& r = records[i];
+                auto it = std::find_if(rows->begin() + static_cast<std::ptrdiff_t>(first_row), rows->end(),
+                                       [&r](const CachedTypeDuplicate& d) { return d.hash == r.hash.hash; });
+                if (it != rows->end()) {
+                    it->copies++;
+                    continue;
+                }
+                CachedTypeDuplicate d;
+                d.name = name;
+                d.hash = r.hash.hash;
+                d.first_id = r.id;
+                d.size = r.size;
+                d.members = r.hash.members;
+                d.copies = 1;
+                rows->push_back(std::move(d));
+            }
+            const DWORD variants = static_cast<DWORD>(rows->size() - first_row);
+            for (size_t k = first_row; k < rows->size(); k++) (*rows)[k].variants = variants;
+        }
+        std::sort(rows->begin(), rows->end(), [](const CachedTypeDuplicate& a, const CachedTypeDuplicate& b) {
+            if (a.variants != b.variants) return a.variants > b.variants;
+            if (a.name != b.name) return a.name < b.name;
+            return a.copies > b.copies;
+        });
+        span.arg("udts", records.size()).arg("rows", rows->size());
+        rows_ = std::move(rows);
+    }
+
+public:
+    explicit TypeDuplicateCache(PdbSession& session) : session_(session) {}
+
+    std::shared_ptr<const std::vector<CachedTypeDuplicate>> rows() {
+        if (!rows_) build();
+        return rows_;
+    }
+};
+
+// ============================================================================
+// Inline sites (S_INLINESITE)
+// ============================================================================
+
+// One address range of an inlined call. DIA decodes the site's binary
+// annotations into line records; each record is one row.
+struct CachedInlineSite {
+    DWORD site_id = 0;
+    DWORD parent_id = 0;        // Enclosing inline site, or func_id at depth 1
+    DWORD func_id = 0;          // Out-of-line function the code was inlined into
+    std::string func_name;
+    std::string inlinee;
+    DWORD depth = 0;            // 1 = inlined directly into func_id
+    DWORD call_file_id = 0;     // Call site in the parent
+    DWORD call_line = 0;
+    DWORD rva = 0;
+    DWORD length = 0;
+    DWORD file_id = 0;          // Inlinee source at the start of the range
+    DWORD line = 0;
+};
+
+// Walks every function (or one, by id) depth-first through blocks and nested
+// inline sites with an explicit stack, streaming one row per decoded range.
+// Names are read once per site, not per range.
+class InlineSiteGenerator : public xsql::Generator<CachedInlineSite> {
+    struct Scope {
+        CComPtr<IDiaSymbol> symbol;
+        CComPtr<IDiaEnumSymbols> children;
+        DWORD id = 0;           // Nearest inline site or function (blocks inherit it)
+        DWORD depth = 0;
+        bool is_site = false;
+    };
+
+    PdbSession& session_;
+    DWORD only_func_id_ = 0;
+    CComPtr<IDiaEnumSymbols> functions_;
+    std::vector<Scope> stack_;
+    CComPtr<IDiaEnumLineNumbers> ranges_;
+    CComPtr<IDiaSymbol> call_parent_;   // Set until the call site is resolved
+    bool call_parent_is_site_ = false;
+    CachedInlineSite site_;     // Per-site columns; ranges fill the rest
+    CachedInlineSite current_;
+    sqlite3_int64 rowid_ = -1;
+    bool started_ = false;
+
+    static void first_line(IDiaEnumLineNumbers* lines, DWORD& file_id, DWORD& line) {
+        CComPtr<IDiaLineNumber> first;
+        ULONG fetched = 0;
+        if (lines && SUCCEEDED(lines->Next(1, &first, &fetched)) && fetched == 1) {
+            first->get_sourceFileId(&file_id);
+            first->get_lineNumber(&line);
+        }
+    }
+
+    bool push_function(IDiaSymbol* func) {
+        stack_.clear();
+        Scope scope;
+        scope.symbol = func;
+        func->get_symIndexId(&scope.id);
+        if (FAILED(func->findChildren(SymTagNull, nullptr, nsNone, &scope.children)) || !scope.children) return false;
+        site_ = {};
+        site_.func_id = scope.id;
+        site_.func_name = safe_symbol_name(func);
+        stack_.push_back(std::move(scope));
+        return true;
+    }
+
+    bool next_function() {
+        if (only_func_id_) {
+            if (functions_ || started_) return false;
+            started_ = true;
+            IDiaSession* dia_session = session_.session();
+            CComPtr<IDiaSymbol> func;
+            DWORD tag = 0;
+            if (!dia_session || FAILED(dia_session->symbolById(only_func_id_, &func)) || !func ||
+                FAILED(func->get_symTag(&tag)) || tag != SymTagFunction) {
+                return false;
+            }
+            return push_function(func);
+        }
+        if (!started_) {
+            started_ = true;
+            functions_ = session_.enum_symbols(SymTagFunction);
+        }
+        CComPtr<IDiaSymbol> func;
+        ULONG fetched = 0;
+        while (functions_ && SUCCEEDED(functions_->Next(1, &func, &fetched)) && fetched == 1) {
+            if (push_function(func)) return true;
+            func.Release();
+        }
+        return false;
+    }
+
+    // The call site is the parent's line at the start of the site's first range
+    void resolve_call_site(DWORD start) {
+        CComPtr<IDiaEnumLineNumbers> call;
+        if (call_parent_is_site_) {
+            call_parent_->findInlineeLinesByRVA(start, 1, &call);
+        } else if (IDiaSession* dia_session = session_.session()) {
+            dia_session->findLinesByRVA(start, 1, &call);
+        }
+        first_line(call, site_.call_file_id, site_.call_line);
+        call_parent_.Release();
+    }
+
+    // Enter an inline site: per-site columns and its decoded ranges
+    void enter_site(IDiaSymbol* site, const Scope& parent) {
+        Scope scope;
+        scope.symbol = site;
+        site->get_symIndexId(&scope.id);
+        scope.depth = parent.depth + 1;
+        scope.is_site = true;
+        site->findChildren(SymTagNull, nullptr, nsNone, &scope.children);
+
+        site_.site_id = scope.id;
+        site_.parent_id = parent.id;
+        site_.depth = scope.depth;
+        site_.inlinee = safe_symbol_name(site);
+        site_.call_file_id = 0;
+        site_.call_line = 0;
+
+        ranges_.Release();
+        site->findInlineeLines(&ranges_);
+        call_parent_ = parent.symbol;
+        call_parent_is_site_ = parent.is_site;
+
+        stack_.push_back(std::move(scope));
+    }
+
+public:
+    explicit InlineSiteGenerator(PdbSession& session, DWORD only_func_id = 0)
+        : session_(session), only_func_id_(only_func_id) {}
+
+    bool next() override {
+        while (true) {
+            if (ranges_) {
+                CComPtr<IDiaLineNumber> range;
+                ULONG fetched = 0;
+                if (SUCCEEDED(ranges_->Next(1, &range, &fetched)) && fetched == 1) {
+                    DWORD rva = 0;
+                    range->get_relativeVirtualAddress(&rva);
+                    if (call_parent_) resolve_call_site(rva);
+                    current_ = site_;
+                    current_.rva = rva;
+                    range->get_length(&current_.length);
+                    range->get_sourceFileId(&current_.file_id);
+                    range->get_lineNumber(&current_.line);
+                    ++rowid_;
+                    return true;
+                }
+                ranges_.Release();
+                call_parent_.Release();
+            }
+
+            if (stack_.empty()) {
+                if (!next_function()) return false;
+                continue;
+            }
+
+            CComPtr<IDiaSymbol> child;
+            ULONG fetched = 0;
+            Scope& top = stack_.back();
+            if (!top.children || FAILED(top.children->Next(1, &child, &fetched)) || fetched != 1) {
+                stack_.pop_back();
+                continue;
+            }
+
+            DWORD tag = 0;
+            child->get_symTag(&tag);
+            if (tag == SymTagInlineSite) {
+                enter_site(child, top);
+            } else if (tag == SymTagBlock) {
+                Scope block;
+                block.symbol = child;
+                block.id = top.id;
+                block.depth = top.depth;
+                block.is_site = top.is_site;
+                child->findChildren(SymTagNull, nullptr, nsNone, &block.children);
+                stack_.push_back(std::move(block));
+            }
+        }
+    }
+
+    const CachedInlineSite& current() const override { return current_; }
+    sqlite3_int64 rowid() const override { return rowid_; }
+};
+
+// Inline call chain at an RVA, innermost first and ending with the
+// out-of-line function: "inner <- outer <- Function". Empty if no function
+// covers the address.
+inline std::string inline_chain_at(PdbSession& session, DWORD rva) {
+    IDiaSession* dia_session = session.session();
+    CComPtr<IDiaSymbol> func;
+    if (!dia_session || FAILED(dia_session->findSymbolByRVA(rva, SymTagFunction, &func)) || !func) return "";
+
+    std::vector<std::pair<DWORD, std::string>> frames;  // (depth, name)
+    CComPtr<IDiaEnumSymbols> sites;
+    if (SUCCEEDED(func->findInlineFramesByRVA(rva, &sites)) && sites) {
+        CComPtr<IDiaSymbol> site;
+        ULONG fetched = 0;
+        while (SUCCEEDED(sites->Next(1, &site, &fetched)) && fetched == 1) {
+            DWORD depth = 0;
+            CComPtr<IDiaSymbol> scope = site;
+            for (int guard = 0; scope && guard < 64; guard++) {
+                DWORD tag = 0;
+                scope->get_symTag(&tag);
+                if (tag == SymTagFunction) break;
+                if (tag == SymTagInlineSite) depth++;
+                CComPtr<IDiaSymbol> parent;
+                if (FAILED(scope->get_lexicalParent(&parent))) break;
+                scope = parent;
+            }
+            frames.emplace_back(depth, safe_symbol_name(site));
+            site.Release();
+        }
+    }
+    std::stable_sort(frames.begin(), frames.end(),
+                     [](const auto& a, const auto& b) { return a.first > b.first; });
+
+    std::string chain;
+    for (const auto& frame : frames) {
+        chain += frame.second;
+        chain += " <- ";
+    }
+    chain += safe_symbol_name(func);
+    return chain;
+}
+
+// SQL: inlinees_at(rva) -> inline_chain_at() text, NULL if nothing covers rva
+inline void inlinees_at_sql(sqlite3_context* ctx, int argc, sqlite3_value** argv) {
+    if (argc != 1 || sqlite3_value_type(argv[0]) == SQLITE_NULL) {
+        sqlite3_result_null(ctx);
+        return;
+    }
+    const sqlite3_int64 rva = sqlite3_value_int64(argv[0]);
+    if (rva < 0 || rva > 0xFFFFFFFFLL) {
+        sqlite3_result_null(ctx);
+        return;
+    }
+    auto* session = static_cast<PdbSession*>(sqlite3_user_data(ctx));
+    std::string chain = inline_chain_at(*session, static_cast<DWORD>(rva));
+    if (chain.empty()) {
+        sqlite3_result_null(ctx);
+        return;
+    }
+    sqlite3_result_text(ctx, chain.c_str(), static_cast<int>(chain.size()), SQLITE_TRANSIENT);
+}
+
+// ============================================================================
+// RVA interval index
+// ============================================================================
+
+// Point lookups over [start, start + size) ranges kept sorted by start.
+// max_end_[i] is the highest end among ranges [0, i], so a lookup only walks
+// back over ranges that can still cover the address; for the usual
+// non-overlapping tables that is a single step after the binary search.
+class RvaIntervalIndex {
+    std::vector<DWORD> starts_;
+    std::vector<ULONGLONG> ends_;
+    std::vector<ULONGLONG> max_end_;
+
+public:
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    // rows must already be sorted by start
+    template<typename Row, typename Start, typename Size>
+    void build(const std::vector<Row>& rows, Start start, Size size) {
+        starts_.resize(rows.size());
+        ends_.resize(rows.size());
+        max_end_.resize(rows.size());
+        ULONGLONG max_end = 0;
+        for (size_t i = 0; i < rows.size(); i++) {
+            starts_[i] = start(rows[i]);
+            ends_[i] = static_cast<ULONGLONG>(starts_[i]) + size(rows[i]);
+            max_end = (std::max)(max_end, ends_[i]);
+            max_end_[i] = max_end;
+        }
+    }
+
+    // Index of the covering range with the latest start (innermost), or npos
+    size_t find(DWORD rva) const {
+        size_t i = static_cast<size_t>(std::upper_bound(starts_.begin(), starts_.end(), rva) - starts_.begin());
+        for (; i > 0 && max_end_[i - 1] > rva; i--) {
+            if (ends_[i - 1] > rva) return i - 1;
+        }
+        return npos;
+    }
+};
+
+// ============================================================================
+// Frame data (FPO / FrameData stack unwinding records)
+// ============================================================================
+
+struct CachedFrameData {
+    DWORD rva_start = 0;
+    DWORD probe_rva = 0;        // Address looked up by probe_rva = ?; rva_start otherwise
+    DWORD code_size = 0;
+    DWORD locals_size = 0;
+    DWORD params_size = 0;
+    DWORD max_stack = 0;
+    DWORD prolog_size = 0;
+    DWORD saved_regs_size = 0;
+    DWORD frame_type = 0;       // FrameTypeFPO, FrameTypeFrameData, ...
+    bool function_start = false;
+    bool uses_bp = false;
+    bool seh = false;
+    bool cpp_eh = false;
+    std::string program;
+};
+
+inline const char* frame_type_name(DWORD type) {
+    switch (type) {
+        case FrameTypeFPO: return "fpo";
+        case FrameTypeTrap: return "trap";
+        case FrameTypeTSS: return "tss";
+        case FrameTypeStandard: return "standard";
+        case FrameTypeFrameData: return "framedata";
+        default: return "unknown";
+    }
+}
+
+// The FrameData table read once per session into an array sorted by start
+// RVA, with an interval index for address lookups.
+class FrameDataCache {
+    PdbSession& session_;
+    std::shared_ptr<const std::vector<CachedFrameData>> rows_;
+    RvaIntervalIndex index_;
+
+    struct RvaStartLess {
+        bool operator()(const CachedFrameData& a, DWORD b) const { return a.rva_start < b; }
+        bool operator()(DWORD a, const CachedFrameData& b) const { return a < b.rva_start; }
+    };
+
+    void build() {
+        TraceSpan span("frame_data.build", "cache");
+        auto rows = std::make_shared<std::vector<CachedFrameData>>();
+        auto frames = find_dia_table<IDiaEnumFrameData>(session_, L"FrameData", IID_IDiaEnumFrameData);
+        LONG count = 0;
+        if (frames && SUCCEEDED(frames->get_Count(&count)) && count > 0) {
+            rows->reserve(static_cast<size_t>(count));
+        }
+
+        CComPtr<IDiaFrameData> frame;
+        ULONG fetched = 0;
+        while (frames && SUCCEEDED(frames->Next(1, &frame, &fetched)) && fetched == 1) {
+            CachedFrameData fd;
+            frame->get_relativeVirtualAddressStart(&fd.rva_start);
+            fd.probe_rva = fd.rva_start;
+            frame->get_lengthBlock(&fd.code_size);
+            frame->get_lengthLocals(&fd.locals_size);
+            frame->get_lengthParams(&fd.params_size);
+            frame->get_maxStack(&fd.max_stack);
+            frame->get_lengthProlog(&fd.prolog_size);
+            frame->get_lengthSavedRegisters(&fd.saved_regs_size);
+            frame->get_type(&fd.frame_type);
+
+            BOOL val = FALSE;
+            if (SUCCEEDED(frame->get_functionStart(&val))) fd.function_start = (val != FALSE);
+            if (SUCCEEDED(frame->get_allocatesBasePointer(&val))) fd.uses_bp = (val != FALSE);
+            if (SUCCEEDED(frame->get_systemExceptionHandling(&val))) fd.seh = (val != FALSE);
+            if (SUCCEEDED(frame->get_cplusplusExceptionHandling(&val))) fd.cpp_eh = (val != FALSE);
+
+            SafeBSTR program;
+            if (SUCCEEDED(frame->get_program(program.ptr()))) fd.program = program.str();
+
+            rows->push_back(std::move(fd));
+            frame.Release();
+        }
+
+        std::stable_sort(rows->begin(), rows->end(), [](const CachedFrameData& a, const CachedFrameData& b) {
+            return a.rva_start < b.rva_start;
+        });
+        index_.build(*rows, [](const CachedFrameData& fd) { return fd.rva_start; },
+                     [](const CachedFrameData& fd) { return fd.code_size; });
+        span.arg("rows", rows->size());
+        rows_ = std::move(rows);
+    }
+
+public:
+    explicit FrameDataCache(PdbSession& session) : session_(session) {}
+
+    std::shared_ptr<const std::vector<CachedFrameData>> rows() {
+        if (!rows_) build();
+        return rows_;
+    }
+
+    // Innermost record covering rva (the latest start), or nullptr
+    const CachedFrameData* find(DWORD rva) {
+        const auto& rows = *this->rows();
+        size_t i = index_.find(rva);
+        return i == RvaIntervalIndex::npos ? nullptr : &rows[i];
+    }
+
+    // frame_data rows for `WHERE probe_rva = ?`: the covering record, with
+    // probe_rva set to the address asked for so SQLite's own equality check
+    // keeps it. rva and rva_start stay the record's start.
+    std::unique_ptr<xsql::Generator<CachedFrameData>> covering(DWORD rva) {
+        const CachedFrameData* fd = find(rva);
+        if (!fd) return std::make_unique<VectorGenerator<CachedFrameData>>(nullptr);
+        auto row = std::make_shared<std::vector<CachedFrameData>>(1, *fd);
+        row->front().probe_rva = rva;
+        return std::make_unique<VectorGenerator<CachedFrameData>>(std::move(row));
+    }
+
+    // frame_data rows for `WHERE rva = ?`: records starting at rva, as a full
+    // scan would return them
+    std::unique_ptr<xsql::Generator<CachedFrameData>> starting_at(DWORD rva) {
+        auto rows = this->rows();
+        auto range = std::equal_range(rows->begin(), rows->end(), rva, RvaStartLess{});
+        const size_t begin = static_cast<size_t>(range.first - rows->begin());
+        const size_t end = static_cast<size_t>(range.second - rows->begin());
+        return std::make_unique<VectorGenerator<CachedFrameData>>(std::move(rows), begin, end);
+    }
+
+};
+
+// ============================================================================
+// Section contributions
+// ============================================================================
+
+// One SectionContribs record: the bytes a compiland put into a section.
+struct CachedSectionContrib {
+    DWORD section = 0;
+    DWORD offset = 0;
+    DWORD rva = 0;
+    DWORD length = 0;
+    DWORD compiland_id = 0;
+    DWORD characteristics = 0;  // IMAGE_SCN_* of the contributing COFF section
+    bool read = false;
+    bool write = false;
+    bool execute = false;
+    bool code = false;
+};
+
+// COFF alignment bits (IMAGE_SCN_ALIGN_MASK) differ per contribution and mean
+// nothing for the linked section, so they are left out of its flags.
+constexpr DWORD SCN_ALIGN_MASK = 0x00F00000;
+
+// The SectionContribs table read once per session, sorted by RVA with an
+// interval index. The sections table is derived from the same pass.
+class SectionContribCache {
+    PdbSession& session_;
+    std::shared_ptr<const std::vector<CachedSectionContrib>> contribs_;
+    std::shared_ptr<const std::vector<CachedSection>> sections_;
+    RvaIntervalIndex index_;
+
+    void build() {
+        TraceSpan span("section_contributions.build", "cache");
+        auto contribs = std::make_shared<std::vector<CachedSectionContrib>>();
+        auto table = find_dia_table<IDiaEnumSectionContribs>(session_, L"SectionContribs",
+                                                             IID_IDiaEnumSectionContribs);
+        LONG count = 0;
+        if (table && SUCCEEDED(table->get_Count(&count)) && count > 0) {
+            contribs->reserve(static_cast<size_t>(count));
+        }
+
+        CComPtr<IDiaSectionContrib> contrib;
+        ULONG fetched = 0;
+        while (table && SUCCEEDED(table->Next(1, &contrib, &fetched)) && fetched == 1) {
+            CachedSectionContrib c;
+            contrib->get_addressSection(&c.section);
+            contrib->get_addressOffset(&c.offset);
+            contrib->get_relativeVirtualAddress(&c.rva);
+            contrib->get_length(&c.length);
+            contrib->get_compilandId(&c.compiland_id);
+            contrib->get_characteristics(&c.characteristics);
+
+            BOOL val = FALSE;
+            if (SUCCEEDED(contrib->get_read(&val))) c.read = (val != FALSE);
+            if (SUCCEEDED(contrib->get_write(&val))) c.write = (val != FALSE);
+            if (SUCCEEDED(contrib->get_execute(&val))) c.execute = (val != FALSE);
+            if (SUCCEEDED(contrib->get_code(&val))) c.code = (val != FALSE);
+
+            contribs->push_back(c);
+            contrib.Release();
+        }
+
+        std::stable_sort(contribs->begin(), contribs->end(),
+                         [](const CachedSectionContrib& a, const CachedSectionContrib& b) { return a.rva < b.rva; });
+        index_.build(*contribs, [](const CachedSectionContrib& c) { return c.rva; },
+                     [](const CachedSectionContrib& c) { return c.length; });
+
+        // Sections: extent and combined flags of their contributions
+        std::unordered_map<DWORD, CachedSection> by_number;
+        for (const CachedSectionContrib& c : *contribs) {
+            auto [it, inserted] = by_number.emplace(c.section, CachedSection{});
+            CachedSection& cs = it->second;
+            if (inserted) {
+                cs.section_number = c.section;
+                cs.rva = c.rva;
+            }
+            const DWORD end = (std::max)(cs.rva + cs.length, c.rva + c.length);
+            cs.rva = (std::min)(cs.rva, c.rva);
+            cs.length = end - cs.rva;
+            cs.characteristics |= c.characteristics & ~SCN_ALIGN_MASK;
+            cs.read = cs.read || c.read;
+            cs.write = cs.write || c.write;
+            cs.execute = cs.execute || c.execute;
+            cs.code = cs.code || c.code;
+        }
+        auto sections = std::make_shared<std::vector<CachedSection>>();
+        sections->reserve(by_number.size());
+        for (auto& [number, section] : by_number) {
+            sections->push_back(std::move(section));
+        }
+        std::sort(sections->begin(), sections->end(), [](const CachedSection& a, const CachedSection& b) {
+            return a.section_number < b.section_number;
+        });
+
+        span.arg("contributions", contribs->size()).arg("sections", sections->size());
+        contribs_ = std::move(contribs);
+        sections_ = std::move(sections);
+    }
+
+public:
+    explicit SectionContribCache(PdbSession& session) : session_(session) {}
+
+    std::shared_ptr<const std::vector<CachedSectionContrib>> contributions() {
+        if (!contribs_) build();
+        return contribs_;
+    }
+
+    std::shared_ptr<const std::vector<CachedSection>> sections() {
+        if (!sections_) build();
+        return sections_;
+    }
+
+    // Contribution covering rva, or nullptr
+    const CachedSectionContrib* contrib_at(DWORD rva) {
+        const auto& contribs = *contributions();
+        size_t i = index_.find(rva);
+        return i == RvaIntervalIndex::npos ? nullptr : &contribs[i];
+    }
+};
+
+// SQL: contrib_at(rva) -> compiland_id of the contribution covering rva, or NULL
+inline void contrib_at_sql(sqlite3_context* ctx, int argc, sqlite3_value** argv) {
+    if (argc != 1 || sqlite3_value_type(argv[0]) == SQLITE_NULL) {
+        sqlite3_result_null(ctx);
+        return;
+    }
+    const sqlite3_int64 rva = sqlite3_value_int64(argv[0]);
+    if (rva < 0 || rva > 0xFFFFFFFFLL) {
+        sqlite3_result_null(ctx);
+        return;
+    }
+    auto* cache = static_cast<SectionContribCache*>(sqlite3_user_data(ctx));
+    const CachedSectionContrib* contrib = cache->contrib_at(static_cast<DWORD>(rva));
+    if (!contrib) {
+        sqlite3_result_null(ctx);
+        return;
+    }
+    sqlite3_result_int64(ctx, static_cast<sqlite3_int64>(contrib->compiland_id));
+}
+
+// SQL: undecorate(name[, flags]) -> undecorated name (UNDNAME_* flags), or the
+// input unchanged when it is not an MSVC decorated name
+inline void undecorate_sql(sqlite3_context* ctx, int argc, sqlite3_value** argv) {
+    if (argc < 1 || argc > 2 || sqlite3_value_type(argv[0]) == SQLITE_NULL) {
+        sqlite3_result_null(ctx);
+        return;
+    }
+    const char* name = reinterpret_cast<const char*>(sqlite3_value_text(argv[0]));
+    const size_t len = static_cast<size_t>(sqlite3_value_bytes(argv[0]));
+    const unsigned flags = argc == 2 ? static_cast<unsigned>(sqlite3_value_int(argv[1])) : UNDECORATE_COMPLETE;
+    auto* cache = static_cast<UndecorateCache*>(sqlite3_user_data(ctx));
+    const std::string& result = cache->get(std::string_view(name ? name : "", len), flags);
+    sqlite3_result_text(ctx, result.c_str(), static_cast<int>(result.size()), SQLITE_TRANSIENT);
+}
+
+// ============================================================================
+// Symbol search
+// ============================================================================
+
+// One ranked match of a symbol_search query
+struct CachedSearchHit {
+    std::string query;          // Echoes the pushed-down query so SQLite's check passes
+    int rank = 0;               // 1 = best
+    int score = 0;
+    const char* kind = "";      // function, public, udt, data, enum
+    DWORD id = 0;
+    std::string name;
+    std::string undecorated;
+};
+
+// Name index over functions, publics, udts, data and enums, built on the
+// first search and reused for the session.
+class SymbolSearchCache {
+    PdbSession& session_;
+    struct Symbol {
+        const char* kind;
+        DWORD id;
+    };
+    std::vector<Symbol> symbols_;   // Parallel to the index entries
+    SymbolSearchIndex index_;
+    bool built_ = false;
+
+    void build() {
+        TraceSpan span("symbol_search.build", "cache");
+        static const std::pair<enum SymTagEnum, const char*> kinds[] = {
+            {SymTagFunction, "function"}, {SymTagPublicSymbol, "public"}, {SymTagUDT, "udt"},
+            {SymTagData, "data"}, {SymTagEnum, "enum"},
+        };
+        for (const auto& [tag, kind] : kinds) {
+            auto symbols = session_.enum_symbols(tag);
+            CComPtr<IDiaSymbol> symbol;
+            ULONG fetched = 0;
+            while (symbols && SUCCEEDED(symbols->Next(1, &symbol, &fetched)) && fetched == 1) {
+                std::string name = safe_symbol_name(symbol);
+                if (!name.empty()) {
+                    Symbol sym{kind, 0};
+                    symbol->get_symIndexId(&sym.id);
+                    SafeBSTR undec;
+                    std::string undecorated;
+                    if (SUCCEEDED(symbol->get_undecoratedName(undec.ptr()))) undecorated = undec.str();
+                    if (undecorated.empty() && name[0] == '?') undecorated = undecorate(name);
+                    index_.add(name, undecorated);
+                    symbols_.push_back(sym);
+                }
+                symbol.Release();
+            }
+        }
+        index_.finish();
+        built_ = true;
+        span.arg("symbols", symbols_.size());
+    }
+
+public:
+    // Rows a query returns at most; LIMIT in SQL picks fewer
+    static constexpr size_t MAX_RESULTS = 100;
+
+    explicit SymbolSearchCache(PdbSession& session) : session_(session) {}
+
+    std::shared_ptr<const std::vector<CachedSearchHit>> search(const std::string& query) {
+        if (!built_) build();
+        auto rows = std::make_shared<std::vector<CachedSearchHit>>();
+        const std::vector<SymbolSearchHit> hits = index_.search(query, MAX_RESULTS);
+        rows->reserve(hits.size());
+        for (size_t i = 0; i < hits.size(); i++) {
+            const Symbol& sym = symbols_[hits[i].entry];
+            CachedSearchHit row;
+            row.query = query;
+            row.rank = static_cast<int>(i + 1);
+            row.score = hits[i].score;
+            row.kind = sym.kind;
+            row.id = sym.id;
+            row.name = index_.name(hits[i].entry);
+            row.undecorated = index_.undecorated(hits[i].entry);
+            rows->push_back(std::move(row));
+        }
+        return rows;
+    }
+};
+
 // ============================================================================
 // Table Definitions
 // ============================================================================
@@ -1790,7 +3048,9 @@ public:
 inline GeneratorTableDef<CachedSymbol> define_functions_table(PdbSession& session) {
     return generator_table<CachedSymbol>("functions")
         .estimate_rows([&session]() { return to_size_t_clamped(session.count_symbols(SymTagFunction)); })
-        .generator([&session]() { return std::make_unique<SymbolGenerator>(session, SymTagFunction); })
+        .generator([&session, scans = &Metrics::global().table("functions")]() {
+            return counted(*scans, std::make_unique<SymbolGenerator>(session, SymTagFunction));
+        })
         .column_int64("id", [](const CachedSymbol& r) { return static_cast<int64_t>(r.id); })
         .column_text("name", [](const CachedSymbol& r) { return r.name; })
         .column_text("undecorated", [](const CachedSymbol& r) { return r.undecorated; })
@@ -1805,7 +3065,9 @@ inline GeneratorTableDef<CachedSymbol> define_functions_table(PdbSession& sessio
 inline GeneratorTableDef<CachedSymbol> define_publics_table(PdbSession& session) {
     return generator_table<CachedSymbol>("publics")
         .estimate_rows([&session]() { return to_size_t_clamped(session.count_symbols(SymTagPublicSymbol)); })
-        .generator([&session]() { return std::make_unique<SymbolGenerator>(session, SymTagPublicSymbol); })
+        .generator([&session, scans = &Metrics::global().table("publics")]() {
+            return counted(*scans, std::make_unique<SymbolGenerator>(session, SymTagPublicSymbol));
+        })
         .column_int64("id", [](const CachedSymbol& r) { return static_cast<int64_t>(r.id); })
         .column_text("name", [](const CachedSymbol& r) { return r.name; })
         .column_text("undecorated", [](const CachedSymbol& r) { return r.undecorated; })
@@ -1820,7 +3082,9 @@ inline GeneratorTableDef<CachedSymbol> define_publics_table(PdbSession& session)
 inline GeneratorTableDef<CachedSymbol> define_data_table(PdbSession& session) {
     return generator_table<CachedSymbol>("data")
         .estimate_rows([&session]() { return to_size_t_clamped(session.count_symbols(SymTagData)); })
-        .generator([&session]() { return std::make_unique<SymbolGenerator>(session, SymTagData); })
+        .generator([&session, scans = &Metrics::global().table("data")]() {
+            return counted(*scans, std::make_unique<SymbolGenerator>(session, SymTagData));
+        })
         .column_int64("id", [](const CachedSymbol& r) { return static_cast<int64_t>(r.id); })
         .column_text("name", [](const CachedSymbol& r) { return r.name; })
         .column_int64("rva", [](const CachedSymbol& r) { return static_cast<int64_t>(r.rva); })
@@ -1834,7 +3098,9 @@ inline GeneratorTableDef<CachedSymbol> define_data_table(PdbSession& session) {
 inline GeneratorTableDef<CachedSymbol> define_udts_table(PdbSession& session) {
     return generator_table<CachedSymbol>("udts")
         .estimate_rows([&session]() { return to_size_t_clamped(session.count_symbols(SymTagUDT)); })
-        .generator([&session]() { return std::make_unique<SymbolGenerator>(session, SymTagUDT); })
+        .generator([&session, scans = &Metrics::global().table("udts")]() {
+            return counted(*scans, std::make_unique<SymbolGenerator>(session, SymTagUDT));
+        })
         .column_int64("id", [](const CachedSymbol& r) { return static_cast<int64_t>(r.id); })
         .column_text("name", [](const CachedSymbol& r) { return r.name; })
         .column_int64("length", [](const CachedSymbol& r) { return static_cast<int64_t>(r.length); })
@@ -1845,7 +3111,9 @@ inline GeneratorTableDef<CachedSymbol> define_udts_table(PdbSession& session) {
 inline GeneratorTableDef<CachedSymbol> define_enums_table(PdbSession& session) {
     return generator_table<CachedSymbol>("enums")
         .estimate_rows([&session]() { return to_size_t_clamped(session.count_symbols(SymTagEnum)); })
-        .generator([&session]() { return std::make_unique<SymbolGenerator>(session, SymTagEnum); })
+        .generator([&session, scans = &Metrics::global().table("enums")]() {
+            return counted(*scans, std::make_unique<SymbolGenerator>(session, SymTagEnum));
+        })
         .column_int64("id", [](const CachedSymbol& r) { return static_cast<int64_t>(r.id); })
         .column_text("name", [](const CachedSymbol& r) { return r.name; })
         .column_int64("length", [](const CachedSymbol& r) { return static_cast<int64_t>(r.length); })
@@ -1856,7 +3124,9 @@ inline GeneratorTableDef<CachedSymbol> define_enums_table(PdbSession& session) {
 inline GeneratorTableDef<CachedSymbol> define_typedefs_table(PdbSession& session) {
     return generator_table<CachedSymbol>("typedefs")
         .estimate_rows([&session]() { return to_size_t_clamped(session.count_symbols(SymTagTypedef)); })
-        .generator([&session]() { return std::make_unique<SymbolGenerator>(session, SymTagTypedef); })
+        .generator([&session, scans = &Metrics::global().table("typedefs")]() {
+            return counted(*scans, std::make_unique<SymbolGenerator>(session, SymTagTypedef));
+        })
         .column_int64("id", [](const CachedSymbol& r) { return static_cast<int64_t>(r.id); })
         .column_text("name", [](const CachedSymbol& r) { return r.name; })
         .column_int64("length", [](const CachedSymbol& r) { return static_cast<int64_t>(r.length); })
@@ -1867,7 +3137,9 @@ inline GeneratorTableDef<CachedSymbol> define_typedefs_table(PdbSession& session
 inline GeneratorTableDef<CachedCompiland> define_compilands_table(PdbSession& session) {
     return generator_table<CachedCompiland>("compilands")
         .estimate_rows([&session]() { return to_size_t_clamped(session.count_symbols(SymTagCompiland)); })
-        .generator([&session]() { return std::make_unique<CompilandGenerator>(session); })
+        .generator([&session, scans = &Metrics::global().table("compilands")]() {
+            return counted(*scans, std::make_unique<CompilandGenerator>(session));
+        })
         .column_int64("id", [](const CachedCompiland& r) { return static_cast<int64_t>(r.id); })
         .column_text("name", [](const CachedCompiland& r) { return r.name; })
         .column_text("library", [](const CachedCompiland& r) { return r.library_name; })
@@ -1879,7 +3151,9 @@ inline GeneratorTableDef<CachedCompiland> define_compilands_table(PdbSession& se
 inline GeneratorTableDef<CachedSourceFile> define_source_files_table(PdbSession& session) {
     return generator_table<CachedSourceFile>("source_files")
         .estimate_rows([]() { return static_cast<size_t>(1000); })
-        .generator([&session]() { return std::make_unique<SourceFileGenerator>(session); })
+        .generator([&session, scans = &Metrics::global().table("source_files")]() {
+            return counted(*scans, std::make_unique<SourceFileGenerator>(session));
+        })
         .column_int64("id", [](const CachedSourceFile& r) { return static_cast<int64_t>(r.id); })
         .column_text("filename", [](const CachedSourceFile& r) { return r.filename; })
         .column_int("checksum_type", [](const CachedSourceFile& r) { return static_cast<int>(r.checksum_type); })
@@ -1890,7 +3164,9 @@ inline GeneratorTableDef<CachedSourceFile> define_source_files_table(PdbSession&
 inline GeneratorTableDef<CachedLineNumber> define_line_numbers_table(PdbSession& session) {
     return generator_table<CachedLineNumber>("line_numbers")
         .estimate_rows([]() { return static_cast<size_t>(100000); })
-        .generator([&session]() { return std::make_unique<LineNumberGenerator>(session); })
+        .generator([&session, scans = &Metrics::global().table("line_numbers")]() {
+            return counted(*scans, std::make_unique<LineNumberGenerator>(session));
+        })
         .column_int64("file_id", [](const CachedLineNumber& r) { return static_cast<int64_t>(r.file_id); })
         .column_int("line", [](const CachedLineNumber& r) { return static_cast<int>(r.line); })
         .column_int("column", [](const CachedLineNumber& r) { return static_cast<int>(r.column); })
@@ -1901,14 +3177,16 @@ inline GeneratorTableDef<CachedLineNumber> define_line_numbers_table(PdbSession&
 }
 
 // Sections table
-inline GeneratorTableDef<CachedSection> define_sections_table(PdbSession& session) {
+inline GeneratorTableDef<CachedSection> define_sections_table(SectionContribCache& cache) {
     return generator_table<CachedSection>("sections")
         .estimate_rows([]() { return static_cast<size_t>(128); })
-        .generator([&session]() { return std::make_unique<SectionGenerator>(session); })
+        .generator([&cache, scans = &Metrics::global().table("sections")]() {
+            return counted(*scans, std::make_unique<VectorGenerator<CachedSection>>(cache.sections()));
+        })
         .column_int("number", [](const CachedSection& r) { return static_cast<int>(r.section_number); })
         .column_int64("rva", [](const CachedSection& r) { return static_cast<int64_t>(r.rva); })
         .column_int("length", [](const CachedSection& r) { return static_cast<int>(r.length); })
-        .column_int("characteristics", [](const CachedSection& r) { return static_cast<int>(r.characteristics); })
+        .column_int64("characteristics", [](const CachedSection& r) { return static_cast<int64_t>(r.characteristics); })
         .column_int("readable", [](const CachedSection& r) { return r.read ? 1 : 0; })
         .column_int("writable", [](const CachedSection& r) { return r.write ? 1 : 0; })
         .column_int("executable", [](const CachedSection& r) { return r.execute ? 1 : 0; })
@@ -1916,11 +3194,58 @@ inline GeneratorTableDef<CachedSection> define_sections_table(PdbSession& sessio
         .build();
 }
 
+// Section contributions table (which compiland owns which bytes)
+inline GeneratorTableDef<CachedSectionContrib> define_section_contributions_table(SectionContribCache& cache) {
+    return generator_table<CachedSectionContrib>("section_contributions")
+        .estimate_rows([]() { return static_cast<size_t>(100000); })
+        .generator([&cache, scans = &Metrics::global().table("section_contributions")]() {
+            return counted(*scans, std::make_unique<VectorGenerator<CachedSectionContrib>>(cache.contributions()));
+        })
+        .column_int("section", [](const CachedSectionContrib& r) { return static_cast<int>(r.section); })
+        .column_int64("offset", [](const CachedSectionContrib& r) { return static_cast<int64_t>(r.offset); })
+        .column_int64("rva", [](const CachedSectionContrib& r) { return static_cast<int64_t>(r.rva); })
+        .column_int64("length", [](const CachedSectionContrib& r) { return static_cast<int64_t>(r.length); })
+        .column_int64("compiland_id", [](const CachedSectionContrib& r) { return static_cast<int64_t>(r.compiland_id); })
+        .column_int64("characteristics", [](const CachedSectionContrib& r) { return static_cast<int64_t>(r.characteristics); })
+        .column_int("readable", [](const CachedSectionContrib& r) { return r.read ? 1 : 0; })
+        .column_int("writable", [](const CachedSectionContrib& r) { return r.write ? 1 : 0; })
+        .column_int("executable", [](const CachedSectionContrib& r) { return r.execute ? 1 : 0; })
+        .column_int("code", [](const CachedSectionContrib& r) { return r.code ? 1 : 0; })
+        .build();
+}
+
+// Frame data table (FPO / FrameData unwind records)
+inline GeneratorTableDef<CachedFrameData> define_frame_data_table(FrameDataCache& cache) {
+    return generator_table<CachedFrameData>("frame_data")
+        .estimate_rows([]() { return static_cast<size_t>(100000); })
+        .generator([&cache, scans = &Metrics::global().table("frame_data")]() {
+            return counted(*scans, std::make_unique<VectorGenerator<CachedFrameData>>(cache.rows()));
+        })
+        .column_int64("rva", [](const CachedFrameData& r) { return static_cast<int64_t>(r.rva_start); })
+        .column_int64("rva_start", [](const CachedFrameData& r) { return static_cast<int64_t>(r.rva_start); })
+        .column_int64("code_size", [](const CachedFrameData& r) { return static_cast<int64_t>(r.code_size); })
+        .column_int64("locals_size", [](const CachedFrameData& r) { return static_cast<int64_t>(r.locals_size); })
+        .column_int64("params_size", [](const CachedFrameData& r) { return static_cast<int64_t>(r.params_size); })
+        .column_int64("max_stack", [](const CachedFrameData& r) { return static_cast<int64_t>(r.max_stack); })
+        .column_int("prolog_size", [](const CachedFrameData& r) { return static_cast<int>(r.prolog_size); })
+        .column_int("saved_regs_size", [](const CachedFrameData& r) { return static_cast<int>(r.saved_regs_size); })
+        .column_text("type", [](const CachedFrameData& r) { return std::string(frame_type_name(r.frame_type)); })
+        .column_int("function_start", [](const CachedFrameData& r) { return r.function_start ? 1 : 0; })
+        .column_int("uses_bp", [](const CachedFrameData& r) { return r.uses_bp ? 1 : 0; })
+        .column_int("seh", [](const CachedFrameData& r) { return r.seh ? 1 : 0; })
+        .column_int("cpp_eh", [](const CachedFrameData& r) { return r.cpp_eh ? 1 : 0; })
+        .column_text("program", [](const CachedFrameData& r) { return r.program; })
+        .column_int64("probe_rva", [](const CachedFrameData& r) { return static_cast<int64_t>(r.probe_rva); })
+        .build();
+}
+
 // Thunks table
 inline GeneratorTableDef<CachedSymbol> define_thunks_table(PdbSession& session) {
     return generator_table<CachedSymbol>("thunks")
         .estimate_rows([&session]() { return to_size_t_clamped(session.count_symbols(SymTagThunk)); })
-        .generator([&session]() { return std::make_unique<SymbolGenerator>(session, SymTagThunk); })
+        .generator([&session, scans = &Metrics::global().table("thunks")]() {
+            return counted(*scans, std::make_unique<SymbolGenerator>(session, SymTagThunk));
+        })
         .column_int64("id", [](const CachedSymbol& r) { return static_cast<int64_t>(r.id); })
         .column_text("name", [](const CachedSymbol& r) { return r.name; })
         .column_int64("rva", [](const CachedSymbol& r) { return static_cast<int64_t>(r.rva); })
@@ -1933,7 +3258,9 @@ inline GeneratorTableDef<CachedSymbol> define_thunks_table(PdbSession& session)
 inline GeneratorTableDef<CachedSymbol> define_labels_table(PdbSession& session) {
     return generator_table<CachedSymbol>("labels")
         .estimate_rows([&session]() { return to_size_t_clamped(session.count_symbols(SymTagLabel)); })
-        .generator([&session]() { return std::make_unique<SymbolGenerator>(session, SymTagLabel); })
+        .generator([&session, scans = &Metrics::global().table("labels")]() {
+            return counted(*scans, std::make_unique<SymbolGenerator>(session, SymTagLabel));
+        })
         .column_int64("id", [](const CachedSymbol& r) { return static_cast<int64_t>(r.id); })
         .column_text("name", [](const CachedSymbol& r) { return r.name; })
         .column_int64("rva", [](const CachedSymbol& r) { return static_cast<int64_t>(r.rva); })
@@ -1946,7 +3273,9 @@ inline GeneratorTableDef<CachedSymbol> define_labels_table(PdbSession& session)
 inline GeneratorTableDef<CachedMember> define_udt_members_table(PdbSession& session) {
     return generator_table<CachedMember>("udt_members")
         .estimate_rows([]() { return static_cast<size_t>(100000); })
-        .generator([&session]() { return std::make_unique<MemberGenerator>(session); })
+        .generator([&session, scans = &Metrics::global().table("udt_members")]() {
+            return counted(*scans, std::make_unique<MemberGenerator>(session));
+        })
         .column_int64("udt_id", [](const CachedMember& r) { return static_cast<int64_t>(r.parent_id); })
         .column_text("udt_name", [](const CachedMember& r) { return r.parent_name; })
         .column_int64("id", [](const CachedMember& r) { return static_cast<int64_t>(r.id); })
@@ -1960,11 +3289,100 @@ inline GeneratorTableDef<CachedMember> define_udt_members_table(PdbSession& sess
         .build();
 }
 
+// UDT layout table (pahole-style: padding, holes, cache lines)
+inline GeneratorTableDef<CachedLayoutMember> define_udt_layout_table(PdbSession& session, UdtLayoutCache& cache) {
+    return generator_table<CachedLayoutMember>("udt_layout")
+        .estimate_rows([&session]() { return to_size_t_clamped(session.count_symbols(SymTagUDT)) * 8; })
+        .generator([&cache, scans = &Metrics::global().table("udt_layout")]() {
+            return counted(*scans, std::make_unique<VectorGenerator<CachedLayoutMember>>(cache.all()));
+        })
+        .column_int64("udt_id", [](const CachedLayoutMember& r) { return static_cast<int64_t>(r.udt_id); })
+        .column_text("udt_name", [](const CachedLayoutMember& r) { return r.udt_name; })
+        .column_int64("udt_size", [](const CachedLayoutMember& r) { return static_cast<int64_t>(r.udt_size); })
+        .column_int("ordinal", [](const CachedLayoutMember& r) { return static_cast<int>(r.ordinal); })
+        .column_text("kind", [](const CachedLayoutMember& r) { return r.kind; })
+        .column_text("name", [](const CachedLayoutMember& r) { return r.name; })
+        .column_text("type", [](const CachedLayoutMember& r) { return r.type_name; })
+        .column_int("offset", [](const CachedLayoutMember& r) { return static_cast<int>(r.offset); })
+        .column_int64("size", [](const CachedLayoutMember& r) { return static_cast<int64_t>(r.size); })
+        .column_int("bit_position", [](const CachedLayoutMember& r) { return static_cast<int>(r.bit_position); })
+        .column_int("bit_length", [](const CachedLayoutMember& r) { return static_cast<int>(r.bit_length); })
+        .column_int64("padding_after", [](const CachedLayoutMember& r) { return static_cast<int64_t>(r.padding_after); })
+        .column_int64("cache_line", [](const CachedLayoutMember& r) { return static_cast<int64_t>(r.cache_line()); })
+        .column_int("crosses_cache_line", [](const CachedLayoutMember& r) { return r.crosses_cache_line() ? 1 : 0; })
+        .column_int64("holes", [](const CachedLayoutMember& r) { return static_cast<int64_t>(r.holes); })
+        .column_int64("tail_padding", [](const CachedLayoutMember& r) { return static_cast<int64_t>(r.tail_padding); })
+        .build();
+}
+
+// Duplicate type definitions (same UDT name defined more than once)
+inline GeneratorTableDef<CachedTypeDuplicate> define_type_duplicates_table(TypeDuplicateCache& cache) {
+    return generator_table<CachedTypeDuplicate>("type_duplicates")
+        .estimate_rows([]() { return static_cast<size_t>(1000); })
+        .generator([&cache, scans = &Metrics::global().table("type_duplicates")]() {
+            return counted(*scans, std::make_unique<VectorGenerator<CachedTypeDuplicate>>(cache.rows()));
+        })
+        .column_text("name", [](const CachedTypeDuplicate& r) { return r.name; })
+        .column_text("hash", [](const CachedTypeDuplicate& r) {
+            char buf[24];
+            snprintf(buf, sizeof(buf), "%016llx", static_cast<unsigned long long>(r.hash));
+            return std::string(buf);
+        })
+        .column_int64("udt_id", [](const CachedTypeDuplicate& r) { return static_cast<int64_t>(r.first_id); })
+        .column_int64("size", [](const CachedTypeDuplicate& r) { return static_cast<int64_t>(r.size); })
+        .column_int("members", [](const CachedTypeDuplicate& r) { return static_cast<int>(r.members); })
+        .column_int("copies", [](const CachedTypeDuplicate& r) { return static_cast<int>(r.copies); })
+        .column_int("variants", [](const CachedTypeDuplicate& r) { return static_cast<int>(r.variants); })
+        .column_int("odr_violation", [](const CachedTypeDuplicate& r) { return r.variants > 1 ? 1 : 0; })
+        .build();
+}
+
+// Symbol search table; rows only come from the query pushdown
+inline GeneratorTableDef<CachedSearchHit> define_symbol_search_table() {
+    return generator_table<CachedSearchHit>("symbol_search")
+        .estimate_rows([]() { return SymbolSearchCache::MAX_RESULTS; })
+        .generator([scans = &Metrics::global().table("symbol_search")]() {
+            return counted(*scans, std::make_unique<VectorGenerator<CachedSearchHit>>(nullptr));
+        })
+        .column_text("query", [](const CachedSearchHit& r) { return r.query; })
+        .column_int("rank", [](const CachedSearchHit& r) { return r.rank; })
+        .column_int("score", [](const CachedSearchHit& r) { return r.score; })
+        .column_text("kind", [](const CachedSearchHit& r) { return std::string(r.kind); })
+        .column_int64("id", [](const CachedSearchHit& r) { return static_cast<int64_t>(r.id); })
+        .column_text("name", [](const CachedSearchHit& r) { return r.name; })
+        .column_text("undecorated", [](const CachedSearchHit& r) { return r.undecorated; })
+        .build();
+}
+
+// Inline sites table (one row per decoded address range)
+inline GeneratorTableDef<CachedInlineSite> define_inline_sites_table(PdbSession& session) {
+    return generator_table<CachedInlineSite>("inline_sites")
+        .estimate_rows([&session]() { return to_size_t_clamped(session.count_symbols(SymTagFunction)) * 16; })
+        .generator([&session, scans = &Metrics::global().table("inline_sites")]() {
+            return counted(*scans, std::make_unique<InlineSiteGenerator>(session));
+        })
+        .column_int64("site_id", [](const CachedInlineSite& r) { return static_cast<int64_t>(r.site_id); })
+        .column_int64("parent_id", [](const CachedInlineSite& r) { return static_cast<int64_t>(r.parent_id); })
+        .column_int64("func_id", [](const CachedInlineSite& r) { return static_cast<int64_t>(r.func_id); })
+        .column_text("func_name", [](const CachedInlineSite& r) { return r.func_name; })
+        .column_text("inlinee", [](const CachedInlineSite& r) { return r.inlinee; })
+        .column_int("depth", [](const CachedInlineSite& r) { return static_cast<int>(r.depth); })
+        .column_int64("call_file_id", [](const CachedInlineSite& r) { return static_cast<int64_t>(r.call_file_id); })
+        .column_int("call_line", [](const CachedInlineSite& r) { return static_cast<int>(r.call_line); })
+        .column_int64("rva", [](const CachedInlineSite& r) { return static_cast<int64_t>(r.rva); })
+        .column_int64("length", [](const CachedInlineSite& r) { return static_cast<int64_t>(r.length); })
+        .column_int64("file_id", [](const CachedInlineSite& r) { return static_cast<int64_t>(r.file_id); })
+        .column_int("line", [](const CachedInlineSite& r) { return static_cast<int>(r.line); })
+        .build();
+}
+
 // Enum values table
 inline GeneratorTableDef<CachedEnumValue> define_enum_values_table(PdbSession& session) {
     return generator_table<CachedEnumValue>("enum_values")
         .estimate_rows([]() { return static_cast<size_t>(100000); })
-        .generator([&session]() { return std::make_unique<EnumValueGenerator>(session); })
+        .generator([&session, scans = &Metrics::global().table("enum_values")]() {
+            return counted(*scans, std::make_unique<EnumValueGenerator>(session));
+        })
         .column_int64("enum_id", [](const CachedEnumValue& r) { return static_cast<int64_t>(r.enum_id); })
         .column_text("enum_name", [](const CachedEnumValue& r) { return r.enum_name; })
         .column_int64("id", [](const CachedEnumValue& r) { return static_cast<int64_t>(r.id); })
@@ -1977,7 +3395,9 @@ inline GeneratorTableDef<CachedEnumValue> define_enum_values_table(PdbSession& s
 inline GeneratorTableDef<CachedBaseClass> define_base_classes_table(PdbSession& session) {
     return generator_table<CachedBaseClass>("base_classes")
         .estimate_rows([]() { return static_cast<size_t>(100000); })
-        .generator([&session]() { return std::make_unique<BaseClassGenerator>(session); })
+        .generator([&session, scans = &Metrics::global().table("base_classes")]() {
+            return counted(*scans, std::make_unique<BaseClassGenerator>(session));
+        })
         .column_int64("derived_id", [](const CachedBaseClass& r) { return static_cast<int64_t>(r.derived_id); })
         .column_text("derived_name", [](const CachedBaseClass& r) { return r.derived_name; })
         .column_int64("base_id", [](const CachedBaseClass& r) { return static_cast<int64_t>(r.base_id); })
@@ -1992,7 +3412,9 @@ inline GeneratorTableDef<CachedBaseClass> define_base_classes_table(PdbSession&
 inline GeneratorTableDef<CachedLocal> define_locals_table(PdbSession& session) {
     return generator_table<CachedLocal>("locals")
         .estimate_rows([]() { return static_cast<size_t>(100000); })
-        .generator([&session]() { return std::make_unique<LocalOrParamGenerator>(session, DataIsLocal); })
+        .generator([&session, scans = &Metrics::global().table("locals")]() {
+            return counted(*scans, std::make_unique<LocalOrParamGenerator>(session, DataIsLocal));
+        })
         .column_int64("func_id", [](const CachedLocal& r) { return static_cast<int64_t>(r.func_id); })
         .column_text("func_name", [](const CachedLocal& r) { return r.func_name; })
         .column_int64("id", [](const CachedLocal& r) { return static_cast<int64_t>(r.id); })
@@ -2007,7 +3429,9 @@ inline GeneratorTableDef<CachedLocal> define_locals_table(PdbSession& session) {
 inline GeneratorTableDef<CachedLocal> define_parameters_table(PdbSession& session) {
     return generator_table<CachedLocal>("parameters")
         .estimate_rows([]() { return static_cast<size_t>(100000); })
-        .generator([&session]() { return std::make_unique<LocalOrParamGenerator>(session, DataIsParam); })
+        .generator([&session, scans = &Metrics::global().table("parameters")]() {
+            return counted(*scans, std::make_unique<LocalOrParamGenerator>(session, DataIsParam));
+        })
         .column_int64("func_id", [](const CachedLocal& r) { return static_cast<int64_t>(r.func_id); })
         .column_text("func_name", [](const CachedLocal& r) { return r.func_name; })
         .column_int64("id", [](const CachedLocal& r) { return static_cast<int64_t>(r.id); })
@@ -2024,6 +3448,12 @@ inline GeneratorTableDef<CachedLocal> define_parameters_table(PdbSession& sessio
 
 class TableRegistry {
     PdbSession& session_;
+    UdtLayoutCache udt_layout_cache_;
+    TypeDuplicateCache type_duplicates_cache_;
+    FrameDataCache frame_data_cache_;
+    SectionContribCache section_contribs_cache_;
+    UndecorateCache undecorate_cache_;
+    SymbolSearchCache symbol_search_cache_;
 
     GeneratorTableDef<CachedSymbol> functions_;
     GeneratorTableDef<CachedSymbol> publics_;
@@ -2033,14 +3463,20 @@ class TableRegistry {
     GeneratorTableDef<CachedSymbol> typedefs_;
     GeneratorTableDef<CachedSymbol> thunks_;
     GeneratorTableDef<CachedSymbol> labels_;
+    GeneratorTableDef<CachedSearchHit> symbol_search_;
 
     GeneratorTableDef<CachedCompiland> compilands_;
     GeneratorTableDef<CachedSourceFile> source_files_;
     GeneratorTableDef<CachedLineNumber> line_numbers_;
+    GeneratorTableDef<CachedInlineSite> inline_sites_;
 
     GeneratorTableDef<CachedSection> sections_;
+    GeneratorTableDef<CachedSectionContrib> section_contributions_;
+    GeneratorTableDef<CachedFrameData> frame_data_;
 
     GeneratorTableDef<CachedMember> udt_members_;
+    GeneratorTableDef<CachedLayoutMember> udt_layout_;
+    GeneratorTableDef<CachedTypeDuplicate> type_duplicates_;
     GeneratorTableDef<CachedEnumValue> enum_values_;
     GeneratorTableDef<CachedBaseClass> base_classes_;
 
@@ -2049,6 +3485,8 @@ class TableRegistry {
 
     template<typename RowData>
     static void register_one(xsql::Database& db, GeneratorTableDef<RowData>& def) {
+        TraceSpan span("register_table", "setup");
+        span.arg("table", def.name);
         std::string module_name = "pdb_" + def.name;
         db.register_generator_table(module_name.c_str(), &def);
         db.create_table(def.name.c_str(), module_name.c_str());
@@ -2057,6 +3495,11 @@ class TableRegistry {
 public:
     explicit TableRegistry(PdbSession& session)
         : session_(session)
+        , udt_layout_cache_(session_)
+        , type_duplicates_cache_(session_)
+        , frame_data_cache_(session_)
+        , section_contribs_cache_(session_)
+        , symbol_search_cache_(session_)
         , functions_(define_functions_table(session_))
         , publics_(define_publics_table(session_))
         , data_(define_data_table(session_))
@@ -2065,11 +3508,17 @@ public:
         , typedefs_(define_typedefs_table(session_))
         , thunks_(define_thunks_table(session_))
         , labels_(define_labels_table(session_))
+        , symbol_search_(define_symbol_search_table())
         , compilands_(define_compilands_table(session_))
         , source_files_(define_source_files_table(session_))
         , line_numbers_(define_line_numbers_table(session_))
-        , sections_(define_sections_table(session_))
+        , inline_sites_(define_inline_sites_table(session_))
+        , sections_(define_sections_table(section_contribs_cache_))
+        , section_contributions_(define_section_contributions_table(section_contribs_cache_))
+        , frame_data_(define_frame_data_table(frame_data_cache_))
         , udt_members_(define_udt_members_table(session_))
+        , udt_layout_(define_udt_layout_table(session_, udt_layout_cache_))
+        , type_duplicates_(define_type_duplicates_table(type_duplicates_cache_))
         , enum_values_(define_enum_values_table(session_))
         , base_classes_(define_base_classes_table(session_))
         , locals_(define_locals_table(session_))
@@ -2215,6 +3664,23 @@ public:
                            },
                            10.0, 100.0);
 
+        auto* udt_layout_def = &udt_layout_;
+        add_filter_eq(udt_layout_, "udt_id",
+                      [udt_layout_def, this](int64_t id) -> std::unique_ptr<xsql::RowIterator> {
+                          if (id <= 0 || id > 0xFFFFFFFFLL) {
+                              return std::make_unique<GeneratorRowIterator<CachedLayoutMember>>(udt_layout_def, nullptr);
+                          }
+                          return std::make_unique<GeneratorRowIterator<CachedLayoutMember>>(
+                              udt_layout_def, udt_layout_cache_.by_id(static_cast<DWORD>(id)));
+                      },
+                      10.0, 20.0);
+        add_filter_eq_text(udt_layout_, "udt_name",
+                           [udt_layout_def, this](const char* name) -> std::unique_ptr<xsql::RowIterator> {
+                               return std::make_unique<GeneratorRowIterator<CachedLayoutMember>>(
+                                   udt_layout_def, udt_layout_cache_.by_name(name ? name : ""));
+                           },
+                           10.0, 20.0);
+
         auto* enum_values_def = &enum_values_;
         add_filter_eq(enum_values_, "enum_id",
                       [enum_values_def, this](int64_t id) -> std::unique_ptr<xsql::RowIterator> {
@@ -2281,9 +3747,52 @@ public:
                               std::make_unique<LineNumbersByCompilandIdGenerator>(session_, static_cast<DWORD>(id)));
                       },
                       50.0, 1000.0);
+
+        auto* inline_sites_def = &inline_sites_;
+        add_filter_eq(inline_sites_, "func_id",
+                      [inline_sites_def, this](int64_t id) -> std::unique_ptr<xsql::RowIterator> {
+                          if (id <= 0 || id > 0xFFFFFFFFLL) {
+                              return std::make_unique<GeneratorRowIterator<CachedInlineSite>>(inline_sites_def, nullptr);
+                          }
+                          return std::make_unique<GeneratorRowIterator<CachedInlineSite>>(
+                              inline_sites_def,
+                              std::make_unique<InlineSiteGenerator>(session_, static_cast<DWORD>(id)));
+                      },
+                      10.0, 100.0);
+
+        auto* frame_data_def = &frame_data_;
+        add_filter_eq(frame_data_, "probe_rva",
+                      [frame_data_def, this](int64_t rva) -> std::unique_ptr<xsql::RowIterator> {
+                          if (rva < 0 || rva > 0xFFFFFFFFLL) {
+                              return std::make_unique<GeneratorRowIterator<CachedFrameData>>(frame_data_def, nullptr);
+                          }
+                          return std::make_unique<GeneratorRowIterator<CachedFrameData>>(
+                              frame_data_def, frame_data_cache_.covering(static_cast<DWORD>(rva)));
+                      },
+                      1.0, 1.0);
+        add_filter_eq(frame_data_, "rva",
+                      [frame_data_def, this](int64_t rva) -> std::unique_ptr<xsql::RowIterator> {
+                          if (rva < 0 || rva > 0xFFFFFFFFLL) {
+                              return std::make_unique<GeneratorRowIterator<CachedFrameData>>(frame_data_def, nullptr);
+                          }
+                          return std::make_unique<GeneratorRowIterator<CachedFrameData>>(
+                              frame_data_def, frame_data_cache_.starting_at(static_cast<DWORD>(rva)));
+                      },
+                      1.0, 1.0);
+
+        auto* symbol_search_def = &symbol_search_;
+        add_filter_eq_text(symbol_search_, "query",
+                           [symbol_search_def, this](const char* query) -> std::unique_ptr<xsql::RowIterator> {
+                               return std::make_unique<GeneratorRowIterator<CachedSearchHit>>(
+                                   symbol_search_def,
+                                   std::make_unique<VectorGenerator<CachedSearchHit>>(
+                                       symbol_search_cache_.search(query ? query : "")));
+                           },
+                           1.0, static_cast<double>(SymbolSearchCache::MAX_RESULTS));
     }
 
     void register_all(xsql::Database& db) {
+        TraceSpan span("register_tables", "setup");
         register_one(db, functions_);
         register_one(db, publics_);
         register_one(db, data_);
@@ -2292,19 +3801,47 @@ public:
         register_one(db, typedefs_);
         register_one(db, thunks_);
         register_one(db, labels_);
+        register_one(db, symbol_search_);
 
         register_one(db, compilands_);
         register_one(db, source_files_);
         register_one(db, line_numbers_);
+        register_one(db, inline_sites_);
 
         register_one(db, sections_);
+        register_one(db, section_contributions_);
+        register_one(db, frame_data_);
 
         register_one(db, udt_members_);
+        register_one(db, udt_layout_);
+        register_one(db, type_duplicates_);
         register_one(db, enum_values_);
         register_one(db, base_classes_);
 
         register_one(db, locals_);
         register_one(db, parameters_);
+
+        sqlite3_create_function_v2(db.handle(), "inlinees_at", 1, SQLITE_UTF8, &session_,
+                                   inlinees_at_sql, nullptr, nullptr, nullptr);
+        sqlite3_create_function_v2(db.handle(), "contrib_at", 1, SQLITE_UTF8, &section_contribs_cache_,
+                                   contrib_at_sql, nullptr, nullptr, nullptr);
+        sqlite3_create_function_v2(db.handle(), "undecorate", -1, SQLITE_UTF8 | SQLITE_DETERMINISTIC,
+                                   &undecorate_cache_, undecorate_sql, nullptr, nullptr, nullptr);
+    }
+
+    // Also read by SizeReport, so contributions load once per session
+    SectionContribCache& section_contrib_cache() { return section_contribs_cache_; }
+
+    // Names of the tables register_all() creates, in registration order
+    std::vector<std::string> table_names() const {
+        return {
+            functions_.name, publics_.name, data_.name, udts_.name, enums_.name,
+            typedefs_.name, thunks_.name, labels_.name, symbol_search_.name,
+            compilands_.name, source_files_.name, line_numbers_.name, inline_sites_.name,
+            sections_.name, section_contributions_.name, frame_data_.name,
+            udt_members_.name, udt_layout_.name, type_duplicates_.name, enum_values_.name, base_classes_.name,
+            locals_.name, parameters_.name,
+        };
     }
 };
 
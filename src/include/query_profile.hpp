@@ -0,0 +1,221 @@
+#pragma once
+// query_profile.hpp - Per-query vtable profiling
+//
+// While a QueryProfile::Scope is active on a thread, the counted vtable
+// wrappers in pdb_tables.hpp record, per table: cursors opened (xFilter
+// calls), which plan each cursor used (full scan or filter #id), rows
+// emitted, next() calls and wall time spent in generators. explain() adds
+// SQLite's EXPLAIN QUERY PLAN so the two can be read side by side.
+//
+// Entry points: `.profile on` in the REPL, a leading `PROFILE` on a query
+// (REPL and socket server), and `profile: true` on HTTP requests.
+
+#include <xsql/database.hpp>
+
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace pdbsql {
+
+struct TableProfile {
+    std::string table;
+    uint64_t cursors = 0;                   // xFilter calls
+    std::map<std::string, uint64_t> plans;  // "full scan" / "filter #2 (name =)" -> cursors
+    uint64_t next_calls = 0;
+    uint64_t rows = 0;                      // Rows emitted to SQLite
+    uint64_t generator_ns = 0;              // Time inside generators (lookups + next())
+};
+
+class QueryProfile {
+public:
+    QueryProfile() : id_(next_id().fetch_add(1) + 1) {}
+
+    QueryProfile(const QueryProfile&) = delete;
+    QueryProfile& operator=(const QueryProfile&) = delete;
+
+    // Profile that vtable cursors on this thread report to (nullptr = none).
+    static QueryProfile* active() { return active_slot(); }
+
+    // Makes a profile active for the current thread; times the enclosed work.
+    class Scope {
+    public:
+        explicit Scope(QueryProfile& profile)
+            : profile_(profile)
+            , previous_(active_slot())
+            , start_(std::chrono::steady_clock::now())
+        {
+            active_slot() = &profile;
+        }
+        ~Scope() {
+            profile_.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+            active_slot() = previous_;
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        QueryProfile& profile_;
+        QueryProfile* previous_;
+        std::chrono::steady_clock::time_point start_;
+    };
+
+    // Unique per profile, so cursors can tell whether the profile they were
+    // opened under is still the active one.
+    uint64_t id() const { return id_; }
+
+    TableProfile& table(const std::string& name) {
+        auto it = tables_.find(name);
+        if (it != tables_.end()) return it->second;
+        order_.push_back(name);
+        TableProfile& t = tables_[name];
+        t.table = name;
+        return t;
+    }
+
+    std::vector<const TableProfile*> tables() const {
+        std::vector<const TableProfile*> out;
+        for (const auto& name : order_) out.push_back(&tables_.at(name));
+        return out;
+    }
+
+    uint64_t rows_emitted() const {
+        uint64_t total = 0;
+        for (const auto& [name, t] : tables_) total += t.rows;
+        return total;
+    }
+
+    // Rows SQLite consumed without returning them (residual WHERE terms,
+    // joins, aggregation). Only attributable per table when one table ran.
+    uint64_t rows_discarded() const {
+        uint64_t emitted = rows_emitted();
+        return emitted > rows_returned ? emitted - rows_returned : 0;
+    }
+
+    // Fill `plan` with EXPLAIN QUERY PLAN output for every statement in sql.
+    void explain(sqlite3* db, const std::string& sql) {
+        const char* tail = sql.c_str();
+        while (tail && *tail) {
+            sqlite3_stmt* stmt = nullptr;
+            const char* next = nullptr;
+            if (sqlite3_prepare_v2(db, tail, -1, &stmt, &next) != SQLITE_OK) {
+                plan.push_back(std::string("(plan unavailable: ") + sqlite3_errmsg(db) + ")");
+                return;
+            }
+            tail = next;
+            if (!stmt) continue;  // Whitespace / comment
+            std::string text = sqlite3_sql(stmt);
+            sqlite3_finalize(stmt);
+            explain_one(db, text);
+        }
+    }
+
+    // Tabular report (REPL, socket PROFILE results): one row per table, a
+    // "(query)" totals row, then one "(plan)" row per EXPLAIN QUERY PLAN line.
+    static std::vector<std::string> columns() {
+        return {"table", "cursors", "plan", "rows", "discarded", "next_calls", "ms"};
+    }
+
+    std::vector<std::vector<std::string>> rows() const {
+        std::vector<std::vector<std::string>> out;
+        const bool single = tables_.size() == 1;
+        for (const TableProfile* t : tables()) {
+            out.push_back({
+                t->table,
+                std::to_string(t->cursors),
+                plans_text(*t),
+                std::to_string(t->rows),
+                single ? std::to_string(rows_discarded()) : "-",
+                std::to_string(t->next_calls),
+                format_ms(static_cast<double>(t->generator_ns) / 1e6),
+            });
+        }
+        out.push_back({"(query)", "", "returned " + std::to_string(rows_returned),
+                       std::to_string(rows_emitted()), std::to_string(rows_discarded()), "",
+                       format_ms(seconds * 1000.0)});
+        for (const auto& line : plan) {
+            out.push_back({"(plan)", "", line, "", "", "", ""});
+        }
+        return out;
+    }
+
+    static std::string plans_text(const TableProfile& t) {
+        std::string text;
+        for (const auto& [label, count] : t.plans) {
+            if (!text.empty()) text += ", ";
+            text += label;
+            if (t.plans.size() > 1 || count > 1) text += " x" + std::to_string(count);
+        }
+        return text;
+    }
+
+    static std::string format_ms(double ms) {
+        char buf[32];
+        snprintf(buf, sizeof(buf), "%.3f", ms);
+        return buf;
+    }
+
+    std::vector<std::string> plan;  // EXPLAIN QUERY PLAN, indented by depth
+    uint64_t rows_returned = 0;
+    double seconds = 0.0;
+    bool timed = true;  // false: count cursors/plans/rows only, skip per-row clock reads
+
+private:
+    uint64_t id_;
+    std::map<std::string, TableProfile> tables_;
+    std::vector<std::string> order_;  // First-use order
+
+    static QueryProfile*& active_slot() {
+        thread_local QueryProfile* active = nullptr;
+        return active;
+    }
+
+    static std::atomic<uint64_t>& next_id() {
+        static std::atomic<uint64_t> id{0};
+        return id;
+    }
+
+    void explain_one(sqlite3* db, const std::string& sql) {
+        sqlite3_stmt* stmt = nullptr;
+        std::string eqp = "EXPLAIN QUERY PLAN " + sql;
+        if (sqlite3_prepare_v2(db, eqp.c_str(), -1, &stmt, nullptr) != SQLITE_OK || !stmt) {
+            if (stmt) sqlite3_finalize(stmt);
+            return;  // Not every statement can be explained
+        }
+        std::map<int, int> depth;  // node id -> depth
+        while (sqlite3_step(stmt) == SQLITE_ROW) {
+            int id = sqlite3_column_int(stmt, 0);
+            int parent = sqlite3_column_int(stmt, 1);
+            const unsigned char* detail = sqlite3_column_text(stmt, 3);
+            auto it = depth.find(parent);
+            int d = it == depth.end() ? 0 : it->second + 1;
+            depth[id] = d;
+            plan.push_back(std::string(static_cast<size_t>(d) * 2, ' ') +
+                           (detail ? reinterpret_cast<const char*>(detail) : ""));
+        }
+        sqlite3_finalize(stmt);
+    }
+};
+
+// Strip a leading PROFILE keyword. Returns false if the query has none.
+inline bool split_profile_directive(const std::string& sql, std::string& rest) {
+    size_t i = 0;
+    while (i < sql.size() && std::isspace(static_cast<unsigned char>(sql[i]))) i++;
+    static const char KEYWORD[] = "PROFILE";
+    const size_t n = sizeof(KEYWORD) - 1;
+    if (sql.size() - i <= n) return false;
+    for (size_t k = 0; k < n; k++) {
+        if (std::toupper(static_cast<unsigned char>(sql[i + k])) != KEYWORD[k]) return false;
+    }
+    if (!std::isspace(static_cast<unsigned char>(sql[i + n]))) return false;
+    rest = sql.substr(i + n + 1);
+    return true;
+}
+
+} // namespace pdbsql
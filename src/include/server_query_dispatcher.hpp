@@ -1,8 +1,11 @@
 #pragma once
 // server_query_dispatcher.hpp - Single-threaded server execution with queuing
 
+#include <chrono>
 #include <condition_variable>
+#include <functional>
 #include <future>
+#include <memory>
 #include <mutex>
 #include <queue>
 #include <string>
@@ -14,14 +17,49 @@
 #include <xsql/socket/server.hpp>
 
 #include "dia_helpers.hpp"  // For ComInit (COM init on worker thread)
+#include "metrics.hpp"
+#include "query_profile.hpp"
+#include "slow_query_log.hpp"
+#include "statement_cache.hpp"
+#include "trace.hpp"
 
 namespace pdbsql {
 
+// Where a query runs: database, its statement cache, and the SQL to execute
+// (with any routing directive already stripped).
+struct QueryTarget {
+    xsql::Database* db = nullptr;
+    StatementCache* statements = nullptr;
+    std::string sql;
+};
+
+// Resolves an incoming query to a target. Runs on the worker thread.
+using QueryRouter = std::function<bool(const std::string& sql, QueryTarget& target, std::string& error)>;
+
 // Runs all server queries on one COM-initialized worker thread with backpressure.
 class ServerQueryDispatcher {
 public:
-    explicit ServerQueryDispatcher(xsql::Database& db)
-        : db_(db), worker_(&ServerQueryDispatcher::worker_thread, this) {}
+    // Single database: every query runs against db.
+    explicit ServerQueryDispatcher(xsql::Database& db, size_t statement_cache_size = 64)
+        : statements_(std::make_unique<StatementCache>(db.handle(), statement_cache_size))
+    {
+        xsql::Database* db_ptr = &db;
+        StatementCache* cache = statements_.get();
+        router_ = [db_ptr, cache](const std::string& sql, QueryTarget& target, std::string&) {
+            target.db = db_ptr;
+            target.statements = cache;
+            target.sql = sql;
+            return true;
+        };
+        worker_ = std::thread(&ServerQueryDispatcher::worker_thread, this);
+    }
+
+    // Routed: the router picks the database per query (e.g. a SessionPool).
+    explicit ServerQueryDispatcher(QueryRouter router)
+        : router_(std::move(router))
+    {
+        worker_ = std::thread(&ServerQueryDispatcher::worker_thread, this);
+    }
 
     ~ServerQueryDispatcher() {
         {
@@ -34,32 +72,170 @@ public:
         }
     }
 
+    ServerQueryDispatcher(const ServerQueryDispatcher&) = delete;
+    ServerQueryDispatcher& operator=(const ServerQueryDispatcher&) = delete;
+
     // Enqueue a query and block until it completes.
     xsql::socket::QueryResult run(const std::string& sql) {
-        std::promise<xsql::socket::QueryResult> promise;
-        auto future = promise.get_future();
+        return call([this, &sql] {
+            SlowQueryWatch slow("server", std::string(), sql, queue_wait());
+            auto result = execute_routed(sql);
+            slow.finish(result.rows.size(), result.success, result.error);
+            return result;
+        });
+    }
+
+    // Run arbitrary work on the worker thread and block until it completes.
+    // Exceptions thrown by fn are rethrown to the caller.
+    template<typename F>
+    auto call(F&& fn) -> decltype(fn()) {
+        using R = decltype(fn());
+        auto task = std::make_shared<std::packaged_task<R()>>(std::forward<F>(fn));
+        auto future = task->get_future();
+        auto enqueued = std::chrono::steady_clock::now();
+
+        // Caller side of the trace: queue wait + execution, linked to the job by a flow arrow
+        Tracer& tracer = Tracer::global();
+        TraceSpan span("dispatcher.call", "dispatcher");
+        const uint64_t flow = span.active() ? tracer.next_flow_id() : 0;
+        if (flow) tracer.flow_start("dispatch", flow);
         {
             std::lock_guard<std::mutex> lock(mutex_);
-            queue_.push({sql, std::move(promise)});
+            queue_.push([task, enqueued, flow] {
+                const double wait = std::chrono::duration<double>(std::chrono::steady_clock::now() - enqueued).count();
+                Metrics::global().dispatcher_wait.observe(wait);
+                queue_wait() = wait;
+                if (flow) Tracer::global().flow_finish("dispatch", flow);
+                TraceSpan job("dispatcher.job", "dispatcher");
+                job.arg("queue_wait_ms", wait * 1000.0);
+                (*task)();
+            });
+            Metrics::global().dispatcher_queue_depth.add(1);
         }
         cv_.notify_one();
         return future.get();
     }
 
+    // Seconds the current job spent queued (worker thread only, i.e. inside call()).
+    static double& queue_wait() {
+        thread_local double wait = 0.0;
+        return wait;
+    }
+
+    // Resolve a query with the router (worker thread only, i.e. inside call()).
+    bool route(const std::string& sql, QueryTarget& target, std::string& error) {
+        return router_(sql, target, error);
+    }
+
 private:
-    struct Job {
-        std::string sql;
-        std::promise<xsql::socket::QueryResult> promise;
-    };
+    using Job = std::function<void()>;
 
-    xsql::Database& db_;
-    std::thread worker_;
+    QueryRouter router_;
+    std::unique_ptr<StatementCache> statements_;  // Single-database mode; worker-only
     std::mutex mutex_;
     std::condition_variable cv_;
     std::queue<Job> queue_;
     bool stop_ = false;
+    std::thread worker_;  // Last: started once everything above is constructed
+
+    static bool is_blank(const std::string& sql) {
+        for (char ch : sql) {
+            if (ch != ' ' && ch != '\t' && ch != '\r' && ch != '\n' && ch != ';') return false;
+        }
+        return true;
+    }
+
+    xsql::socket::QueryResult execute_routed(const std::string& sql) {
+        QueryTarget target;
+        std::string error;
+        if (!router_(sql, target, error) || !target.db) {
+            xsql::socket::QueryResult result;
+            result.success = false;
+            result.error = error.empty() ? "No database for query" : error;
+            return result;
+        }
+        if (is_blank(target.sql)) {
+            xsql::socket::QueryResult result;
+            result.success = true;
+            return result;
+        }
+        std::string profiled;
+        if (split_profile_directive(target.sql, profiled)) {
+            return execute_profiled(*target.db, target.statements, profiled);
+        }
+        return execute_sql(*target.db, target.statements, target.sql);
+    }
+
+    // PROFILE <sql>: run the query, drop its rows and return the profile report instead.
+    static xsql::socket::QueryResult execute_profiled(xsql::Database& db, StatementCache* statements,
+                                                      const std::string& sql) {
+        QueryProfile profile;
+        xsql::socket::QueryResult inner;
+        {
+            QueryProfile::Scope scope(profile);
+            inner = execute_sql(db, statements, sql);
+        }
+        if (!inner.success) return inner;
+        profile.rows_returned = inner.rows.size();
+        profile.explain(db.handle(), sql);
 
-    xsql::socket::QueryResult execute_sql(const std::string& sql) {
+        xsql::socket::QueryResult result;
+        result.success = true;
+        result.columns = QueryProfile::columns();
+        result.rows = profile.rows();
+        return result;
+    }
+
+    // Single statements go through the statement cache so repeated queries
+    // skip parsing and planning; scripts fall back to exec().
+    static xsql::socket::QueryResult execute_sql(xsql::Database& db, StatementCache* statements,
+                                                 const std::string& sql) {
+        if (statements) {
+            std::string error;
+            auto stmt = statements->acquire(sql, error);
+            if (stmt) {
+                return execute_statement(stmt.get());
+            }
+        }
+        return execute_script(db, sql);
+    }
+
+    static xsql::socket::QueryResult execute_statement(sqlite3_stmt* stmt) {
+        TraceSpan span("sql.step", "sql");
+        if (span.active()) span.arg("sql", sqlite3_sql(stmt));
+        xsql::socket::QueryResult result;
+        const int ncols = sqlite3_column_count(stmt);
+
+        int rc;
+        while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+            if (result.columns.empty()) {
+                for (int i = 0; i < ncols; i++) {
+                    const char* name = sqlite3_column_name(stmt, i);
+                    result.columns.push_back(name ? name : "");
+                }
+            }
+            std::vector<std::string> row;
+            row.reserve(static_cast<size_t>(ncols));
+            for (int i = 0; i < ncols; i++) {
+                const unsigned char* text = sqlite3_column_text(stmt, i);
+                row.push_back(text ? reinterpret_cast<const char*>(text) : "");
+            }
+            result.rows.push_back(std::move(row));
+        }
+
+        if (rc != SQLITE_DONE) {
+            result.success = false;
+            result.error = sqlite3_errmsg(sqlite3_db_handle(stmt));
+        } else {
+            result.success = true;
+        }
+        span.arg("rows", result.rows.size());
+        return result;
+    }
+
+    static xsql::socket::QueryResult execute_script(xsql::Database& db, const std::string& sql) {
+        TraceSpan span("sql.exec", "sql");
+        span.arg("sql", sql);
         xsql::socket::QueryResult result;
 
         struct Context {
@@ -67,7 +243,7 @@ private:
             bool first_row;
         } ctx{ &result, true };
 
-        int rc = db_.exec(sql.c_str(),
+        int rc = db.exec(sql.c_str(),
             [](void* data, int argc, char** argv, char** col_names) -> int {
                 auto* ctx = static_cast<Context*>(data);
                 if (ctx->first_row) {
@@ -88,7 +264,7 @@ private:
 
         if (rc != SQLITE_OK) {
             result.success = false;
-            result.error = db_.last_error();
+            result.error = db.last_error();
         } else {
             result.success = true;
         }
@@ -99,6 +275,7 @@ private:
     void worker_thread() {
         // Ensure COM is initialized on the worker that touches DIA through xsql tables.
         ComInit com_init;
+        Tracer::name_thread("dispatcher");
         while (true) {
             Job job;
             {
@@ -109,18 +286,12 @@ private:
                 }
                 job = std::move(queue_.front());
                 queue_.pop();
+                Metrics::global().dispatcher_queue_depth.add(-1);
             }
+            Metrics::global().dispatcher_jobs.inc();
 
-            try {
-                auto result = execute_sql(job.sql);
-                job.promise.set_value(std::move(result));
-            } catch (...) {
-                try {
-                    job.promise.set_exception(std::current_exception());
-                } catch (...) {
-                    // Swallow
-                }
-            }
+            // packaged_task captures exceptions for the waiting caller
+            job();
         }
     }
 };
@@ -0,0 +1,566 @@
+#pragma once
+// session_pool.hpp - LRU pool of open PDB sessions for multi-PDB servers
+//
+// A pool knows a set of PDBs (files or directories expanded at startup) and
+// keeps at most `memory_cap` bytes of them open. Queries are routed with a
+// leading directive:
+//
+//   USE ntdll; SELECT * FROM functions WHERE name = 'RtlAllocateHeap'
+//   USE 'C:\symbols\ntdll.pdb'; SELECT COUNT(*) FROM udts
+//   USE 1B2C3D4E5F60718293A4B5C6D7E8F9011; SELECT * FROM sections
+//
+// The identifier is a path, a module name (file stem) or the GUID+age
+// signature. Queries without a directive go to the only PDB when the pool
+// holds one, otherwise to the pool catalog (the `pdbs` table).
+//
+// With a symbol store index attached, the catalog also lists every indexed
+// PDB and a GUID+age signature opens the matching PDB on first use.
+//
+// Not thread-safe: use from a single (COM-initialized) thread, typically the
+// ServerQueryDispatcher worker.
+
+#include "metrics.hpp"
+#include "pdb_session.hpp"
+#include "pdb_tables.hpp"
+#include "server_query_dispatcher.hpp"
+#include "statement_cache.hpp"
+#include "symbol_store_index.hpp"
+
+#include <xsql/database.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <filesystem>
+#include <list>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <unordered_map>
+#include <vector>
+
+namespace pdbsql {
+
+// ============================================================================
+// Helpers
+// ============================================================================
+
+inline std::string to_lower_ascii(std::string s) {
+    for (char& ch : s) ch = static_cast<char>(std::tolower(static_cast<unsigned char>(ch)));
+    return s;
+}
+
+inline std::string to_upper_ascii(std::string s) {
+    for (char& ch : s) ch = static_cast<char>(std::toupper(static_cast<unsigned char>(ch)));
+    return s;
+}
+
+// Expand files and directories (recursively) into a sorted list of .pdb paths.
+inline std::vector<std::string> collect_pdb_paths(const std::vector<std::string>& specs, std::string& error) {
+    namespace fs = std::filesystem;
+    std::vector<std::string> paths;
+
+    for (const auto& spec : specs) {
+        std::error_code ec;
+        fs::path root = fs::u8path(spec);
+        if (fs::is_directory(root, ec)) {
+            fs::recursive_directory_iterator it(root, fs::directory_options::skip_permission_denied, ec);
+            for (; !ec && it != fs::recursive_directory_iterator(); it.increment(ec)) {
+                if (!it->is_regular_file(ec)) continue;
+                if (to_lower_ascii(it->path().extension().u8string()) == ".pdb") {
+                    paths.push_back(it->path().u8string());
+                }
+            }
+        } else if (fs::is_regular_file(root, ec)) {
+            paths.push_back(spec);
+        } else {
+            error = "PDB file or directory not found: " + spec;
+            return {};
+        }
+    }
+
+    std::sort(paths.begin(), paths.end());
+    paths.erase(std::unique(paths.begin(), paths.end()), paths.end());
+    return paths;
+}
+
+// Absolute, normalized, lowercased form of a PDB path, for telling whether
+// two spellings name the same file.
+inline std::string pdb_path_key(const std::string& path) {
+    std::error_code ec;
+    std::filesystem::path p = std::filesystem::u8path(path);
+    std::filesystem::path abs = std::filesystem::absolute(p, ec);
+    return to_lower_ascii((ec ? p : abs).lexically_normal().u8string());
+}
+
+// Split a leading "USE <pdb>;" directive off a query.
+// The identifier may be quoted ('...' or "...") to allow spaces.
+inline bool split_use_directive(const std::string& sql, std::string& pdb_id, std::string& rest) {
+    size_t i = 0;
+    auto skip_ws = [&]() {
+        while (i < sql.size() && std::isspace(static_cast<unsigned char>(sql[i]))) i++;
+    };
+
+    skip_ws();
+    if (sql.size() - i < 4) return false;
+    if (to_lower_ascii(sql.substr(i, 3)) != "use") return false;
+    if (!std::isspace(static_cast<unsigned char>(sql[i + 3]))) return false;
+    i += 3;
+    skip_ws();
+
+    std::string id;
+    if (i < sql.size() && (sql[i] == '\'' || sql[i] == '"')) {
+        char quote = sql[i++];
+        size_t end = sql.find(quote, i);
+        if (end == std::string::npos) return false;
+        id = sql.substr(i, end - i);
+        i = end + 1;
+    } else {
+        size_t start = i;
+        while (i < sql.size() && sql[i] != ';' && !std::isspace(static_cast<unsigned char>(sql[i]))) i++;
+        id = sql.substr(start, i - start);
+    }
+    if (id.empty()) return false;
+
+    skip_ws();
+    if (i < sql.size() && sql[i] == ';') i++;
+
+    pdb_id = id;
+    rest = sql.substr(i);
+    return true;
+}
+
+// ============================================================================
+// Session Pool
+// ============================================================================
+
+// Catalog row for a pooled PDB (also the row type of the `pdbs` table)
+struct PooledPdb {
+    std::string path;
+    std::string module;     // lower-case file stem
+    std::string signature;  // GUID+age from the MSF headers
+    uint64_t file_size = 0;
+    bool is_open = false;
+    uint64_t opens = 0;
+    uint64_t queries = 0;
+    int64_t index_record = -1;  // Record in the attached store index, if any
+};
+
+class SessionPool {
+    // An open PDB: session, its tables and a per-PDB statement cache.
+    // Member order matters: the database must go before the registry it points into.
+    struct Slot {
+        PdbSession session;
+        std::unique_ptr<TableRegistry> registry;
+        xsql::Database db;
+        std::unique_ptr<StatementCache> statements;
+        std::list<size_t>::iterator lru_pos;
+    };
+
+    static constexpr size_t AMBIGUOUS = static_cast<size_t>(-1);
+
+    std::vector<PooledPdb> entries_;
+    std::vector<std::unique_ptr<Slot>> slots_;  // Parallel to entries_; null when closed
+    // Named statements per entry (name -> SQL), parallel to entries_. Kept
+    // outside the slot so they are prepared again when an evicted PDB reopens.
+    std::vector<std::unordered_map<std::string, std::string>> named_sql_;
+    std::list<size_t> lru_;                     // Front = most recently used
+
+    std::unordered_map<std::string, size_t> by_path_;
+    std::unordered_map<std::string, size_t> by_module_;
+    std::unordered_map<std::string, size_t> by_signature_;
+
+    uint64_t memory_cap_ = 0;
+    uint64_t memory_used_ = 0;
+    uint64_t hits_ = 0;
+    uint64_t misses_ = 0;
+    uint64_t evictions_ = 0;
+
+    std::shared_ptr<const SymbolStoreIndex> index_;
+    std::unordered_map<size_t, size_t> by_index_record_;  // Index record -> entry
+
+    // Catalog database exposing the `pdbs` table
+    xsql::Database catalog_db_;
+    GeneratorTableDef<PooledPdb> pdbs_def_;
+    std::unique_ptr<StatementCache> catalog_statements_;
+
+    // Catalog row for an index record, merged with pool state once opened
+    PooledPdb index_row(size_t record) const {
+        auto it = by_index_record_.find(record);
+        if (it != by_index_record_.end()) return entries_[it->second];
+
+        PooledPdb row;
+        row.path = index_->path(record);
+        row.module = index_->module(record);
+        row.signature = index_->signature(record);
+        row.file_size = index_->record(record).file_size;
+        row.index_record = static_cast<int64_t>(record);
+        return row;
+    }
+
+    // Rows of the `pdbs` table: indexed PDBs first, then explicitly added ones
+    class CatalogGenerator : public xsql::Generator<PooledPdb> {
+        const SessionPool& pool_;
+        size_t idx_ = 0;
+        size_t index_count_ = 0;
+        PooledPdb current_;
+        sqlite3_int64 rowid_ = -1;
+        bool started_ = false;
+
+    public:
+        explicit CatalogGenerator(const SessionPool& pool)
+            : pool_(pool)
+            , index_count_(pool.index_ ? pool.index_->size() : 0)
+        {}
+
+        bool next() override {
+            if (started_) ++idx_;
+            started_ = true;
+            if (idx_ < index_count_) {
+                current_ = pool_.index_row(idx_);
+                rowid_ = static_cast<sqlite3_int64>(idx_);
+                return true;
+            }
+            while (idx_ - index_count_ < pool_.entries_.size()) {
+                const PooledPdb& entry = pool_.entries_[idx_ - index_count_];
+                if (entry.index_record < 0) {
+                    current_ = entry;
+                    rowid_ = static_cast<sqlite3_int64>(idx_);
+                    return true;
+                }
+                ++idx_;
+            }
+            return false;
+        }
+
+        const PooledPdb& current() const override { return current_; }
+        sqlite3_int64 rowid() const override { return rowid_; }
+    };
+
+    GeneratorTableDef<PooledPdb> define_pdbs_table() {
+        return generator_table<PooledPdb>("pdbs")
+            .estimate_rows([this]() { return entries_.size() + (index_ ? index_->size() : 0); })
+            .generator([this, scans = &Metrics::global().table("pdbs")]() {
+                return counted(*scans, std::make_unique<CatalogGenerator>(*this));
+            })
+            .column_text("path", [](const PooledPdb& r) { return r.path; })
+            .column_text("module", [](const PooledPdb& r) { return r.module; })
+            .column_text("signature", [](const PooledPdb& r) { return r.signature; })
+            .column_int64("file_size", [](const PooledPdb& r) { return static_cast<int64_t>(r.file_size); })
+            .column_int("is_open", [](const PooledPdb& r) { return r.is_open ? 1 : 0; })
+            .column_int64("opens", [](const PooledPdb& r) { return static_cast<int64_t>(r.opens); })
+            .column_int64("queries", [](const PooledPdb& r) { return static_cast<int64_t>(r.queries); })
+            .build();
+    }
+
+    // Catalog rows for an exact signature (binary search in the index)
+    std::vector<PooledPdb> rows_by_signature(const std::string& signature) const {
+        std::vector<PooledPdb> rows;
+        std::string key = to_upper_ascii(signature);
+        size_t record = 0;
+        if (index_ && index_->find_signature(key, record)) {
+            rows.push_back(index_row(record));
+            return rows;
+        }
+        auto it = by_signature_.find(key);
+        if (it != by_signature_.end()) rows.push_back(entries_[it->second]);
+        return rows;
+    }
+
+    void close_slot(size_t index) {
+        auto& slot = slots_[index];
+        if (!slot) return;
+        lru_.erase(slot->lru_pos);
+        slot.reset();
+        uint64_t released = (std::min)(memory_used_, entries_[index].file_size);
+        memory_used_ -= released;
+        entries_[index].is_open = false;
+        Metrics::global().pool_open_pdbs.add(-1);
+        Metrics::global().pool_memory_bytes.add(-static_cast<int64_t>(released));
+    }
+
+    void evict_for(uint64_t incoming) {
+        while (!lru_.empty() && memory_used_ + incoming > memory_cap_) {
+            close_slot(lru_.back());
+            ++evictions_;
+            Metrics::global().pool_evictions.inc();
+        }
+    }
+
+public:
+    explicit SessionPool(uint64_t memory_cap_bytes)
+        : memory_cap_(memory_cap_bytes)
+        , pdbs_def_(define_pdbs_table())
+    {
+        auto* pdbs_def = &pdbs_def_;
+        add_filter_eq_text(pdbs_def_, "signature",
+                           [pdbs_def, this](const char* signature) -> std::unique_ptr<xsql::RowIterator> {
+                               return std::make_unique<GeneratorRowIterator<PooledPdb>>(
+                                   pdbs_def,
+                                   std::make_unique<VectorGenerator<PooledPdb>>(
+                                       std::make_shared<const std::vector<PooledPdb>>(
+                                           rows_by_signature(signature ? signature : ""))));
+                           },
+                           1.0, 1.0);
+        catalog_db_.register_generator_table("pdb_pdbs", &pdbs_def_);
+        catalog_db_.create_table("pdbs", "pdb_pdbs");
+        catalog_statements_ = std::make_unique<StatementCache>(catalog_db_.handle());
+    }
+
+    ~SessionPool() { close_all(); }
+
+    SessionPool(const SessionPool&) = delete;
+    SessionPool& operator=(const SessionPool&) = delete;
+
+    // Register a PDB without opening it. Returns its index.
+    size_t add(const std::string& path) {
+        std::string key = pdb_path_key(path);
+        auto it = by_path_.find(key);
+        if (it != by_path_.end()) return it->second;
+
+        PooledPdb entry;
+        entry.path = path;
+        std::error_code ec;
+        std::filesystem::path p = std::filesystem::u8path(path);
+        entry.module = to_lower_ascii(p.stem().u8string());
+        entry.file_size = std::filesystem::file_size(p, ec);
+        if (ec) entry.file_size = 0;
+
+        // Identity from the MSF headers, so GUID routing works before the first open
+        PdbHeaderInfo header;
+        std::string header_error;
+        if (read_pdb_header(path, header, header_error)) {
+            entry.signature = format_guid_age(header.guid, header.age);
+        }
+
+        size_t index = entries_.size();
+        entries_.push_back(std::move(entry));
+        slots_.emplace_back();
+        named_sql_.emplace_back();
+        by_path_[key] = index;
+        if (!entries_[index].signature.empty()) {
+            by_signature_.emplace(entries_[index].signature, index);
+        }
+
+        auto [mit, inserted] = by_module_.emplace(entries_[index].module, index);
+        if (!inserted) mit->second = AMBIGUOUS;
+
+        return index;
+    }
+
+    // Attach a symbol store catalog; its PDBs are added to the pool on first use.
+    // PDBs already added by path are linked to their record so the `pdbs`
+    // table lists them once.
+    void attach_index(std::shared_ptr<const SymbolStoreIndex> index) {
+        index_ = std::move(index);
+        by_index_record_.clear();
+        if (!index_ || by_path_.empty()) return;
+        for (size_t record = 0; record < index_->size(); record++) {
+            auto it = by_path_.find(pdb_path_key(index_->path(record)));
+            if (it == by_path_.end()) continue;
+            entries_[it->second].index_record = static_cast<int64_t>(record);
+            by_index_record_[record] = it->second;
+        }
+    }
+
+    // Resolve a path, module name or GUID+age signature to a pool index.
+    // Indexed PDBs matched by signature are added to the pool here.
+    bool resolve(const std::string& id, size_t& index, std::string& error) {
+        if (id.empty()) {
+            if (entries_.size() == 1 && !index_) {
+                index = 0;
+                return true;
+            }
+            error = entries_.empty() ? "No PDBs loaded" : "Multiple PDBs loaded; prefix the query with USE <pdb>;";
+            return false;
+        }
+
+        auto sit = by_signature_.find(to_upper_ascii(id));
+        if (sit != by_signature_.end()) {
+            index = sit->second;
+            return true;
+        }
+
+        size_t record = 0;
+        if (index_ && index_->find_signature(id, record)) {
+            auto rit = by_index_record_.find(record);
+            if (rit != by_index_record_.end()) {
+                index = rit->second;
+                return true;
+            }
+            index = add(index_->path(record));
+            entries_[index].index_record = static_cast<int64_t>(record);
+            by_index_record_[record] = index;
+            return true;
+        }
+
+        std::string module = to_lower_ascii(id);
+        if (module.size() > 4 && module.compare(module.size() - 4, 4, ".pdb") == 0 &&
+            module.find_first_of("/\\") == std::string::npos) {
+            module.resize(module.size() - 4);
+        }
+        auto mit = by_module_.find(module);
+        if (mit != by_module_.end()) {
+            if (mit->second == AMBIGUOUS) {
+                error = "Ambiguous PDB name '" + id + "'; use a path or GUID+age signature";
+                return false;
+            }
+            index = mit->second;
+            return true;
+        }
+
+        auto pit = by_path_.find(pdb_path_key(id));
+        if (pit != by_path_.end()) {
+            index = pit->second;
+            return true;
+        }
+
+        error = "Unknown PDB: " + id;
+        return false;
+    }
+
+    // Get the open slot for index, opening (and evicting cold PDBs) as needed.
+    // Cold PDBs are evicted only once the new session has opened, so a bad
+    // path doesn't close anything; the cap may be exceeded by one PDB meanwhile.
+    Slot* acquire(size_t index, std::string& error) {
+        if (index >= entries_.size()) {
+            error = "Invalid PDB index";
+            return nullptr;
+        }
+
+        PooledPdb& entry = entries_[index];
+        if (slots_[index]) {
+            ++hits_;
+            Metrics::global().pool_hits.inc();
+            Slot* slot = slots_[index].get();
+            lru_.splice(lru_.begin(), lru_, slot->lru_pos);
+            entry.queries++;
+            return slot;
+        }
+
+        ++misses_;
+        Metrics::global().pool_misses.inc();
+
+        auto slot = std::make_unique<Slot>();
+        if (!slot->session.open(entry.path)) {
+            error = slot->session.last_error();
+            return nullptr;
+        }
+        evict_for(entry.file_size);
+        slot->registry = std::make_unique<TableRegistry>(slot->session);
+        slot->registry->register_all(slot->db);
+        slot->statements = std::make_unique<StatementCache>(slot->db.handle());
+        for (const auto& [name, sql] : named_sql_[index]) {
+            std::string prepare_error;
+            slot->statements->register_named(name, sql, prepare_error);
+        }
+
+        lru_.push_front(index);
+        slot->lru_pos = lru_.begin();
+
+        if (entry.signature.empty()) {
+            entry.signature = slot->session.signature();
+            if (!entry.signature.empty()) by_signature_[entry.signature] = index;
+        }
+        entry.is_open = true;
+        entry.opens++;
+        entry.queries++;
+        memory_used_ += entry.file_size;
+        Metrics::global().pool_open_pdbs.add(1);
+        Metrics::global().pool_memory_bytes.add(static_cast<int64_t>(entry.file_size));
+
+        slots_[index] = std::move(slot);
+        return slots_[index].get();
+    }
+
+    // Route a query to a specific PDB (empty id = default routing).
+    bool route_to(const std::string& id, const std::string& sql, QueryTarget& target, std::string& error) {
+        if (id.empty() && (entries_.size() != 1 || index_)) {
+            target.db = &catalog_db_;
+            target.statements = catalog_statements_.get();
+            target.sql = sql;
+            return true;
+        }
+
+        size_t index = 0;
+        if (!resolve(id, index, error)) return false;
+        Slot* slot = acquire(index, error);
+        if (!slot) return false;
+
+        target.db = &slot->db;
+        target.statements = slot->statements.get();
+        target.sql = sql;
+        return true;
+    }
+
+    // Register a named statement on a PDB (empty id = default routing, as for
+    // queries). The pool keeps the SQL so the statement survives eviction.
+    bool register_named(const std::string& id, const std::string& name, const std::string& sql,
+                        std::string& error, int* param_count = nullptr) {
+        if (id.empty() && (entries_.size() != 1 || index_)) {
+            return catalog_statements_->register_named(name, sql, error, param_count);
+        }
+
+        size_t index = 0;
+        if (!resolve(id, index, error)) return false;
+        Slot* slot = acquire(index, error);
+        if (!slot || !slot->statements->register_named(name, sql, error, param_count)) return false;
+        named_sql_[index][name] = sql;
+        return true;
+    }
+
+    // Route a query carrying an optional leading USE directive.
+    bool route(const std::string& sql, QueryTarget& target, std::string& error) {
+        std::string id, rest;
+        if (split_use_directive(sql, id, rest)) {
+            return route_to(id, rest, target, error);
+        }
+        return route_to("", sql, target, error);
+    }
+
+    QueryRouter router() {
+        return [this](const std::string& sql, QueryTarget& target, std::string& error) {
+            return route(sql, target, error);
+        };
+    }
+
+    void close_all() {
+        for (size_t i = 0; i < slots_.size(); i++) close_slot(i);
+    }
+
+    size_t size() const { return entries_.size(); }
+    size_t indexed_count() const { return index_ ? index_->size() : 0; }
+    size_t open_count() const { return lru_.size(); }
+    uint64_t memory_cap() const { return memory_cap_; }
+    uint64_t memory_used() const { return memory_used_; }
+    uint64_t hits() const { return hits_; }
+    uint64_t misses() const { return misses_; }
+    uint64_t evictions() const { return evictions_; }
+    const std::vector<PooledPdb>& entries() const { return entries_; }
+    xsql::Database& catalog_db() { return catalog_db_; }
+};
+
+// Populate a pool from --pdbs specs (files/dirs) and an optional symbol store
+// (its catalog is loaded, or built on first use).
+inline bool populate_session_pool(SessionPool& pool, const std::vector<std::string>& pdb_specs,
+                                  const std::string& store_root, unsigned jobs, std::string& error) {
+    if (!pdb_specs.empty()) {
+        std::vector<std::string> paths = collect_pdb_paths(pdb_specs, error);
+        if (!error.empty()) return false;
+        for (const auto& path : paths) {
+            pool.add(path);
+        }
+    }
+    if (!store_root.empty()) {
+        auto index = open_symbol_store_index(store_root, jobs, error);
+        if (!index) return false;
+        pool.attach_index(std::move(index));
+    }
+    if (pool.size() == 0 && pool.indexed_count() == 0) {
+        error = "No .pdb files found";
+        return false;
+    }
+    return true;
+}
+
+} // namespace pdbsql
@@ -0,0 +1,540 @@
+#pragma once
+// size_report.hpp - Binary size attribution (size_by table, --size-report)
+//
+// Bytes are attributed in one pass over each source:
+//
+//   section contributions  compiland, library (library;object) and directory
+//                          (directory of the compiland's main source file)
+//   functions and data     namespace (name prefix split on '::')
+//
+// Both sources are sorted by RVA and clipped against what is already covered,
+// so overlapping ranges count once. Symbols that COMDAT folding (/OPT:ICF)
+// put on the same range count once as well, under the first one; the others
+// are reported in `folded`. Code/data bytes not covered by any symbol go to
+// a <no symbol> node so every dimension adds up to the same total.
+//
+// Each dimension is a tree. Rows carry their own bytes (self_bytes) and the
+// totals of their subtree; write_folded() prints the tree as folded stacks
+// ("a;b;c <self bytes>") for flamegraph.pl, speedscope or inferno.
+
+#include "metrics.hpp"
+#include "pdb_tables.hpp"
+#include "trace.hpp"
+
+#include <xsql/database.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace pdbsql {
+
+enum class SizeDimension { Compiland, Library, Directory, Namespace };
+constexpr size_t SIZE_DIMENSION_COUNT = 4;
+
+inline const char* size_dimension_name(SizeDimension d) {
+    switch (d) {
+        case SizeDimension::Compiland: return "compiland";
+        case SizeDimension::Library: return "library";
+        case SizeDimension::Directory: return "directory";
+        case SizeDimension::Namespace: return "namespace";
+    }
+    return "";
+}
+
+inline bool parse_size_dimension(const std::string& name, SizeDimension& out) {
+    for (size_t i = 0; i < SIZE_DIMENSION_COUNT; i++) {
+        if (name == size_dimension_name(static_cast<SizeDimension>(i))) {
+            out = static_cast<SizeDimension>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+struct SizeNode {
+    std::string dimension;
+    std::string name;           // Last path component
+    std::string path;           // Components joined by ';'
+    std::string parent;         // Path of the parent ('' at the top)
+    uint32_t depth = 0;         // 1 = top level
+    uint64_t code_bytes = 0;    // Subtree totals
+    uint64_t data_bytes = 0;
+    uint64_t self_code_bytes = 0;
+    uint64_t self_data_bytes = 0;
+    uint64_t items = 0;         // Contributions or symbols in the subtree
+    uint64_t folded = 0;        // Symbols folded onto another's bytes
+};
+
+namespace size_detail {
+
+constexpr size_t NO_NODE = static_cast<size_t>(-1);
+
+// One dimension's tree. Nodes are created parent first, so a single reverse
+// pass rolls the totals up.
+class SizeTree {
+    std::string dimension_;
+    std::vector<SizeNode> nodes_;
+    std::vector<size_t> parent_;
+    std::unordered_map<std::string, size_t> by_path_;
+
+public:
+    explicit SizeTree(std::string dimension) : dimension_(std::move(dimension)) {}
+
+    // Node for the given path, creating missing ancestors
+    size_t node(const std::vector<std::string_view>& components) {
+        size_t current = NO_NODE;
+        std::string path;
+        for (std::string_view component : components) {
+            const size_t parent_len = path.size();
+            if (!path.empty()) path += ';';
+            const size_t name_start = path.size();
+            for (char c : component) path += (c == ';' || c == '\n') ? ':' : c;
+
+            auto it = by_path_.find(path);
+            if (it != by_path_.end()) {
+                current = it->second;
+                continue;
+            }
+            SizeNode n;
+            n.dimension = dimension_;
+            n.name = path.substr(name_start);
+            n.path = path;
+            n.parent = path.substr(0, parent_len);
+            n.depth = static_cast<uint32_t>(current == NO_NODE ? 1 : nodes_[current].depth + 1);
+            nodes_.push_back(std::move(n));
+            parent_.push_back(current);
+            current = nodes_.size() - 1;
+            by_path_.emplace(path, current);
+        }
+        return current;
+    }
+
+    void add(size_t node, uint64_t code, uint64_t data, uint64_t items, uint64_t folded = 0) {
+        if (node == NO_NODE) return;
+        SizeNode& n = nodes_[node];
+        n.self_code_bytes += code;
+        n.self_data_bytes += data;
+        n.items += items;
+        n.folded += folded;
+    }
+
+    // Roll up subtree totals; largest subtrees first
+    std::vector<SizeNode> finish() {
+        for (SizeNode& n : nodes_) {
+            n.code_bytes += n.self_code_bytes;
+            n.data_bytes += n.self_data_bytes;
+        }
+        for (size_t i = nodes_.size(); i-- > 0;) {
+            const size_t p = parent_[i];
+            if (p == NO_NODE) continue;
+            nodes_[p].code_bytes += nodes_[i].code_bytes;
+            nodes_[p].data_bytes += nodes_[i].data_bytes;
+            nodes_[p].items += nodes_[i].items;
+            nodes_[p].folded += nodes_[i].folded;
+        }
+        std::sort(nodes_.begin(), nodes_.end(), [](const SizeNode& a, const SizeNode& b) {
+            const uint64_t ta = a.code_bytes + a.data_bytes;
+            const uint64_t tb = b.code_bytes + b.data_bytes;
+            return ta != tb ? ta > tb : a.path < b.path;
+        });
+        by_path_.clear();
+        parent_.clear();
+        return std::move(nodes_);
+    }
+};
+
+inline std::string_view base_name(std::string_view path) {
+    const size_t slash = path.find_last_of("\\/");
+    return slash == std::string_view::npos ? path : path.substr(slash + 1);
+}
+
+// Directory components of a source path ("C:\src\a\b.cpp" -> C:, src, a).
+// Lowercased: Windows paths differ in case between compilands.
+inline std::vector<std::string> directory_components(std::string path, const std::string& cwd) {
+    const bool absolute = !path.empty() && (path[0] == '/' || path[0] == '\\' || (path.size() > 1 && path[1] == ':'));
+    if (!absolute && !cwd.empty()) path = cwd + "/" + path;
+    for (char& c : path) {
+        if (c == '\\') c = '/';
+        else if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+    }
+
+    std::vector<std::string> out;
+    size_t start = 0;
+    const size_t file = path.rfind('/');
+    if (file == std::string::npos) return out;
+    while (start < file) {
+        size_t end = path.find('/', start);
+        if (end == std::string::npos || end > file) end = file;
+        if (end > start) {
+            std::string part = path.substr(start, end - start);
+            if (part == "..") {
+                if (!out.empty()) out.pop_back();
+            } else if (part != ".") {
+                out.push_back(std::move(part));
+            }
+        }
+        start = end + 1;
+    }
+    return out;
+}
+
+inline bool is_identifier_char(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' || c == '$';
+}
+
+// Length of the operator token at name[i] ("operator<<", "operator()",
+// "operator new[]"), or 0 when no operator name starts there
+inline size_t operator_length(std::string_view name, size_t i) {
+    constexpr std::string_view keyword = "operator";
+    if (name.compare(i, keyword.size(), keyword) != 0) return 0;
+    if (i > 0 && is_identifier_char(name[i - 1])) return 0;
+    size_t j = i + keyword.size();
+    if (j < name.size() && is_identifier_char(name[j])) return 0;  // operator_fn
+    while (j < name.size() && name[j] == ' ') j++;
+    // Longest first, so operator<<<char> is operator<< and its arguments
+    static constexpr std::string_view symbols[] = {
+        "<<=", ">>=", "<=>", "->*", "()", "[]", "<<", ">>", "<=", ">=", "==", "!=", "&&", "||", "++", "--",
+        "->", "+=", "-=", "*=", "/=", "%=", "&=", "|=", "^=", "<", ">", "=", "!", "+", "-", "*", "/", "%",
+        "^", "&", "|", "~", ",",
+    };
+    for (std::string_view op : symbols) {
+        if (name.compare(j, op.size(), op) == 0) return j + op.size() - i;
+    }
+    // operator new/delete, possibly with [], and conversions (operator int)
+    // end at the next identifier
+    while (j < name.size() && is_identifier_char(name[j])) j++;
+    if (name.compare(j, 2, "[]") == 0) j += 2;
+    return j - i;
+}
+
+// Namespace components of a symbol name: split on '::' outside <> and (),
+// without the last component (the function or variable itself). Operator
+// names are skipped whole, so the '<' of operator< or operator<< doesn't
+// open a template argument list.
+inline std::vector<std::string_view> namespace_components(std::string_view name) {
+    std::vector<std::string_view> out;
+    int depth = 0;
+    size_t start = 0;
+    for (size_t i = 0; i + 1 < name.size(); i++) {
+        const char c = name[i];
+        if (c == 'o') {
+            if (const size_t len = operator_length(name, i)) {
+                i += len - 1;
+                continue;
+            }
+        }
+        if (c == '<' || c == '(') depth++;
+        else if ((c == '>' || c == ')') && depth > 0) depth--;
+        else if (c == ':' && name[i + 1] == ':' && depth == 0) {
+            if (i > start) out.push_back(name.substr(start, i - start));
+            start = i + 2;
+            i++;
+        }
+    }
+    return out;
+}
+
+struct CompilandInfo {
+    std::string name;
+    std::string library;
+    std::vector<std::string> directory;
+};
+
+// src and cwd from the compiland's environment block
+inline void read_compiland_env(IDiaSymbol* compiland, std::string& src, std::string& cwd) {
+    CComPtr<IDiaEnumSymbols> env;
+    if (FAILED(compiland->findChildren(SymTagCompilandEnv, nullptr, nsNone, &env)) || !env) return;
+    CComPtr<IDiaSymbol> entry;
+    ULONG fetched = 0;
+    while (SUCCEEDED(env->Next(1, &entry, &fetched)) && fetched == 1) {
+        const std::string key = safe_symbol_name(entry);
+        if (key == "src" || key == "cwd") {
+            VARIANT v = {};
+            if (SUCCEEDED(entry->get_value(&v))) {
+                if (v.vt == VT_BSTR && v.bstrVal) (key == "src" ? src : cwd) = bstr_to_string(v.bstrVal);
+                VariantClear(&v);
+            }
+        }
+        entry.Release();
+    }
+}
+
+} // namespace size_detail
+
+class SizeReport {
+    PdbSession& session_;
+    SectionContribCache& contribs_;  // Shared with the sections tables
+    std::array<std::shared_ptr<const std::vector<SizeNode>>, SIZE_DIMENSION_COUNT> rows_;
+    std::shared_ptr<const std::vector<SizeNode>> all_;
+    uint64_t code_total_ = 0;   // Contribution bytes, set by build_contributions()
+    uint64_t data_total_ = 0;
+    bool contributions_built_ = false;
+
+    GeneratorTableDef<SizeNode> def_;
+
+    std::unordered_map<DWORD, size_detail::CompilandInfo> compilands() {
+        std::unordered_map<DWORD, size_detail::CompilandInfo> out;
+        auto compilands = session_.enum_symbols(SymTagCompiland);
+        CComPtr<IDiaSymbol> compiland;
+        ULONG fetched = 0;
+        while (compilands && SUCCEEDED(compilands->Next(1, &compiland, &fetched)) && fetched == 1) {
+            DWORD id = 0;
+            compiland->get_symIndexId(&id);
+            size_detail::CompilandInfo info;
+            info.name = safe_symbol_name(compiland);
+            SafeBSTR lib;
+            if (SUCCEEDED(compiland->get_libraryName(lib.ptr()))) info.library = lib.str();
+            std::string src, cwd;
+            size_detail::read_compiland_env(compiland, src, cwd);
+            if (!src.empty()) info.directory = size_detail::directory_components(src, cwd);
+            out.emplace(id, std::move(info));
+            compiland.Release();
+        }
+        return out;
+    }
+
+    // compiland, library and directory from one pass over the contributions
+    void build_contributions() {
+        if (contributions_built_) return;
+        contributions_built_ = true;
+        TraceSpan span("size_report.contributions", "cache");
+
+        auto info = compilands();
+        size_detail::SizeTree by_compiland("compiland");
+        size_detail::SizeTree by_library("library");
+        size_detail::SizeTree by_directory("directory");
+        std::unordered_map<DWORD, std::array<size_t, 3>> nodes;
+
+        auto contribs = contribs_.contributions();
+        ULONGLONG covered = 0;
+        for (const CachedSectionContrib& c : *contribs) {
+            const ULONGLONG end = static_cast<ULONGLONG>(c.rva) + c.length;
+            const ULONGLONG start = (std::max)(static_cast<ULONGLONG>(c.rva), covered);
+            const uint64_t bytes = end > start ? end - start : 0;
+            covered = (std::max)(covered, end);
+
+            auto it = nodes.find(c.compiland_id);
+            if (it == nodes.end()) {
+                static const size_detail::CompilandInfo unknown{"<unknown>", "", {}};
+                auto ci = info.find(c.compiland_id);
+                const size_detail::CompilandInfo& ci_ref = ci != info.end() ? ci->second : unknown;
+                std::string_view object = size_detail::base_name(ci_ref.name);
+                std::string_view library = ci_ref.library.empty() ? std::string_view("<no library>")
+                                                                  : size_detail::base_name(ci_ref.library);
+                std::vector<std::string_view> dir;
+                for (const std::string& part : ci_ref.directory) dir.push_back(part);
+                if (dir.empty()) dir.push_back("<no source>");
+                std::array<size_t, 3> n = {
+                    by_compiland.node({ci_ref.name.empty() ? std::string_view("<unnamed>") : std::string_view(ci_ref.name)}),
+                    by_library.node({library, object.empty() ? std::string_view("<unnamed>") : object}),
+                    by_directory.node(dir),
+                };
+                it = nodes.emplace(c.compiland_id, n).first;
+            }
+
+            const bool code = c.code || c.execute;
+            const uint64_t code_bytes = code ? bytes : 0;
+            const uint64_t data_bytes = code ? 0 : bytes;
+            code_total_ += code_bytes;
+            data_total_ += data_bytes;
+            by_compiland.add(it->second[0], code_bytes, data_bytes, 1);
+            by_library.add(it->second[1], code_bytes, data_bytes, 1);
+            by_directory.add(it->second[2], code_bytes, data_bytes, 1);
+        }
+
+        rows_[static_cast<size_t>(SizeDimension::Compiland)] =
+            std::make_shared<const std::vector<SizeNode>>(by_compiland.finish());
+        rows_[static_cast<size_t>(SizeDimension::Library)] =
+            std::make_shared<const std::vector<SizeNode>>(by_library.finish());
+        rows_[static_cast<size_t>(SizeDimension::Directory)] =
+            std::make_shared<const std::vector<SizeNode>>(by_directory.finish());
+        span.arg("contributions", contribs->size());
+    }
+
+    // namespace from one pass over functions and one over static data
+    void build_namespaces() {
+        build_contributions();  // For the totals
+        TraceSpan span("size_report.namespaces", "cache");
+
+        struct Span {
+            DWORD rva;
+            DWORD length;
+            uint32_t node;
+            bool code;
+        };
+        std::vector<Span> spans;
+        size_detail::SizeTree tree("namespace");
+        std::unordered_map<std::string, size_t> prefix_nodes;
+
+        auto collect = [&](enum SymTagEnum tag) {
+            auto symbols = session_.enum_symbols(tag);
+            LONG count = 0;
+            if (symbols && SUCCEEDED(symbols->get_Count(&count)) && count > 0) {
+                spans.reserve(spans.size() + static_cast<size_t>(count));
+            }
+            CComPtr<IDiaSymbol> symbol;
+            ULONG fetched = 0;
+            while (symbols && SUCCEEDED(symbols->Next(1, &symbol, &fetched)) && fetched == 1) {
+                DWORD rva = 0;
+                ULONGLONG length = 0;
+                DWORD loc = LocIsStatic;
+                if (tag == SymTagData) symbol->get_locationType(&loc);
+                if (loc == LocIsStatic && SUCCEEDED(symbol->get_relativeVirtualAddress(&rva)) && rva != 0) {
+                    symbol->get_length(&length);
+                    CComPtr<IDiaSymbol> type;
+                    if (length == 0 && tag == SymTagData && SUCCEEDED(symbol->get_type(&type)) && type) {
+                        type->get_length(&length);
+                    }
+                }
+                if (length > 0) {
+                    const std::string name = safe_symbol_name(symbol);
+                    auto parts = size_detail::namespace_components(name);
+                    const size_t prefix_len = parts.empty() ? 0 : static_cast<size_t>(
+                        parts.back().data() + parts.back().size() - name.data());
+                    std::string prefix = name.substr(0, prefix_len);
+                    auto it = prefix_nodes.find(prefix);
+                    if (it == prefix_nodes.end()) {
+                        if (parts.empty()) parts.push_back("<global>");
+                        it = prefix_nodes.emplace(std::move(prefix), tree.node(parts)).first;
+                    }
+                    spans.push_back({rva, static_cast<DWORD>((std::min)(length, static_cast<ULONGLONG>(0xFFFFFFFF))),
+                                     static_cast<uint32_t>(it->second), tag == SymTagFunction});
+                }
+                symbol.Release();
+            }
+        };
+        collect(SymTagFunction);
+        collect(SymTagData);
+
+        // Longest first at equal RVAs, so nested ranges are clipped away
+        std::sort(spans.begin(), spans.end(), [](const Span& a, const Span& b) {
+            return a.rva != b.rva ? a.rva < b.rva : a.length > b.length;
+        });
+        ULONGLONG covered = 0;
+        uint64_t code_symbols = 0, data_symbols = 0;
+        const Span* prev = nullptr;
+        for (const Span& s : spans) {
+            if (prev && prev->rva == s.rva && prev->length == s.length) {
+                tree.add(s.node, 0, 0, 1, 1);  // Folded onto prev
+                continue;
+            }
+            prev = &s;
+            const ULONGLONG end = static_cast<ULONGLONG>(s.rva) + s.length;
+            const ULONGLONG start = (std::max)(static_cast<ULONGLONG>(s.rva), covered);
+            const uint64_t bytes = end > start ? end - start : 0;
+            covered = (std::max)(covered, end);
+            if (s.code) code_symbols += bytes;
+            else data_symbols += bytes;
+            tree.add(s.node, s.code ? bytes : 0, s.code ? 0 : bytes, 1);
+        }
+
+        const uint64_t code_rest = code_total_ > code_symbols ? code_total_ - code_symbols : 0;
+        const uint64_t data_rest = data_total_ > data_symbols ? data_total_ - data_symbols : 0;
+        if (code_rest || data_rest) tree.add(tree.node({"<no symbol>"}), code_rest, data_rest, 0);
+
+        rows_[static_cast<size_t>(SizeDimension::Namespace)] =
+            std::make_shared<const std::vector<SizeNode>>(tree.finish());
+        span.arg("symbols", spans.size());
+    }
+
+    std::shared_ptr<const std::vector<SizeNode>> all_rows() {
+        if (!all_) {
+            auto all = std::make_shared<std::vector<SizeNode>>();
+            for (size_t d = 0; d < SIZE_DIMENSION_COUNT; d++) {
+                const auto& rows = *this->rows(static_cast<SizeDimension>(d));
+                all->insert(all->end(), rows.begin(), rows.end());
+            }
+            all_ = std::move(all);
+        }
+        return all_;
+    }
+
+    GeneratorTableDef<SizeNode> define_table() {
+        return generator_table<SizeNode>("size_by")
+            .estimate_rows([]() { return static_cast<size_t>(50000); })
+            .generator([this, scans = &Metrics::global().table("size_by")]() {
+                return counted(*scans, std::make_unique<VectorGenerator<SizeNode>>(all_rows()));
+            })
+            .column_text("dimension", [](const SizeNode& r) { return r.dimension; })
+            .column_text("path", [](const SizeNode& r) { return r.path; })
+            .column_text("name", [](const SizeNode& r) { return r.name; })
+            .column_text("parent", [](const SizeNode& r) { return r.parent; })
+            .column_int("depth", [](const SizeNode& r) { return static_cast<int>(r.depth); })
+            .column_int64("bytes", [](const SizeNode& r) { return static_cast<int64_t>(r.code_bytes + r.data_bytes); })
+            .column_int64("code_bytes", [](const SizeNode& r) { return static_cast<int64_t>(r.code_bytes); })
+            .column_int64("data_bytes", [](const SizeNode& r) { return static_cast<int64_t>(r.data_bytes); })
+            .column_int64("self_bytes", [](const SizeNode& r) {
+                return static_cast<int64_t>(r.self_code_bytes + r.self_data_bytes);
+            })
+            .column_int64("items", [](const SizeNode& r) { return static_cast<int64_t>(r.items); })
+            .column_int64("folded", [](const SizeNode& r) { return static_cast<int64_t>(r.folded); })
+            .build();
+    }
+
+public:
+    // contribs is normally TableRegistry::section_contrib_cache(), so the
+    // contributions are read once per session; both must outlive the report
+    SizeReport(PdbSession& session, SectionContribCache& contribs)
+        : session_(session)
+        , contribs_(contribs)
+        , def_(define_table())
+    {
+        auto* def = &def_;
+        add_filter_eq_text(def_, "dimension",
+                           [def, this](const char* name) -> std::unique_ptr<xsql::RowIterator> {
+                               SizeDimension d;
+                               if (!name || !parse_size_dimension(name, d)) {
+                                   return std::make_unique<GeneratorRowIterator<SizeNode>>(def, nullptr);
+                               }
+                               return std::make_unique<GeneratorRowIterator<SizeNode>>(
+                                   def, std::make_unique<VectorGenerator<SizeNode>>(rows(d)));
+                           },
+                           1.0, 1000.0);
+    }
+
+    SizeReport(const SizeReport&) = delete;
+    SizeReport& operator=(const SizeReport&) = delete;
+
+    // Tree of one dimension, computed on first use
+    std::shared_ptr<const std::vector<SizeNode>> rows(SizeDimension d) {
+        auto& rows = rows_[static_cast<size_t>(d)];
+        if (!rows) {
+            if (d == SizeDimension::Namespace) build_namespaces();
+            else build_contributions();
+        }
+        return rows;
+    }
+
+    uint64_t total_bytes() {
+        build_contributions();
+        return code_total_ + data_total_;
+    }
+
+    // Folded stacks ("a;b;c <self bytes>"), one line per node that has bytes
+    // of its own. Returns the number of lines written.
+    size_t write_folded(FILE* out, SizeDimension d) {
+        size_t lines = 0;
+        for (const SizeNode& n : *rows(d)) {
+            const uint64_t self = n.self_code_bytes + n.self_data_bytes;
+            if (self == 0) continue;
+            fprintf(out, "%s %llu\n", n.path.c_str(), static_cast<unsigned long long>(self));
+            lines++;
+        }
+        return lines;
+    }
+
+    // Must outlive db
+    void register_table(xsql::Database& db) {
+        db.register_generator_table("pdb_size_by", &def_);
+        db.create_table("size_by", "pdb_size_by");
+    }
+};
+
+} // namespace pdbsql
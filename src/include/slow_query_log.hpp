@@ -0,0 +1,348 @@
+#pragma once
+// slow_query_log.hpp - Slow-query log for the server modes (--slow-log)
+//
+// Queries slower than the threshold are appended to a file as JSON lines:
+//
+//   {"time":"2026-01-02T03:04:05.678Z","source":"http","client":"10.0.0.7:50112",
+//    "sql":"SELECT name FROM functions WHERE name LIKE ?","ms":812.4,
+//    "queue_wait_ms":3.1,"rows":40,"success":true,
+//    "tables":[{"table":"functions","cursors":1,"plans":{"full scan":1},"rows":91234}]}
+//
+// "sql" is normalized (literals replaced by ?, whitespace collapsed) so
+// repeated queries group together. "tables" lists the vtable plans each
+// cursor used (a plan-only QueryProfile, no per-row timing).
+//
+// The query thread only moves a record onto a bounded queue; a background
+// thread formats and writes it. Records beyond the queue limit are dropped
+// and counted in /metrics.
+
+#include "json_text.hpp"
+#include "metrics.hpp"
+#include "query_profile.hpp"
+
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace pdbsql {
+
+// Replace string/number/blob literals with ? and collapse whitespace.
+inline std::string normalize_sql(const std::string& sql) {
+    std::string out;
+    out.reserve(sql.size());
+    const size_t n = sql.size();
+    auto is_ident = [](char c) {
+        return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '$';
+    };
+    auto space = [&out] {
+        if (!out.empty() && out.back() != ' ') out += ' ';
+    };
+
+    size_t i = 0;
+    while (i < n) {
+        char c = sql[i];
+        if (std::isspace(static_cast<unsigned char>(c))) {
+            space();
+            i++;
+        } else if (c == '-' && i + 1 < n && sql[i + 1] == '-') {
+            while (i < n && sql[i] != '\n') i++;  // Line comment
+            space();
+        } else if (c == '/' && i + 1 < n && sql[i + 1] == '*') {
+            size_t end = sql.find("*/", i + 2);
+            i = end == std::string::npos ? n : end + 2;
+            space();
+        } else if (c == '\'') {
+            // String literal ('' escapes a quote)
+            for (i++; i < n; i++) {
+                if (sql[i] == '\'') {
+                    if (i + 1 < n && sql[i + 1] == '\'') { i++; continue; }
+                    i++;
+                    break;
+                }
+            }
+            out += '?';
+        } else if ((c == 'x' || c == 'X') && i + 1 < n && sql[i + 1] == '\'' &&
+                   (out.empty() || !is_ident(out.back()))) {
+            i++;  // Blob literal x'...'
+            continue;
+        } else if (std::isdigit(static_cast<unsigned char>(c)) && (out.empty() || !is_ident(out.back()))) {
+            // Number: decimal, hex (0x...), float, exponent
+            while (i < n && (is_ident(sql[i]) || sql[i] == '.' ||
+                             ((sql[i] == '+' || sql[i] == '-') && (sql[i - 1] == 'e' || sql[i - 1] == 'E')))) {
+                i++;
+            }
+            out += '?';
+        } else if (c == '"' || c == '[' || c == '`') {
+            // Quoted identifier: keep as is
+            char close = c == '[' ? ']' : c;
+            size_t end = sql.find(close, i + 1);
+            end = end == std::string::npos ? n : end + 1;
+            out.append(sql, i, end - i);
+            i = end;
+        } else {
+            out += c;
+            i++;
+        }
+    }
+    while (!out.empty() && (out.back() == ' ' || out.back() == ';')) out.pop_back();
+    return out;
+}
+
+struct SlowQueryRecord {
+    std::chrono::system_clock::time_point time;
+    std::string source;     // "server", "http", "mcp", "agent"
+    std::string client;     // Peer address, if the transport knows it
+    std::string user_agent;
+    std::string sql;        // Normalized
+    std::string statement;  // Prepared statement name (/execute by name)
+    double ms = 0.0;
+    double queue_wait_ms = 0.0;
+    uint64_t rows = 0;
+    bool success = true;
+    std::string error;
+    std::vector<TableProfile> tables;
+
+    std::string to_json() const {
+        std::string out = "{\"time\":";
+        append_json_string(out, format_time(time));
+        out += ",\"source\":";
+        append_json_string(out, source);
+        if (!client.empty()) {
+            out += ",\"client\":";
+            append_json_string(out, client);
+        }
+        if (!user_agent.empty()) {
+            out += ",\"user_agent\":";
+            append_json_string(out, user_agent);
+        }
+        if (!statement.empty()) {
+            out += ",\"statement\":";
+            append_json_string(out, statement);
+        }
+        out += ",\"sql\":";
+        append_json_string(out, sql);
+
+        char buf[160];
+        snprintf(buf, sizeof(buf), ",\"ms\":%.3f,\"queue_wait_ms\":%.3f,\"rows\":%llu,\"success\":%s",
+                 ms, queue_wait_ms, static_cast<unsigned long long>(rows), success ? "true" : "false");
+        out += buf;
+        if (!error.empty()) {
+            out += ",\"error\":";
+            append_json_string(out, error);
+        }
+
+        out += ",\"tables\":[";
+        for (size_t i = 0; i < tables.size(); i++) {
+            const TableProfile& t = tables[i];
+            if (i > 0) out += ',';
+            out += "{\"table\":";
+            append_json_string(out, t.table);
+            out += ",\"cursors\":" + std::to_string(t.cursors) + ",\"plans\":{";
+            bool first = true;
+            for (const auto& [label, count] : t.plans) {
+                if (!first) out += ',';
+                first = false;
+                append_json_string(out, label);
+                out += ':' + std::to_string(count);
+            }
+            out += "},\"rows\":" + std::to_string(t.rows) + "}";
+        }
+        out += "]}";
+        return out;
+    }
+
+    // ISO 8601 UTC with milliseconds
+    static std::string format_time(std::chrono::system_clock::time_point tp) {
+        std::time_t t = std::chrono::system_clock::to_time_t(tp);
+        std::tm tm{};
+#ifdef _WIN32
+        gmtime_s(&tm, &t);
+#else
+        gmtime_r(&t, &tm);
+#endif
+        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(tp.time_since_epoch()).count() % 1000;
+        char buf[80];
+        snprintf(buf, sizeof(buf), "%04d-%02d-%02dT%02d:%02d:%02d.%03dZ",
+                 tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday, tm.tm_hour, tm.tm_min, tm.tm_sec,
+                 static_cast<int>(ms));
+        return buf;
+    }
+};
+
+class SlowQueryLog {
+public:
+    static constexpr size_t MAX_PENDING = 4096;
+
+    static SlowQueryLog& global() {
+        static SlowQueryLog instance;
+        return instance;
+    }
+
+    bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+    double threshold_ms() const { return threshold_ms_; }
+
+    // Append to `path`; log queries taking at least threshold_ms.
+    bool start(const std::string& path, double threshold_ms, std::string& error) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (file_) {
+            error = "Slow-query log already started";
+            return false;
+        }
+        file_ = fopen(path.c_str(), "ab");
+        if (!file_) {
+            error = "Cannot open slow-query log: " + path;
+            return false;
+        }
+        threshold_ms_ = threshold_ms;
+        stop_ = false;
+        writer_ = std::thread(&SlowQueryLog::writer_thread, this);
+        enabled_.store(true, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Write out everything queued, then close the file.
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!file_) return;
+            enabled_.store(false, std::memory_order_relaxed);
+            stop_ = true;
+        }
+        cv_.notify_one();
+        if (writer_.joinable()) writer_.join();
+        std::lock_guard<std::mutex> lock(mutex_);
+        fclose(file_);
+        file_ = nullptr;
+    }
+
+    void submit(SlowQueryRecord record) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!file_ || stop_) return;
+            if (pending_.size() >= MAX_PENDING) {
+                Metrics::global().slow_queries_dropped.inc();
+                return;
+            }
+            pending_.push_back(std::move(record));
+        }
+        Metrics::global().slow_queries.inc();
+        cv_.notify_one();
+    }
+
+private:
+    SlowQueryLog() = default;
+    ~SlowQueryLog() { stop(); }
+
+    std::atomic<bool> enabled_{false};
+    double threshold_ms_ = 0.0;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<SlowQueryRecord> pending_;
+    bool stop_ = false;
+    FILE* file_ = nullptr;
+    std::thread writer_;
+
+    void writer_thread() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            cv_.wait(lock, [this] { return stop_ || !pending_.empty(); });
+            if (pending_.empty()) break;  // stop_ and drained
+
+            std::deque<SlowQueryRecord> batch;
+            batch.swap(pending_);
+            FILE* file = file_;
+            lock.unlock();
+
+            std::string text;
+            for (const auto& record : batch) {
+                text += record.to_json();
+                text += '\n';
+            }
+            fwrite(text.data(), 1, text.size(), file);
+            fflush(file);
+
+            lock.lock();
+        }
+    }
+};
+
+// Times one query on the thread that runs it. While alive it keeps a
+// plan-only QueryProfile active so the vtable plans can be reported; finish()
+// queues a record if the query crossed the threshold. Inert when the log is off.
+class SlowQueryWatch {
+public:
+    SlowQueryWatch(const char* source, std::string client, const std::string& sql,
+                   double queue_wait_seconds = 0.0) {
+        if (!SlowQueryLog::global().enabled()) return;
+        profile_ = std::make_unique<QueryProfile>();
+        profile_->timed = false;
+        scope_ = std::make_unique<QueryProfile::Scope>(*profile_);
+        record_.source = source;
+        record_.client = std::move(client);
+        record_.queue_wait_ms = queue_wait_seconds * 1000.0;
+        sql_ = sql;
+        start_ = std::chrono::steady_clock::now();
+    }
+
+    ~SlowQueryWatch() { finish(0, false, "abandoned"); }
+
+    SlowQueryWatch(const SlowQueryWatch&) = delete;
+    SlowQueryWatch& operator=(const SlowQueryWatch&) = delete;
+
+    bool active() const { return profile_ != nullptr; }
+
+    void set_user_agent(const std::string& user_agent) { if (active()) record_.user_agent = user_agent; }
+    void set_statement(const std::string& name) { if (active()) record_.statement = name; }
+
+    void finish(uint64_t rows, bool success = true, const std::string& error = std::string()) {
+        if (!active() || done_) return;
+        done_ = true;
+        scope_.reset();
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start_).count();
+        SlowQueryLog& log = SlowQueryLog::global();
+        if (ms < log.threshold_ms()) return;
+
+        record_.time = std::chrono::system_clock::now();
+        record_.ms = ms;
+        record_.rows = rows;
+        record_.success = success;
+        record_.error = error;
+        record_.sql = normalize_sql(sql_);  // Only slow queries pay for this
+        for (const TableProfile* t : profile_->tables()) record_.tables.push_back(*t);
+        log.submit(std::move(record_));
+    }
+
+private:
+    std::unique_ptr<QueryProfile> profile_;
+    std::unique_ptr<QueryProfile::Scope> scope_;
+    SlowQueryRecord record_;
+    std::string sql_;
+    std::chrono::steady_clock::time_point start_;
+    bool done_ = false;
+};
+
+// Starts the slow-query log for the lifetime of the object (main's --slow-log).
+class SlowQueryLogFile {
+public:
+    SlowQueryLogFile() = default;
+    ~SlowQueryLogFile() { SlowQueryLog::global().stop(); }
+
+    SlowQueryLogFile(const SlowQueryLogFile&) = delete;
+    SlowQueryLogFile& operator=(const SlowQueryLogFile&) = delete;
+
+    bool open(const std::string& path, double threshold_ms, std::string& error) {
+        return SlowQueryLog::global().start(path, threshold_ms, error);
+    }
+};
+
+} // namespace pdbsql
@@ -0,0 +1,429 @@
+#pragma once
+// statement_cache.hpp - Prepared statement LRU cache and parameter binding
+
+#include <xsql/database.hpp>
+
+#include "metrics.hpp"
+
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace pdbsql {
+
+// ============================================================================
+// Statement parameters
+// ============================================================================
+
+// A single value bound to a prepared statement.
+// Empty name = positional (?), otherwise named (:name, @name, $name).
+struct StatementParam {
+    enum class Type { Null, Integer, Real, Text };
+
+    Type type = Type::Null;
+    std::string name;
+    int64_t int_value = 0;
+    double real_value = 0.0;
+    std::string text_value;
+
+    static StatementParam null_value() { return {}; }
+
+    static StatementParam integer(int64_t v) {
+        StatementParam p;
+        p.type = Type::Integer;
+        p.int_value = v;
+        return p;
+    }
+
+    static StatementParam real(double v) {
+        StatementParam p;
+        p.type = Type::Real;
+        p.real_value = v;
+        return p;
+    }
+
+    static StatementParam text(std::string v) {
+        StatementParam p;
+        p.type = Type::Text;
+        p.text_value = std::move(v);
+        return p;
+    }
+};
+
+// Convert a JSON value (nlohmann-compatible) into statement parameters.
+// Arrays bind positionally, objects bind by name. Booleans bind as 0/1.
+template<typename Json>
+inline bool params_from_json(const Json& j, std::vector<StatementParam>& out, std::string& error) {
+    auto convert = [&error](const Json& v, StatementParam& p) -> bool {
+        if (v.is_null()) {
+            p.type = StatementParam::Type::Null;
+        } else if (v.is_boolean()) {
+            p.type = StatementParam::Type::Integer;
+            p.int_value = v.template get<bool>() ? 1 : 0;
+        } else if (v.is_number_unsigned()) {
+            const uint64_t u = v.template get<uint64_t>();
+            if (u > static_cast<uint64_t>((std::numeric_limits<int64_t>::max)())) {
+                error = "Integer parameter out of range (SQLite integers are signed 64-bit)";
+                return false;
+            }
+            p.type = StatementParam::Type::Integer;
+            p.int_value = static_cast<int64_t>(u);
+        } else if (v.is_number_integer()) {
+            p.type = StatementParam::Type::Integer;
+            p.int_value = v.template get<int64_t>();
+        } else if (v.is_number_float()) {
+            p.type = StatementParam::Type::Real;
+            p.real_value = v.template get<double>();
+        } else if (v.is_string()) {
+            p.type = StatementParam::Type::Text;
+            p.text_value = v.template get<std::string>();
+        } else {
+            error = "Unsupported parameter type (use null, bool, number or string)";
+            return false;
+        }
+        return true;
+    };
+
+    out.clear();
+    if (j.is_null()) return true;
+
+    if (j.is_array()) {
+        out.reserve(j.size());
+        for (const auto& v : j) {
+            StatementParam p;
+            if (!convert(v, p)) return false;
+            out.push_back(std::move(p));
+        }
+        return true;
+    }
+
+    if (j.is_object()) {
+        out.reserve(j.size());
+        for (auto it = j.begin(); it != j.end(); ++it) {
+            StatementParam p;
+            if (!convert(it.value(), p)) return false;
+            p.name = it.key();
+            out.push_back(std::move(p));
+        }
+        return true;
+    }
+
+    error = "params must be an array or an object";
+    return false;
+}
+
+// Bind parameters to a freshly reset statement.
+inline bool bind_statement_params(sqlite3_stmt* stmt,
+                                  const std::vector<StatementParam>& params,
+                                  std::string& error) {
+    if (!stmt) {
+        error = "No statement";
+        return false;
+    }
+
+    const int expected = sqlite3_bind_parameter_count(stmt);
+    int positional = 0;
+
+    for (const auto& p : params) {
+        int idx = 0;
+        if (!p.name.empty()) {
+            idx = sqlite3_bind_parameter_index(stmt, p.name.c_str());
+            if (idx == 0 && p.name[0] != ':' && p.name[0] != '@' && p.name[0] != '$') {
+                idx = sqlite3_bind_parameter_index(stmt, (":" + p.name).c_str());
+            }
+            if (idx == 0) {
+                error = "Unknown parameter: " + p.name;
+                return false;
+            }
+        } else {
+            idx = ++positional;
+            if (idx > expected) {
+                error = "Too many parameters (statement expects " + std::to_string(expected) + ")";
+                return false;
+            }
+        }
+
+        int rc = SQLITE_OK;
+        switch (p.type) {
+            case StatementParam::Type::Null:
+                rc = sqlite3_bind_null(stmt, idx);
+                break;
+            case StatementParam::Type::Integer:
+                rc = sqlite3_bind_int64(stmt, idx, static_cast<sqlite3_int64>(p.int_value));
+                break;
+            case StatementParam::Type::Real:
+                rc = sqlite3_bind_double(stmt, idx, p.real_value);
+                break;
+            case StatementParam::Type::Text:
+                rc = sqlite3_bind_text(stmt, idx, p.text_value.data(),
+                                       static_cast<int>(p.text_value.size()), SQLITE_TRANSIENT);
+                break;
+        }
+        if (rc != SQLITE_OK) {
+            error = sqlite3_errmsg(sqlite3_db_handle(stmt));
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// ============================================================================
+// Statement cache
+// ============================================================================
+
+// LRU of prepared statements keyed by SQL text, plus pinned named statements.
+// Not thread-safe: callers serialize access (dispatcher worker or query mutex).
+class StatementCache {
+    struct Entry {
+        std::string sql;
+        sqlite3_stmt* stmt = nullptr;
+        bool in_use = false;
+    };
+
+    struct Named {
+        std::string sql;
+        sqlite3_stmt* stmt = nullptr;
+        bool in_use = false;
+    };
+
+public:
+    // Borrowed statement. Reset and unbound on release; owned (uncached)
+    // statements are finalized instead.
+    class Handle {
+        sqlite3_stmt* stmt_ = nullptr;
+        bool* in_use_ = nullptr;
+        bool owned_ = false;
+
+        void release() {
+            if (!stmt_) return;
+            if (owned_) {
+                sqlite3_finalize(stmt_);
+            } else {
+                sqlite3_reset(stmt_);
+                sqlite3_clear_bindings(stmt_);
+                if (in_use_) *in_use_ = false;
+            }
+            stmt_ = nullptr;
+            in_use_ = nullptr;
+            owned_ = false;
+        }
+
+    public:
+        Handle() = default;
+        Handle(sqlite3_stmt* stmt, bool* in_use, bool owned)
+            : stmt_(stmt), in_use_(in_use), owned_(owned) {}
+        ~Handle() { release(); }
+
+        Handle(Handle&& other) noexcept
+            : stmt_(other.stmt_), in_use_(other.in_use_), owned_(other.owned_) {
+            other.stmt_ = nullptr;
+            other.in_use_ = nullptr;
+            other.owned_ = false;
+        }
+
+        Handle& operator=(Handle&& other) noexcept {
+            if (this != &other) {
+                release();
+                stmt_ = other.stmt_;
+                in_use_ = other.in_use_;
+                owned_ = other.owned_;
+                other.stmt_ = nullptr;
+                other.in_use_ = nullptr;
+                other.owned_ = false;
+            }
+            return *this;
+        }
+
+        Handle(const Handle&) = delete;
+        Handle& operator=(const Handle&) = delete;
+
+        sqlite3_stmt* get() const { return stmt_; }
+        explicit operator bool() const { return stmt_ != nullptr; }
+    };
+
+    explicit StatementCache(sqlite3* db, size_t capacity = 64)
+        : db_(db), capacity_(capacity ? capacity : 1) {}
+
+    ~StatementCache() { clear(); }
+
+    StatementCache(const StatementCache&) = delete;
+    StatementCache& operator=(const StatementCache&) = delete;
+
+    // Prepare (or reuse) a single SQL statement.
+    Handle acquire(const std::string& sql, std::string& error) {
+        auto it = index_.find(sql);
+        if (it != index_.end()) {
+            Entry& e = *it->second;
+            if (!e.in_use) {
+                ++hits_;
+                Metrics::global().statement_cache_hits.inc();
+                lru_.splice(lru_.begin(), lru_, it->second);
+                e.in_use = true;
+                return Handle(e.stmt, &e.in_use, false);
+            }
+            // Same text already borrowed (re-entrant use) - hand out a private copy
+            sqlite3_stmt* stmt = prepare_single(sql, error);
+            if (!stmt) return {};
+            ++misses_;
+            Metrics::global().statement_cache_misses.inc();
+            return Handle(stmt, nullptr, true);
+        }
+
+        sqlite3_stmt* stmt = prepare_single(sql, error);
+        if (!stmt) return {};
+        ++misses_;
+        Metrics::global().statement_cache_misses.inc();
+
+        lru_.push_front(Entry{sql, stmt, true});
+        index_[sql] = lru_.begin();
+        evict_excess();
+        return Handle(stmt, &lru_.front().in_use, false);
+    }
+
+    // Register a named statement. Named statements are pinned until removed.
+    bool register_named(const std::string& name, const std::string& sql, std::string& error,
+                        int* param_count = nullptr) {
+        if (name.empty()) {
+            error = "Statement name required";
+            return false;
+        }
+        sqlite3_stmt* stmt = prepare_single(sql, error);
+        if (!stmt) return false;
+        if (param_count) *param_count = sqlite3_bind_parameter_count(stmt);
+
+        auto it = named_.find(name);
+        if (it != named_.end()) {
+            if (it->second.in_use) {
+                sqlite3_finalize(stmt);
+                error = "Statement is in use: " + name;
+                return false;
+            }
+            sqlite3_finalize(it->second.stmt);
+            it->second = Named{sql, stmt, false};
+        } else {
+            named_.emplace(name, Named{sql, stmt, false});
+        }
+        return true;
+    }
+
+    Handle acquire_named(const std::string& name, std::string& error) {
+        auto it = named_.find(name);
+        if (it == named_.end()) {
+            error = "Unknown statement: " + name;
+            return {};
+        }
+        Named& n = it->second;
+        if (n.in_use) {
+            sqlite3_stmt* stmt = prepare_single(n.sql, error);
+            if (!stmt) return {};
+            return Handle(stmt, nullptr, true);
+        }
+        ++hits_;
+        Metrics::global().statement_cache_hits.inc();
+        n.in_use = true;
+        return Handle(n.stmt, &n.in_use, false);
+    }
+
+    bool remove_named(const std::string& name) {
+        auto it = named_.find(name);
+        if (it == named_.end() || it->second.in_use) return false;
+        sqlite3_finalize(it->second.stmt);
+        named_.erase(it);
+        return true;
+    }
+
+    void clear() {
+        for (auto& e : lru_) {
+            if (e.stmt) sqlite3_finalize(e.stmt);
+        }
+        lru_.clear();
+        index_.clear();
+        for (auto& [name, n] : named_) {
+            if (n.stmt) sqlite3_finalize(n.stmt);
+        }
+        named_.clear();
+    }
+
+    size_t size() const { return lru_.size(); }
+    size_t named_count() const { return named_.size(); }
+    size_t capacity() const { return capacity_; }
+    uint64_t hits() const { return hits_; }
+    uint64_t misses() const { return misses_; }
+
+private:
+    sqlite3* db_ = nullptr;
+    size_t capacity_ = 64;
+    std::list<Entry> lru_;
+    std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+    std::unordered_map<std::string, Named> named_;
+    uint64_t hits_ = 0;
+    uint64_t misses_ = 0;
+
+    // True if tail holds only whitespace, ';' and comments ("-- ..." to end
+    // of line, "/* ... */", unterminated at the end as SQLite allows)
+    static bool only_trailing_noise(const char* tail) {
+        if (!tail) return true;
+        for (const char* p = tail; *p; ++p) {
+            unsigned char ch = static_cast<unsigned char>(*p);
+            if (ch == ';' || std::isspace(ch)) continue;
+            if (p[0] == '-' && p[1] == '-') {
+                while (p[1] && p[1] != '\n') ++p;
+                continue;
+            }
+            if (p[0] == '/' && p[1] == '*') {
+                const char* end = std::strstr(p + 2, "*/");
+                if (!end) return true;
+                p = end + 1;
+                continue;
+            }
+            return false;
+        }
+        return true;
+    }
+
+    sqlite3_stmt* prepare_single(const std::string& sql, std::string& error) {
+        if (!db_) {
+            error = "Database not open";
+            return nullptr;
+        }
+        sqlite3_stmt* stmt = nullptr;
+        const char* tail = nullptr;
+        int rc = sqlite3_prepare_v3(db_, sql.c_str(), static_cast<int>(sql.size()),
+                                    SQLITE_PREPARE_PERSISTENT, &stmt, &tail);
+        if (rc != SQLITE_OK) {
+            error = sqlite3_errmsg(db_);
+            if (stmt) sqlite3_finalize(stmt);
+            return nullptr;
+        }
+        if (!stmt) {
+            error = "Empty statement";
+            return nullptr;
+        }
+        if (!only_trailing_noise(tail)) {
+            sqlite3_finalize(stmt);
+            error = "Prepared statements must contain a single SQL statement";
+            return nullptr;
+        }
+        return stmt;
+    }
+
+    void evict_excess() {
+        auto it = lru_.end();
+        while (lru_.size() > capacity_ && it != lru_.begin()) {
+            --it;
+            if (it->in_use) continue;
+            index_.erase(it->sql);
+            sqlite3_finalize(it->stmt);
+            it = lru_.erase(it);
+        }
+    }
+};
+
+} // namespace pdbsql
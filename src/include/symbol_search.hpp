@@ -0,0 +1,301 @@
+#pragma once
+// symbol_search.hpp - Ranked fuzzy search over symbol names
+//
+// A trigram index over normalized names (and undecorated names), plus the
+// initials of each name's words so "gfs" finds GetFileSize. A query counts
+// trigram hits per entry to pick candidates, then ranks only those by exact,
+// prefix and substring matches, word overlap (camelCase, snake_case and ::
+// boundaries) and trigram overlap. Short names win ties. Portable: no DIA.
+//
+// Names and queries are normalized the same way: lowercased, with every run
+// of separators ('_', spaces, "::", ...) folded to one '_', so "file size"
+// finds get_file_size and "ns foo" finds ns::foo.
+//
+// The index is built once: add() every entry, then finish() sorts the
+// (trigram, entry) pairs into one flat posting array.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace pdbsql {
+
+namespace search_detail {
+
+inline char lower(char c) {
+    return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+inline bool is_word_char(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9');
+}
+
+// Anything but ASCII letters and digits; bytes of UTF-8 sequences are kept
+inline bool is_separator(char c) {
+    return !is_word_char(c) && static_cast<unsigned char>(c) < 0x80;
+}
+
+// Lowercased s with each run of separators folded to one '_', into out
+inline void normalize(std::string_view s, std::string& out) {
+    out.clear();
+    for (size_t i = 0; i < s.size(); i++) {
+        if (!is_separator(s[i])) {
+            out += lower(s[i]);
+        } else if (i == 0 || !is_separator(s[i - 1])) {
+            out += '_';
+        }
+    }
+}
+
+inline std::string normalize(std::string_view s) {
+    std::string out;
+    out.reserve(s.size());
+    normalize(s, out);
+    return out;
+}
+
+// Lowercased words of s: split at non-alphanumerics, lower->Upper and
+// letter<->digit changes, and before the last capital of a run ("HTTPServer"
+// -> http, server).
+inline std::vector<std::string> words(std::string_view s) {
+    std::vector<std::string> out;
+    std::string cur;
+    auto flush = [&] {
+        if (!cur.empty()) out.push_back(std::move(cur));
+        cur.clear();
+    };
+    for (size_t i = 0; i < s.size(); i++) {
+        const char c = s[i];
+        if (!is_word_char(c)) {
+            flush();
+            continue;
+        }
+        if (!cur.empty()) {
+            const char p = s[i - 1];
+            const bool upper = c >= 'A' && c <= 'Z';
+            const bool digit = c >= '0' && c <= '9';
+            const bool p_upper = p >= 'A' && p <= 'Z';
+            const bool p_digit = p >= '0' && p <= '9';
+            const bool next_lower = i + 1 < s.size() && s[i + 1] >= 'a' && s[i + 1] <= 'z';
+            if ((upper && !p_upper) || (upper && p_upper && next_lower) || digit != p_digit) flush();
+        }
+        cur += lower(c);
+    }
+    flush();
+    return out;
+}
+
+inline std::string initials(const std::vector<std::string>& w) {
+    std::string out;
+    for (const auto& word : w) out += word[0];
+    return out;
+}
+
+// Trailing component of a qualified name ("ns::Foo::bar" -> "bar")
+inline std::string_view last_component(std::string_view s) {
+    const size_t at = s.rfind("::");
+    return at == std::string_view::npos ? s : s.substr(at + 2);
+}
+
+inline uint32_t trigram(const char* p) {
+    return static_cast<uint32_t>(static_cast<unsigned char>(p[0])) << 16 |
+           static_cast<uint32_t>(static_cast<unsigned char>(p[1])) << 8 |
+           static_cast<uint32_t>(static_cast<unsigned char>(p[2]));
+}
+
+// Distinct trigrams of the '\n'-separated parts of text (none span parts)
+inline void trigrams(const std::string& text, std::vector<uint32_t>& out) {
+    out.clear();
+    size_t start = 0;
+    while (start <= text.size()) {
+        size_t end = text.find('\n', start);
+        if (end == std::string::npos) end = text.size();
+        for (size_t i = start; i + 3 <= end; i++) out.push_back(trigram(text.data() + i));
+        start = end + 1;
+    }
+    std::sort(out.begin(), out.end());
+    out.erase(std::unique(out.begin(), out.end()), out.end());
+}
+
+} // namespace search_detail
+
+struct SymbolSearchHit {
+    size_t entry = 0;   // Index in add() order
+    int score = 0;
+};
+
+class SymbolSearchIndex {
+    struct Entry {
+        std::string name;           // As added, for scoring
+        std::string undecorated;
+    };
+    std::vector<Entry> entries_;
+    std::vector<std::pair<uint32_t, uint32_t>> pending_;   // (trigram, entry) until finish()
+    std::vector<uint32_t> keys_;        // Sorted distinct trigrams
+    std::vector<uint32_t> offsets_;     // keys_[i] -> postings_[offsets_[i], offsets_[i + 1])
+    std::vector<uint32_t> postings_;
+
+    // Normalized searchable text of an entry: name, its initials, undecorated
+    static std::string index_text(std::string_view name, std::string_view undecorated) {
+        std::string text = search_detail::normalize(name);
+        text += '\n';
+        text += search_detail::initials(search_detail::words(search_detail::last_component(name)));
+        if (!undecorated.empty() && undecorated != name) {
+            text += '\n';
+            text += search_detail::normalize(undecorated);
+        }
+        return text;
+    }
+
+    // Match score of one candidate string (0 if it does not match at all)
+    static int score_text(std::string_view text, const std::string& q, const std::vector<std::string>& q_words,
+                          const std::string& q_compact) {
+        if (text.empty()) return 0;
+        const std::string full = search_detail::normalize(text);
+        const std::string_view tail_raw = search_detail::last_component(text);
+        const std::string tail = search_detail::normalize(tail_raw);
+
+        int score = 0;
+        if (tail == q || full == q) score += 1000;
+        else if (tail.compare(0, q.size(), q) == 0) score += 400;
+        else if (full.compare(0, q.size(), q) == 0) score += 300;
+        else if (full.find(q) != std::string::npos) score += 200;
+
+        const std::vector<std::string> t_words = search_detail::words(tail_raw);
+        if (!q_compact.empty() && q_compact.size() > 1) {
+            const std::string t_initials = search_detail::initials(t_words);
+            if (t_initials == q_compact) score += 250;
+            else if (t_initials.compare(0, q_compact.size(), q_compact) == 0) score += 150;
+        }
+
+        // Word overlap: each query word that starts a word of the name
+        int matched = 0;
+        for (const auto& qw : q_words) {
+            for (const auto& tw : t_words) {
+                if (tw.compare(0, qw.size(), qw) == 0) {
+                    matched++;
+                    break;
+                }
+            }
+        }
+        if (!q_words.empty()) {
+            score += 60 * matched;
+            if (matched == static_cast<int>(q_words.size()) && q_words.size() > 1) score += 100;
+        }
+        return score;
+    }
+
+public:
+    void reserve(size_t n) { entries_.reserve(n); }
+
+    void add(std::string_view name, std::string_view undecorated) {
+        const uint32_t id = static_cast<uint32_t>(entries_.size());
+        entries_.push_back(Entry{std::string(name), std::string(undecorated)});
+        std::vector<uint32_t> grams;
+        search_detail::trigrams(index_text(name, undecorated), grams);
+        for (uint32_t g : grams) pending_.emplace_back(g, id);
+    }
+
+    void finish() {
+        std::sort(pending_.begin(), pending_.end());
+        keys_.clear();
+        offsets_.clear();
+        postings_.clear();
+        postings_.reserve(pending_.size());
+        for (size_t i = 0; i < pending_.size(); i++) {
+            if (i == 0 || pending_[i].first != pending_[i - 1].first) {
+                keys_.push_back(pending_[i].first);
+                offsets_.push_back(static_cast<uint32_t>(postings_.size()));
+            }
+            postings_.push_back(pending_[i].second);
+        }
+        offsets_.push_back(static_cast<uint32_t>(postings_.size()));
+        std::vector<std::pair<uint32_t, uint32_t>>().swap(pending_);
+    }
+
+    size_t size() const { return entries_.size(); }
+    const std::string& name(size_t entry) const { return entries_[entry].name; }
+    const std::string& undecorated(size_t entry) const { return entries_[entry].undecorated; }
+
+    // Best `limit` entries for query, highest score first
+    std::vector<SymbolSearchHit> search(std::string_view query, size_t limit) const {
+        std::vector<SymbolSearchHit> hits;
+        query = query.substr(0, 256);  // Keeps per-entry hit counts within uint16_t
+        const std::string q = search_detail::normalize(query);
+        if (q.empty() || limit == 0) return hits;
+        const std::vector<std::string> q_words = search_detail::words(query);
+        std::string q_compact;
+        for (const auto& w : q_words) q_compact += w;
+
+        std::vector<uint32_t> grams;
+        search_detail::trigrams(q, grams);
+        if (q_compact != q && q_compact.size() >= 3) {
+            std::vector<uint32_t> more;
+            search_detail::trigrams(q_compact, more);
+            grams.insert(grams.end(), more.begin(), more.end());
+            std::sort(grams.begin(), grams.end());
+            grams.erase(std::unique(grams.begin(), grams.end()), grams.end());
+        }
+
+        // Candidates: entries sharing enough trigrams with the query. Queries
+        // shorter than a trigram scan every entry for a substring.
+        std::vector<uint32_t> candidates;
+        std::vector<uint16_t> counts;
+        if (grams.empty()) {
+            std::string name, undecorated;
+            for (size_t i = 0; i < entries_.size(); i++) {
+                search_detail::normalize(entries_[i].name, name);
+                search_detail::normalize(entries_[i].undecorated, undecorated);
+                if (name.find(q) != std::string::npos || undecorated.find(q) != std::string::npos) {
+                    candidates.push_back(static_cast<uint32_t>(i));
+                }
+            }
+        } else {
+            counts.assign(entries_.size(), 0);
+            for (uint32_t g : grams) {
+                auto it = std::lower_bound(keys_.begin(), keys_.end(), g);
+                if (it == keys_.end() || *it != g) continue;
+                const size_t k = static_cast<size_t>(it - keys_.begin());
+                for (uint32_t p = offsets_[k]; p < offsets_[k + 1]; p++) {
+                    if (counts[postings_[p]]++ == 0) candidates.push_back(postings_[p]);
+                }
+            }
+            const uint16_t need = static_cast<uint16_t>(grams.size() <= 2 ? 1 : (grams.size() + 1) / 2);
+            candidates.erase(std::remove_if(candidates.begin(), candidates.end(),
+                                            [&counts, need](uint32_t e) { return counts[e] < need; }),
+                             candidates.end());
+        }
+
+        hits.reserve(candidates.size());
+        for (uint32_t e : candidates) {
+            const Entry& entry = entries_[e];
+            int score = (std::max)(score_text(entry.name, q, q_words, q_compact),
+                                   score_text(entry.undecorated, q, q_words, q_compact));
+            if (!counts.empty()) score += static_cast<int>(100 * counts[e] / grams.size());
+            if (score <= 0) continue;
+            score -= static_cast<int>((std::min<size_t>)(entry.name.size(), 200) / 4);  // Prefer short names
+            hits.push_back(SymbolSearchHit{e, score});
+        }
+
+        auto better = [this](const SymbolSearchHit& a, const SymbolSearchHit& b) {
+            if (a.score != b.score) return a.score > b.score;
+            const std::string& an = entries_[a.entry].name;
+            const std::string& bn = entries_[b.entry].name;
+            if (an != bn) return an < bn;
+            return a.entry < b.entry;
+        };
+        if (hits.size() > limit) {
+            std::partial_sort(hits.begin(), hits.begin() + static_cast<std::ptrdiff_t>(limit), hits.end(), better);
+            hits.resize(limit);
+        } else {
+            std::sort(hits.begin(), hits.end(), better);
+        }
+        return hits;
+    }
+};
+
+} // namespace pdbsql
@@ -0,0 +1,363 @@
+#pragma once
+// symbol_store_index.hpp - On-disk catalog of a symbol store, keyed by GUID+age
+//
+// A symbol store (name.pdb/GUIDAGE/name.pdb) can hold hundreds of thousands of
+// PDBs. build() scans it in parallel, reading only MSF headers, and writes a
+// compact catalog: fixed-size records sorted by (GUID, age) followed by a
+// string pool of store-relative paths. load() reads it back in one go and
+// find() is a binary search, so a crash dump's GUID+age resolves to a path
+// without touching the filesystem.
+//
+// File layout (little-endian):
+//   Header   magic "PDBSQLX1", version, record count, string pool size
+//   Record[] 40 bytes each: guid[16], age, signature, file_size, path offset/length
+//   char[]   string pool (UTF-8 relative paths, '/' separated)
+
+#include "msf_reader.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace pdbsql {
+
+class SymbolStoreIndex {
+public:
+    struct Record {
+        uint8_t guid[16];
+        uint32_t age;
+        uint32_t signature;
+        uint64_t file_size;
+        uint32_t path_offset;
+        uint32_t path_length;
+    };
+    static_assert(sizeof(Record) == 40, "index record layout");
+
+    struct BuildStats {
+        uint64_t files = 0;    // .pdb files found
+        uint64_t indexed = 0;  // Files with a readable header
+        uint64_t failed = 0;
+        double seconds = 0.0;
+    };
+
+    static constexpr const char* DEFAULT_FILE_NAME = "pdbsql.idx";
+
+    static std::string default_index_path(const std::string& root) {
+        return (std::filesystem::u8path(root) / DEFAULT_FILE_NAME).u8string();
+    }
+
+    // Scan `root` with `jobs` threads and write the catalog to `index_path`.
+    static bool build(const std::string& root, const std::string& index_path, unsigned jobs,
+                      BuildStats& stats, std::string& error) {
+        namespace fs = std::filesystem;
+        auto start = std::chrono::steady_clock::now();
+        stats = BuildStats{};
+
+        std::error_code ec;
+        fs::path root_path = fs::u8path(root);
+        if (!fs::is_directory(root_path, ec)) {
+            error = "Symbol store directory not found: " + root;
+            return false;
+        }
+
+        // Work items: top-level entries (one per PDB name in a symbol store)
+        std::vector<fs::path> work;
+        for (fs::directory_iterator it(root_path, fs::directory_options::skip_permission_denied, ec);
+             !ec && it != fs::directory_iterator(); it.increment(ec)) {
+            work.push_back(it->path());
+        }
+        if (ec) {
+            error = "Cannot read directory: " + root;
+            return false;
+        }
+
+        struct Found {
+            PdbHeaderInfo info;
+            std::string relative;
+        };
+
+        if (jobs == 0) jobs = std::max(1u, std::thread::hardware_concurrency());
+        jobs = static_cast<unsigned>(std::min<size_t>(jobs, std::max<size_t>(work.size(), 1)));
+
+        std::atomic<size_t> next{0};
+        std::atomic<uint64_t> files{0}, failed{0};
+        std::vector<std::vector<Found>> per_worker(jobs);
+
+        auto worker = [&](unsigned id) {
+            auto& out = per_worker[id];
+            auto visit = [&](const fs::path& file) {
+                if (to_lower(file.extension().u8string()) != ".pdb") return;
+                files.fetch_add(1, std::memory_order_relaxed);
+                Found f;
+                std::string read_error;
+                if (!read_pdb_header(file.u8string(), f.info, read_error)) {
+                    failed.fetch_add(1, std::memory_order_relaxed);
+                    return;
+                }
+                f.relative = file.lexically_relative(root_path).generic_u8string();
+                out.push_back(std::move(f));
+            };
+
+            for (size_t i; (i = next.fetch_add(1)) < work.size();) {
+                std::error_code wec;
+                if (fs::is_directory(work[i], wec)) {
+                    fs::recursive_directory_iterator it(work[i], fs::directory_options::skip_permission_denied, wec);
+                    for (; !wec && it != fs::recursive_directory_iterator(); it.increment(wec)) {
+                        std::error_code fec;
+                        if (it->is_regular_file(fec)) visit(it->path());
+                    }
+                } else if (fs::is_regular_file(work[i], wec)) {
+                    visit(work[i]);
+                }
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (unsigned t = 1; t < jobs; t++) threads.emplace_back(worker, t);
+        worker(0);
+        for (auto& t : threads) t.join();
+
+        // Merge and sort by (GUID, age)
+        std::vector<Found> all;
+        for (auto& v : per_worker) {
+            for (auto& f : v) all.push_back(std::move(f));
+        }
+        std::sort(all.begin(), all.end(), [](const Found& a, const Found& b) {
+            return compare(a.info.guid, a.info.age, b.info.guid, b.info.age) < 0;
+        });
+
+        std::vector<Record> records;
+        std::string strings;
+        records.reserve(all.size());
+        for (const auto& f : all) {
+            Record r{};
+            std::memcpy(r.guid, f.info.guid, sizeof(r.guid));
+            r.age = f.info.age;
+            r.signature = f.info.signature;
+            r.file_size = f.info.file_size;
+            r.path_offset = static_cast<uint32_t>(strings.size());
+            r.path_length = static_cast<uint32_t>(f.relative.size());
+            strings += f.relative;
+            records.push_back(r);
+        }
+
+        if (!write_file(index_path, records, strings, error)) return false;
+
+        stats.files = files.load();
+        stats.failed = failed.load();
+        stats.indexed = records.size();
+        stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return true;
+    }
+
+    // Load a catalog; relative paths resolve against `root`.
+    bool load(const std::string& index_path, const std::string& root, std::string& error) {
+        std::ifstream in(std::filesystem::u8path(index_path), std::ios::binary);
+        if (!in) {
+            error = "Cannot open index: " + index_path;
+            return false;
+        }
+
+        Header h{};
+        in.read(reinterpret_cast<char*>(&h), sizeof(h));
+        if (in.gcount() != static_cast<std::streamsize>(sizeof(h)) ||
+            std::memcmp(h.magic, MAGIC, sizeof(h.magic)) != 0 || h.version != VERSION) {
+            error = "Not a pdbsql symbol store index (or wrong version): " + index_path;
+            return false;
+        }
+
+        std::error_code ec;
+        uint64_t file_size = std::filesystem::file_size(std::filesystem::u8path(index_path), ec);
+        if (ec || h.count > file_size / sizeof(Record) ||
+            sizeof(Header) + h.count * sizeof(Record) + h.strings_size != file_size) {
+            error = "Corrupt index: " + index_path;
+            return false;
+        }
+
+        std::vector<Record> records(static_cast<size_t>(h.count));
+        std::string strings(static_cast<size_t>(h.strings_size), '\0');
+        in.read(reinterpret_cast<char*>(records.data()), static_cast<std::streamsize>(records.size() * sizeof(Record)));
+        in.read(strings.data(), static_cast<std::streamsize>(strings.size()));
+        if (!in) {
+            error = "Truncated index: " + index_path;
+            return false;
+        }
+        for (const auto& r : records) {
+            if (static_cast<uint64_t>(r.path_offset) + r.path_length > strings.size()) {
+                error = "Corrupt index: " + index_path;
+                return false;
+            }
+        }
+
+        records_ = std::move(records);
+        strings_ = std::move(strings);
+        root_ = root;
+        return true;
+    }
+
+    size_t size() const { return records_.size(); }
+    const Record& record(size_t i) const { return records_[i]; }
+    const std::string& root() const { return root_; }
+
+    std::string relative_path(size_t i) const {
+        const Record& r = records_[i];
+        return strings_.substr(r.path_offset, r.path_length);
+    }
+
+    std::string path(size_t i) const {
+        return (std::filesystem::u8path(root_) / std::filesystem::u8path(relative_path(i)))
+            .lexically_normal().u8string();
+    }
+
+    // Lower-case PDB file name without extension
+    std::string module(size_t i) const {
+        return to_lower(std::filesystem::u8path(relative_path(i)).stem().u8string());
+    }
+
+    std::string signature(size_t i) const {
+        return format_guid_age(records_[i].guid, records_[i].age);
+    }
+
+    // Binary search by GUID+age.
+    bool find(const uint8_t guid[16], uint32_t age, size_t& index) const {
+        auto it = std::lower_bound(records_.begin(), records_.end(), 0,
+            [&](const Record& r, int) { return compare(r.guid, r.age, guid, age) < 0; });
+        if (it == records_.end() || compare(it->guid, it->age, guid, age) != 0) return false;
+        index = static_cast<size_t>(it - records_.begin());
+        return true;
+    }
+
+    bool find_signature(const std::string& signature, size_t& index) const {
+        uint8_t guid[16];
+        uint32_t age = 0;
+        return parse_guid_age(signature, guid, age) && find(guid, age, index);
+    }
+
+private:
+    static constexpr char MAGIC[8] = {'P', 'D', 'B', 'S', 'Q', 'L', 'X', '1'};
+    static constexpr uint32_t VERSION = 1;
+
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t reserved;
+        uint64_t count;
+        uint64_t strings_size;
+    };
+    static_assert(sizeof(Header) == 32, "index header layout");
+
+    std::vector<Record> records_;
+    std::string strings_;
+    std::string root_;
+
+    static std::string to_lower(std::string s) {
+        for (char& ch : s) ch = static_cast<char>(std::tolower(static_cast<unsigned char>(ch)));
+        return s;
+    }
+
+    static int compare(const uint8_t* guid_a, uint32_t age_a, const uint8_t* guid_b, uint32_t age_b) {
+        int c = std::memcmp(guid_a, guid_b, 16);
+        if (c != 0) return c;
+        return age_a < age_b ? -1 : (age_a > age_b ? 1 : 0);
+    }
+
+    static bool write_file(const std::string& index_path, const std::vector<Record>& records,
+                           const std::string& strings, std::string& error) {
+        namespace fs = std::filesystem;
+        fs::path final_path = fs::u8path(index_path);
+        fs::path tmp_path = final_path;
+        tmp_path += ".tmp";
+
+        {
+            std::ofstream out(tmp_path, std::ios::binary | std::ios::trunc);
+            if (!out) {
+                error = "Cannot write index: " + index_path;
+                return false;
+            }
+            Header h{};
+            std::memcpy(h.magic, MAGIC, sizeof(h.magic));
+            h.version = VERSION;
+            h.count = records.size();
+            h.strings_size = strings.size();
+            out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+            out.write(reinterpret_cast<const char*>(records.data()),
+                      static_cast<std::streamsize>(records.size() * sizeof(Record)));
+            out.write(strings.data(), static_cast<std::streamsize>(strings.size()));
+            if (!out) {
+                error = "Failed writing index: " + index_path;
+                return false;
+            }
+        }
+
+        // Replace atomically so concurrent readers never see a partial file
+        std::error_code ec;
+        fs::rename(tmp_path, final_path, ec);
+        if (ec) {
+            fs::remove(final_path, ec);
+            fs::rename(tmp_path, final_path, ec);
+        }
+        if (ec) {
+            error = "Cannot replace index: " + index_path;
+            return false;
+        }
+        return true;
+    }
+};
+
+// True if the store changed after its catalog was written: a top-level entry
+// (a name.pdb directory gains a GUIDAGE directory when a PDB is added) is
+// newer than the index, or the root is. Writing the index touches the root
+// too, hence the slack on that one.
+inline bool symbol_store_index_stale(const std::string& root, const std::string& index_path) {
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    const fs::path index = fs::u8path(index_path);
+    const fs::file_time_type written = fs::last_write_time(index, ec);
+    if (ec) return true;
+
+    const fs::path root_path = fs::u8path(root);
+    const fs::file_time_type root_time = fs::last_write_time(root_path, ec);
+    if (!ec && root_time > written + std::chrono::seconds(2)) return true;
+
+    for (fs::directory_iterator it(root_path, fs::directory_options::skip_permission_denied, ec);
+         !ec && it != fs::directory_iterator(); it.increment(ec)) {
+        const std::string name = it->path().filename().u8string();
+        if (name == SymbolStoreIndex::DEFAULT_FILE_NAME || name == std::string(SymbolStoreIndex::DEFAULT_FILE_NAME) + ".tmp") {
+            continue;
+        }
+        std::error_code tec;
+        const fs::file_time_type t = it->last_write_time(tec);
+        if (!tec && t > written) return true;
+    }
+    return false;
+}
+
+// Load the catalog for a store, building it first if it does not exist yet or
+// the store has changed since it was written.
+inline std::shared_ptr<SymbolStoreIndex> open_symbol_store_index(const std::string& root, unsigned jobs,
+                                                                 std::string& error) {
+    std::string index_path = SymbolStoreIndex::default_index_path(root);
+    std::error_code ec;
+    const bool exists = std::filesystem::exists(std::filesystem::u8path(index_path), ec);
+    if (!exists || symbol_store_index_stale(root, index_path)) {
+        if (exists) fprintf(stderr, "Symbol store changed since %s was written; rebuilding\n", index_path.c_str());
+        SymbolStoreIndex::BuildStats stats;
+        if (!SymbolStoreIndex::build(root, index_path, jobs, stats, error)) return nullptr;
+    }
+    auto index = std::make_shared<SymbolStoreIndex>();
+    if (!index->load(index_path, root, error)) return nullptr;
+    return index;
+}
+
+} // namespace pdbsql
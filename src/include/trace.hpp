@@ -0,0 +1,310 @@
+#pragma once
+// trace.hpp - Chrome Trace Event output (--trace out.json)
+//
+// Opt-in span tracing for latency investigations. Spans are written as
+// Chrome Trace Event JSON ("X" complete events, one track per thread) and
+// open in chrome://tracing or https://ui.perfetto.dev.
+//
+// When tracing is off every hook is a single relaxed atomic load. When on,
+// events are appended to a buffer under a mutex and flushed to the file
+// every 64 KB or once a second, so a killed server still leaves a usable
+// trace (both viewers accept a file without the closing bracket).
+//
+// Spans recorded: PDB open and DIA enumeration calls, table registration,
+// xFilter pushdowns, generator batches (per cursor, up to 1024 rows each),
+// statement execution and JSON serialization, HTTP handlers and response
+// writes, dispatcher jobs (with a flow arrow from the waiting caller) and
+// the agent loop.
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "json_text.hpp"
+
+namespace pdbsql {
+
+class Tracer {
+public:
+    static Tracer& global() {
+        static Tracer instance;
+        return instance;
+    }
+
+    bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+    bool start(const std::string& path, std::string& error) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (file_) {
+            error = "Trace already started";
+            return false;
+        }
+        file_ = fopen(path.c_str(), "wb");
+        if (!file_) {
+            error = "Cannot open trace file: " + path;
+            return false;
+        }
+        buffer_ = "[\n";
+        first_ = true;
+        session_++;
+        last_flush_ = std::chrono::steady_clock::now();
+        append_locked("{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"pdbsql\"}}");
+        enabled_.store(true, std::memory_order_relaxed);
+        return true;
+    }
+
+    void stop() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!file_) return;
+        enabled_.store(false, std::memory_order_relaxed);
+        buffer_ += "\n]\n";
+        flush_locked();
+        fclose(file_);
+        file_ = nullptr;
+    }
+
+    // Microseconds on the steady clock (trace timestamps)
+    static double now_us() {
+        return std::chrono::duration<double, std::micro>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // Label the calling thread's track. May be called before start().
+    static void name_thread(const char* name) {
+        ThreadInfo& t = thread_info();
+        if (t.name == name) return;
+        t.name = name;
+        t.announced = 0;
+    }
+
+    // Complete event. `args` is a JSON object body ("\"k\":v,...") or empty.
+    void complete(const std::string& name, const char* cat, double ts_us, double dur_us,
+                  const std::string& args = std::string()) {
+        char head[160];
+        snprintf(head, sizeof(head), "{\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,\"cat\":\"%s\",\"name\":",
+                 thread_info().tid, ts_us, dur_us < 0 ? 0.0 : dur_us, cat);
+        emit(head, name, args);
+    }
+
+    // Flow arrow between threads: start on the producer, finish on the consumer.
+    void flow_start(const char* name, uint64_t id) { flow("s", name, id, now_us()); }
+    void flow_finish(const char* name, uint64_t id) { flow("f", name, id, now_us()); }
+
+    uint64_t next_flow_id() { return flow_ids_.fetch_add(1, std::memory_order_relaxed) + 1; }
+
+private:
+    Tracer() = default;
+    ~Tracer() { stop(); }
+
+    struct ThreadInfo {
+        unsigned tid = 0;
+        const char* name = nullptr;
+        uint64_t announced = 0;  // Trace session the thread name was written to
+    };
+
+    static ThreadInfo& thread_info() {
+        static std::atomic<unsigned> next_tid{0};
+        thread_local ThreadInfo info{next_tid.fetch_add(1) + 1, nullptr, 0};
+        return info;
+    }
+
+    static constexpr size_t FLUSH_BYTES = 64 * 1024;
+
+    std::atomic<bool> enabled_{false};
+    std::atomic<uint64_t> flow_ids_{0};
+    std::mutex mutex_;
+    FILE* file_ = nullptr;
+    std::string buffer_;
+    bool first_ = true;
+    uint64_t session_ = 0;
+    std::chrono::steady_clock::time_point last_flush_;
+
+    void flow(const char* ph, const char* name, uint64_t id, double ts_us) {
+        char head[192];
+        snprintf(head, sizeof(head),
+                 "{\"ph\":\"%s\",\"bp\":\"e\",\"id\":%llu,\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"cat\":\"flow\",\"name\":",
+                 ph, static_cast<unsigned long long>(id), thread_info().tid, ts_us);
+        emit(head, name, std::string());
+    }
+
+    void emit(const char* head, const std::string& name, const std::string& args) {
+        std::string event = head;
+        append_json_string(event, name);
+        if (!args.empty()) {
+            event += ",\"args\":{";
+            event += args;
+            event += '}';
+        }
+        event += '}';
+
+        ThreadInfo& t = thread_info();
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!file_) return;
+        if (t.announced != session_) {
+            t.announced = session_;
+            std::string meta = "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + std::to_string(t.tid) +
+                               ",\"args\":{\"name\":";
+            append_json_string(meta, t.name ? t.name : "thread " + std::to_string(t.tid));
+            meta += "}}";
+            append_locked(meta);
+        }
+        append_locked(event);
+
+        auto now = std::chrono::steady_clock::now();
+        if (buffer_.size() >= FLUSH_BYTES || now - last_flush_ >= std::chrono::seconds(1)) {
+            flush_locked();
+            last_flush_ = now;
+        }
+    }
+
+    void append_locked(const std::string& event) {
+        if (!first_) buffer_ += ",\n";
+        first_ = false;
+        buffer_ += event;
+    }
+
+    void flush_locked() {
+        if (file_ && !buffer_.empty()) {
+            fwrite(buffer_.data(), 1, buffer_.size(), file_);
+            fflush(file_);
+        }
+        buffer_.clear();
+    }
+};
+
+// Records one complete event for its lifetime. No-op when tracing is off.
+class TraceSpan {
+public:
+    TraceSpan(const char* name, const char* cat)
+        : active_(Tracer::global().enabled())
+    {
+        if (!active_) return;
+        name_ = name;
+        cat_ = cat;
+        start_us_ = Tracer::now_us();
+    }
+
+    ~TraceSpan() {
+        if (!active_) return;
+        Tracer::global().complete(name_, cat_, start_us_, Tracer::now_us() - start_us_, args_);
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+
+    bool active() const { return active_; }
+
+    TraceSpan& arg(const char* key, const std::string& value) {
+        if (!active_) return *this;
+        key_(key);
+        append_json_string(args_, value);
+        return *this;
+    }
+
+    TraceSpan& arg(const char* key, const char* value) {
+        return active_ ? arg(key, std::string(value ? value : "")) : *this;
+    }
+
+    template<typename T, typename = std::enable_if_t<std::is_arithmetic<T>::value>>
+    TraceSpan& arg(const char* key, T value) {
+        if (!active_) return *this;
+        key_(key);
+        args_ += std::to_string(value);
+        return *this;
+    }
+
+private:
+    bool active_;
+    std::string name_;
+    const char* cat_ = "";
+    double start_us_ = 0.0;
+    std::string args_;
+
+    void key_(const char* key) {
+        if (!args_.empty()) args_ += ',';
+        args_ += '"';
+        args_ += key;
+        args_ += "\":";
+    }
+};
+
+// Groups one cursor's next() calls into spans of up to ROWS rows. Each span
+// runs from the first to the last call of the batch (SQLite's own work
+// in between included) and carries the time spent inside the generator.
+class TraceBatch {
+public:
+    static constexpr uint64_t ROWS = 1024;
+
+    TraceBatch() = default;
+    ~TraceBatch() { flush(); }
+
+    TraceBatch(const TraceBatch&) = delete;
+    TraceBatch& operator=(const TraceBatch&) = delete;
+
+    // Start batching if tracing is on; the table name becomes the span name.
+    void open(const std::string& table, const std::string& plan) {
+        if (!Tracer::global().enabled()) return;
+        active_ = true;
+        table_ = table;
+        plan_ = plan;
+    }
+
+    bool active() const { return active_; }
+
+    void record(double start_us, double dur_us, bool produced_row) {
+        if (calls_ == 0) first_us_ = start_us;
+        calls_++;
+        busy_us_ += dur_us;
+        last_us_ = start_us + dur_us;
+        if (produced_row) rows_++;
+        if (!produced_row || rows_ >= ROWS) flush();
+    }
+
+private:
+    bool active_ = false;
+    std::string table_;
+    std::string plan_;
+    uint64_t batch_ = 0;
+    uint64_t calls_ = 0;
+    uint64_t rows_ = 0;
+    double first_us_ = 0.0;
+    double last_us_ = 0.0;
+    double busy_us_ = 0.0;
+
+    void flush() {
+        if (!active_ || calls_ == 0) return;
+        std::string args = "\"plan\":";
+        append_json_string(args, plan_);
+        char buf[128];
+        snprintf(buf, sizeof(buf), ",\"batch\":%llu,\"rows\":%llu,\"next_calls\":%llu,\"generator_us\":%.3f",
+                 static_cast<unsigned long long>(batch_), static_cast<unsigned long long>(rows_),
+                 static_cast<unsigned long long>(calls_), busy_us_);
+        args += buf;
+        Tracer::global().complete(table_, "generator", first_us_, last_us_ - first_us_, args);
+        batch_++;
+        calls_ = 0;
+        rows_ = 0;
+        busy_us_ = 0.0;
+    }
+};
+
+// Starts tracing to `path` for the lifetime of the object (main's --trace).
+class TraceFile {
+public:
+    TraceFile() = default;
+    ~TraceFile() { Tracer::global().stop(); }
+
+    TraceFile(const TraceFile&) = delete;
+    TraceFile& operator=(const TraceFile&) = delete;
+
+    bool open(const std::string& path, std::string& error) {
+        return Tracer::global().start(path, error);
+    }
+};
+
+} // namespace pdbsql
@@ -0,0 +1,92 @@
+#pragma once
+// utf16.hpp - UTF-16LE to UTF-8 transcoding (DIA BSTRs, native readers)
+//
+// One pass into a caller-provided buffer: runs of ASCII are narrowed 16 code
+// units at a time with SSE2 (scalar elsewhere), everything else is encoded
+// per code unit. Unpaired surrogates become U+FFFD. Portable: no Windows API.
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define PDBSQL_UTF16_SSE2 1
+#endif
+
+namespace pdbsql {
+
+// UTF-8 bytes needed in the worst case for `units` UTF-16 code units
+inline size_t utf8_capacity_for_utf16(size_t units) {
+    return units * 3;
+}
+
+// Convert src[0, units) into dst, which must hold utf8_capacity_for_utf16(units)
+// bytes. Returns the number of bytes written (no terminator).
+inline size_t utf16_to_utf8(const char16_t* src, size_t units, char* dst) {
+    char* out = dst;
+    size_t i = 0;
+    while (i < units) {
+#if defined(PDBSQL_UTF16_SSE2)
+        // ASCII fast path: 16 units -> 16 bytes while no unit is >= 0x80
+        const __m128i high = _mm_set1_epi16(static_cast<short>(0xFF80));
+        const __m128i zero = _mm_setzero_si128();
+        while (i + 16 <= units) {
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 8));
+            __m128i non_ascii = _mm_or_si128(_mm_and_si128(a, high), _mm_and_si128(b, high));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi16(non_ascii, zero)) != 0xFFFF) break;
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_packus_epi16(a, b));
+            out += 16;
+            i += 16;
+        }
+        if (i >= units) break;
+#endif
+        const uint32_t u = src[i++];
+        if (u < 0x80) {
+            *out++ = static_cast<char>(u);
+            continue;
+        }
+        if (u < 0x800) {
+            *out++ = static_cast<char>(0xC0 | (u >> 6));
+            *out++ = static_cast<char>(0x80 | (u & 0x3F));
+            continue;
+        }
+        uint32_t cp = u;
+        if (u >= 0xD800 && u <= 0xDFFF) {
+            if (u <= 0xDBFF && i < units && src[i] >= 0xDC00 && src[i] <= 0xDFFF) {
+                cp = 0x10000 + ((u - 0xD800) << 10) + (src[i++] - 0xDC00u);
+                *out++ = static_cast<char>(0xF0 | (cp >> 18));
+                *out++ = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+                *out++ = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+                *out++ = static_cast<char>(0x80 | (cp & 0x3F));
+                continue;
+            }
+            cp = 0xFFFD;  // Unpaired surrogate
+        }
+        *out++ = static_cast<char>(0xE0 | (cp >> 12));
+        *out++ = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        *out++ = static_cast<char>(0x80 | (cp & 0x3F));
+    }
+    return static_cast<size_t>(out - dst);
+}
+
+// Append the UTF-8 form of src[0, units) to out.
+inline void append_utf16_as_utf8(std::string& out, const char16_t* src, size_t units) {
+    const size_t old_size = out.size();
+    out.resize(old_size + utf8_capacity_for_utf16(units));
+    out.resize(old_size + utf16_to_utf8(src, units, &out[old_size]));
+}
+
+// Exact-size std::string. Converts into a per-thread scratch buffer first so
+// the result is allocated once at its final length.
+inline std::string utf16_to_utf8(const char16_t* src, size_t units) {
+    if (units == 0) return std::string();
+    thread_local std::vector<char> scratch;
+    const size_t need = utf8_capacity_for_utf16(units);
+    if (scratch.size() < need) scratch.resize(need);
+    return std::string(scratch.data(), utf16_to_utf8(src, units, scratch.data()));
+}
+
+} // namespace pdbsql
@@ -0,0 +1,113 @@
+// bench_json_text.cpp - append_json_escaped() against the old scalar escaper
+//
+// Escapes the same corpus repeatedly with each implementation and prints
+// throughput. Inputs are shaped like query results: symbol names, long
+// undecorated template names, paths with backslashes and some non-ASCII text.
+//
+//   bench_json_text [iterations]
+
+#include "json_text.hpp"
+#include "json_text_reference.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Corpus {
+    const char* name;
+    std::vector<std::string> strings;
+    size_t bytes = 0;
+};
+
+Corpus make_corpus(const char* name, size_t count, std::string (*make)(std::mt19937&)) {
+    Corpus c;
+    c.name = name;
+    std::mt19937 rng(42);
+    for (size_t i = 0; i < count; i++) {
+        c.strings.push_back(make(rng));
+        c.bytes += c.strings.back().size();
+    }
+    return c;
+}
+
+std::string symbol_name(std::mt19937& rng) {
+    static const char* words[] = {"Get", "Set", "File", "Size", "Create", "Window", "Handle", "Buffer", "Init"};
+    std::string s;
+    for (int k = 2 + static_cast<int>(rng() % 3); k > 0; k--) s += words[rng() % 9];
+    return s;
+}
+
+std::string template_name(std::mt19937& rng) {
+    std::string s = "class std::basic_string<char,struct std::char_traits<char>,class std::allocator<char> > ";
+    s += "__cdecl std::_Func_impl_no_alloc<class <lambda_";
+    for (int i = 0; i < 32; i++) s += "0123456789abcdef"[rng() % 16];
+    s += ">,void>::_Do_call(void)";
+    return s;
+}
+
+std::string source_path(std::mt19937& rng) {
+    std::string s = "C:\\src\\project\\module";
+    s += std::to_string(rng() % 100);
+    s += "\\file.cpp";
+    return s;
+}
+
+std::string mixed_text(std::mt19937& rng) {
+    std::string s = symbol_name(rng);
+    s += " \"caf\xc3\xa9\" \xe2\x82\xac ";
+    s += symbol_name(rng);
+    return s;
+}
+
+template<typename Escape>
+double run(const Corpus& c, int iterations, Escape escape, size_t& sink) {
+    std::string out;
+    const auto start = std::chrono::steady_clock::now();
+    for (int it = 0; it < iterations; it++) {
+        for (const auto& s : c.strings) {
+            out.clear();
+            escape(out, s.data(), s.size());
+            sink += out.size();
+        }
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return static_cast<double>(c.bytes) * iterations / seconds / 1e9;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int iterations = argc > 1 ? std::atoi(argv[1]) : 50;
+    const Corpus corpora[] = {
+        make_corpus("symbol names", 100000, symbol_name),
+        make_corpus("template names", 20000, template_name),
+        make_corpus("source paths", 100000, source_path),
+        make_corpus("mixed UTF-8", 100000, mixed_text),
+    };
+
+#if defined(PDBSQL_JSON_AVX2)
+    const char* simd = "AVX2";
+#elif defined(PDBSQL_JSON_SSE2)
+    const char* simd = "SSE2";
+#else
+    const char* simd = "scalar";
+#endif
+    printf("append_json_escaped (%s) vs legacy scalar loop, %d iterations\n", simd, iterations);
+    printf("%-16s %12s %12s %8s\n", "corpus", "legacy GB/s", "current GB/s", "speedup");
+    size_t sink = 0;
+    for (const auto& c : corpora) {
+        const double legacy = run(c, iterations, pdbsql_test::legacy_append_json_escaped, sink);
+        const double current = run(c, iterations,
+                                   [](std::string& out, const char* p, size_t n) {
+                                       pdbsql::append_json_escaped(out, p, n);
+                                   },
+                                   sink);
+        printf("%-16s %12.2f %12.2f %7.1fx\n", c.name, legacy, current, current / legacy);
+    }
+    return sink == 0;  // Keeps the work observable
+}
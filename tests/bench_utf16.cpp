@@ -0,0 +1,99 @@
+// bench_utf16.cpp - utf16_to_utf8() against a per-code-unit encoder
+//
+// WideCharToMultiByte, which bstr_to_string() used before, is Windows-only,
+// so the baseline here is the straightforward per-unit loop from
+// utf16_reference.hpp. Inputs are shaped like DIA names: short symbols, long
+// template names and a few non-ASCII strings.
+//
+//   bench_utf16 [iterations]
+
+#include "utf16.hpp"
+#include "utf16_reference.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Corpus {
+    const char* name;
+    std::vector<std::u16string> strings;
+    size_t units = 0;
+};
+
+std::u16string widen(const std::string& s) {
+    return std::u16string(s.begin(), s.end());
+}
+
+Corpus make_corpus(const char* name, size_t count, std::u16string (*make)(std::mt19937&)) {
+    Corpus c;
+    c.name = name;
+    std::mt19937 rng(42);
+    for (size_t i = 0; i < count; i++) {
+        c.strings.push_back(make(rng));
+        c.units += c.strings.back().size();
+    }
+    return c;
+}
+
+std::u16string symbol_name(std::mt19937& rng) {
+    static const char* words[] = {"Get", "Set", "File", "Size", "Create", "Window", "Handle", "Buffer", "Init"};
+    std::string s;
+    for (int k = 2 + static_cast<int>(rng() % 3); k > 0; k--) s += words[rng() % 9];
+    return widen(s);
+}
+
+std::u16string template_name(std::mt19937& rng) {
+    std::string s = "std::_Func_impl_no_alloc<<lambda_";
+    for (int i = 0; i < 32; i++) s += "0123456789abcdef"[rng() % 16];
+    s += ">,void>::_Do_call";
+    return widen(s);
+}
+
+std::u16string non_ascii(std::mt19937& rng) {
+    std::u16string s = symbol_name(rng);
+    s += u"_caf\u00e9_\u20ac_\U0001F600";
+    return s;
+}
+
+template<typename Convert>
+double run(const Corpus& c, int iterations, Convert convert, size_t& sink) {
+    const auto start = std::chrono::steady_clock::now();
+    for (int it = 0; it < iterations; it++) {
+        for (const auto& s : c.strings) sink += convert(s.data(), s.size()).size();
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return static_cast<double>(c.units) * iterations / seconds / 1e6;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const int iterations = argc > 1 ? std::atoi(argv[1]) : 50;
+    const Corpus corpora[] = {
+        make_corpus("symbol names", 100000, symbol_name),
+        make_corpus("template names", 50000, template_name),
+        make_corpus("non-ASCII", 100000, non_ascii),
+    };
+
+#if defined(PDBSQL_UTF16_SSE2)
+    const char* simd = "SSE2";
+#else
+    const char* simd = "scalar";
+#endif
+    printf("utf16_to_utf8 (%s) vs per-unit encoder, %d iterations\n", simd, iterations);
+    printf("%-16s %14s %14s %8s\n", "corpus", "per-unit Mu/s", "current Mu/s", "speedup");
+    size_t sink = 0;
+    for (const auto& c : corpora) {
+        const double baseline = run(c, iterations, pdbsql_test::reference_utf16_to_utf8, sink);
+        const double current = run(c, iterations,
+                                   [](const char16_t* p, size_t n) { return pdbsql::utf16_to_utf8(p, n); },
+                                   sink);
+        printf("%-16s %14.1f %14.1f %7.1fx\n", c.name, baseline, current, current / baseline);
+    }
+    return sink == 0;  // Keeps the work observable
+}
@@ -0,0 +1,84 @@
+#pragma once
+// json_text_reference.hpp - Scalar JSON escapers to compare json_text.hpp with
+//
+// legacy_append_json_escaped() is the byte-at-a-time escaper json_text.hpp
+// replaced (non-ASCII bytes passed through unchecked); the benchmark measures
+// against it. reference_append_json_escaped() is the same loop plus a
+// decode-based UTF-8 check, so it defines the expected output for any input.
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+namespace pdbsql_test {
+
+inline void legacy_append_json_escaped(std::string& out, const char* text, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        char ch = text[i];
+        switch (ch) {
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(ch) < 0x20) {
+                    char buf[8];
+                    snprintf(buf, sizeof(buf), "\\u%04x", static_cast<unsigned char>(ch));
+                    out += buf;
+                } else {
+                    out += ch;
+                }
+        }
+    }
+}
+
+// Length of a valid UTF-8 sequence at p (lead byte >= 0x80), 0 if invalid.
+// Decodes the code point and rejects overlong forms, surrogates and values
+// above U+10FFFF.
+inline size_t reference_utf8_length(const unsigned char* p, size_t avail) {
+    size_t n;
+    uint32_t cp;
+    if ((p[0] & 0xE0) == 0xC0) {
+        n = 2;
+        cp = p[0] & 0x1F;
+    } else if ((p[0] & 0xF0) == 0xE0) {
+        n = 3;
+        cp = p[0] & 0x0F;
+    } else if ((p[0] & 0xF8) == 0xF0) {
+        n = 4;
+        cp = p[0] & 0x07;
+    } else {
+        return 0;
+    }
+    if (avail < n) return 0;
+    for (size_t k = 1; k < n; k++) {
+        if ((p[k] & 0xC0) != 0x80) return 0;
+        cp = (cp << 6) | (p[k] & 0x3F);
+    }
+    static const uint32_t min_for_length[] = {0, 0, 0x80, 0x800, 0x10000};
+    if (cp < min_for_length[n] || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) return 0;
+    return n;
+}
+
+inline void reference_append_json_escaped(std::string& out, const char* text, size_t len) {
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(text);
+    size_t i = 0;
+    while (i < len) {
+        if (p[i] < 0x80) {
+            legacy_append_json_escaped(out, text + i, 1);
+            i++;
+            continue;
+        }
+        size_t n = reference_utf8_length(p + i, len - i);
+        if (n) {
+            out.append(text + i, n);
+            i += n;
+        } else {
+            out += "\\ufffd";  // One per invalid byte
+            i++;
+        }
+    }
+}
+
+} // namespace pdbsql_test
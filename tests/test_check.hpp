@@ -0,0 +1,59 @@
+#pragma once
+// test_check.hpp - Minimal assertions for the portable header tests
+//
+// CHECK / CHECK_EQ record a failure and keep going; a test's main() returns
+// test_result() so ctest sees a non-zero exit when anything failed.
+
+#include <cstdio>
+#include <string>
+
+namespace pdbsql_test {
+
+inline int& failures() {
+    static int count = 0;
+    return count;
+}
+
+inline std::string printable(const std::string& s) {
+    std::string out;
+    for (unsigned char c : s) {
+        if (c >= 0x20 && c < 0x7F) {
+            out += static_cast<char>(c);
+        } else {
+            char buf[8];
+            snprintf(buf, sizeof(buf), "\\x%02x", c);
+            out += buf;
+        }
+    }
+    return out;
+}
+
+inline void check_eq(const std::string& actual, const std::string& expected, const char* what,
+                     const char* file, int line) {
+    if (actual == expected) return;
+    failures()++;
+    fprintf(stderr, "%s:%d: %s\n  expected: %s\n  actual:   %s\n", file, line, what,
+            printable(expected).c_str(), printable(actual).c_str());
+}
+
+inline int test_result(const char* name) {
+    if (failures()) {
+        fprintf(stderr, "%s: %d failure(s)\n", name, failures());
+        return 1;
+    }
+    printf("%s: ok\n", name);
+    return 0;
+}
+
+} // namespace pdbsql_test
+
+#define CHECK(cond)                                                              \
+    do {                                                                         \
+        if (!(cond)) {                                                           \
+            ::pdbsql_test::failures()++;                                         \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+        }                                                                        \
+    } while (0)
+
+#define CHECK_EQ(actual, expected) \
+    ::pdbsql_test::check_eq((actual), (expected), #actual, __FILE__, __LINE__)
@@ -0,0 +1,99 @@
+// test_json_text.cpp - append_json_escaped() against the scalar reference
+//
+// Built once for the baseline target (SSE2 on x86-64) and once with AVX2, so
+// both vector loops and the scalar tail are compared on the same inputs.
+
+#include "json_text.hpp"
+#include "json_text_reference.hpp"
+#include "test_check.hpp"
+
+#include <random>
+#include <string>
+
+using pdbsql_test::reference_append_json_escaped;
+
+static std::string escaped(const std::string& s) {
+    std::string out;
+    pdbsql::append_json_escaped(out, s.data(), s.size());
+    return out;
+}
+
+static std::string expected(const std::string& s) {
+    std::string out;
+    reference_append_json_escaped(out, s.data(), s.size());
+    return out;
+}
+
+static void test_known_values() {
+    CHECK_EQ(escaped(""), "");
+    CHECK_EQ(escaped("plain"), "plain");
+    CHECK_EQ(escaped("a\"b\\c"), "a\\\"b\\\\c");
+    CHECK_EQ(escaped("\n\r\t"), "\\n\\r\\t");
+    CHECK_EQ(escaped(std::string("\x01\x1f\x7f", 3)), "\\u0001\\u001f\x7f");
+    CHECK_EQ(escaped(std::string("a\0b", 3)), "a\\u0000b");
+    CHECK_EQ(escaped("caf\xc3\xa9"), "caf\xc3\xa9");                     // U+00E9
+    CHECK_EQ(escaped("\xe2\x82\xac"), "\xe2\x82\xac");                   // U+20AC
+    CHECK_EQ(escaped("\xf0\x9f\x98\x80"), "\xf0\x9f\x98\x80");           // U+1F600
+    CHECK_EQ(escaped("\xc0\xaf"), "\\ufffd\\ufffd");                     // Overlong '/'
+    CHECK_EQ(escaped("\xe0\x80\xaf"), "\\ufffd\\ufffd\\ufffd");          // Overlong, 3 bytes
+    CHECK_EQ(escaped("\xed\xa0\x80"), "\\ufffd\\ufffd\\ufffd");          // Surrogate D800
+    CHECK_EQ(escaped("\xf4\x90\x80\x80"), "\\ufffd\\ufffd\\ufffd\\ufffd");  // Above U+10FFFF
+    CHECK_EQ(escaped("ab\xe2\x82"), "ab\\ufffd\\ufffd");                 // Truncated at end
+    CHECK_EQ(escaped("\x80x"), "\\ufffdx");                              // Stray continuation
+    CHECK_EQ(escaped("\xff"), "\\ufffd");
+
+    std::string quoted;
+    pdbsql::append_json_string(quoted, "x\"y");
+    CHECK_EQ(quoted, "\"x\\\"y\"");
+}
+
+// A special byte at every offset of strings around the 16/32-byte block sizes
+static void test_block_boundaries() {
+    const char* specials[] = {"\"", "\\", "\n", "\x01", "\xc3\xa9", "\xe2\x82\xac", "\xf0\x9f\x98\x80", "\xc3", "\x80"};
+    for (size_t len = 0; len <= 70; len++) {
+        for (size_t at = 0; at <= len; at++) {
+            for (const char* special : specials) {
+                std::string s(len, 'a');
+                s.insert(at, special);
+                CHECK_EQ(escaped(s), expected(s));
+            }
+        }
+    }
+}
+
+static void test_random(uint32_t seed, size_t count) {
+    std::mt19937 rng(seed);
+    // Mostly ASCII with some structure, so clean runs of every length occur
+    const std::string pieces[] = {"\"", "\\", "\n", "\t", std::string(1, '\0'), "\x1f", "\xc3\xa9", "\xe2\x82\xac",
+                                  "\xf0\x9f\x98\x80", "\xed\xa0\x80", "\xc0\xaf", "\xf4\x90\x80\x80", "\xe2\x82",
+                                  "\x80", "\xff"};
+    for (size_t n = 0; n < count; n++) {
+        std::string s;
+        const size_t len = rng() % 200;
+        while (s.size() < len) {
+            const uint32_t r = rng() % 100;
+            if (r < 70) {
+                s += static_cast<char>('a' + rng() % 26);
+            } else if (r < 85) {
+                s += pieces[rng() % (sizeof(pieces) / sizeof(pieces[0]))];
+            } else {
+                s += static_cast<char>(rng() & 0xFF);  // Any byte
+            }
+        }
+        CHECK_EQ(escaped(s), expected(s));
+    }
+}
+
+int main() {
+#if defined(PDBSQL_JSON_AVX2) && defined(__GNUC__)
+    if (!__builtin_cpu_supports("avx2")) {
+        printf("test_json_text: skipped (CPU has no AVX2)\n");
+        return 0;
+    }
+#endif
+    test_known_values();
+    test_block_boundaries();
+    test_random(1, 20000);
+    test_random(2, 20000);
+    return pdbsql_test::test_result("test_json_text");
+}
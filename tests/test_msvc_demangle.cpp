@@ -0,0 +1,247 @@
+// test_msvc_demangle.cpp - undecorate() against expected undname output
+//
+// The corpus covers functions, variables, members, operators, templates,
+// back-references, pointers to functions/members/arrays and special names.
+// Expected strings are in UnDecorateSymbolName's format (__ptr64, no space
+// after ',' and "> >"), which differs from llvm-undname's.
+
+#include "msvc_demangle.hpp"
+#include "test_check.hpp"
+
+#include <string>
+
+struct Case {
+    const char* mangled;
+    const char* expected;
+};
+
+static const Case kCorpus[] = {
+    {"?foo@@YAHH@Z",
+     "int __cdecl foo(int)"},
+    {"?x@@3HA",
+     "int x"},
+    {"?x@ns@@3PEBDEB",
+     "char const * __ptr64 ns::x"},
+    {"?bar@Foo@@QEAAXXZ",
+     "public: void __cdecl Foo::bar(void) __ptr64"},
+    {"?bar@Foo@@QEBAHXZ",
+     "public: int __cdecl Foo::bar(void) const __ptr64"},
+    {"??0Foo@@QEAA@XZ",
+     "public: __cdecl Foo::Foo(void) __ptr64"},
+    {"??1Foo@@UEAA@XZ",
+     "public: virtual __cdecl Foo::~Foo(void) __ptr64"},
+    {"??_GFoo@@UEAAPEAXI@Z",
+     "public: virtual void * __ptr64 __cdecl Foo::`scalar deleting destructor'(unsigned int) __ptr64"},
+    {"??_7Foo@@6B@",
+     "const Foo::`vftable'"},
+    {"??4Foo@@QEAAAEAV0@AEBV0@@Z",
+     "public: class Foo & __ptr64 __cdecl Foo::operator=(class Foo const & __ptr64) __ptr64"},
+    {"?f@@YAXPEAHAEAH@Z",
+     "void __cdecl f(int * __ptr64,int & __ptr64)"},
+    {"?f@@YAXP6AHH@Z@Z",
+     "void __cdecl f(int (__cdecl*)(int))"},
+    {"?f@@YAXPEBD0@Z",
+     "void __cdecl f(char const * __ptr64,char const * __ptr64)"},
+    {"??$max@H@std@@YAAEBHAEBH0@Z",
+     "int const & __ptr64 __cdecl std::max<int>(int const & __ptr64,int const & __ptr64)"},
+    {"?push_back@?$vector@HV?$allocator@H@std@@@std@@QEAAXAEBH@Z",
+     "public: void __cdecl std::vector<int,class std::allocator<int> >::push_back(int const & __ptr64) __ptr64"},
+    {"?g@@YAXZZ",
+     "void __cdecl g(...)"},
+    {"?h@@YA_NXZ",
+     "bool __cdecl h(void)"},
+    {"?i@@YAX_K_J@Z",
+     "void __cdecl i(unsigned __int64,__int64)"},
+    {"?s@Foo@@SAXXZ",
+     "public: static void __cdecl Foo::s(void)"},
+    {"?v@Foo@@MEAAXXZ",
+     "protected: virtual void __cdecl Foo::v(void) __ptr64"},
+    {"?p@Foo@@AEAAXXZ",
+     "private: void __cdecl Foo::p(void) __ptr64"},
+    {"?arr@@3PAY01HA",
+     "int (* arr)[2]"},
+    {"?f@@YAXQEAH@Z",
+     "void __cdecl f(int * __ptr64 const)"},
+    {"?f@@YAX$$QEAH@Z",
+     "void __cdecl f(int && __ptr64)"},
+    {"?a@?A0x1234@@3HA",
+     "int `anonymous namespace'::a"},
+    {"?f@@YAXW4E@@@Z",
+     "void __cdecl f(enum E)"},
+    {"?f@@YAXTU@@@Z",
+     "void __cdecl f(union U)"},
+    {"?f@@YAXUS@@@Z",
+     "void __cdecl f(struct S)"},
+    {"??H@YA?AVFoo@@AEBV0@0@Z",
+     "class Foo __cdecl operator+(class Foo const & __ptr64,class Foo const & __ptr64)"},
+    {"??BFoo@@QEBAHXZ",
+     "public: __cdecl Foo::operator int(void) const __ptr64"},
+    {"?f@@YGXH@Z",
+     "void __stdcall f(int)"},
+    {"?f@@YIXH@Z",
+     "void __fastcall f(int)"},
+    {"?f@@YAXPEAPEAH@Z",
+     "void __cdecl f(int * __ptr64 * __ptr64)"},
+    {"?f@@YAXP8Foo@@EAAXXZ@Z",
+     "void __cdecl f(void (__cdecl Foo::*)(void) __ptr64)"},
+    {"?m@@3PEQFoo@@HEQ1@",
+     "int Foo::* __ptr64 m"},
+    {"??_R0?AVFoo@@@8",
+     "class Foo `RTTI Type Descriptor'"},
+    {"??_R4Foo@@6B@",
+     "const Foo::`RTTI Complete Object Locator'"},
+    {"??_R3Foo@@8",
+     "Foo::`RTTI Class Hierarchy Descriptor'"},
+    {"?f@@YAX$$T@Z",
+     "void __cdecl f(std::nullptr_t)"},
+    {"?x@?1??foo@@YAXXZ@4HA",
+     "int `void __cdecl foo(void)'::`2'::x"},
+    {"?f@@YAXAEAY01H@Z",
+     "void __cdecl f(int (& __ptr64)[2])"},
+    {"?f@Foo@@QEAAXXZ",
+     "public: void __cdecl Foo::f(void) __ptr64"},
+    {"??$f@$0A@@@YAXXZ",
+     "void __cdecl f<0>(void)"},
+    {"??$f@$0BA@@@YAXXZ",
+     "void __cdecl f<16>(void)"},
+    {"??$f@$0?5@@YAXXZ",
+     "void __cdecl f<-6>(void)"},
+    {"?f@@YAXPEAX@Z",
+     "void __cdecl f(void * __ptr64)"},
+    {"?f@@YA?BHXZ",
+     "int const __cdecl f(void)"},
+    {"??$?8DU?$char_traits@D@std@@V?$allocator@D@1@@std@@YA_NAEBV?$basic_string@DU?$char_traits@D@std@@V?$allocator@D@2@@0@PEBD@Z",
+     "bool __cdecl std::operator==<char,struct std::char_traits<char>,class std::allocator<char> >(class std::basic_string<char,struct std::char_traits<char>,class std::allocator<char> > const & __ptr64,char const * __ptr64)"},
+    {"?f@@YAXV?$A@V?$B@H@@@@@Z",
+     "void __cdecl f(class A<class B<int> >)"},
+    {"??0?$A@H@@QEAA@XZ",
+     "public: __cdecl A<int>::A<int>(void) __ptr64"},
+    {"?what@exception@std@@UEBAPEBDXZ",
+     "public: virtual char const * __ptr64 __cdecl std::exception::what(void) const __ptr64"},
+    {"?f@@YAXPEAU?$pair@HH@std@@@Z",
+     "void __cdecl f(struct std::pair<int,int> * __ptr64)"},
+    {"?f@@YAXP6AXXZ0@Z",
+     "void __cdecl f(void (__cdecl*)(void),void (__cdecl*)(void))"},
+    {"?g@@YAP6AHH@ZXZ",
+     "int (__cdecl* __cdecl g(void))(int)"},
+    {"?x@@3P6AHH@ZEA",
+     "int (__cdecl* __ptr64 x)(int)"},
+    {"?f@@YAX_W@Z",
+     "void __cdecl f(wchar_t)"},
+    {"?f@@YAXPEA_W@Z",
+     "void __cdecl f(wchar_t * __ptr64)"},
+    {"?f@@YAXPECH@Z",
+     "void __cdecl f(int volatile * __ptr64)"},
+    {"?f@@YAXPEDH@Z",
+     "void __cdecl f(int const volatile * __ptr64)"},
+    {"??__Ex@@YAXXZ",
+     "void __cdecl `dynamic initializer for 'x''(void)"},
+    {"??_R1A@?0A@EA@Foo@@8",
+     "Foo::`RTTI Base Class Descriptor at (0,-1,0,64)'"},
+    {"??_7Foo@@6BBar@@@",
+     "const Foo::`vftable'{for `Bar'}"},
+    {"??_C@_0M@ABCD@hello?5world?$AA@",
+     "`string'"},
+    {"?f@Foo@@W7EAAXXZ",
+     "[thunk]:public: virtual void __cdecl Foo::f`adjustor{8}' (void) __ptr64"},
+    {"?f@@YAXP6AXH@Z@Z",
+     "void __cdecl f(void (__cdecl*)(int))"},
+    {"?f@@YAXPEAY02H@Z",
+     "void __cdecl f(int (* __ptr64)[3])"},
+    {"?f@@YAXQEBD@Z",
+     "void __cdecl f(char const * __ptr64 const)"},
+    {"?s@@3V?$basic_string@DU?$char_traits@D@std@@V?$allocator@D@2@@std@@A",
+     "class std::basic_string<char,struct std::char_traits<char>,class std::allocator<char> > s"},
+    {"?f@@YAXV?$function@$$A6AXH@Z@std@@@Z",
+     "void __cdecl f(class std::function<void __cdecl(int)>)"},
+    {"?f@@YAX$$QEAV?$unique_ptr@HU?$default_delete@H@std@@@std@@@Z",
+     "void __cdecl f(class std::unique_ptr<int,struct std::default_delete<int> > && __ptr64)"},
+    {"?f@@YA?AV?$vector@V?$vector@HV?$allocator@H@std@@@std@@V?$allocator@V?$vector@HV?$allocator@H@std@@@std@@@2@@std@@XZ",
+     "class std::vector<class std::vector<int,class std::allocator<int> >,class std::allocator<class std::vector<int,class std::allocator<int> > > > __cdecl f(void)"},
+    {"?f@Foo@@QEGAAXXZ",
+     "public: void __cdecl Foo::f(void) __ptr64 &"},
+    {"?f@Foo@@QEHAAXXZ",
+     "public: void __cdecl Foo::f(void) __ptr64 &&"},
+    {"?g@@YAXPEBQEAH@Z",
+     "void __cdecl g(int * __ptr64 const * __ptr64)"},
+    {"?x@@3PEAHEA",
+     "int * __ptr64 x"},
+    {"?y@@3QEBHEB",
+     "int const * __ptr64 const y"},
+    {"?ptr@@3PEAXEA",
+     "void * __ptr64 ptr"},
+    {"?f@@YAXHHHHHHHHHHHH@Z",
+     "void __cdecl f(int,int,int,int,int,int,int,int,int,int,int,int)"},
+    {"?f@@YAXPEAHPEAH@Z",
+     "void __cdecl f(int * __ptr64,int * __ptr64)"},
+    {"?f@@YAXAEAVA@@AEAVB@@01@Z",
+     "void __cdecl f(class A & __ptr64,class B & __ptr64,class A & __ptr64,class B & __ptr64)"},
+};
+
+static void test_corpus() {
+    for (const Case& c : kCorpus) {
+        std::string out;
+        CHECK(pdbsql::undecorate(c.mangled, pdbsql::UNDECORATE_COMPLETE, out));
+        CHECK_EQ(out, c.expected);
+    }
+}
+
+static void test_flags() {
+    CHECK_EQ(pdbsql::undecorate("?bar@Foo@@QEBAHXZ", pdbsql::UNDECORATE_NO_MS_KEYWORDS),
+             "public: int Foo::bar(void) const");
+    CHECK_EQ(pdbsql::undecorate("?bar@Foo@@QEBAHXZ", pdbsql::UNDECORATE_NAME_ONLY), "Foo::bar");
+    CHECK_EQ(pdbsql::undecorate("_foo@8"), "foo");
+    CHECK_EQ(pdbsql::undecorate("not_decorated"), "not_decorated");
+}
+
+// Pointer to member function: the calling convention and the class are
+// separate words, unlike a plain function pointer's "(__cdecl*)"
+static void test_member_function_pointer() {
+    CHECK_EQ(pdbsql::undecorate("?f@@YAXP8C@@EAAXXZ@Z"), "void __cdecl f(void (__cdecl C::*)(void) __ptr64)");
+    CHECK_EQ(pdbsql::undecorate("?f@@YAXP8C@@EAAXXZ@Z", pdbsql::UNDECORATE_NO_MS_KEYWORDS),
+             "void f(void (C::*)(void))");
+    CHECK_EQ(pdbsql::undecorate("?f@@YAXP8C@@EBAHH@Z@Z"), "void __cdecl f(int (__cdecl C::*)(int) const __ptr64)");
+    CHECK_EQ(pdbsql::undecorate("?f@@YAXP6AXXZ@Z"), "void __cdecl f(void (__cdecl*)(void))");
+}
+
+// A member pointer variable whose storage class names the class again: the
+// second class name adds nodes while the pointer node is being updated
+static void test_member_pointer_variable() {
+    std::string out;
+    CHECK(pdbsql::undecorate("?x@@3PEQ?$Foo@H@@HEQ?$Bar@HHHHHHHHHHH@@", pdbsql::UNDECORATE_COMPLETE, out));
+    CHECK_EQ(out, "int Foo<int>::* __ptr64 x");
+}
+
+// Deeply nested input fails (and comes back unchanged) instead of
+// overflowing the stack
+static void test_nesting_limit() {
+    std::string deep = "?f@@YAX";
+    for (int i = 0; i < 10000; i++) deep += "PEA";
+    deep += "H@Z";
+    std::string out;
+    CHECK(!pdbsql::undecorate(deep, pdbsql::UNDECORATE_COMPLETE, out));
+    CHECK_EQ(out, deep);
+
+    std::string shallow = "?f@@YAX";
+    for (int i = 0; i < 100; i++) shallow += "PEA";
+    shallow += "H@Z";
+    CHECK(pdbsql::undecorate(shallow, pdbsql::UNDECORATE_COMPLETE, out));
+
+    // Nested template arguments and nested symbols count toward the same limit
+    std::string templates = "?f@@YAXV";
+    for (int i = 0; i < 10000; i++) templates += "?$A@V";
+    templates += "B@@";
+    std::string nested = "?f@@YAXU?$A@$1";
+    for (int i = 0; i < 10000; i++) nested += "?x@@3U?$A@$1";
+    CHECK(!pdbsql::undecorate(templates, pdbsql::UNDECORATE_COMPLETE, out));
+    CHECK(!pdbsql::undecorate(nested, pdbsql::UNDECORATE_COMPLETE, out));
+}
+
+int main() {
+    test_corpus();
+    test_flags();
+    test_member_function_pointer();
+    test_member_pointer_variable();
+    test_nesting_limit();
+    return pdbsql_test::test_result("test_msvc_demangle");
+}
@@ -0,0 +1,72 @@
+// test_output_format.cpp - exec_records() and RecordWriter output
+//
+// Runs queries against an in-memory SQLite database and compares the bytes
+// written for each --format, including results with no rows.
+
+#include "output_format.hpp"
+#include "test_check.hpp"
+
+#include <sqlite3.h>
+
+#include <cstdio>
+#include <string>
+
+// Output of sql in format, read back from a temporary file
+static std::string run(sqlite3* db, const char* sql, OutputFormat format, int* rc = nullptr) {
+    FILE* out = tmpfile();
+    if (!out) return "<tmpfile failed>";
+    {
+        RecordWriter writer(format, out);
+        const int result = exec_records(db, sql, writer);
+        if (rc) *rc = result;
+    }
+    std::string text;
+    rewind(out);
+    char buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), out)) > 0) text.append(buf, n);
+    fclose(out);
+    return text;
+}
+
+static void test_empty_result(sqlite3* db) {
+    CHECK_EQ(run(db, "SELECT name, rva FROM t WHERE 0", OutputFormat::Csv), "name,rva\r\n");
+    CHECK_EQ(run(db, "SELECT name, rva FROM t WHERE 0", OutputFormat::Tsv), "name\trva\n");
+    CHECK_EQ(run(db, "SELECT name, rva FROM t WHERE 0", OutputFormat::Ndjson), "");
+    CHECK_EQ(run(db, "SELECT name, rva FROM t WHERE 0", OutputFormat::Null), "");
+}
+
+static void test_rows(sqlite3* db) {
+    CHECK_EQ(run(db, "SELECT name, rva FROM t ORDER BY rva", OutputFormat::Csv),
+             "name,rva\r\nmain,16\r\n\"a,b\",32\r\n,48\r\n");
+    CHECK_EQ(run(db, "SELECT name, rva FROM t ORDER BY rva", OutputFormat::Tsv),
+             "name\trva\nmain\t16\na,b\t32\n\\N\t48\n");
+    CHECK_EQ(run(db, "SELECT name, rva FROM t ORDER BY rva", OutputFormat::Ndjson),
+             "{\"name\":\"main\",\"rva\":\"16\"}\n{\"name\":\"a,b\",\"rva\":\"32\"}\n"
+             "{\"name\":null,\"rva\":\"48\"}\n");
+}
+
+// Several statements: one header (from the first with columns), then all rows
+static void test_statements(sqlite3* db) {
+    CHECK_EQ(run(db, "CREATE TEMP TABLE u(x); SELECT rva FROM t WHERE 0; SELECT 1 AS one; -- done",
+                 OutputFormat::Csv),
+             "rva\r\n1\r\n");
+
+    int rc = SQLITE_OK;
+    CHECK_EQ(run(db, "SELECT missing FROM t", OutputFormat::Csv, &rc), "");
+    CHECK(rc == SQLITE_ERROR);
+    CHECK_EQ(sqlite3_errmsg(db), std::string("no such column: missing"));
+}
+
+int main() {
+    sqlite3* db = nullptr;
+    if (sqlite3_open(":memory:", &db) != SQLITE_OK) return 1;
+    sqlite3_exec(db, "CREATE TABLE t(name TEXT, rva INTEGER);"
+                     "INSERT INTO t VALUES ('main', 16), ('a,b', 32), (NULL, 48);",
+                 nullptr, nullptr, nullptr);
+    test_empty_result(db);
+    test_rows(db);
+    test_statements(db);
+    sqlite3_close(db);
+    return pdbsql_test::test_result("test_output_format");
+}
@@ -0,0 +1,86 @@
+// test_symbol_search.cpp - SymbolSearchIndex candidates and ranking
+//
+// Queries and names are normalized alike, so separators ('_', spaces, "::")
+// match each other: "file size" has to find get_file_size as well as
+// GetFileSize.
+
+#include "symbol_search.hpp"
+#include "test_check.hpp"
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+pdbsql::SymbolSearchIndex make_index() {
+    pdbsql::SymbolSearchIndex index;
+    const char* names[] = {
+        "get_file_size", "GetFileSize", "ns::file::size", "set_file_time", "get_window_size",
+        "FileSystem::open", "resize_buffer", "profile_sizes_table", "main", "__imp_CreateFileW",
+    };
+    for (const char* name : names) index.add(name, "");
+    index.finish();
+    return index;
+}
+
+std::vector<std::string> search(const pdbsql::SymbolSearchIndex& index, std::string_view query, size_t limit = 20) {
+    std::vector<std::string> out;
+    for (const auto& hit : index.search(query, limit)) out.push_back(index.name(hit.entry));
+    return out;
+}
+
+bool found(const std::vector<std::string>& hits, const std::string& name) {
+    for (const auto& hit : hits) {
+        if (hit == name) return true;
+    }
+    return false;
+}
+
+std::string first(const std::vector<std::string>& hits) {
+    return hits.empty() ? std::string() : hits[0];
+}
+
+} // namespace
+
+static void test_normalize() {
+    using pdbsql::search_detail::normalize;
+    CHECK_EQ(normalize("Get_File_Size"), "get_file_size");
+    CHECK_EQ(normalize("file size"), "file_size");
+    CHECK_EQ(normalize("ns::Foo<int>"), "ns_foo_int_");
+    CHECK_EQ(normalize("__imp_  x"), "_imp_x");
+    CHECK_EQ(normalize("caf\xc3\xa9"), "caf\xc3\xa9");  // UTF-8 bytes are not separators
+}
+
+// Space-separated queries against snake_case names, and the other way round
+static void test_separators() {
+    const auto index = make_index();
+
+    auto hits = search(index, "file size");
+    CHECK(found(hits, "get_file_size"));
+    CHECK(found(hits, "GetFileSize"));
+    CHECK(found(hits, "ns::file::size"));
+
+    CHECK_EQ(first(search(index, "get file size")), "get_file_size");
+    CHECK_EQ(first(search(index, "get-file-size")), "get_file_size");
+    CHECK_EQ(first(search(index, "ns file size")), "ns::file::size");
+    CHECK(found(search(index, "file_size"), "GetFileSize"));
+    CHECK(found(search(index, "imp create"), "__imp_CreateFileW"));
+}
+
+static void test_ranking() {
+    const auto index = make_index();
+    CHECK_EQ(first(search(index, "GetFileSize")), "GetFileSize");
+    CHECK_EQ(first(search(index, "gfs")), "GetFileSize");
+    CHECK_EQ(first(search(index, "main")), "main");
+    CHECK(found(search(index, "ai"), "main"));  // Shorter than a trigram
+    CHECK(search(index, "zzzz").empty());
+    CHECK(search(index, "file", 2).size() == 2);
+}
+
+int main() {
+    test_normalize();
+    test_separators();
+    test_ranking();
+    return pdbsql_test::test_result("test_symbol_search");
+}
@@ -0,0 +1,111 @@
+// test_utf16.cpp - utf16_to_utf8() against the per-code-unit reference
+//
+// Covers surrogate pairs, unpaired surrogates, embedded NULs and inputs that
+// straddle the 16-unit SSE2 block, where the vector loop hands off to the
+// scalar one.
+
+#include "utf16.hpp"
+#include "utf16_reference.hpp"
+#include "test_check.hpp"
+
+#include <random>
+#include <string>
+
+using pdbsql_test::reference_utf16_to_utf8;
+
+static std::string convert(const std::u16string& s) {
+    return pdbsql::utf16_to_utf8(s.data(), s.size());
+}
+
+static std::string expected(const std::u16string& s) {
+    return reference_utf16_to_utf8(s.data(), s.size());
+}
+
+static void test_known_values() {
+    CHECK_EQ(convert(u""), "");
+    CHECK_EQ(convert(u"main"), "main");
+    CHECK_EQ(convert(u"caf\u00e9"), "caf\xc3\xa9");                        // 2 bytes
+    CHECK_EQ(convert(u"\u20ac"), "\xe2\x82\xac");                          // 3 bytes
+    CHECK_EQ(convert(u"\U0001F600"), "\xf0\x9f\x98\x80");                  // Surrogate pair
+    CHECK_EQ(convert(u"\U0010FFFF"), "\xf4\x8f\xbf\xbf");                  // Highest pair
+    CHECK_EQ(convert(std::u16string(1, 0xD83D)), "\xef\xbf\xbd");          // Lone high at end
+    CHECK_EQ(convert(std::u16string(1, 0xDE00)), "\xef\xbf\xbd");          // Lone low
+    CHECK_EQ(convert(std::u16string{0xDE00, 0xD83D}), "\xef\xbf\xbd\xef\xbf\xbd");  // Reversed pair
+    CHECK_EQ(convert(std::u16string{0xD83D, u'x'}), "\xef\xbf\xbdx");      // High, then not low
+    CHECK_EQ(convert(std::u16string{0xD83D, 0xD83D, 0xDE00}), "\xef\xbf\xbd\xf0\x9f\x98\x80");
+}
+
+// bstr_to_string() converts SysStringLen() units, so a BSTR with an embedded
+// NUL keeps it and everything after it. WideCharToMultiByte(cchWideChar = -1),
+// which it used before, stopped at the first NUL.
+static void test_embedded_nul() {
+    const std::u16string s(u"ab\0cd", 5);
+    CHECK_EQ(convert(s), std::string("ab\0cd", 5));
+    CHECK_EQ(convert(std::u16string(1, u'\0')), std::string(1, '\0'));
+
+    // Inside and at the end of an ASCII block
+    std::u16string block(40, u'x');
+    block[7] = u'\0';
+    block[31] = u'\0';
+    std::string want(40, 'x');
+    want[7] = '\0';
+    want[31] = '\0';
+    CHECK_EQ(convert(block), want);
+}
+
+// One non-ASCII unit (or pair) at every offset of strings around the
+// 16-unit block size, including a pair split across two blocks
+static void test_block_boundaries() {
+    const std::u16string specials[] = {u"\u00e9", u"\u20ac", u"\U0001F600", std::u16string(1, 0xD800),
+                                       std::u16string(1, 0xDC00), u"\u007f", u"\u0080", u"\uffff"};
+    for (size_t len = 0; len <= 50; len++) {
+        for (size_t at = 0; at <= len; at++) {
+            for (const auto& special : specials) {
+                std::u16string s(len, u'a');
+                s.insert(at, special);
+                CHECK_EQ(convert(s), expected(s));
+            }
+        }
+    }
+}
+
+static void test_append() {
+    std::string out = "prefix:";
+    const std::u16string s = u"name\u00e9";
+    pdbsql::append_utf16_as_utf8(out, s.data(), s.size());
+    CHECK_EQ(out, "prefix:name\xc3\xa9");
+
+    char buf[3 * 4];
+    const std::u16string w = u"\u20ac\u20ac\u20ac\u20ac";  // Worst case: 3 bytes per unit
+    CHECK(pdbsql::utf16_to_utf8(w.data(), w.size(), buf) == pdbsql::utf8_capacity_for_utf16(w.size()));
+}
+
+static void test_random(uint32_t seed, size_t count) {
+    std::mt19937 rng(seed);
+    for (size_t n = 0; n < count; n++) {
+        std::u16string s;
+        const size_t len = rng() % 100;
+        while (s.size() < len) {
+            const uint32_t r = rng() % 100;
+            if (r < 70) {
+                s += static_cast<char16_t>('a' + rng() % 26);
+            } else if (r < 80) {
+                s += static_cast<char16_t>(0xD800 + rng() % 0x800);  // Any surrogate
+            } else if (r < 85) {
+                s += u"\U0001F600";
+            } else {
+                s += static_cast<char16_t>(rng() & 0xFFFF);
+            }
+        }
+        CHECK_EQ(convert(s), expected(s));
+    }
+}
+
+int main() {
+    test_known_values();
+    test_embedded_nul();
+    test_block_boundaries();
+    test_append();
+    test_random(1, 50000);
+    return pdbsql_test::test_result("test_utf16");
+}
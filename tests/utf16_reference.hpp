@@ -0,0 +1,49 @@
+#pragma once
+// utf16_reference.hpp - Per-code-unit UTF-16 to UTF-8 encoder to compare utf16.hpp with
+//
+// Decodes one code point at a time (surrogate pairs joined, unpaired
+// surrogates replaced by U+FFFD) and encodes it by range. No fast paths.
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace pdbsql_test {
+
+inline void reference_append_code_point(std::string& out, uint32_t cp) {
+    if (cp < 0x80) {
+        out += static_cast<char>(cp);
+    } else if (cp < 0x800) {
+        out += static_cast<char>(0xC0 | (cp >> 6));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        out += static_cast<char>(0xE0 | (cp >> 12));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (cp >> 18));
+        out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    }
+}
+
+inline std::string reference_utf16_to_utf8(const char16_t* src, size_t units) {
+    std::string out;
+    for (size_t i = 0; i < units; i++) {
+        const uint32_t u = src[i];
+        const bool high = u >= 0xD800 && u <= 0xDBFF;
+        const bool low = u >= 0xDC00 && u <= 0xDFFF;
+        if (high && i + 1 < units && src[i + 1] >= 0xDC00 && src[i + 1] <= 0xDFFF) {
+            reference_append_code_point(out, 0x10000 + ((u - 0xD800) << 10) + (src[i + 1] - 0xDC00u));
+            i++;
+        } else if (high || low) {
+            reference_append_code_point(out, 0xFFFD);
+        } else {
+            reference_append_code_point(out, u);
+        }
+    }
+    return out;
+}
+
+} // namespace pdbsql_test